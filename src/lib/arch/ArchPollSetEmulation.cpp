@@ -0,0 +1,156 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/ArchPollSetEmulation.h"
+
+#include "arch/Arch.h"
+
+//
+// ArchPollSetEmulation
+//
+
+ArchPollSetEmulation::ArchPollSetEmulation(IArchNetwork* network) :
+	m_network(network),
+	m_mutex(ARCH->newMutex()),
+	m_done(ARCH->newCondVar()),
+	m_waiter(NULL),
+	m_waiting(false),
+	m_changed(false)
+{
+	// do nothing
+}
+
+ArchPollSetEmulation::~ArchPollSetEmulation()
+{
+	assert(!m_waiting);
+
+	if (m_waiter != NULL) {
+		ARCH->closeThread(m_waiter);
+	}
+	ARCH->closeCondVar(m_done);
+	ARCH->closeMutex(m_mutex);
+}
+
+void
+ArchPollSetEmulation::set(ArchSocket s, unsigned short events, void* data)
+{
+	assert(s != NULL);
+
+	ArchMutexLock lock(m_mutex);
+
+	size_t i = 0;
+	while (i < m_entries.size() && m_entries[i].m_socket != s) {
+		++i;
+	}
+	if (i == m_entries.size()) {
+		IArchNetwork::PollEntry entry;
+		entry.m_socket  = s;
+		entry.m_revents = 0;
+		m_entries.push_back(entry);
+		m_data.push_back(NULL);
+	}
+	m_entries[i].m_events = events;
+	m_data[i]             = data;
+
+	m_changed = true;
+	if (m_waiting) {
+		m_network->unblockPollSocket(m_waiter);
+	}
+}
+
+void
+ArchPollSetEmulation::remove(ArchSocket s)
+{
+	assert(s != NULL);
+
+	ArchMutexLock lock(m_mutex);
+
+	for (size_t i = 0; i < m_entries.size(); ++i) {
+		if (m_entries[i].m_socket == s) {
+			m_entries.erase(m_entries.begin() + i);
+			m_data.erase(m_data.begin() + i);
+
+			// the waiting thread may be using the socket so wait for
+			// it to return before the caller can close the socket.
+			m_changed = true;
+			if (m_waiting) {
+				m_network->unblockPollSocket(m_waiter);
+				while (m_waiting) {
+					ARCH->waitCondVar(m_done, m_mutex, -1.0);
+				}
+			}
+			break;
+		}
+	}
+}
+
+int
+ArchPollSetEmulation::wait(IArchNetwork::PollSetEvent events[],
+				int num, double timeout)
+{
+	assert(events != NULL || num == 0);
+
+	// pick up changes.  the copy lets other threads change the set
+	// while we're polling.
+	{
+		ArchMutexLock lock(m_mutex);
+		if (m_changed) {
+			m_polling     = m_entries;
+			m_pollingData = m_data;
+			m_changed     = false;
+		}
+
+		// the same thread always waits so it's looked up just once
+		if (m_waiter == NULL) {
+			m_waiter = ARCH->newCurrentThread();
+		}
+		m_waiting = true;
+	}
+
+	int n;
+	try {
+		IArchNetwork::PollEntry* pe = NULL;
+		if (!m_polling.empty()) {
+			pe = &m_polling[0];
+		}
+		n = m_network->pollSocket(pe, (int)m_polling.size(), timeout);
+	}
+	catch (...) {
+		doneWaiting();
+		throw;
+	}
+	doneWaiting();
+
+	// report sockets with events
+	int j = 0;
+	for (size_t i = 0; n > 0 && i < m_polling.size() && j < num; ++i) {
+		if (m_polling[i].m_revents != 0) {
+			events[j].m_data    = m_pollingData[i];
+			events[j].m_revents = m_polling[i].m_revents;
+			++j;
+		}
+	}
+	return j;
+}
+
+void
+ArchPollSetEmulation::doneWaiting()
+{
+	ArchMutexLock lock(m_mutex);
+	m_waiting = false;
+	ARCH->broadcastCondVar(m_done);
+}
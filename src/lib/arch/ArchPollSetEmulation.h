@@ -0,0 +1,79 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "arch/IArchNetwork.h"
+#include "arch/IArchMultithread.h"
+#include "common/stdvector.h"
+
+//! Poll set emulation
+/*!
+A poll set for platforms without a native one.  Each wait polls a copy
+of the sockets with IArchNetwork::pollSocket() so other threads can
+change the set meanwhile;  changes unblock the waiting thread so it
+picks them up.
+
+A poll set must always be waited on by the same thread.
+*/
+class ArchPollSetEmulation {
+public:
+	ArchPollSetEmulation(IArchNetwork* network);
+	~ArchPollSetEmulation();
+
+	//! @name manipulators
+	//@{
+
+	//! Add or change a socket
+	/*!
+	See IArchNetwork::setPollSetSocket().
+	*/
+	void				set(ArchSocket s, unsigned short events, void* data);
+
+	//! Remove a socket
+	/*!
+	See IArchNetwork::removePollSetSocket().
+	*/
+	void				remove(ArchSocket s);
+
+	//! Wait on the poll set
+	/*!
+	See IArchNetwork::waitPollSet().
+	*/
+	int					wait(IArchNetwork::PollSetEvent events[],
+							int num, double timeout);
+
+	//@}
+
+private:
+	void				doneWaiting();
+
+private:
+	typedef std::vector<IArchNetwork::PollEntry> PollEntries;
+	typedef std::vector<void*> PollData;
+
+	IArchNetwork*		m_network;
+	ArchMutex			m_mutex;
+	ArchCond			m_done;
+	ArchThread			m_waiter;
+	bool				m_waiting;
+	bool				m_changed;
+	PollEntries			m_entries;
+	PollData			m_data;
+	PollEntries			m_polling;
+	PollData			m_pollingData;
+};
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "common/IInterface.h"
+#include "common/basic_types.h"
 
 /*!      
 \class ArchCondImpl
@@ -201,6 +202,14 @@ public:
 	*/
 	virtual void		setPriorityOfThread(ArchThread, int n) = 0;
 
+	//! Restrict thread to CPUs
+	/*!
+	Lets \c thread run only on the CPUs whose bits are set in \c cpus,
+	bit 0 being the first CPU.  Zero lets it run on any CPU.  Some
+	architectures may not support this, in which case it does nothing.
+	*/
+	virtual void		setAffinityOfThread(ArchThread, UInt32 cpus) = 0;
+
 	//! Cancellation point
 	/*!
 	This method does nothing but is a cancellation point.  Clients
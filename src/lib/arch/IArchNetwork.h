@@ -53,6 +53,21 @@ An opaque type representing a network address.
 */
 typedef ArchNetAddressImpl* ArchNetAddress;
 
+/*!      
+\class ArchPollSetImpl
+\brief Internal poll set data.
+An architecture dependent type holding the necessary data for a set
+of sockets to poll.
+*/
+class ArchPollSetImpl;
+
+/*!      
+\var ArchPollSet
+\brief Opaque poll set type.
+An opaque type representing a set of sockets to poll.
+*/
+typedef ArchPollSetImpl* ArchPollSet;
+
 //! Interface for architecture dependent networking
 /*!
 This interface defines the networking operations required by
@@ -101,6 +116,26 @@ public:
 		unsigned short	m_revents;
 	};
 
+	//! A result from \c waitPollSet()
+	class PollSetEvent {
+	public:
+		//! The data passed to \c setPollSetSocket() for the socket
+		void*			m_data;
+
+		//! The result events
+		unsigned short	m_revents;
+	};
+
+	//! A block of data for \c writevSocket()
+	class WriteBuffer {
+	public:
+		//! The data to write
+		const void*		m_data;
+
+		//! The number of bytes at \c m_data
+		size_t			m_size;
+	};
+
 	//! @name manipulators
 	//@{
 
@@ -196,6 +231,53 @@ public:
 	*/
 	virtual void		unblockPollSocket(ArchThread thread) = 0;
 
+	//! Create a poll set
+	/*!
+	Returns a new, empty set of sockets to wait on with \c waitPollSet().
+	Unlike \c pollSocket(), sockets are added and removed one at a time
+	so nothing has to be rebuilt for each wait.
+	*/
+	virtual ArchPollSet	newPollSet() = 0;
+
+	//! Destroy a poll set
+	/*!
+	Destroys a poll set.  This does not close the sockets in it.
+	*/
+	virtual void		closePollSet(ArchPollSet) = 0;
+
+	//! Add or change a socket in a poll set
+	/*!
+	Adds socket \c s to the poll set, or changes its entry if it's
+	already in the set.  \c events can be any combination of \c kPOLLIN
+	and \c kPOLLOUT.  \c data is reported by \c waitPollSet() when the
+	socket has events.  This may be called while another thread is in
+	\c waitPollSet() on the same set;  that thread will see the change
+	without returning.
+	*/
+	virtual void		setPollSetSocket(ArchPollSet, ArchSocket s,
+							unsigned short events, void* data) = 0;
+
+	//! Remove a socket from a poll set
+	/*!
+	Removes socket \c s from the poll set.  Does nothing if it's not in
+	the set.  A thread already in \c waitPollSet() may still report
+	the socket.
+	*/
+	virtual void		removePollSetSocket(ArchPollSet, ArchSocket s) = 0;
+
+	//! Wait on a poll set
+	/*!
+	Waits up to \c timeout seconds (or indefinitely if \c timeout < 0)
+	for sockets in the poll set to have events, then fills in up to
+	\c num entries of \c events and returns the number filled in.
+	Returns 0 if the timeout expired or the thread was unblocked with
+	\c unblockPollSocket().  Event flags are as for \c pollSocket().
+
+	(Cancellation point)
+	*/
+	virtual int			waitPollSet(ArchPollSet, PollSetEvent events[],
+							int num, double timeout) = 0;
+
 	//! Read data from socket
 	/*!
 	Read up to \c len bytes from socket \c s in \c buf and return the
@@ -215,6 +297,15 @@ public:
 	virtual size_t		writeSocket(ArchSocket s,
 							const void* buf, size_t len) = 0;
 
+	//! Write data to socket from several buffers
+	/*!
+	Like \c writeSocket() but writes the \c num buffers in \c bufs, in
+	order, with one call to the socket layer.  Returns the total number
+	of bytes written, which can end part way through any buffer.
+	*/
+	virtual size_t		writevSocket(ArchSocket s,
+							const WriteBuffer* bufs, int num) = 0;
+
 	//! Check error on socket
 	/*!
 	If the socket \c s is in an error state then throws an appropriate
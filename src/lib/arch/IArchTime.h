@@ -19,6 +19,7 @@
 #pragma once
 
 #include "common/IInterface.h"
+#include "common/basic_types.h"
 
 //! Interface for architecture dependent time operations
 /*!
@@ -33,9 +34,19 @@ public:
 	//! Get the current time
 	/*!
 	Returns the number of seconds since some arbitrary starting time.
-	This should return as high a precision as reasonable.
+	This should return as high a precision as reasonable.  The clock
+	is monotonic:  it never goes backwards and doesn't jump when the
+	system's date and time are changed, so it's only good for
+	measuring intervals.
 	*/
 	virtual double		time() = 0;
 
+	//! Get the current time in nanoseconds
+	/*!
+	Returns the same clock as time() in nanoseconds.  Use this for
+	timestamps that must keep their full precision, e.g. for tracing.
+	*/
+	virtual UInt64		nanoseconds() = 0;
+
 	//@}
 };
@@ -20,8 +20,15 @@
 
 #include "arch/Arch.h"
 #include "arch/XArch.h"
+#include "mt/Atomic.h"
 
 #include <signal.h>
+#include <sched.h>
+#include <sys/resource.h>
+#if HAVE_SYS_GETTID
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
 #if TIME_WITH_SYS_TIME
 #	include <sys/time.h>
 #	include <time.h>
@@ -36,6 +43,13 @@
 
 #define SIGWAKEUP SIGUSR1
 
+// time condition variable waits on the monotonic clock where pthreads
+// lets us choose the clock so that changing the date doesn't stretch
+// or cut short a wait
+#if HAVE_CLOCK_GETTIME && !defined(__APPLE__)
+#	define CONDVAR_MONOTONIC 1
+#endif
+
 #if !HAVE_PTHREAD_SIGNAL
 	// boy, is this platform broken.  forget about pthread signal
 	// handling and let signals through to every process.  synergy
@@ -58,6 +72,17 @@ setSignalSet(sigset_t* sigset)
 	sigaddset(sigset, SIGUSR2);
 }
 
+static
+pid_t
+getCurrentTID()
+{
+#if HAVE_SYS_GETTID
+	return static_cast<pid_t>(syscall(SYS_gettid));
+#else
+	return 0;
+#endif
+}
+
 //
 // ArchThreadImpl
 //
@@ -72,11 +97,13 @@ public:
 	pthread_t			m_thread;
 	IArchMultithread::ThreadFunc	m_func;
 	void*				m_userData;
-	bool				m_cancel;
+	AtomicUInt32		m_cancel;
 	bool				m_cancelling;
 	bool				m_exited;
 	void*				m_result;
 	void*				m_networkData;
+	pid_t				m_tid;
+	int					m_priority;
 };
 
 ArchThreadImpl::ArchThreadImpl() :
@@ -84,15 +111,58 @@ ArchThreadImpl::ArchThreadImpl() :
 	m_id(0),
 	m_func(NULL),
 	m_userData(NULL),
-	m_cancel(false),
+	m_cancel(0),
 	m_cancelling(false),
 	m_exited(false),
 	m_result(NULL),
-	m_networkData(NULL)
+	m_networkData(NULL),
+	m_tid(0),
+	m_priority(0)
 {
 	// do nothing
 }
 
+static
+void
+applyPriority(ArchThreadImpl* thread, int base)
+{
+	// positive priorities are lower, like nice values
+#if HAVE_SYS_GETTID
+	// linux gives each thread its own nice value.  raising it above
+	// the base needs privileges and otherwise silently fails.
+	if (thread->m_tid == 0) {
+		return;
+	}
+	int nice = base + thread->m_priority;
+	if (nice < -20) {
+		nice = -20;
+	}
+	else if (nice > 19) {
+		nice = 19;
+	}
+	setpriority(PRIO_PROCESS, static_cast<id_t>(thread->m_tid), nice);
+#else
+	// elsewhere the scheduling priority is per thread and higher
+	// values are more urgent
+	int policy;
+	struct sched_param param;
+	if (pthread_getschedparam(thread->m_thread, &policy, &param) != 0) {
+		return;
+	}
+	int priority = base - thread->m_priority;
+	int lowest   = sched_get_priority_min(policy);
+	int highest  = sched_get_priority_max(policy);
+	if (priority < lowest) {
+		priority = lowest;
+	}
+	else if (priority > highest) {
+		priority = highest;
+	}
+	param.sched_priority = priority;
+	pthread_setschedparam(thread->m_thread, policy, &param);
+#endif
+}
+
 
 //
 // ArchMultithreadPosix
@@ -102,7 +172,8 @@ ArchMultithreadPosix*	ArchMultithreadPosix::s_instance = NULL;
 
 ArchMultithreadPosix::ArchMultithreadPosix() :
 	m_newThreadCalled(false),
-	m_nextID(0)
+	m_nextID(0),
+	m_basePriority(0)
 {
 	assert(s_instance == NULL);
 
@@ -121,8 +192,30 @@ ArchMultithreadPosix::ArchMultithreadPosix() :
 	// list.  no need to lock the mutex since we're the only thread.
 	m_mainThread           = new ArchThreadImpl;
 	m_mainThread->m_thread = pthread_self();
+	m_mainThread->m_tid    = getCurrentTID();
 	insert(m_mainThread);
 
+	// each thread we know about keeps a pointer to itself so finding
+	// the current thread doesn't mean searching the list under the
+	// mutex
+	pthread_key_create(&m_currentKey, NULL);
+	setCurrent(m_mainThread);
+
+	// thread priorities are relative to the main thread's
+#if HAVE_SYS_GETTID
+	errno          = 0;
+	m_basePriority = getpriority(PRIO_PROCESS, 0);
+	if (errno != 0) {
+		m_basePriority = 0;
+	}
+#else
+	int policy;
+	struct sched_param param;
+	if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+		m_basePriority = param.sched_priority;
+	}
+#endif
+
 	// install SIGWAKEUP handler.  this causes SIGWAKEUP to interrupt
 	// system calls.  we use that when cancelling a thread to force it
 	// to wake up immediately if it's blocked in a system call.  we
@@ -153,6 +246,7 @@ ArchMultithreadPosix::~ArchMultithreadPosix()
 {
 	assert(s_instance != NULL);
 
+	pthread_key_delete(m_currentKey);
 	closeMutex(m_threadMutex);
 	s_instance = NULL;
 }
@@ -185,7 +279,15 @@ ArchCond
 ArchMultithreadPosix::newCondVar()
 {
 	ArchCondImpl* cond = new ArchCondImpl;
+#if CONDVAR_MONOTONIC
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	int status = pthread_cond_init(&cond->m_cond, &attr);
+	pthread_condattr_destroy(&attr);
+#else
 	int status = pthread_cond_init(&cond->m_cond, NULL);
+#endif
 	(void)status;
 	assert(status == 0);
 	return cond;
@@ -237,11 +339,15 @@ ArchMultithreadPosix::waitCondVar(ArchCond cond,
 	testCancelThread();
 
 	// get final time
+	struct timespec finalTime;
+#if CONDVAR_MONOTONIC
+	clock_gettime(CLOCK_MONOTONIC, &finalTime);
+#else
 	struct timeval now;
 	gettimeofday(&now, NULL);
-	struct timespec finalTime;
 	finalTime.tv_sec   = now.tv_sec;
 	finalTime.tv_nsec  = now.tv_usec * 1000;
+#endif
 	long timeout_sec   = (long)timeout;
 	long timeout_nsec  = (long)(1.0e+9 * (timeout - timeout_sec));
 	finalTime.tv_sec  += timeout_sec;
@@ -396,10 +502,11 @@ ArchMultithreadPosix::newThread(ThreadFunc func, void* data)
 ArchThread
 ArchMultithreadPosix::newCurrentThread()
 {
+	ArchThreadImpl* thread = findCurrent();
+	assert(thread != NULL);
 	lockMutex(m_threadMutex);
-	ArchThreadImpl* thread = find(pthread_self());
+	refThread(thread);
 	unlockMutex(m_threadMutex);
-	assert(thread != NULL);
 	return thread;
 }
 
@@ -442,7 +549,7 @@ ArchMultithreadPosix::cancelThread(ArchThread thread)
 	bool wakeup = false;
 	lockMutex(m_threadMutex);
 	if (!thread->m_exited && !thread->m_cancelling) {
-		thread->m_cancel = true;
+		thread->m_cancel.store(1);
 		wakeup = true;
 	}
 	unlockMutex(m_threadMutex);
@@ -454,23 +561,44 @@ ArchMultithreadPosix::cancelThread(ArchThread thread)
 }
 
 void
-ArchMultithreadPosix::setPriorityOfThread(ArchThread thread, int /*n*/)
+ArchMultithreadPosix::setPriorityOfThread(ArchThread thread, int n)
 {
 	assert(thread != NULL);
 
-	// FIXME
+	// a new thread doesn't know its kernel id until it runs so save
+	// the priority for it to apply then
+	lockMutex(m_threadMutex);
+	thread->m_priority = n;
+	applyPriority(thread, m_basePriority);
+	unlockMutex(m_threadMutex);
 }
 
 void
-ArchMultithreadPosix::testCancelThread()
+ArchMultithreadPosix::setAffinityOfThread(ArchThread thread, UInt32 cpus)
 {
-	// find current thread
-	lockMutex(m_threadMutex);
-	ArchThreadImpl* thread = findNoRef(pthread_self());
-	unlockMutex(m_threadMutex);
+	assert(thread != NULL);
 
+#if HAVE_PTHREAD_SETAFFINITY_NP
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int i = 0; i < CPU_SETSIZE; ++i) {
+		if (cpus == 0 || (i < 32 && (cpus & (1u << i)) != 0)) {
+			CPU_SET(i, &set);
+		}
+	}
+
+	// fails if none of the cpus exist, which leaves the thread as it was
+	pthread_setaffinity_np(thread->m_thread, sizeof(set), &set);
+#else
+	(void)cpus;
+#endif
+}
+
+void
+ArchMultithreadPosix::testCancelThread()
+{
 	// test cancel on thread
-	testCancelThreadImpl(thread);
+	testCancelThreadImpl(findCurrent());
 }
 
 bool
@@ -672,17 +800,43 @@ ArchMultithreadPosix::refThread(ArchThreadImpl* thread)
 	++thread->m_refCount;
 }
 
+ArchThreadImpl*
+ArchMultithreadPosix::findCurrent()
+{
+	ArchThreadImpl* thread =
+		reinterpret_cast<ArchThreadImpl*>(pthread_getspecific(m_currentKey));
+	if (thread == NULL) {
+		// a thread we didn't start.  search for it.
+		lockMutex(m_threadMutex);
+		thread = findNoRef(pthread_self());
+		unlockMutex(m_threadMutex);
+	}
+	return thread;
+}
+
+void
+ArchMultithreadPosix::setCurrent(ArchThreadImpl* thread)
+{
+	pthread_setspecific(m_currentKey, thread);
+}
+
 void
 ArchMultithreadPosix::testCancelThreadImpl(ArchThreadImpl* thread)
 {
 	assert(thread != NULL);
 
+	// only cancelThread() sets the flag so there's no need for the
+	// mutex until it has
+	if (thread->m_cancel.load() == 0) {
+		return;
+	}
+
 	// update cancel state
 	lockMutex(m_threadMutex);
 	bool cancel = false;
-	if (thread->m_cancel && !thread->m_cancelling) {
+	if (thread->m_cancel.load() != 0 && !thread->m_cancelling) {
 		thread->m_cancelling = true;
-		thread->m_cancel     = false;
+		thread->m_cancel.store(0);
 		cancel               = true;
 	}
 	unlockMutex(m_threadMutex);
@@ -713,11 +867,15 @@ ArchMultithreadPosix::threadFunc(void* vrep)
 void
 ArchMultithreadPosix::doThreadFunc(ArchThread thread)
 {
-	// default priority is slightly below normal
-	setPriorityOfThread(thread, 1);
+	setCurrent(thread);
 
-	// wait for parent to initialize this object
+	// wait for parent to initialize this object.  threads start at
+	// normal priority because an unprivileged thread that lowered its
+	// priority could never get it back;  apply any priority the
+	// parent set before we knew our kernel id.
 	lockMutex(m_threadMutex);
+	thread->m_tid = getCurrentTID();
+	applyPriority(thread, m_basePriority);
 	unlockMutex(m_threadMutex);
 
 	void* result = NULL;
@@ -734,6 +892,7 @@ ArchMultithreadPosix::doThreadFunc(ArchThread thread)
 		lockMutex(m_threadMutex);
 		thread->m_exited = true;
 		unlockMutex(m_threadMutex);
+		setCurrent(NULL);
 		closeThread(thread);
 		throw;
 	}
@@ -745,6 +904,7 @@ ArchMultithreadPosix::doThreadFunc(ArchThread thread)
 	unlockMutex(m_threadMutex);
 
 	// done with thread
+	setCurrent(NULL);
 	closeThread(thread);
 }
 
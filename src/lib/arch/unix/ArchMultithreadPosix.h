@@ -72,6 +72,7 @@ public:
 	virtual void		closeThread(ArchThread);
 	virtual void		cancelThread(ArchThread);
 	virtual void		setPriorityOfThread(ArchThread, int n);
+	virtual void		setAffinityOfThread(ArchThread, UInt32 cpus);
 	virtual void		testCancelThread();
 	virtual bool		wait(ArchThread, double timeout);
 	virtual bool		isSameThread(ArchThread, ArchThread);
@@ -90,6 +91,8 @@ private:
 	void				erase(ArchThreadImpl* thread);
 
 	void				refThread(ArchThreadImpl* rep);
+	ArchThreadImpl*	findCurrent();
+	void				setCurrent(ArchThreadImpl* thread);
 	void				testCancelThreadImpl(ArchThreadImpl* rep);
 
 	void				doThreadFunc(ArchThread thread);
@@ -108,6 +111,8 @@ private:
 	ArchThread			m_mainThread;
 	ThreadList			m_threadList;
 	ThreadID			m_nextID;
+	pthread_key_t		m_currentKey;
+	int					m_basePriority;
 
 	pthread_t			m_signalThread;
 	SignalFunc			m_signalFunc[kNUM_SIGNALS];
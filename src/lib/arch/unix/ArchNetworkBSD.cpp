@@ -31,6 +31,7 @@
 #	include <netinet/tcp.h>
 #endif
 #include <arpa/inet.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <string.h>
@@ -46,10 +47,17 @@
 #	endif
 #endif
 
+#if HAVE_EPOLL
+#	include <sys/epoll.h>
+#endif
+
 #if !HAVE_INET_ATON
 #	include <stdio.h>
 #endif
 
+// the most buffers passed to writev() at once.  it's well below IOV_MAX.
+static const int		kMaxWriteBuffers = 64;
+
 static const int s_family[] = {
 	PF_UNSPEC,
 	PF_INET
@@ -508,6 +516,187 @@ ArchNetworkBSD::unblockPollSocket(ArchThread thread)
 	}
 }
 
+#if HAVE_EPOLL
+
+// most events returned by one waitPollSet().  more are reported by the
+// next call.
+static const int		kMaxPollSetEvents = 64;
+
+ArchPollSet
+ArchNetworkBSD::newPollSet()
+{
+	// the size is only a hint
+	int fd = epoll_create(kMaxPollSetEvents);
+	if (fd == -1) {
+		throwError(errno);
+	}
+
+	ArchPollSetImpl* pollSet = new ArchPollSetImpl;
+	pollSet->m_fd        = fd;
+	pollSet->m_unblockFd = -1;
+	return pollSet;
+}
+
+void
+ArchNetworkBSD::closePollSet(ArchPollSet pollSet)
+{
+	assert(pollSet != NULL);
+
+	close(pollSet->m_fd);
+	delete pollSet;
+}
+
+void
+ArchNetworkBSD::setPollSetSocket(ArchPollSet pollSet, ArchSocket s,
+				unsigned short events, void* data)
+{
+	assert(pollSet != NULL);
+	assert(s       != NULL);
+
+	struct epoll_event ev;
+	ev.events   = 0;
+	ev.data.ptr = data;
+	if ((events & kPOLLIN) != 0) {
+		ev.events |= EPOLLIN;
+	}
+	if ((events & kPOLLOUT) != 0) {
+		ev.events |= EPOLLOUT;
+	}
+
+	// changing a socket is much more common than adding one
+	if (epoll_ctl(pollSet->m_fd, EPOLL_CTL_MOD, s->m_fd, &ev) == -1) {
+		if (errno != ENOENT ||
+			epoll_ctl(pollSet->m_fd, EPOLL_CTL_ADD, s->m_fd, &ev) == -1) {
+			throwError(errno);
+		}
+	}
+}
+
+void
+ArchNetworkBSD::removePollSetSocket(ArchPollSet pollSet, ArchSocket s)
+{
+	assert(pollSet != NULL);
+	assert(s       != NULL);
+
+	// ignore errors;  the socket may not be in the set.  older kernels
+	// require a non-NULL event even though it's unused.
+	struct epoll_event ev;
+	epoll_ctl(pollSet->m_fd, EPOLL_CTL_DEL, s->m_fd, &ev);
+}
+
+int
+ArchNetworkBSD::waitPollSet(ArchPollSet pollSet, PollSetEvent events[],
+				int num, double timeout)
+{
+	assert(pollSet != NULL);
+	assert(events  != NULL || num == 0);
+
+	// watch the calling thread's unblock pipe.  it's tagged with the
+	// poll set pointer, which can't be the data for any socket.
+	const int* unblockPipe = getUnblockPipe();
+	if (unblockPipe != NULL && unblockPipe[0] != pollSet->m_unblockFd) {
+		struct epoll_event ev;
+		ev.events   = EPOLLIN;
+		ev.data.ptr = pollSet;
+		if (pollSet->m_unblockFd != -1) {
+			epoll_ctl(pollSet->m_fd, EPOLL_CTL_DEL, pollSet->m_unblockFd, &ev);
+		}
+		if (epoll_ctl(pollSet->m_fd, EPOLL_CTL_ADD, unblockPipe[0], &ev) == -1) {
+			throwError(errno);
+		}
+		pollSet->m_unblockFd = unblockPipe[0];
+	}
+
+	// prepare timeout
+	int t = (timeout < 0.0) ? -1 : static_cast<int>(1000.0 * timeout);
+
+	// do the wait
+	struct epoll_event ev[kMaxPollSetEvents];
+	if (num > kMaxPollSetEvents) {
+		num = kMaxPollSetEvents;
+	}
+	int n = epoll_wait(pollSet->m_fd, ev, num, t);
+
+	// handle results
+	if (n == -1) {
+		if (errno == EINTR) {
+			// interrupted system call
+			ARCH->testCancelThread();
+			return 0;
+		}
+		throwError(errno);
+	}
+
+	// translate back, skipping the unblock pipe
+	int j = 0;
+	for (int i = 0; i < n; ++i) {
+		if (ev[i].data.ptr == pollSet) {
+			// the unblock event was signalled.  flush the pipe.
+			char dummy[100];
+			int ignore;
+
+			do {
+				ignore = read(unblockPipe[0], dummy, sizeof(dummy));
+			} while (errno != EAGAIN);
+			continue;
+		}
+
+		events[j].m_data    = ev[i].data.ptr;
+		events[j].m_revents = 0;
+		if ((ev[i].events & EPOLLIN) != 0) {
+			events[j].m_revents |= kPOLLIN;
+		}
+		if ((ev[i].events & EPOLLOUT) != 0) {
+			events[j].m_revents |= kPOLLOUT;
+		}
+		if ((ev[i].events & EPOLLERR) != 0) {
+			events[j].m_revents |= kPOLLERR;
+		}
+		++j;
+	}
+	return j;
+}
+
+#else
+
+ArchPollSet
+ArchNetworkBSD::newPollSet()
+{
+	return new ArchPollSetImpl(this);
+}
+
+void
+ArchNetworkBSD::closePollSet(ArchPollSet pollSet)
+{
+	assert(pollSet != NULL);
+	delete pollSet;
+}
+
+void
+ArchNetworkBSD::setPollSetSocket(ArchPollSet pollSet, ArchSocket s,
+				unsigned short events, void* data)
+{
+	assert(pollSet != NULL);
+	pollSet->set(s, events, data);
+}
+
+void
+ArchNetworkBSD::removePollSetSocket(ArchPollSet pollSet, ArchSocket s)
+{
+	assert(pollSet != NULL);
+	pollSet->remove(s);
+}
+
+int
+ArchNetworkBSD::waitPollSet(ArchPollSet pollSet, PollSetEvent events[],
+				int num, double timeout)
+{
+	assert(pollSet != NULL);
+	return pollSet->wait(events, num, timeout);
+}
+
+#endif
+
 size_t
 ArchNetworkBSD::readSocket(ArchSocket s, void* buf, size_t len)
 {
@@ -538,6 +727,32 @@ ArchNetworkBSD::writeSocket(ArchSocket s, const void* buf, size_t len)
 	return n;
 }
 
+size_t
+ArchNetworkBSD::writevSocket(ArchSocket s, const WriteBuffer* bufs, int num)
+{
+	assert(s    != NULL);
+	assert(bufs != NULL);
+
+	// anything past the first kMaxWriteBuffers is left for the next call
+	if (num > kMaxWriteBuffers) {
+		num = kMaxWriteBuffers;
+	}
+	struct iovec iov[kMaxWriteBuffers];
+	for (int i = 0; i < num; ++i) {
+		iov[i].iov_base = const_cast<void*>(bufs[i].m_data);
+		iov[i].iov_len  = bufs[i].m_size;
+	}
+
+	ssize_t n = writev(s->m_fd, iov, num);
+	if (n == -1) {
+		if (errno == EINTR || errno == EAGAIN) {
+			return 0;
+		}
+		throwError(errno);
+	}
+	return n;
+}
+
 void
 ArchNetworkBSD::throwErrorOnSocket(ArchSocket s)
 {
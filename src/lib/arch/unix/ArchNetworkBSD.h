@@ -27,6 +27,9 @@
 #if HAVE_SYS_SOCKET_H
 #	include <sys/socket.h>
 #endif
+#if !HAVE_EPOLL
+#	include "arch/ArchPollSetEmulation.h"
+#endif
 
 #if !HAVE_SOCKLEN_T
 typedef int socklen_t;
@@ -54,6 +57,24 @@ public:
 	socklen_t			m_len;
 };
 
+#if HAVE_EPOLL
+
+class ArchPollSetImpl {
+public:
+	int					m_fd;
+	int					m_unblockFd;
+};
+
+#else
+
+// without epoll, a poll set is emulated with pollSocket()
+class ArchPollSetImpl : public ArchPollSetEmulation {
+public:
+	ArchPollSetImpl(IArchNetwork* network) : ArchPollSetEmulation(network) { }
+};
+
+#endif
+
 //! Berkeley (BSD) sockets implementation of IArchNetwork
 class ArchNetworkBSD : public IArchNetwork {
 public:
@@ -73,9 +94,18 @@ public:
 	virtual bool		connectSocket(ArchSocket s, ArchNetAddress name);
 	virtual int			pollSocket(PollEntry[], int num, double timeout);
 	virtual void		unblockPollSocket(ArchThread thread);
+	virtual ArchPollSet	newPollSet();
+	virtual void		closePollSet(ArchPollSet);
+	virtual void		setPollSetSocket(ArchPollSet, ArchSocket s,
+							unsigned short events, void* data);
+	virtual void		removePollSetSocket(ArchPollSet, ArchSocket s);
+	virtual int			waitPollSet(ArchPollSet, PollSetEvent events[],
+							int num, double timeout);
 	virtual size_t		readSocket(ArchSocket s, void* buf, size_t len);
 	virtual size_t		writeSocket(ArchSocket s,
 							const void* buf, size_t len);
+	virtual size_t		writevSocket(ArchSocket s,
+							const WriteBuffer* bufs, int num);
 	virtual void		throwErrorOnSocket(ArchSocket);
 	virtual bool		setNoDelayOnSocket(ArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(ArchSocket, bool reuse);
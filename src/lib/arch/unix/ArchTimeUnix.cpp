@@ -15,7 +15,6 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-
 #include "arch/unix/ArchTimeUnix.h"
 
 #if TIME_WITH_SYS_TIME
@@ -27,6 +26,80 @@
 #	else
 #		include <time.h>
 #	endif
+#endif
+#if !HAVE_CLOCK_GETTIME && defined(__APPLE__)
+#	include <mach/mach_time.h>
+#endif
+#if SYNERGY_TSC_CLOCK && (defined(__i386__) || defined(__x86_64__))
+#	include <cpuid.h>
+#	include <x86intrin.h>
+#	define ARCH_TIME_TSC 1
+#endif
+
+static
+UInt64
+systemNanoseconds()
+{
+#if HAVE_CLOCK_GETTIME
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return static_cast<UInt64>(t.tv_sec) * 1000000000 + t.tv_nsec;
+#elif defined(__APPLE__)
+	static mach_timebase_info_data_t s_timebase;
+	if (s_timebase.denom == 0) {
+		mach_timebase_info(&s_timebase);
+	}
+	return mach_absolute_time() * s_timebase.numer / s_timebase.denom;
+#else
+	// not monotonic.  only for systems without a better clock.
+	struct timeval t;
+	gettimeofday(&t, NULL);
+	return static_cast<UInt64>(t.tv_sec) * 1000000000 +
+			static_cast<UInt64>(t.tv_usec) * 1000;
+#endif
+}
+
+#if ARCH_TIME_TSC
+
+// the time stamp counter and the clock at calibration and the length
+// of a tick in nanoseconds.  a zero tick length means the counter
+// isn't used.
+static UInt64			s_tscStart   = 0;
+static UInt64			s_clockStart = 0;
+static double			s_tscTick    = 0.0;
+
+static
+void
+calibrateTSC()
+{
+	// only a counter that runs at a constant rate in every power
+	// state and on every core can stand in for the clock
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0 ||
+		(edx & (1u << 8)) == 0) {
+		return;
+	}
+
+	// time the counter against the clock for 10 ms.  the clock can
+	// be read in well under a microsecond so the error in the rate
+	// is a few parts per million.
+	UInt64 clock0 = systemNanoseconds();
+	UInt64 tsc0   = __rdtsc();
+	UInt64 clock1;
+	do {
+		clock1 = systemNanoseconds();
+	} while (clock1 - clock0 < 10000000);
+	UInt64 tsc1 = __rdtsc();
+	if (tsc1 <= tsc0) {
+		return;
+	}
+
+	s_tscStart   = tsc0;
+	s_clockStart = clock0;
+	s_tscTick    = static_cast<double>(clock1 - clock0) /
+					static_cast<double>(tsc1 - tsc0);
+}
+
 #endif
 
 //
@@ -35,7 +108,11 @@
 
 ArchTimeUnix::ArchTimeUnix()
 {
-	// do nothing
+#if ARCH_TIME_TSC
+	if (s_tscTick == 0.0) {
+		calibrateTSC();
+	}
+#endif
 }
 
 ArchTimeUnix::~ArchTimeUnix()
@@ -46,7 +123,17 @@ ArchTimeUnix::~ArchTimeUnix()
 double
 ArchTimeUnix::time()
 {
-	struct timeval t;
-	gettimeofday(&t, NULL);
-	return (double)t.tv_sec + 1.0e-6 * (double)t.tv_usec;
+	return 1.0e-9 * static_cast<double>(nanoseconds());
+}
+
+UInt64
+ArchTimeUnix::nanoseconds()
+{
+#if ARCH_TIME_TSC
+	if (s_tscTick != 0.0) {
+		return s_clockStart + static_cast<UInt64>(
+			s_tscTick * static_cast<double>(__rdtsc() - s_tscStart));
+	}
+#endif
+	return systemNanoseconds();
 }
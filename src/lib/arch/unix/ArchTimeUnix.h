@@ -23,6 +23,11 @@
 #define ARCH_TIME ArchTimeUnix
 
 //! Generic Unix implementation of IArchTime
+/*!
+Reads \c CLOCK_MONOTONIC.  When built with \c SYNERGY_TSC_CLOCK on a
+CPU with an invariant time stamp counter, the counter is calibrated
+against that clock once and read instead.
+*/
 class ArchTimeUnix : public IArchTime {
 public:
 	ArchTimeUnix();
@@ -30,4 +35,5 @@ public:
 
 	// IArchTime overrides
 	virtual double		time();
+	virtual UInt64		nanoseconds();
 };
@@ -435,6 +435,25 @@ ArchMultithreadWindows::setPriorityOfThread(ArchThread thread, int n)
 	SetThreadPriority(thread->m_thread, s_pClass[index].m_level);
 }
 
+void
+ArchMultithreadWindows::setAffinityOfThread(ArchThread thread, UInt32 cpus)
+{
+	assert(thread != NULL);
+
+	// keep to the cpus the process may use
+	DWORD_PTR process, system;
+	if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system)) {
+		return;
+	}
+	DWORD_PTR mask = process;
+	if (cpus != 0) {
+		mask &= static_cast<DWORD_PTR>(cpus);
+	}
+	if (mask != 0) {
+		SetThreadAffinityMask(thread->m_thread, mask);
+	}
+}
+
 void
 ArchMultithreadWindows::testCancelThread()
 {
@@ -79,6 +79,7 @@ public:
 	virtual void		closeThread(ArchThread);
 	virtual void		cancelThread(ArchThread);
 	virtual void		setPriorityOfThread(ArchThread, int n);
+	virtual void		setAffinityOfThread(ArchThread, UInt32 cpus);
 	virtual void		testCancelThread();
 	virtual bool		wait(ArchThread, double timeout);
 	virtual bool		isSameThread(ArchThread, ArchThread);
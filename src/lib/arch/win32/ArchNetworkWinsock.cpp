@@ -24,6 +24,9 @@
 
 #include <malloc.h>
 
+// the most buffers passed to WSASend() at once
+static const int		kMaxWriteBuffers = 64;
+
 static const int s_family[] = {
 	PF_UNSPEC,
 	PF_INET
@@ -63,6 +66,7 @@ static BOOL (PASCAL FAR *WSAResetEvent_winsock)(WSAEVENT);
 static int (PASCAL FAR *WSAEventSelect_winsock)(SOCKET, WSAEVENT, long);
 static DWORD (PASCAL FAR *WSAWaitForMultipleEvents_winsock)(DWORD, const WSAEVENT FAR*, BOOL, DWORD, BOOL);
 static int (PASCAL FAR *WSAEnumNetworkEvents_winsock)(SOCKET, WSAEVENT, LPWSANETWORKEVENTS);
+static int (PASCAL FAR *WSASend_winsock)(SOCKET, LPWSABUF, DWORD, LPDWORD, DWORD, LPWSAOVERLAPPED, LPWSAOVERLAPPED_COMPLETION_ROUTINE);
 
 #undef FD_ISSET
 #define FD_ISSET(fd, set) WSAFDIsSet_winsock((SOCKET)(fd), (fd_set FAR *)(set))
@@ -198,6 +202,7 @@ ArchNetworkWinsock::initModule(HMODULE module)
 	setfunc(WSAEventSelect_winsock, WSAEventSelect, int (PASCAL FAR *)(SOCKET, WSAEVENT, long));
 	setfunc(WSAWaitForMultipleEvents_winsock, WSAWaitForMultipleEvents, DWORD (PASCAL FAR *)(DWORD, const WSAEVENT FAR*, BOOL, DWORD, BOOL));
 	setfunc(WSAEnumNetworkEvents_winsock, WSAEnumNetworkEvents, int (PASCAL FAR *)(SOCKET, WSAEVENT, LPWSANETWORKEVENTS));
+	setfunc(WSASend_winsock, WSASend, int (PASCAL FAR *)(SOCKET, LPWSABUF, DWORD, LPDWORD, DWORD, LPWSAOVERLAPPED, LPWSAOVERLAPPED_COMPLETION_ROUTINE));
 
 	s_networkModule = module;
 }
@@ -540,6 +545,42 @@ ArchNetworkWinsock::unblockPollSocket(ArchThread thread)
 	}
 }
 
+ArchPollSet
+ArchNetworkWinsock::newPollSet()
+{
+	return new ArchPollSetImpl(this);
+}
+
+void
+ArchNetworkWinsock::closePollSet(ArchPollSet pollSet)
+{
+	assert(pollSet != NULL);
+	delete pollSet;
+}
+
+void
+ArchNetworkWinsock::setPollSetSocket(ArchPollSet pollSet, ArchSocket s,
+				unsigned short events, void* data)
+{
+	assert(pollSet != NULL);
+	pollSet->set(s, events, data);
+}
+
+void
+ArchNetworkWinsock::removePollSetSocket(ArchPollSet pollSet, ArchSocket s)
+{
+	assert(pollSet != NULL);
+	pollSet->remove(s);
+}
+
+int
+ArchNetworkWinsock::waitPollSet(ArchPollSet pollSet, PollSetEvent events[],
+				int num, double timeout)
+{
+	assert(pollSet != NULL);
+	return pollSet->wait(events, num, timeout);
+}
+
 size_t
 ArchNetworkWinsock::readSocket(ArchSocket s, void* buf, size_t len)
 {
@@ -576,6 +617,38 @@ ArchNetworkWinsock::writeSocket(ArchSocket s, const void* buf, size_t len)
 	return static_cast<size_t>(n);
 }
 
+size_t
+ArchNetworkWinsock::writevSocket(ArchSocket s, const WriteBuffer* bufs, int num)
+{
+	assert(s    != NULL);
+	assert(bufs != NULL);
+
+	// anything past the first kMaxWriteBuffers is left for the next call
+	if (num > kMaxWriteBuffers) {
+		num = kMaxWriteBuffers;
+	}
+	WSABUF wsabufs[kMaxWriteBuffers];
+	for (int i = 0; i < num; ++i) {
+		wsabufs[i].buf = static_cast<CHAR*>(const_cast<void*>(bufs[i].m_data));
+		wsabufs[i].len = static_cast<ULONG>(bufs[i].m_size);
+	}
+
+	DWORD n = 0;
+	if (WSASend_winsock(s->m_socket, wsabufs, num, &n, 0, NULL, NULL) ==
+								SOCKET_ERROR) {
+		int err = getsockerror_winsock();
+		if (err == WSAEINTR) {
+			return 0;
+		}
+		if (err == WSAEWOULDBLOCK) {
+			s->m_pollWrite = true;
+			return 0;
+		}
+		throwError(err);
+	}
+	return static_cast<size_t>(n);
+}
+
 void
 ArchNetworkWinsock::throwErrorOnSocket(ArchSocket s)
 {
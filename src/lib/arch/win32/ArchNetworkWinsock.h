@@ -24,11 +24,13 @@
 
 #include "arch/IArchNetwork.h"
 #include "arch/IArchMultithread.h"
+#include "arch/ArchPollSetEmulation.h"
 
 #include <WinSock2.h>
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <list>
+#include <vector>
 
 #define ARCH_NETWORK ArchNetworkWinsock
 
@@ -48,6 +50,13 @@ public:
 	int					m_len;
 	struct sockaddr		m_addr;
 };
+// winsock has no equivalent of epoll so a poll set is emulated with
+// pollSocket()
+class ArchPollSetImpl : public ArchPollSetEmulation {
+public:
+	ArchPollSetImpl(IArchNetwork* network) : ArchPollSetEmulation(network) { }
+};
+
 #define ADDR_HDR_SIZE	offsetof(ArchNetAddressImpl, m_addr)
 #define TYPED_ADDR(type_, addr_) (reinterpret_cast<type_*>(&addr_->m_addr))
 
@@ -71,9 +80,18 @@ public:
 	virtual bool		connectSocket(ArchSocket s, ArchNetAddress name);
 	virtual int			pollSocket(PollEntry[], int num, double timeout);
 	virtual void		unblockPollSocket(ArchThread thread);
+	virtual ArchPollSet	newPollSet();
+	virtual void		closePollSet(ArchPollSet);
+	virtual void		setPollSetSocket(ArchPollSet, ArchSocket s,
+							unsigned short events, void* data);
+	virtual void		removePollSetSocket(ArchPollSet, ArchSocket s);
+	virtual int			waitPollSet(ArchPollSet, PollSetEvent events[],
+							int num, double timeout);
 	virtual size_t		readSocket(ArchSocket s, void* buf, size_t len);
 	virtual size_t		writeSocket(ArchSocket s,
 							const void* buf, size_t len);
+	virtual size_t		writevSocket(ArchSocket s,
+							const WriteBuffer* bufs, int num);
 	virtual void		throwErrorOnSocket(ArchSocket);
 	virtual bool		setNoDelayOnSocket(ArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(ArchSocket, bool reuse);
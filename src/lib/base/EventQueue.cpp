@@ -28,6 +28,9 @@
 #include "base/Log.h"
 #include "base/XBase.h"
 
+// number of events that can be saved without locking the queue
+static const UInt32		kEventRingSize = 4096;
+
 EVENT_TYPE_ACCESSOR(Client)
 EVENT_TYPE_ACCESSOR(IStream)
 EVENT_TYPE_ACCESSOR(IpcClient)
@@ -66,6 +69,7 @@ interrupt(Arch::ESignal, void* data)
 EventQueue::EventQueue() :
 	m_systemTarget(0),
 	m_nextType(Event::kLast),
+	m_ring(kEventRingSize),
 	m_typesForClient(NULL),
 	m_typesForIStream(NULL),
 	m_typesForIpcClient(NULL),
@@ -97,6 +101,11 @@ EventQueue::EventQueue() :
 
 EventQueue::~EventQueue()
 {
+	for (Timers::iterator index = m_timers.begin();
+							index != m_timers.end(); ++index) {
+		m_timerQueue.remove(index->second);
+		delete index->second;
+	}
 	delete m_buffer;
 	delete m_readyCondVar;
 	delete m_readyMutex;
@@ -179,16 +188,32 @@ EventQueue::adoptBuffer(IEventQueueBuffer* buffer)
 
 	LOG((CLOG_DEBUG "adopting new buffer"));
 
-	if (m_events.size() != 0) {
+	// force new events through the mutex and wait for threads that
+	// are already posting to the old buffer without it.
+	m_bufferLocked.fetchAdd(1);
+	while (m_bufferUsers.load() != 0) {
+		// posting an event never blocks for long but the poster may
+		// need this cpu to finish
+		ARCH->sleep(0.0);
+	}
+
+	std::vector<Event> events;
+	m_ring.removeAll(events);
+	for (EventTable::iterator i = m_events.begin(); i != m_events.end(); ++i) {
+		events.push_back(i->second);
+	}
+
+	if (events.size() != 0) {
 		// this can come as a nasty surprise to programmers expecting
 		// their events to be raised, only to have them deleted.
-		LOG((CLOG_DEBUG "discarding %d event(s)", m_events.size()));
+		LOG((CLOG_DEBUG "discarding %d event(s)", events.size()));
 	}
 
 	// discard old buffer and old events
 	delete m_buffer;
-	for (EventTable::iterator i = m_events.begin(); i != m_events.end(); ++i) {
-		Event::deleteData(i->second);
+	for (std::vector<Event>::iterator i = events.begin();
+							i != events.end(); ++i) {
+		Event::deleteData(*i);
 	}
 	m_events.clear();
 	m_oldEventIDs.clear();
@@ -198,6 +223,8 @@ EventQueue::adoptBuffer(IEventQueueBuffer* buffer)
 	if (m_buffer == NULL) {
 		m_buffer = new SimpleEventQueueBuffer;
 	}
+
+	m_bufferLocked.fetchSub(1);
 }
 
 bool
@@ -247,11 +274,11 @@ retry:
 		return true;
 
 	case IEventQueueBuffer::kUser:
-		{
+		if (!m_ring.remove(dataID, event)) {
 			ArchMutexLock lock(m_mutex);
 			event = removeEvent(dataID);
-			return true;
 		}
+		return true;
 
 	default:
 		assert(0 && "invalid event type");
@@ -303,6 +330,24 @@ EventQueue::addEvent(const Event& event)
 void
 EventQueue::addEventToBuffer(const Event& event)
 {
+	// try to store the event and post it without locking the queue.
+	// this fails if the ring is full or the buffer is being replaced.
+	m_bufferUsers.fetchAdd(1);
+	if (m_bufferLocked.load() == 0) {
+		UInt32 eventID;
+		if (m_ring.store(event, eventID)) {
+			if (!m_buffer->addEvent(eventID)) {
+				// failed to send event
+				Event discard;
+				m_ring.remove(eventID, discard);
+				Event::deleteData(event);
+			}
+			m_bufferUsers.fetchSub(1);
+			return;
+		}
+	}
+	m_bufferUsers.fetchSub(1);
+
 	ArchMutexLock lock(m_mutex);
 	
 	// store the event's data locally
@@ -319,66 +364,46 @@ EventQueue::addEventToBuffer(const Event& event)
 EventQueueTimer*
 EventQueue::newTimer(double duration, void* target)
 {
-	assert(duration > 0.0);
-
-	EventQueueTimer* timer = m_buffer->newTimer(duration, false);
-	if (target == NULL) {
-		target = timer;
-	}
-	ArchMutexLock lock(m_mutex);
-	m_timers.insert(timer);
-	// initial duration is requested duration plus whatever's on
-	// the clock currently because the latter will be subtracted
-	// the next time we check for timers.
-	m_timerQueue.push(Timer(timer, duration,
-							duration + m_time.getTime(), target, false));
-	return timer;
+	return addTimer(duration, target, false);
 }
 
 EventQueueTimer*
 EventQueue::newOneShotTimer(double duration, void* target)
 {
-	assert(duration > 0.0);
-
-	EventQueueTimer* timer = m_buffer->newTimer(duration, true);
-	if (target == NULL) {
-		target = timer;
-	}
-	ArchMutexLock lock(m_mutex);
-	m_timers.insert(timer);
-	// initial duration is requested duration plus whatever's on
-	// the clock currently because the latter will be subtracted
-	// the next time we check for timers.
-	m_timerQueue.push(Timer(timer, duration,
-							duration + m_time.getTime(), target, true));
-	return timer;
+	return addTimer(duration, target, true);
 }
 
 void
 EventQueue::deleteTimer(EventQueueTimer* timer)
 {
 	ArchMutexLock lock(m_mutex);
-	for (TimerQueue::iterator index = m_timerQueue.begin();
-							index != m_timerQueue.end(); ++index) {
-		if (index->getTimer() == timer) {
-			m_timerQueue.erase(index);
-			break;
-		}
-	}
 	Timers::iterator index = m_timers.find(timer);
 	if (index != m_timers.end()) {
+		m_timerQueue.remove(index->second);
+		delete index->second;
 		m_timers.erase(index);
 	}
 	m_buffer->deleteTimer(timer);
 }
 
+void
+EventQueue::resetTimer(EventQueueTimer* timer, double duration)
+{
+	assert(duration > 0.0);
+
+	ArchMutexLock lock(m_mutex);
+	Timers::iterator index = m_timers.find(timer);
+	if (index != m_timers.end()) {
+		index->second->setTimeout(duration);
+		m_timerQueue.schedule(index->second, m_time.getTime() + duration);
+	}
+}
+
 void
 EventQueue::adoptHandler(Event::Type type, void* target, IEventJob* handler)
 {
 	ArchMutexLock lock(m_mutex);
-	IEventJob*& job = m_handlers[target][type];
-	delete job;
-	job = handler;
+	delete m_handlers.adopt(type, target, handler);
 }
 
 void
@@ -387,15 +412,7 @@ EventQueue::removeHandler(Event::Type type, void* target)
 	IEventJob* handler = NULL;
 	{
 		ArchMutexLock lock(m_mutex);
-		HandlerTable::iterator index = m_handlers.find(target);
-		if (index != m_handlers.end()) {
-			TypeHandlerTable& typeHandlers = index->second;
-			TypeHandlerTable::iterator index2 = typeHandlers.find(type);
-			if (index2 != typeHandlers.end()) {
-				handler = index2->second;
-				typeHandlers.erase(index2);
-			}
-		}
+		handler = m_handlers.remove(type, target);
 	}
 	delete handler;
 }
@@ -406,16 +423,7 @@ EventQueue::removeHandlers(void* target)
 	std::vector<IEventJob*> handlers;
 	{
 		ArchMutexLock lock(m_mutex);
-		HandlerTable::iterator index = m_handlers.find(target);
-		if (index != m_handlers.end()) {
-			// copy to handlers array and clear table for target
-			TypeHandlerTable& typeHandlers = index->second;
-			for (TypeHandlerTable::iterator index2 = typeHandlers.begin();
-							index2 != typeHandlers.end(); ++index2) {
-				handlers.push_back(index2->second);
-			}
-			typeHandlers.clear();
-		}
+		m_handlers.removeAll(target, handlers);
 	}
 
 	// delete handlers
@@ -434,16 +442,8 @@ EventQueue::isEmpty() const
 IEventJob*
 EventQueue::getHandler(Event::Type type, void* target) const
 {
-	ArchMutexLock lock(m_mutex);
-	HandlerTable::const_iterator index = m_handlers.find(target);
-	if (index != m_handlers.end()) {
-		const TypeHandlerTable& typeHandlers = index->second;
-		TypeHandlerTable::const_iterator index2 = typeHandlers.find(type);
-		if (index2 != typeHandlers.end()) {
-			return index2->second;
-		}
-	}
-	return NULL;
+	// the table can be read without m_mutex
+	return m_handlers.find(type, target);
 }
 
 UInt32
@@ -457,8 +457,8 @@ EventQueue::saveEvent(const Event& event)
 		m_oldEventIDs.pop_back();
 	}
 	else {
-		// make a new id
-		id = static_cast<UInt32>(m_events.size());
+		// make a new id.  ids below the ring's capacity are the ring's.
+		id = static_cast<UInt32>(m_events.size()) + m_ring.getCapacity();
 	}
 
 	// save data
@@ -485,43 +485,51 @@ EventQueue::removeEvent(UInt32 eventID)
 	return event;
 }
 
+EventQueueTimer*
+EventQueue::addTimer(double duration, void* target, bool oneShot)
+{
+	assert(duration > 0.0);
+
+	EventQueueTimer* timer = m_buffer->newTimer(duration, oneShot);
+	if (target == NULL) {
+		target = timer;
+	}
+	Timer* record = new Timer(timer, duration, target, oneShot);
+	ArchMutexLock lock(m_mutex);
+	m_timers.insert(std::make_pair(timer, record));
+	m_timerQueue.schedule(record, m_time.getTime() + duration);
+	return timer;
+}
+
 bool
 EventQueue::hasTimerExpired(Event& event)
 {
-	// return true if there's a timer in the timer priority queue that
-	// has expired.  if returning true then fill in event appropriately
-	// and reset and reinsert the timer.
+	// return true if there's a timer in the timer queue that has
+	// expired.  if returning true then fill in event appropriately
+	// and reschedule or dequeue the timer.
+	ArchMutexLock lock(m_mutex);
 	if (m_timerQueue.empty()) {
 		return false;
 	}
 
-	// get time elapsed since last check
-	const double time = m_time.getTime();
-	m_time.reset();
-
-	// countdown elapsed time
-	for (TimerQueue::iterator index = m_timerQueue.begin();
-							index != m_timerQueue.end(); ++index) {
-		(*index) -= time;
-	}
-
 	// done if no timers are expired
-	if (m_timerQueue.top() > 0.0) {
+	const double now = m_time.getTime();
+	Timer* timer = static_cast<Timer*>(m_timerQueue.top());
+	if (timer->getDeadline() > now) {
 		return false;
 	}
 
-	// remove timer from queue
-	Timer timer = m_timerQueue.top();
-	m_timerQueue.pop();
-
-	// prepare event and reset the timer's clock
-	timer.fillEvent(m_timerEvent);
-	event = Event(Event::kTimer, timer.getTarget(), &m_timerEvent);
-	timer.reset();
+	// prepare event
+	timer->fillEvent(m_timerEvent, now);
+	event = Event(Event::kTimer, timer->getTarget(), &m_timerEvent);
 
-	// reinsert timer into queue if it's not a one-shot
-	if (!timer.isOneShot()) {
-		m_timerQueue.push(timer);
+	// count down again unless it's a one-shot.  an expired one-shot
+	// stays around, out of the queue, until it's deleted or reset.
+	if (timer->isOneShot()) {
+		m_timerQueue.remove(timer);
+	}
+	else {
+		m_timerQueue.schedule(timer, now + timer->getTimeout());
 	}
 
 	return true;
@@ -531,15 +539,16 @@ double
 EventQueue::getNextTimerTimeout() const
 {
 	// return -1 if no timers, 0 if the top timer has expired, otherwise
-	// the time until the top timer in the timer priority queue will
-	// expire.
+	// the time until the top timer in the timer queue will expire.
+	ArchMutexLock lock(m_mutex);
 	if (m_timerQueue.empty()) {
 		return -1.0;
 	}
-	if (m_timerQueue.top() <= 0.0) {
+	double timeout = m_timerQueue.top()->getDeadline() - m_time.getTime();
+	if (timeout <= 0.0) {
 		return 0.0;
 	}
-	return m_timerQueue.top();
+	return timeout;
 }
 
 Event::Type
@@ -577,12 +586,11 @@ EventQueue::waitForReady() const
 //
 
 EventQueue::Timer::Timer(EventQueueTimer* timer, double timeout,
-				double initialTime, void* target, bool oneShot) :
+				void* target, bool oneShot) :
 	m_timer(timer),
 	m_timeout(timeout),
 	m_target(target),
-	m_oneShot(oneShot),
-	m_time(initialTime)
+	m_oneShot(oneShot)
 {
 	assert(m_timeout > 0.0);
 }
@@ -593,21 +601,10 @@ EventQueue::Timer::~Timer()
 }
 
 void
-EventQueue::Timer::reset()
-{
-	m_time = m_timeout;
-}
-
-EventQueue::Timer&
-EventQueue::Timer::operator-=(double dt)
-{
-	m_time -= dt;
-	return *this;
-}
-
-EventQueue::Timer::operator double() const
+EventQueue::Timer::setTimeout(double timeout)
 {
-	return m_time;
+	assert(timeout > 0.0);
+	m_timeout = timeout;
 }
 
 bool
@@ -616,6 +613,12 @@ EventQueue::Timer::isOneShot() const
 	return m_oneShot;
 }
 
+double
+EventQueue::Timer::getTimeout() const
+{
+	return m_timeout;
+}
+
 EventQueueTimer*
 EventQueue::Timer::getTimer() const
 {
@@ -629,17 +632,11 @@ EventQueue::Timer::getTarget() const
 }
 
 void
-EventQueue::Timer::fillEvent(TimerEvent& event) const
+EventQueue::Timer::fillEvent(TimerEvent& event, double now) const
 {
+	// count the periods that have gone by, as if the timer had been
+	// counting down since its deadline
 	event.m_timer = m_timer;
-	event.m_count = 0;
-	if (m_time <= 0.0) {
-		event.m_count = static_cast<UInt32>((m_timeout - m_time) / m_timeout);
-	}
-}
-
-bool
-EventQueue::Timer::operator<(const Timer& t) const
-{
-	return m_time < t.m_time;
+	event.m_count = static_cast<UInt32>(
+						(m_timeout + now - getDeadline()) / m_timeout);
 }
@@ -22,10 +22,12 @@
 #include "arch/IArchMultithread.h"
 #include "base/IEventQueue.h"
 #include "base/Event.h"
-#include "base/PriorityQueue.h"
+#include "base/EventRing.h"
+#include "base/HandlerTable.h"
+#include "base/TimerHeap.h"
 #include "base/Stopwatch.h"
+#include "mt/Atomic.h"
 #include "common/stdmap.h"
-#include "common/stdset.h"
 
 #include <queue>
 
@@ -52,6 +54,7 @@ public:
 	virtual EventQueueTimer*
 						newOneShotTimer(double duration, void* target);
 	virtual void		deleteTimer(EventQueueTimer*);
+	virtual void		resetTimer(EventQueueTimer*, double duration);
 	virtual void		adoptHandler(Event::Type type,
 							void* target, IEventJob* handler);
 	virtual void		removeHandler(Event::Type type, void* target);
@@ -69,47 +72,38 @@ public:
 private:
 	UInt32				saveEvent(const Event& event);
 	Event				removeEvent(UInt32 eventID);
+	EventQueueTimer*	addTimer(double duration, void* target, bool oneShot);
 	bool				hasTimerExpired(Event& event);
 	double				getNextTimerTimeout() const;
 	void				addEventToBuffer(const Event& event);
 	
 private:
-	class Timer {
+	class Timer : public TimerHeap::Entry {
 	public:
-		Timer(EventQueueTimer*, double timeout, double initialTime,
-							void* target, bool oneShot);
+		Timer(EventQueueTimer*, double timeout, void* target, bool oneShot);
 		~Timer();
 
-		void			reset();
-
-		Timer&			operator-=(double);
-
-						operator double() const;
+		void			setTimeout(double);
 
 		bool			isOneShot() const;
+		double			getTimeout() const;
 		EventQueueTimer*
 						getTimer() const;
 		void*			getTarget() const;
-		void			fillEvent(TimerEvent&) const;
-
-		bool			operator<(const Timer&) const;
+		void			fillEvent(TimerEvent&, double now) const;
 
 	private:
 		EventQueueTimer*	m_timer;
 		double				m_timeout;
 		void*				m_target;
 		bool				m_oneShot;
-		double				m_time;
 	};
 
-	typedef std::set<EventQueueTimer*> Timers;
-	typedef PriorityQueue<Timer> TimerQueue;
+	typedef std::map<EventQueueTimer*, Timer*> Timers;
 	typedef std::map<UInt32, Event> EventTable;
 	typedef std::vector<UInt32> EventIDList;
 	typedef std::map<Event::Type, const char*> TypeMap;
 	typedef std::map<String, Event::Type> NameMap;
-	typedef std::map<Event::Type, IEventJob*> TypeHandlerTable;
-	typedef std::map<void*, TypeHandlerTable> HandlerTable;
 
 	int					m_systemTarget;
 	ArchMutex			m_mutex;
@@ -122,17 +116,24 @@ private:
 	// buffer of events
 	IEventQueueBuffer*	m_buffer;
 
-	// saved events
+	// saved events.  events are stored in the lock-free ring when
+	// possible and in the table (using ids past the ring's) otherwise.
+	EventRing			m_ring;
 	EventTable			m_events;
 	EventIDList		m_oldEventIDs;
 
-	// timers
+	// threads posting to m_buffer without holding m_mutex, and whether
+	// they must take m_mutex instead because the buffer is being replaced
+	AtomicUInt32		m_bufferUsers;
+	AtomicUInt32		m_bufferLocked;
+
+	// timers.  deadlines are times on m_time, which is never reset.
 	Stopwatch			m_time;
 	Timers				m_timers;
-	TimerQueue			m_timerQueue;
+	TimerHeap			m_timerQueue;
 	TimerEvent			m_timerEvent;
 
-	// event handlers
+	// event handlers.  changed under m_mutex, looked up without it.
 	HandlerTable		m_handlers;
 
 public:
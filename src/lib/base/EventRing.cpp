@@ -0,0 +1,86 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/EventRing.h"
+
+//
+// EventRing
+//
+
+EventRing::EventRing(UInt32 capacity) :
+	m_ring(capacity)
+{
+	// do nothing
+}
+
+EventRing::~EventRing()
+{
+	// do nothing
+}
+
+bool
+EventRing::store(const Event& event, UInt32& id)
+{
+	UInt32 pos;
+	Event* slot = m_ring.claim(pos);
+	if (slot == NULL) {
+		return false;
+	}
+
+	// fill the slot then publish it
+	*slot = event;
+	m_ring.publish(pos);
+
+	id = m_ring.getSlot(pos);
+	return true;
+}
+
+bool
+EventRing::remove(UInt32 id, Event& event)
+{
+	if (id >= m_ring.getCapacity()) {
+		return false;
+	}
+
+	UInt32 pos;
+	Event* slot = m_ring.getPublished(id, pos);
+	if (slot == NULL) {
+		return false;
+	}
+
+	event = *slot;
+	*slot = Event();
+	m_ring.release(pos);
+	return true;
+}
+
+void
+EventRing::removeAll(std::vector<Event>& events)
+{
+	Event event;
+	for (UInt32 id = 0; id < m_ring.getCapacity(); ++id) {
+		if (remove(id, event)) {
+			events.push_back(event);
+		}
+	}
+}
+
+UInt32
+EventRing::getCapacity() const
+{
+	return m_ring.getCapacity();
+}
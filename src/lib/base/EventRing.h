@@ -0,0 +1,88 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/Event.h"
+#include "base/SequencedRing.h"
+#include "common/stdvector.h"
+
+//! Lock-free event storage
+/*!
+A bounded multi-producer, single-consumer ring of events.  Any thread
+may store an event and get back an id for it, without taking a lock.
+Only one thread (the event queue's thread) may remove events.  Events
+may be removed in any order.
+
+Slots are claimed in order, so if the slot at the head of the ring is
+still occupied then \c store() fails even though other slots may be
+free.  Callers must be prepared to store the event elsewhere.
+*/
+class EventRing {
+public:
+	//! Create a ring
+	/*!
+	\p capacity is rounded up to a power of two and must be at least 2.
+	*/
+	EventRing(UInt32 capacity);
+	~EventRing();
+
+	//! @name manipulators
+	//@{
+
+	//! Store an event
+	/*!
+	Copies \p event into a free slot and sets \p id to the slot's id,
+	which is less than \c getCapacity().  Returns false if the ring is
+	full.  May be called from any thread.
+	*/
+	bool				store(const Event& event, UInt32& id);
+
+	//! Remove an event
+	/*!
+	Copies the event with id \p id to \p event and frees its slot.
+	Returns false if there's no event with that id.  Must only be
+	called from the consumer thread, or from the thread that stored
+	the event if its id was never handed to anyone else.
+	*/
+	bool				remove(UInt32 id, Event& event);
+
+	//! Remove all events
+	/*!
+	Removes every stored event, appending it to \p events.  Events
+	being stored concurrently may or may not be removed.  Must only be
+	called from the consumer thread.
+	*/
+	void				removeAll(std::vector<Event>& events);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of slots
+	UInt32				getCapacity() const;
+
+	//@}
+
+private:
+	// not implemented
+	EventRing(const EventRing&);
+	EventRing& operator=(const EventRing&);
+
+private:
+	SequencedRing<Event>	m_ring;
+};
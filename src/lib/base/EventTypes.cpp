@@ -46,6 +46,7 @@ EventTypes::setEvents(IEventQueue* events)
 REGISTER_EVENT(Client, connected)
 REGISTER_EVENT(Client, connectionFailed)
 REGISTER_EVENT(Client, disconnected)
+REGISTER_EVENT(Client, fillClipboards)
 
 //
 // IStream
@@ -53,6 +54,7 @@ REGISTER_EVENT(Client, disconnected)
 
 REGISTER_EVENT(IStream, inputReady)
 REGISTER_EVENT(IStream, outputFlushed)
+REGISTER_EVENT(IStream, priorityFlushed)
 REGISTER_EVENT(IStream, outputError)
 REGISTER_EVENT(IStream, inputShutdown)
 REGISTER_EVENT(IStream, outputShutdown)
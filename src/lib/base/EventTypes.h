@@ -45,7 +45,8 @@ public:
 	ClientEvents() :
 		m_connected(Event::kUnknown),
 		m_connectionFailed(Event::kUnknown),
-		m_disconnected(Event::kUnknown) { }
+		m_disconnected(Event::kUnknown),
+		m_fillClipboards(Event::kUnknown) { }
 
 	//! @name accessors
 	//@{
@@ -72,12 +73,20 @@ public:
 	*/
 	Event::Type		disconnected();
 
+	//! Get fill clipboards event type
+	/*!
+	Returns the fill clipboards event type.  The client sends this to
+	itself to read the clipboards it owns after it has left its screen.
+	*/
+	Event::Type		fillClipboards();
+
 	//@}
 
 private:
 	Event::Type		m_connected;
 	Event::Type		m_connectionFailed;
 	Event::Type		m_disconnected;
+	Event::Type		m_fillClipboards;
 };
 
 class IStreamEvents : public EventTypes {
@@ -85,6 +94,7 @@ public:
 	IStreamEvents() :
 		m_inputReady(Event::kUnknown),
 		m_outputFlushed(Event::kUnknown),
+		m_priorityFlushed(Event::kUnknown),
 		m_outputError(Event::kUnknown),
 		m_inputShutdown(Event::kUnknown),
 		m_outputShutdown(Event::kUnknown) { }
@@ -109,6 +119,15 @@ public:
 	*/
 	Event::Type		outputFlushed();
 
+	//! Get priority flushed event type
+	/*!
+	Returns the priority flushed event type.  A stream that keeps bulk
+	data apart sends this event when everything written with \c write()
+	has been sent, even if data written with \c writeBulk() is still
+	waiting.  It's sent along with \c outputFlushed too.
+	*/
+	Event::Type		priorityFlushed();
+
 	//! Get output error event type
 	/*!
 	Returns the output error event type.  A stream sends this event
@@ -138,6 +157,7 @@ public:
 private:
 	Event::Type		m_inputReady;
 	Event::Type		m_outputFlushed;
+	Event::Type		m_priorityFlushed;
 	Event::Type		m_outputError;
 	Event::Type		m_inputShutdown;
 	Event::Type		m_outputShutdown;
@@ -0,0 +1,216 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/HandlerTable.h"
+
+// the smallest table.  tables are kept at most half full so probe
+// sequences stay short.
+static const UInt32		kMinCapacity = 16;
+
+static
+UInt32
+hashKey(Event::Type type, void* target)
+{
+	// fold the pointer without shifting past the width of size_t
+	size_t p = reinterpret_cast<size_t>(target);
+	UInt32 h = static_cast<UInt32>(p) ^ static_cast<UInt32>((p >> 16) >> 16);
+	h ^= static_cast<UInt32>(type) * 0x9e3779b9u;
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	return h;
+}
+
+//
+// HandlerTable::Table
+//
+
+HandlerTable::Table::Table(UInt32 capacity) :
+	m_mask(capacity - 1),
+	m_count(0),
+	m_slots(capacity)
+{
+	for (UInt32 i = 0; i < capacity; ++i) {
+		m_slots[i].m_target  = NULL;
+		m_slots[i].m_type    = Event::kUnknown;
+		m_slots[i].m_handler = NULL;
+	}
+}
+
+const HandlerTable::Slot*
+HandlerTable::Table::find(Event::Type type, void* target) const
+{
+	// empty slots have no handler
+	for (UInt32 i = hashKey(type, target) & m_mask; ; i = (i + 1) & m_mask) {
+		const Slot& slot = m_slots[i];
+		if (slot.m_handler == NULL) {
+			return NULL;
+		}
+		if (slot.m_target == target && slot.m_type == type) {
+			return &slot;
+		}
+	}
+}
+
+void
+HandlerTable::Table::insert(const Slot& entry)
+{
+	UInt32 i = hashKey(entry.m_type, entry.m_target) & m_mask;
+	while (m_slots[i].m_handler != NULL) {
+		i = (i + 1) & m_mask;
+	}
+	m_slots[i] = entry;
+	++m_count;
+}
+
+
+//
+// HandlerTable
+//
+
+HandlerTable::HandlerTable() :
+	m_table(new Table(kMinCapacity))
+{
+	// do nothing
+}
+
+HandlerTable::~HandlerTable()
+{
+	delete m_table.load();
+	for (size_t i = 0; i < m_retired.size(); ++i) {
+		delete m_retired[i];
+	}
+}
+
+IEventJob*
+HandlerTable::adopt(Event::Type type, void* target, IEventJob* handler)
+{
+	if (handler == NULL) {
+		return remove(type, target);
+	}
+
+	const Table* table = m_table.load();
+	const Slot* slot   = table->find(type, target);
+	IEventJob* old     = (slot != NULL) ? slot->m_handler : NULL;
+
+	// copy into a table big enough to stay at most half full
+	UInt32 count    = table->m_count + ((slot == NULL) ? 1 : 0);
+	UInt32 capacity = table->m_mask + 1;
+	while (2 * count > capacity) {
+		capacity <<= 1;
+	}
+	Table* copy = new Table(capacity);
+	for (UInt32 i = 0; i <= table->m_mask; ++i) {
+		if (table->m_slots[i].m_handler != NULL && &table->m_slots[i] != slot) {
+			copy->insert(table->m_slots[i]);
+		}
+	}
+
+	Slot entry;
+	entry.m_target  = target;
+	entry.m_type    = type;
+	entry.m_handler = handler;
+	copy->insert(entry);
+	publish(copy);
+	return old;
+}
+
+IEventJob*
+HandlerTable::remove(Event::Type type, void* target)
+{
+	const Table* table = m_table.load();
+	const Slot* slot   = table->find(type, target);
+	if (slot == NULL) {
+		return NULL;
+	}
+	IEventJob* handler = slot->m_handler;
+
+	// copy everything else, shrinking when the table is mostly empty
+	UInt32 capacity = table->m_mask + 1;
+	while (capacity > kMinCapacity && 8 * (table->m_count - 1) < capacity) {
+		capacity >>= 1;
+	}
+	Table* copy = new Table(capacity);
+	for (UInt32 i = 0; i <= table->m_mask; ++i) {
+		if (table->m_slots[i].m_handler != NULL && &table->m_slots[i] != slot) {
+			copy->insert(table->m_slots[i]);
+		}
+	}
+	publish(copy);
+	return handler;
+}
+
+void
+HandlerTable::removeAll(void* target, std::vector<IEventJob*>& removed)
+{
+	const Table* table = m_table.load();
+	size_t n = removed.size();
+	Table* copy = new Table(table->m_mask + 1);
+	for (UInt32 i = 0; i <= table->m_mask; ++i) {
+		const Slot& slot = table->m_slots[i];
+		if (slot.m_handler == NULL) {
+			continue;
+		}
+		if (slot.m_target == target) {
+			removed.push_back(slot.m_handler);
+		}
+		else {
+			copy->insert(slot);
+		}
+	}
+
+	if (removed.size() == n) {
+		delete copy;
+		return;
+	}
+	publish(copy);
+}
+
+IEventJob*
+HandlerTable::find(Event::Type type, void* target) const
+{
+	// announce the lookup before reading the table so that the table
+	// can't be freed while we're using it
+	m_readers.fetchAdd(1);
+	const Slot* slot   = m_table.load()->find(type, target);
+	IEventJob* handler = (slot != NULL) ? slot->m_handler : NULL;
+	m_readers.fetchSub(1);
+	return handler;
+}
+
+size_t
+HandlerTable::size() const
+{
+	return m_table.load()->m_count;
+}
+
+void
+HandlerTable::publish(Table* table)
+{
+	m_retired.push_back(m_table.exchange(table));
+
+	// a lookup that starts after the exchange sees the new table so
+	// the old ones can go once no lookup is in progress.  otherwise
+	// try again after the next change.
+	if (m_readers.compareAndSwap(0, 0)) {
+		for (size_t i = 0; i < m_retired.size(); ++i) {
+			delete m_retired[i];
+		}
+		m_retired.clear();
+	}
+}
@@ -0,0 +1,114 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "base/Event.h"
+#include "mt/Atomic.h"
+#include "common/stdvector.h"
+
+class IEventJob;
+
+//! Event handler table
+/*!
+Maps (type, target) pairs to event handlers.  Lookups take no lock.
+The table is an open-addressing hash that's never changed once it's
+published:  adding or removing a handler builds a new table and swaps
+it in, so a lookup sees either the old table or the new one.  Replaced
+tables are freed once no lookup can still be using them.
+
+Lookups may be made from any thread.  Changes must be serialized by
+the caller.
+*/
+class HandlerTable {
+public:
+	HandlerTable();
+	~HandlerTable();
+
+	//! @name manipulators
+	//@{
+
+	//! Set handler
+	/*!
+	Sets the handler for \p type and \p target to \p handler.  Returns
+	the handler it replaces, or NULL.  The caller owns both.
+	*/
+	IEventJob*			adopt(Event::Type type, void* target,
+							IEventJob* handler);
+
+	//! Remove handler
+	/*!
+	Removes and returns the handler for \p type and \p target, or
+	returns NULL if there isn't one.
+	*/
+	IEventJob*			remove(Event::Type type, void* target);
+
+	//! Remove handlers for target
+	/*!
+	Removes every handler for \p target and appends them to \p removed.
+	*/
+	void				removeAll(void* target,
+							std::vector<IEventJob*>& removed);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Find handler
+	/*!
+	Returns the handler for \p type and \p target, or NULL.
+	*/
+	IEventJob*			find(Event::Type type, void* target) const;
+
+	//! Get the number of handlers
+	size_t				size() const;
+
+	//@}
+
+private:
+	class Slot {
+	public:
+		void*			m_target;
+		Event::Type		m_type;
+		IEventJob*		m_handler;
+	};
+
+	class Table {
+	public:
+		Table(UInt32 capacity);
+
+		const Slot*		find(Event::Type type, void* target) const;
+		void			insert(const Slot&);
+
+	public:
+		UInt32			m_mask;
+		UInt32			m_count;
+		std::vector<Slot>	m_slots;
+	};
+
+	// not implemented
+	HandlerTable(const HandlerTable&);
+	HandlerTable&		operator=(const HandlerTable&);
+
+	void				publish(Table*);
+
+private:
+	AtomicPointer<Table>	m_table;
+	mutable AtomicUInt32	m_readers;
+	std::vector<Table*>	m_retired;
+};
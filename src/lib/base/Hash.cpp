@@ -0,0 +1,110 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/Hash.h"
+
+namespace synergy {
+namespace hash {
+
+static const UInt32		kPrime1 = 2654435761U;
+static const UInt32		kPrime2 = 2246822519U;
+static const UInt32		kPrime3 = 3266489917U;
+static const UInt32		kPrime4 =  668265263U;
+static const UInt32		kPrime5 =  374761393U;
+
+static inline
+UInt32
+rotateLeft(UInt32 x, int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+static inline
+UInt32
+read32(const UInt8* p)
+{
+	// little-endian regardless of the host
+	return  static_cast<UInt32>(p[0])        |
+		   (static_cast<UInt32>(p[1]) <<  8) |
+		   (static_cast<UInt32>(p[2]) << 16) |
+		   (static_cast<UInt32>(p[3]) << 24);
+}
+
+static inline
+UInt32
+round(UInt32 acc, UInt32 input)
+{
+	acc += input * kPrime2;
+	acc  = rotateLeft(acc, 13);
+	return acc * kPrime1;
+}
+
+UInt32
+xxHash32(const void* data, size_t size, UInt32 seed)
+{
+	const UInt8* p   = static_cast<const UInt8*>(data);
+	const UInt8* end = p + size;
+	UInt32 h;
+
+	if (size >= 16) {
+		// four lanes of 4 bytes each
+		const UInt8* limit = end - 16;
+		UInt32 v1 = seed + kPrime1 + kPrime2;
+		UInt32 v2 = seed + kPrime2;
+		UInt32 v3 = seed;
+		UInt32 v4 = seed - kPrime1;
+		do {
+			v1 = round(v1, read32(p));
+			v2 = round(v2, read32(p + 4));
+			v3 = round(v3, read32(p + 8));
+			v4 = round(v4, read32(p + 12));
+			p += 16;
+		} while (p <= limit);
+
+		h = rotateLeft(v1, 1) + rotateLeft(v2, 7) +
+			rotateLeft(v3, 12) + rotateLeft(v4, 18);
+	}
+	else {
+		h = seed + kPrime5;
+	}
+
+	h += static_cast<UInt32>(size);
+
+	// the tail
+	while (p + 4 <= end) {
+		h += read32(p) * kPrime3;
+		h  = rotateLeft(h, 17) * kPrime4;
+		p += 4;
+	}
+	while (p < end) {
+		h += (*p) * kPrime5;
+		h  = rotateLeft(h, 11) * kPrime1;
+		++p;
+	}
+
+	// mix the bits
+	h ^= h >> 15;
+	h *= kPrime2;
+	h ^= h >> 13;
+	h *= kPrime3;
+	h ^= h >> 16;
+	return h;
+}
+
+}
+}
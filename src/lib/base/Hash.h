@@ -0,0 +1,39 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <cstddef>
+
+namespace synergy {
+
+//! Hash functions
+namespace hash {
+
+//! xxHash32
+/*!
+Returns the 32-bit xxHash of the \p size bytes at \p data using
+\p seed.  It's a fast non-cryptographic hash, suited to spotting
+unchanged data, and gives the same result on every platform.
+*/
+UInt32 xxHash32(const void* data, size_t size, UInt32 seed = 0);
+
+}
+}
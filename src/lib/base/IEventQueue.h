@@ -144,6 +144,16 @@ public:
 	*/
 	virtual void		deleteTimer(EventQueueTimer*) = 0;
 
+	//! Restart a timer
+	/*!
+	Restarts \p timer so that its next event comes \p duration seconds
+	from now.  A recurring timer keeps \p duration as its new period.  A
+	one-shot timer that has already expired is armed again.  This is
+	cheaper than deleting the timer and creating a new one, e.g. for an
+	alarm that's pushed back every time a message arrives.
+	*/
+	virtual void		resetTimer(EventQueueTimer*, double duration) = 0;
+
 	//! Register an event handler for an event type
 	/*!
 	Registers an event handler for \p type and \p target.  The \p handler
@@ -65,5 +65,13 @@ public:
 	*/
 	virtual bool		write(ELevel level, const char* message) = 0;
 
+	//! Flush written messages
+	/*!
+	Called after each message, or after each batch of messages when
+	the log is asynchronous.  Outputters that hold on to messages in
+	\c write() must output them now.  The default does nothing.
+	*/
+	virtual void		flush() { }
+
 	//@}
 };
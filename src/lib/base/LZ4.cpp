@@ -0,0 +1,253 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/LZ4.h"
+
+#include <cstring>
+
+namespace synergy {
+namespace lz4 {
+
+// format limits
+static const size_t		kMinMatch     = 4;
+static const size_t		kLastLiterals = 5;
+static const size_t		kMatchLimit   = 12;
+static const size_t		kMaxOffset    = 65535;
+
+// the match finder remembers the last position of each 4 byte hash
+static const int		kHashLog      = 12;
+
+// misses before the search starts skipping ahead faster
+static const int		kSkipTrigger  = 6;
+
+static inline
+UInt32
+read32(const UInt8* p)
+{
+	UInt32 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline
+UInt32
+hashSequence(UInt32 v)
+{
+	return (v * 2654435761U) >> (32 - kHashLog);
+}
+
+static inline
+void
+putLength(UInt8*& op, size_t n)
+{
+	// lengths of 15 or more continue in 255s after the token
+	for (; n >= 255; n -= 255) {
+		*op++ = 255;
+	}
+	*op++ = static_cast<UInt8>(n);
+}
+
+size_t
+compressBound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t
+compress(const void* srcData, size_t size, void* dstData, size_t capacity)
+{
+	const UInt8* src = static_cast<const UInt8*>(srcData);
+	UInt8* dst       = static_cast<UInt8*>(dstData);
+	UInt8* op        = dst;
+	UInt8* oend      = dst + capacity;
+	size_t anchor    = 0;
+
+	if (size >= kMatchLimit + 1) {
+		UInt32 table[1 << kHashLog];
+		memset(table, 0, sizeof(table));
+
+		// matches may not start in the last kMatchLimit bytes nor run
+		// into the last kLastLiterals bytes
+		const size_t ilimit = size - kMatchLimit;
+		const size_t mlimit = size - kLastLiterals;
+
+		size_t ip     = 1;
+		UInt32 misses = 0;
+		table[hashSequence(read32(src))] = 0;
+		while (ip <= ilimit) {
+			UInt32 seq  = read32(src + ip);
+			UInt32 h    = hashSequence(seq);
+			size_t ref  = table[h];
+			table[h]    = static_cast<UInt32>(ip);
+
+			if (ip - ref > kMaxOffset || read32(src + ref) != seq) {
+				ip += 1 + (misses++ >> kSkipTrigger);
+				continue;
+			}
+			misses = 0;
+
+			// extend the match backwards over pending literals
+			while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+				--ip;
+				--ref;
+			}
+
+			// and forwards
+			size_t end = ip + kMinMatch;
+			size_t r   = ref + kMinMatch;
+			while (end < mlimit && src[end] == src[r]) {
+				++end;
+				++r;
+			}
+
+			// emit literals and match
+			size_t literals = ip - anchor;
+			size_t match    = end - ip - kMinMatch;
+			if (static_cast<size_t>(oend - op) <
+					1 + literals + literals / 255 + 1 + 2 + match / 255 + 1) {
+				return 0;
+			}
+			UInt8* token = op++;
+			if (literals >= 15) {
+				*token = 15 << 4;
+				putLength(op, literals - 15);
+			}
+			else {
+				*token = static_cast<UInt8>(literals << 4);
+			}
+			memcpy(op, src + anchor, literals);
+			op += literals;
+
+			size_t offset = ip - ref;
+			*op++ = static_cast<UInt8>(offset & 0xff);
+			*op++ = static_cast<UInt8>(offset >> 8);
+			if (match >= 15) {
+				*token |= 15;
+				putLength(op, match - 15);
+			}
+			else {
+				*token |= static_cast<UInt8>(match);
+			}
+
+			ip     = end;
+			anchor = ip;
+			if (ip - 2 <= ilimit) {
+				table[hashSequence(read32(src + ip - 2))] =
+					static_cast<UInt32>(ip - 2);
+			}
+		}
+	}
+
+	// the rest goes out as literals
+	size_t literals = size - anchor;
+	if (static_cast<size_t>(oend - op) < 1 + literals + literals / 255 + 1) {
+		return 0;
+	}
+	if (literals >= 15) {
+		*op++ = 15 << 4;
+		putLength(op, literals - 15);
+	}
+	else {
+		*op++ = static_cast<UInt8>(literals << 4);
+	}
+	memcpy(op, src + anchor, literals);
+	op += literals;
+
+	return op - dst;
+}
+
+bool
+decompress(const void* srcData, size_t size, void* dstData, size_t dstSize)
+{
+	const UInt8* ip   = static_cast<const UInt8*>(srcData);
+	const UInt8* iend = ip + size;
+	UInt8* dst        = static_cast<UInt8*>(dstData);
+	UInt8* op         = dst;
+	UInt8* oend       = dst + dstSize;
+
+	while (ip < iend) {
+		UInt8 token = *ip++;
+
+		// literals
+		size_t literals = token >> 4;
+		if (literals == 15) {
+			UInt8 b;
+			do {
+				if (ip == iend) {
+					return false;
+				}
+				b = *ip++;
+				literals += b;
+			} while (b == 255);
+		}
+		if (literals > static_cast<size_t>(iend - ip) ||
+			literals > static_cast<size_t>(oend - op)) {
+			return false;
+		}
+		memcpy(op, ip, literals);
+		ip += literals;
+		op += literals;
+
+		// the last sequence has no match
+		if (ip == iend) {
+			break;
+		}
+
+		// match
+		if (iend - ip < 2) {
+			return false;
+		}
+		size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+		ip += 2;
+		if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+			return false;
+		}
+		size_t match = token & 15;
+		if (match == 15) {
+			UInt8 b;
+			do {
+				if (ip == iend) {
+					return false;
+				}
+				b = *ip++;
+				match += b;
+			} while (b == 255);
+		}
+		match += kMinMatch;
+		if (match > static_cast<size_t>(oend - op)) {
+			return false;
+		}
+
+		const UInt8* from = op - offset;
+		if (offset >= match) {
+			memcpy(op, from, match);
+			op += match;
+		}
+		else {
+			// overlapping copies repeat the last offset bytes
+			for (size_t i = 0; i < match; ++i) {
+				*op++ = *from++;
+			}
+		}
+	}
+
+	return (op == oend);
+}
+
+}
+}
@@ -0,0 +1,59 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <cstddef>
+
+namespace synergy {
+
+//! LZ4 block compression
+/*!
+A small, dependency free implementation of the LZ4 block format.  It
+favours speed over ratio:  incompressible data goes through at close
+to memory bandwidth and text typically shrinks by half or more.  The
+output can be read by any LZ4 block decoder.
+*/
+namespace lz4 {
+
+//! Worst case compressed size
+/*!
+Returns the most space compress() can need for \p size bytes.
+*/
+size_t compressBound(size_t size);
+
+//! Compress a block
+/*!
+Compresses the \p size bytes at \p src into \p dst, which has room for
+\p capacity bytes.  Returns the compressed size, or 0 if it doesn't
+fit.
+*/
+size_t compress(const void* src, size_t size, void* dst, size_t capacity);
+
+//! Decompress a block
+/*!
+Decompresses the \p size bytes at \p src into \p dst, which must
+decompress to exactly \p dstSize bytes.  Returns false if the block is
+malformed or the wrong size.  Never reads or writes out of bounds.
+*/
+bool decompress(const void* src, size_t size, void* dst, size_t dstSize);
+
+}
+}
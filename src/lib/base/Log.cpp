@@ -19,8 +19,11 @@
 #include "arch/Arch.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
+#include "base/LogRing.h"
 #include "base/String.h"
+#include "base/TMethodJob.h"
 #include "base/log_outputters.h"
+#include "mt/Thread.h"
 #include "common/Version.h"
 
 #include <cstdio>
@@ -53,34 +56,64 @@ static const int		g_defaultMaxPriority = kDEBUG;
 static const int		g_defaultMaxPriority = kINFO;
 #endif
 
+// number of messages queued in asynchronous mode.  each one takes
+// kLogMessageLength bytes.
+static const UInt32		g_asyncRingSize = 512;
+
+// longest time the writer thread sleeps between checks for messages
+static const double		g_asyncWriterInterval = 0.05;
+
 //
 // Log
 //
 
 Log*				 Log::s_log = NULL;
 
-Log::Log()
+Log::Log() :
+	m_maxPriority(g_defaultMaxPriority),
+	m_ring(NULL),
+	m_writer(NULL),
+	m_async(0),
+	m_stopWriter(0),
+	m_writerIdle(0),
+	m_droppedReported(0)
 {
 	assert(s_log == NULL);
 
 	// create mutex for multithread safe operation
 	m_mutex = ARCH->newMutex();
+	m_writerCond  = ARCH->newCondVar();
+	m_writerMutex = ARCH->newMutex();
 
 	// other initalization
-	m_maxPriority = g_defaultMaxPriority;
 	m_maxNewlineLength = 0;
 	insert(new ConsoleLogOutputter);
 
 	s_log = this;
 }
 
-Log::Log(Log* src)
+Log::Log(Log* src) :
+	m_ring(NULL),
+	m_writer(NULL),
+	m_writerCond(NULL),
+	m_writerMutex(NULL),
+	m_async(0),
+	m_stopWriter(0),
+	m_writerIdle(0),
+	m_droppedReported(0)
 {
 	s_log = src;
 }
 
 Log::~Log()
 {
+	// write anything still queued
+	setAsync(false);
+	if (m_ring != NULL) {
+		drain();
+		delete m_ring;
+	}
+
 	// clean up
 	for (OutputterList::iterator index	= m_outputters.begin();
 									index != m_outputters.end(); ++index) {
@@ -90,6 +123,8 @@ Log::~Log()
 									index != m_alwaysOutputters.end(); ++index) {
 		delete *index;
 	}
+	ARCH->closeMutex(m_writerMutex);
+	ARCH->closeCondVar(m_writerCond);
 	ARCH->closeMutex(m_mutex);
 }
 
@@ -180,7 +215,15 @@ Log::print(const char* file, int line, const char* fmt, ...)
 		timespec ts;
 		clock_gettime( CLOCK_REALTIME, &ts );
 
-		tm = localtime(&ts.tv_sec);
+		// the reentrant version is thread safe and doesn't check the
+		// time zone files on every call
+		struct tm tmBuf;
+#if SYSAPI_WIN32
+		localtime_s(&tmBuf, &ts.tv_sec);
+		tm = &tmBuf;
+#else
+		tm = localtime_r(&ts.tv_sec, &tmBuf);
+#endif
 		sprintf(tmp, "%04i-%02i-%02iT%02i:%02i:%02i.%09i", tm->tm_year + 1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec, (int)ts.tv_nsec);
 
 #else
@@ -269,15 +312,63 @@ Log::setFilter(const char* maxPriority)
 void
 Log::setFilter(int maxPriority)
 {
-	ArchMutexLock lock(m_mutex);
-	m_maxPriority = maxPriority;
+	// read on every print() so it's kept outside the mutex
+	m_maxPriority.store(static_cast<UInt32>(maxPriority));
+}
+
+void
+Log::setAsync(bool async)
+{
+	if (async == isAsync()) {
+		return;
+	}
+
+	if (async) {
+		// the ring outlives the writer thread since other threads may
+		// still be storing to it after asynchronous output is disabled
+		if (m_ring == NULL) {
+			m_ring = new LogRing(g_asyncRingSize, kLogMessageLength);
+		}
+		m_stopWriter.store(0);
+		m_writer = new Thread(new TMethodJob<Log>(
+							this, &Log::writerThread));
+		m_async.store(1);
+	}
+	else {
+		m_async.store(0);
+		m_stopWriter.store(1);
+		{
+			ArchMutexLock lock(m_writerMutex);
+			ARCH->broadcastCondVar(m_writerCond);
+		}
+		m_writer->wait();
+		delete m_writer;
+		m_writer = NULL;
+
+		// write whatever was stored after the writer's last pass
+		drain();
+	}
 }
 
 int
 Log::getFilter() const
 {
-	ArchMutexLock lock(m_mutex);
-	return m_maxPriority;
+	return static_cast<int>(m_maxPriority.load());
+}
+
+bool
+Log::isAsync() const
+{
+	return (m_async.load() != 0);
+}
+
+UInt32
+Log::getDropped() const
+{
+	if (m_ring == NULL) {
+		return 0;
+	}
+	return m_ring->getDropped();
 }
 
 void
@@ -287,8 +378,31 @@ Log::output(ELevel priority, char* msg)
 	assert(msg != NULL);
 	if (!msg) return;
 
+	if (m_async.load() != 0) {
+		if (priority > kERROR) {
+			// hand the message to the writer thread.  if the ring is
+			// full the message is counted as dropped.
+			if (m_ring->store(priority, msg) &&
+				m_writerIdle.compareAndSwap(1, 0)) {
+				ARCH->broadcastCondVar(m_writerCond);
+			}
+			return;
+		}
+
+		// errors are often followed by exiting, so write them now.
+		// write the queued messages first to keep them in order.
+		drain();
+	}
+
 	ArchMutexLock lock(m_mutex);
+	write(priority, msg);
+	flush();
+}
 
+void
+Log::write(ELevel priority, const char* msg)
+{
+	// m_mutex must be locked
 	OutputterList::const_iterator i;
 
 	for (i = m_alwaysOutputters.begin(); i != m_alwaysOutputters.end(); ++i) {
@@ -305,3 +419,63 @@ Log::output(ELevel priority, char* msg)
 		}
 	}
 }
+
+void
+Log::flush()
+{
+	// m_mutex must be locked
+	OutputterList::const_iterator i;
+	for (i = m_alwaysOutputters.begin(); i != m_alwaysOutputters.end(); ++i) {
+		(*i)->flush();
+	}
+	for (i = m_outputters.begin(); i != m_outputters.end(); ++i) {
+		(*i)->flush();
+	}
+}
+
+void
+Log::drain()
+{
+	// write all queued messages as one batch.  the mutex also makes
+	// sure only one thread at a time reads from the ring.
+	ArchMutexLock lock(m_mutex);
+	ELevel priority;
+	const char* msg;
+	bool wrote = false;
+	while ((msg = m_ring->peek(priority)) != NULL) {
+		write(priority, msg);
+		m_ring->pop();
+		wrote = true;
+	}
+	if (wrote) {
+		flush();
+	}
+}
+
+void
+Log::writerThread(void*)
+{
+	while (m_stopWriter.load() == 0) {
+		drain();
+
+		// report drops through the ring like any other message
+		UInt32 dropped = m_ring->getDropped();
+		if (dropped != m_droppedReported) {
+			LOG((CLOG_WARN "dropped %u log messages", dropped - m_droppedReported));
+			m_droppedReported = dropped;
+		}
+
+		// wait for more.  only the first message stored while we're
+		// idle wakes us, which keeps busy loggers out of the kernel.  a
+		// wakeup may be missed between draining and going idle so don't
+		// sleep for long.
+		ArchMutexLock lock(m_writerMutex);
+		m_writerIdle.store(1);
+		if (m_stopWriter.load() == 0) {
+			ARCH->waitCondVar(m_writerCond, m_writerMutex,
+							g_asyncWriterInterval);
+		}
+		m_writerIdle.store(0);
+	}
+	drain();
+}
@@ -20,6 +20,7 @@
 
 #include "arch/IArchMultithread.h"
 #include "arch/Arch.h"
+#include "mt/Atomic.h"
 #include "common/common.h"
 #include "common/stdlist.h"
 
@@ -29,6 +30,7 @@
 #define BYE "\nTry `%s --help' for more information."
 
 class ILogOutputter;
+class LogRing;
 class Thread;
 
 //! Logging facility
@@ -37,6 +39,15 @@ The logging class;  all console output should go through this class.
 It supports multithread safe operation, several message priority levels,
 filtering by priority, and output redirection.  The macros LOG() and
 LOGC() provide convenient access.
+
+In asynchronous mode messages are formatted by the thread that logs
+them and queued in a fixed size lock-free ring.  A writer thread takes
+them off in batches and passes them to the outputters, so a thread that
+logs never waits for a file or the system log.  If the ring fills up
+then messages are dropped and counted rather than blocking the caller.
+Errors, fatal errors and \c CLOG_PRINT messages are still written
+immediately, after any queued messages, since they often precede an
+exit.
 */
 class Log {
 public:
@@ -94,6 +105,16 @@ public:
 	//! Set the minimum priority filter (by ordinal).
 	void				setFilter(int);
 
+	//! Enable or disable asynchronous output
+	/*!
+	When \p async is true messages are queued and written to the
+	outputters by a writer thread.  When it's false messages are
+	written by the thread that logs them, as they are by default.
+	Disabling asynchronous output waits for queued messages to be
+	written.
+	*/
+	void				setAsync(bool async);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -110,6 +131,16 @@ public:
 	//! Get the minimum priority level.
 	int					getFilter() const;
 
+	//! Test for asynchronous output
+	bool				isAsync() const;
+
+	//! Get the number of dropped messages
+	/*!
+	Returns the number of messages that were thrown away in asynchronous
+	mode because the writer thread couldn't keep up.
+	*/
+	UInt32				getDropped() const;
+
 	//! Get the filter name of the current filter level.
 	const char*			getFilterName() const;
 
@@ -126,6 +157,10 @@ public:
 
 private:
 	void				output(ELevel priority, char* msg);
+	void				write(ELevel priority, const char* msg);
+	void				flush();
+	void				drain();
+	void				writerThread(void*);
 
 private:
 	typedef std::list<ILogOutputter*> OutputterList;
@@ -136,7 +171,17 @@ private:
 	OutputterList		m_outputters;
 	OutputterList		m_alwaysOutputters;
 	int					m_maxNewlineLength;
-	int					m_maxPriority;
+	AtomicUInt32		m_maxPriority;
+
+	// asynchronous output
+	LogRing*			m_ring;
+	Thread*				m_writer;
+	ArchCond			m_writerCond;
+	ArchMutex			m_writerMutex;
+	AtomicUInt32		m_async;
+	AtomicUInt32		m_stopWriter;
+	AtomicUInt32		m_writerIdle;
+	UInt32				m_droppedReported;
 };
 
 const UInt16 kLogMessageLength = 2048;
@@ -0,0 +1,103 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/LogRing.h"
+
+#include <cstring>
+
+//
+// LogRing
+//
+
+LogRing::LogRing(UInt32 capacity, UInt32 recordSize) :
+	m_ring(capacity),
+	m_messages(NULL),
+	m_recordSize(recordSize),
+	m_tail(0),
+	m_dropped(0)
+{
+	assert(recordSize >= 1);
+
+	// the records are allocated up front so memory use is fixed
+	UInt32 n   = m_ring.getCapacity();
+	m_messages = new char[n * m_recordSize];
+	for (UInt32 i = 0; i < n; ++i) {
+		Record& record   = m_ring.get(i);
+		record.m_level   = kPRINT;
+		record.m_message = m_messages + i * m_recordSize;
+	}
+}
+
+LogRing::~LogRing()
+{
+	delete[] m_messages;
+}
+
+bool
+LogRing::store(ELevel level, const char* message)
+{
+	UInt32 pos;
+	Record* record = m_ring.claim(pos);
+	if (record == NULL) {
+		m_dropped.fetchAdd(1);
+		return false;
+	}
+
+	// fill the record then publish it
+	size_t n = strlen(message);
+	if (n > m_recordSize - 1) {
+		n = m_recordSize - 1;
+	}
+	memcpy(record->m_message, message, n);
+	record->m_message[n] = '\0';
+	record->m_level      = level;
+	m_ring.publish(pos);
+	return true;
+}
+
+const char*
+LogRing::peek(ELevel& level)
+{
+	// messages are read in the order their records were claimed
+	UInt32 pos;
+	Record* record = m_ring.getPublished(m_ring.getSlot(m_tail), pos);
+	if (record == NULL || pos != m_tail) {
+		return NULL;
+	}
+	level = record->m_level;
+	return record->m_message;
+}
+
+void
+LogRing::pop()
+{
+	// free the record for the next lap
+	m_ring.release(m_tail);
+	++m_tail;
+}
+
+UInt32
+LogRing::getCapacity() const
+{
+	return m_ring.getCapacity();
+}
+
+UInt32
+LogRing::getDropped() const
+{
+	return m_dropped.load();
+}
@@ -0,0 +1,106 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/ELevel.h"
+#include "base/SequencedRing.h"
+#include "mt/Atomic.h"
+#include "common/basic_types.h"
+
+//! Lock-free log record storage
+/*!
+A bounded multi-producer, single-consumer ring of formatted log
+messages.  Any thread may store a message without taking a lock.
+Messages longer than a record are truncated.  When the ring is full
+the message is dropped and counted instead of waiting for room, so a
+thread that logs never blocks on the thread that writes the log.
+
+Only one thread at a time may read messages and it sees them in the
+order their slots were claimed.
+*/
+class LogRing {
+public:
+	//! Create a ring
+	/*!
+	\p capacity is the number of records and is rounded up to a power of
+	two.  It must be at least 2.  Each record holds a message of up to
+	\p recordSize - 1 characters.
+	*/
+	LogRing(UInt32 capacity, UInt32 recordSize);
+	~LogRing();
+
+	//! @name manipulators
+	//@{
+
+	//! Store a message
+	/*!
+	Copies \p message, which has level \p level, into the next record.
+	Returns false and counts a drop if the ring is full.  May be called
+	from any thread.
+	*/
+	bool				store(ELevel level, const char* message);
+
+	//! Get the oldest message
+	/*!
+	Returns the oldest stored message and saves its level in \p level,
+	or returns NULL if there are no messages ready.  The message stays
+	valid until pop().  Must not be called by two threads at once.
+	*/
+	const char*			peek(ELevel& level);
+
+	//! Remove the oldest message
+	/*!
+	Frees the record returned by the last successful peek().  Must not
+	be called by two threads at once.
+	*/
+	void				pop();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of records
+	UInt32				getCapacity() const;
+
+	//! Get the number of dropped messages
+	/*!
+	Returns the number of messages that weren't stored because the ring
+	was full.  The count wraps around.
+	*/
+	UInt32				getDropped() const;
+
+	//@}
+
+private:
+	// not implemented
+	LogRing(const LogRing&);
+	LogRing& operator=(const LogRing&);
+
+	class Record {
+	public:
+		ELevel			m_level;
+		char*			m_message;
+	};
+
+private:
+	SequencedRing<Record>	m_ring;
+	char*				m_messages;
+	UInt32				m_recordSize;
+	UInt32				m_tail;
+	AtomicUInt32		m_dropped;
+};
@@ -0,0 +1,216 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mt/Atomic.h"
+#include "common/basic_types.h"
+
+//! Slots of a lock-free ring
+/*!
+The slot bookkeeping shared by the bounded multi-producer rings.  Any
+thread may claim the slot at the head of the ring, fill it in and then
+publish it, all without a lock.  The consumer finds published slots
+and releases them for the next lap.
+
+Each slot has a sequence number.  A slot is free for ring position
+\c pos when its sequence is \c pos and holds a value for \c pos when
+its sequence is \c pos + 1.  Positions wrap around.
+
+Slots are claimed in order, so if the slot at the head still holds a
+value from the previous lap then \c claim() fails even though other
+slots may be free.
+*/
+template <class T>
+class SequencedRing {
+public:
+	//! Create a ring
+	/*!
+	\p capacity is rounded up to a power of two and must be at least 2.
+	*/
+	SequencedRing(UInt32 capacity);
+	~SequencedRing();
+
+	//! @name manipulators
+	//@{
+
+	//! Claim the slot at the head
+	/*!
+	Returns the value in the slot at the head of the ring for the
+	caller to fill in and sets \p pos to the slot's position, or
+	returns NULL if the ring is full.  May be called from any thread.
+	*/
+	T*					claim(UInt32& pos);
+
+	//! Publish a claimed slot
+	/*!
+	Makes the value at position \p pos, filled in after \c claim(),
+	visible to the consumer.
+	*/
+	void				publish(UInt32 pos);
+
+	//! Get a published value
+	/*!
+	Returns the value in slot \p slot if it has been published and sets
+	\p pos to its position, otherwise returns NULL.
+	*/
+	T*					getPublished(UInt32 slot, UInt32& pos);
+
+	//! Release a published slot
+	/*!
+	Frees the slot holding position \p pos for the next lap.  Must only
+	be called from the consumer thread.
+	*/
+	void				release(UInt32 pos);
+
+	//! Get a slot's value
+	/*!
+	Returns the value in slot \p slot whatever its state, e.g. to set
+	it up before the ring is used.
+	*/
+	T&					get(UInt32 slot);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the slot for a position
+	UInt32				getSlot(UInt32 pos) const;
+
+	//! Get the number of slots
+	UInt32				getCapacity() const;
+
+	//@}
+
+private:
+	// not implemented
+	SequencedRing(const SequencedRing&);
+	SequencedRing& operator=(const SequencedRing&);
+
+	class Slot {
+	public:
+		AtomicUInt32	m_sequence;
+		T				m_value;
+	};
+
+private:
+	Slot*				m_slots;
+	UInt32				m_mask;
+	AtomicUInt32		m_head;
+};
+
+template <class T>
+SequencedRing<T>::SequencedRing(UInt32 capacity) :
+	m_slots(NULL),
+	m_mask(1),
+	m_head(0)
+{
+	assert(capacity >= 2);
+
+	// round up to a power of two so positions map to slots with a mask
+	while (m_mask < capacity - 1) {
+		m_mask = (m_mask << 1) | 1;
+	}
+
+	m_slots = new Slot[m_mask + 1];
+	for (UInt32 i = 0; i <= m_mask; ++i) {
+		m_slots[i].m_sequence.store(i);
+	}
+}
+
+template <class T>
+SequencedRing<T>::~SequencedRing()
+{
+	delete[] m_slots;
+}
+
+template <class T>
+T*
+SequencedRing<T>::claim(UInt32& pos)
+{
+	// if the slot's sequence is less than pos then it still holds a
+	// value from the previous lap
+	UInt32 head = m_head.load();
+	for (;;) {
+		Slot& slot  = m_slots[head & m_mask];
+		SInt32 diff = static_cast<SInt32>(slot.m_sequence.load() - head);
+		if (diff == 0) {
+			if (m_head.compareAndSwap(head, head + 1)) {
+				pos = head;
+				return &slot.m_value;
+			}
+		}
+		else if (diff < 0) {
+			return NULL;
+		}
+		head = m_head.load();
+	}
+}
+
+template <class T>
+void
+SequencedRing<T>::publish(UInt32 pos)
+{
+	m_slots[pos & m_mask].m_sequence.store(pos + 1);
+}
+
+template <class T>
+T*
+SequencedRing<T>::getPublished(UInt32 slot, UInt32& pos)
+{
+	assert(slot <= m_mask);
+
+	// a free slot's sequence maps back to the slot itself
+	Slot& s = m_slots[slot];
+	UInt32 sequence = s.m_sequence.load();
+	if ((sequence & m_mask) == slot) {
+		return NULL;
+	}
+	pos = sequence - 1;
+	return &s.m_value;
+}
+
+template <class T>
+void
+SequencedRing<T>::release(UInt32 pos)
+{
+	Slot& slot = m_slots[pos & m_mask];
+	assert(slot.m_sequence.load() == pos + 1);
+	slot.m_sequence.store(pos + m_mask + 1);
+}
+
+template <class T>
+T&
+SequencedRing<T>::get(UInt32 slot)
+{
+	assert(slot <= m_mask);
+	return m_slots[slot].m_value;
+}
+
+template <class T>
+UInt32
+SequencedRing<T>::getSlot(UInt32 pos) const
+{
+	return pos & m_mask;
+}
+
+template <class T>
+UInt32
+SequencedRing<T>::getCapacity() const
+{
+	return m_mask + 1;
+}
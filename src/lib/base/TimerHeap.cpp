@@ -0,0 +1,182 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/TimerHeap.h"
+
+#include <cassert>
+
+// children per node.  a wider node makes the heap shallower, which
+// suits a heap that's rescheduled far more often than it's popped.
+static const size_t		kArity     = 4;
+
+static const size_t		kNotQueued = static_cast<size_t>(-1);
+
+//
+// TimerHeap::Entry
+//
+
+TimerHeap::Entry::Entry() :
+	m_deadline(0.0),
+	m_index(kNotQueued)
+{
+	// do nothing
+}
+
+double
+TimerHeap::Entry::getDeadline() const
+{
+	return m_deadline;
+}
+
+bool
+TimerHeap::Entry::isQueued() const
+{
+	return (m_index != kNotQueued);
+}
+
+
+//
+// TimerHeap
+//
+
+TimerHeap::TimerHeap()
+{
+	// do nothing
+}
+
+TimerHeap::~TimerHeap()
+{
+	for (size_t i = 0; i < m_heap.size(); ++i) {
+		m_heap[i]->m_index = kNotQueued;
+	}
+}
+
+void
+TimerHeap::schedule(Entry* entry, double deadline)
+{
+	assert(entry != NULL);
+
+	if (!entry->isQueued()) {
+		entry->m_deadline = deadline;
+		m_heap.push_back(entry);
+		siftUp(m_heap.size() - 1, entry);
+		return;
+	}
+
+	bool earlier      = (deadline < entry->m_deadline);
+	entry->m_deadline = deadline;
+	if (earlier) {
+		siftUp(entry->m_index, entry);
+	}
+	else {
+		siftDown(entry->m_index, entry);
+	}
+}
+
+void
+TimerHeap::remove(Entry* entry)
+{
+	assert(entry != NULL);
+
+	if (!entry->isQueued()) {
+		return;
+	}
+	assert(m_heap[entry->m_index] == entry);
+
+	// fill the hole with the last entry
+	size_t index = entry->m_index;
+	Entry* last  = m_heap.back();
+	m_heap.pop_back();
+	entry->m_index = kNotQueued;
+	if (last == entry) {
+		return;
+	}
+	if (index > 0 &&
+		last->m_deadline < m_heap[(index - 1) / kArity]->m_deadline) {
+		siftUp(index, last);
+	}
+	else {
+		siftDown(index, last);
+	}
+}
+
+TimerHeap::Entry*
+TimerHeap::top() const
+{
+	return m_heap.empty() ? NULL : m_heap.front();
+}
+
+bool
+TimerHeap::empty() const
+{
+	return m_heap.empty();
+}
+
+size_t
+TimerHeap::size() const
+{
+	return m_heap.size();
+}
+
+void
+TimerHeap::siftUp(size_t index, Entry* entry)
+{
+	while (index > 0) {
+		size_t parent = (index - 1) / kArity;
+		if (!(entry->m_deadline < m_heap[parent]->m_deadline)) {
+			break;
+		}
+		place(index, m_heap[parent]);
+		index = parent;
+	}
+	place(index, entry);
+}
+
+void
+TimerHeap::siftDown(size_t index, Entry* entry)
+{
+	const size_t n = m_heap.size();
+	for (;;) {
+		size_t first = index * kArity + 1;
+		if (first >= n) {
+			break;
+		}
+
+		// find the earliest child
+		size_t end   = (first + kArity < n) ? first + kArity : n;
+		size_t child = first;
+		for (size_t i = first + 1; i < end; ++i) {
+			if (m_heap[i]->m_deadline < m_heap[child]->m_deadline) {
+				child = i;
+			}
+		}
+		if (!(m_heap[child]->m_deadline < entry->m_deadline)) {
+			break;
+		}
+		place(index, m_heap[child]);
+		index = child;
+	}
+	place(index, entry);
+}
+
+void
+TimerHeap::place(size_t index, Entry* entry)
+{
+	m_heap[index]  = entry;
+	entry->m_index = index;
+}
@@ -0,0 +1,100 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common/stdvector.h"
+
+#include <cstddef>
+
+//! Indexed timer heap
+/*!
+A 4-ary min-heap of timers ordered by deadline.  Each entry remembers
+its position in the heap so it can be removed or given a new deadline
+in place without searching for it.  The heap only points to entries;
+their owner must remove them before destroying them.
+*/
+class TimerHeap {
+public:
+	//! Heap entry
+	class Entry {
+	public:
+		Entry();
+
+		//! Get deadline
+		double			getDeadline() const;
+
+		//! Test if queued
+		/*!
+		Returns true if the entry is in a heap.
+		*/
+		bool			isQueued() const;
+
+	private:
+		friend class TimerHeap;
+
+		double			m_deadline;
+		size_t			m_index;
+	};
+
+	TimerHeap();
+	~TimerHeap();
+
+	//! @name manipulators
+	//@{
+
+	//! Schedule entry
+	/*!
+	Sets the deadline of \p entry to \p deadline, adding it to the heap
+	if it isn't already there.
+	*/
+	void				schedule(Entry* entry, double deadline);
+
+	//! Remove entry
+	/*!
+	Takes \p entry out of the heap.  Does nothing if it isn't queued.
+	*/
+	void				remove(Entry* entry);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get earliest entry
+	/*!
+	Returns the entry with the earliest deadline, or NULL if the heap is
+	empty.
+	*/
+	Entry*				top() const;
+
+	//! Test if empty
+	bool				empty() const;
+
+	//! Get the number of entries
+	size_t				size() const;
+
+	//@}
+
+private:
+	void				siftUp(size_t index, Entry* entry);
+	void				siftDown(size_t index, Entry* entry);
+	void				place(size_t index, Entry* entry);
+
+private:
+	std::vector<Entry*>	m_heap;
+};
@@ -23,7 +23,8 @@
 #include <fstream>
 
 enum EFileLogOutputter {
-	kFileSizeLimit = 1024 // kb
+	kFileSizeLimit = 1024, // kb
+	kFileBufferLimit = 64 // kb
 };
 
 //
@@ -244,24 +245,44 @@ FileLogOutputter::FileLogOutputter(const char* logFile)
 
 FileLogOutputter::~FileLogOutputter()
 {
+	flush();
 }
 
 void
 FileLogOutputter::setLogFilename(const char* logFile)
 {
 	assert(logFile != NULL);
+	flush();
 	m_fileName = logFile;
 }
 
 bool
 FileLogOutputter::write(ELevel level, const char *message)
 {
+	// hold on to the message until the log flushes so that a batch of
+	// messages costs one open and close of the file
+	m_buffer += message;
+	m_buffer += '\n';
+	if (m_buffer.size() > kFileBufferLimit * 1024) {
+		flush();
+	}
+	return true;
+}
+
+void
+FileLogOutputter::flush()
+{
+	if (m_buffer.empty()) {
+		return;
+	}
+
 	bool moveFile = false;
 
 	std::ofstream m_handle;
 	m_handle.open(m_fileName.c_str(), std::fstream::app);
 	if (m_handle.is_open() && m_handle.fail() != true) {
-		m_handle << message << std::endl;
+		m_handle << m_buffer;
+		m_handle.flush();
 
 		// when file size exceeds limits, move to 'old log' filename.
 		size_t p = m_handle.tellp();
@@ -270,14 +291,13 @@ FileLogOutputter::write(ELevel level, const char *message)
 		}
 	}
 	m_handle.close();
+	m_buffer.clear();
 
 	if (moveFile) {
 		String oldLogFilename = synergy::string::sprintf("%s.1", m_fileName.c_str());
 		remove(oldLogFilename.c_str());
 		rename(m_fileName.c_str(), oldLogFilename.c_str());
 	}
-
-	return true;
 }
 
 void
@@ -79,11 +79,13 @@ public:
 	virtual void		close();
 	virtual void		show(bool showIfEmpty);
 	virtual bool		write(ELevel level, const char* message);
+	virtual void		flush();
 
 	void				setLogFilename(const char* title);
 
 private:
 	std::string			m_fileName;
+	std::string			m_buffer;
 };
 
 //! Write log to system log
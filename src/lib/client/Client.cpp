@@ -22,6 +22,8 @@
 #include "client/ServerProxy.h"
 #include "synergy/Screen.h"
 #include "synergy/FileChunk.h"
+#include "synergy/FileReceiver.h"
+#include "synergy/FileSendWindow.h"
 #include "synergy/DropHelper.h"
 #include "synergy/PacketStreamFilter.h"
 #include "synergy/ProtocolUtil.h"
@@ -29,6 +31,7 @@
 #include "synergy/XSynergy.h"
 #include "synergy/StreamChunker.h"
 #include "synergy/IPlatformScreen.h"
+#include "mt/Lock.h"
 #include "mt/Thread.h"
 #include "net/TCPSocket.h"
 #include "net/IDataSocket.h"
@@ -69,19 +72,26 @@ Client::Client(
 	m_suspended(false),
 	m_connectOnResume(false),
 	m_events(events),
+	m_fileReceiver(NULL),
 	m_sendFileThread(NULL),
+	m_fileSendWindow(NULL),
 	m_writeToDropDirThread(NULL),
 	m_socket(NULL),
 	m_useSecureNetwork(false),
 	m_args(args),
 	m_sendClipboardThread(NULL),
 	m_mutex(NULL),
-	m_condData(false),
-	m_condVar(NULL)
+	m_condVar(NULL),
+	m_fillPending(false),
+	m_clipboardPending(false)
 {
 	assert(m_socketFactory != NULL);
 	assert(m_screen        != NULL);
 
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		m_clipboardQueued[id] = false;
+	}
+
 	// register suspend/resume event handlers
 	m_events->adoptHandler(m_events->forIScreen().suspend(),
 							getEventTarget(),
@@ -91,6 +101,10 @@ Client::Client(
 							getEventTarget(),
 							new TMethodEventJob<Client>(this,
 								&Client::handleResume));
+	m_events->adoptHandler(m_events->forClient().fillClipboards(),
+							getEventTarget(),
+							new TMethodEventJob<Client>(this,
+								&Client::handleFillClipboards));
 
 	if (m_args.m_enableDragDrop) {
 		m_events->adoptHandler(m_events->forFile().fileChunkSending(),
@@ -110,7 +124,9 @@ Client::Client(
 		}
 	}
 	m_mutex = new Mutex();
-	m_condVar = new CondVar<bool>(m_mutex, m_condData);
+	m_condVar = new CondVar<bool>(m_mutex, false);
+	m_fileReceiver = new FileReceiver;
+	m_fileSendWindow = new FileSendWindow;
 }
 
 Client::~Client()
@@ -123,6 +139,8 @@ Client::~Client()
 							  getEventTarget());
 	m_events->removeHandler(m_events->forIScreen().resume(),
 							  getEventTarget());
+	m_events->removeHandler(m_events->forClient().fillClipboards(),
+							  getEventTarget());
 
 	cleanupTimer();
 	cleanupScreen();
@@ -131,6 +149,8 @@ Client::~Client()
 	delete m_socketFactory;
 	delete m_condVar;
 	delete m_mutex;
+	delete m_fileSendWindow;
+	delete m_fileReceiver;
 }
 
 void
@@ -270,36 +290,15 @@ Client::leave()
 {
 	m_active = false;
 
-	if (m_sendClipboardThread != NULL) {
-		StreamChunker::interruptClipboard();
-		m_sendClipboardThread->wait();
-		delete m_sendClipboardThread;
-		m_sendClipboardThread = NULL;
-	}
-
-	m_condData = false;
-	m_sendClipboardThread = new Thread(
-								new TMethodJob<Client>(
-									this,
-									&Client::sendClipboardThread,
-									NULL));
-	// Bug #4735 - we can't leave() until fillClipboard()s all finish
-	Stopwatch timer(false);
-	m_mutex->lock();
-	while (!m_condData) {
-		if (!m_condVar->wait(timer, 0.5)) {
-			LOG((CLOG_WARN "timed out %fs waiting for clipboard fill",
-				(double) timer.getTime()));
-			break;
-		}
-		LOG((CLOG_DEBUG1 "leave %fs elapsed", (double) timer.getTime()));
-	}
-	m_mutex->unlock();
-
 	m_screen->leave();
 
-	if (!m_receivedFileData.empty()) {
-		m_receivedFileData.clear();
+	// Bug #4735 - fillClipboard() mustn't overlap the screen's leave().
+	// the clipboards are read after it and sent by the capture thread so
+	// the switch never waits on reading, marshalling or sending them.
+	captureClipboards();
+
+	if (m_fileReceiver->isReceiving()) {
+		m_fileReceiver->discard();
 		LOG((CLOG_DEBUG "file transmission interrupted"));
 	}
 
@@ -311,7 +310,11 @@ Client::setClipboard(ClipboardID id, const IClipboard* clipboard)
 {
  	m_screen->setClipboard(id, clipboard);
 	m_ownClipboard[id]  = false;
-	m_sentClipboard[id] = false;
+
+	// a queued copy is no longer ours to send
+	Lock lock(m_mutex);
+	m_sentClipboard[id]   = false;
+	m_clipboardQueued[id] = false;
 }
 
 void
@@ -319,7 +322,11 @@ Client::grabClipboard(ClipboardID id)
 {
 	m_screen->grabClipboard(id);
 	m_ownClipboard[id]  = false;
-	m_sentClipboard[id] = false;
+
+	// a queued copy is no longer ours to send
+	Lock lock(m_mutex);
+	m_sentClipboard[id]   = false;
+	m_clipboardQueued[id] = false;
 }
 
 void
@@ -377,6 +384,18 @@ Client::mouseWheel(SInt32 xDelta, SInt32 yDelta)
 	m_screen->mouseWheel(xDelta, yDelta);
 }
 
+void
+Client::beginInputBatch()
+{
+	m_screen->beginInputBatch();
+}
+
+void
+Client::endInputBatch()
+{
+	m_screen->endInputBatch();
+}
+
 void
 Client::screensaver(bool activate)
 {
@@ -416,30 +435,21 @@ Client::fillClipboard(ClipboardID id, Clipboard *clipboard)
 void
 Client::sendClipboard(ClipboardID id, Clipboard *clipboard)
 {
-	assert(m_screen != NULL);
 	assert(m_server != NULL);
 
-	// get clipboard data.  set the clipboard time to the last
-	// clipboard time before getting the data from the screen
-	// as the screen may detect an unchanged clipboard and
-	// avoid copying the data.
-
-	// check time
-	if (m_timeClipboard[id] == 0 ||
-		clipboard->getTime() != m_timeClipboard[id]) {
-		// save new time
-		m_timeClipboard[id] = clipboard->getTime();
-
-		// marshall the data
-		String data = clipboard->marshall();
-
-		// save and send data if different or not yet sent
-		if (!m_sentClipboard[id] || data != m_dataClipboard[id]) {
-			m_sentClipboard[id] = true;
-			m_dataClipboard[id] = data;
-			m_server->onClipboardChanged(id, clipboard);
+	// marshall the data
+	String data = clipboard->marshall();
+
+	// save and send data if different or not yet sent
+	{
+		Lock lock(m_mutex);
+		if (m_sentClipboard[id] && data == m_dataClipboard[id]) {
+			return;
 		}
+		m_sentClipboard[id] = true;
+		m_dataClipboard[id] = data;
 	}
+	m_server->onClipboardChanged(id, clipboard);
 }
 
 void
@@ -512,6 +522,10 @@ Client::setupConnection()
 	m_events->adoptHandler(m_events->forISocket().stopRetry(),
 						   m_stream->getEventTarget(),
 						   new TMethodEventJob<Client>(this, &Client::handleStopRetry));
+	m_events->adoptHandler(m_events->forIStream().outputFlushed(),
+							m_stream->getEventTarget(),
+							new TMethodEventJob<Client>(this,
+								&Client::handleOutputFlushed));
 }
 
 void
@@ -569,6 +583,8 @@ Client::cleanupConnection()
 							m_stream->getEventTarget());
 		m_events->removeHandler(m_events->forISocket().stopRetry(),
 								m_stream->getEventTarget());
+		m_events->removeHandler(m_events->forIStream().outputFlushed(),
+							m_stream->getEventTarget());
 		cleanupStream();
 	}
 }
@@ -576,6 +592,20 @@ Client::cleanupConnection()
 void
 Client::cleanupScreen()
 {
+	// the capture thread uses the server proxy and screen so it must
+	// finish before they go.  it never waits on the event loop.
+	{
+		Lock lock(m_mutex);
+		m_clipboardPending = false;
+		StreamChunker::interruptClipboard();
+		while (*m_condVar) {
+			m_condVar->wait();
+		}
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			m_clipboardQueued[id] = false;
+		}
+	}
+
 	if (m_server != NULL) {
 		if (m_ready) {
 			m_screen->disable();
@@ -622,10 +652,13 @@ Client::handleConnected(const Event&, void*)
 	setupConnection();
 
 	// reset clipboard state
-	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-		m_ownClipboard[id]  = false;
-		m_sentClipboard[id] = false;
-		m_timeClipboard[id] = 0;
+	{
+		Lock lock(m_mutex);
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			m_ownClipboard[id]  = false;
+			m_sentClipboard[id] = false;
+			m_timeClipboard[id] = 0;
+		}
 	}
 
 	m_socket->secureConnect();
@@ -694,15 +727,17 @@ Client::handleClipboardGrabbed(const Event& event, void*)
 
 	// we now own the clipboard and it has not been sent to the server
 	m_ownClipboard[info->m_id]  = true;
-	m_sentClipboard[info->m_id] = false;
 	m_timeClipboard[info->m_id] = 0;
+	{
+		Lock lock(m_mutex);
+		m_sentClipboard[info->m_id] = false;
+	}
 
 	// if we're not the active screen then send the clipboard now,
-	// otherwise we'll wait until we leave.
-	Clipboard clipboard;
+	// otherwise we'll wait until we leave.  the capture thread
+	// compresses and sends it so the event loop doesn't have to.
 	if (!m_active) {
-		fillClipboard(info->m_id, &clipboard);
-		sendClipboard(info->m_id, &clipboard);
+		captureClipboards();
 	}
 }
 
@@ -770,7 +805,7 @@ Client::handleResume(const Event&, void*)
 void
 Client::handleFileChunkSending(const Event& event, void*)
 {
-	sendFileChunk(event.getData());
+	sendFileChunk(event.getDataObject());
 }
 
 void
@@ -790,35 +825,137 @@ Client::onFileRecieveCompleted()
 }
 
 void
-Client::sendClipboardThread(void * data)
+Client::captureClipboards()
 {
-	Stopwatch timer(false);
+	if (m_fillPending) {
+		return;
+	}
+
+	bool owned = false;
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		owned = owned || m_ownClipboard[id];
+	}
+	if (!owned) {
+		return;
+	}
+
+	// reading a clipboard can take a while, e.g. if its owner is slow
+	// to convert it, so we don't do it in the caller.  it can't go to
+	// the capture thread either since the screen's clipboards pump the
+	// display's events, so it's done on this thread once the event
+	// we're handling is done.
+	m_fillPending = true;
+	sendEvent(m_events->forClient().fillClipboards(), NULL);
+}
+
+void
+Client::handleFillClipboards(const Event&, void*)
+{
+	m_fillPending = false;
+
+	// if we've entered again then they're read when we next leave
+	if (m_server != NULL && !m_active) {
+		fillClipboards();
+	}
+}
+
+void
+Client::fillClipboards()
+{
+	// read the clipboards we own on this thread.  the screen's
+	// clipboards also answer requests from other clients so only the
+	// event thread may touch them.
 	Clipboard clipboard[kClipboardEnd];
-	// fill clipboards that we own and that have changed
+	bool changed[kClipboardEnd];
+	bool anyChanged = false;
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-		if (m_ownClipboard[id]) {
-			fillClipboard(id, &clipboard[id]);
+		changed[id] = false;
+		if (!m_ownClipboard[id]) {
+			continue;
 		}
-	}
-	LOG((CLOG_DEBUG1 "fill took %fs, signaling", (double) timer.getTime()));
 
-	// signal that fill is done
-	m_mutex->lock();
-	m_condData = true;
-	m_condVar->signal();
-	m_mutex->unlock();
+		// set the clipboard time to the last clipboard time before
+		// getting the data from the screen as the screen may detect
+		// an unchanged clipboard and avoid copying the data.
+		fillClipboard(id, &clipboard[id]);
+		if (m_timeClipboard[id] == 0 ||
+			clipboard[id].getTime() != m_timeClipboard[id]) {
+			m_timeClipboard[id] = clipboard[id].getTime();
+			changed[id] = true;
+			anyChanged  = true;
+		}
+	}
+	if (!anyChanged) {
+		return;
+	}
 
-	// send clipboards that we own and that have changed
+	// hand the copies to the capture thread
+	Lock lock(m_mutex);
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-		if (m_ownClipboard[id]) {
-			sendClipboard(id, &clipboard[id]);
+		if (changed[id]) {
+			m_captureClipboard[id] = clipboard[id];
+			m_clipboardQueued[id]  = true;
 		}
 	}
+	m_clipboardPending = true;
+	if (*m_condVar) {
+		// the running send is out of date.  it starts over when it
+		// finishes, so there's no need to wait for it here.  a send cut
+		// short must go again even if the data hasn't changed.
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			if (changed[id]) {
+				m_sentClipboard[id] = false;
+			}
+		}
+		StreamChunker::interruptClipboard();
+		return;
+	}
 
-	delete m_sendClipboardThread;
-	m_sendClipboardThread = NULL;
-	LOG((CLOG_DEBUG1 "send took %fs", (double) timer.getTime()));
+	*m_condVar = true;
+	m_sendClipboardThread = new Thread(
+								new TMethodJob<Client>(
+									this,
+									&Client::sendClipboardThread,
+									NULL));
+}
 
+void
+Client::sendClipboardThread(void*)
+{
+	for (;;) {
+		Clipboard clipboard[kClipboardEnd];
+		bool queued[kClipboardEnd];
+		{
+			Lock lock(m_mutex);
+			if (!m_clipboardPending) {
+				// done.  this is under the same lock as the check so the
+				// next leave() starts a new thread.
+				delete m_sendClipboardThread;
+				m_sendClipboardThread = NULL;
+				*m_condVar = false;
+				m_condVar->broadcast();
+				return;
+			}
+			m_clipboardPending = false;
+			for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+				queued[id] = m_clipboardQueued[id];
+				if (queued[id]) {
+					clipboard[id]          = m_captureClipboard[id];
+					m_captureClipboard[id] = Clipboard();
+					m_clipboardQueued[id]  = false;
+				}
+			}
+		}
+
+		// send clipboards that have changed
+		Stopwatch timer(false);
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			if (queued[id]) {
+				sendClipboard(id, &clipboard[id]);
+			}
+		}
+		LOG((CLOG_DEBUG1 "send took %fs", (double) timer.getTime()));
+	}
 }
 
 void
@@ -827,6 +964,13 @@ Client::handleStopRetry(const Event&, void*)
 	m_args.m_restartable = false;
 }
 
+void
+Client::handleOutputFlushed(const Event&, void*)
+{
+	// the server has taken everything sent so far
+	m_fileSendWindow->outputFlushed();
+}
+
 void
 Client::writeToDropDirThread(void*)
 {
@@ -837,7 +981,7 @@ Client::writeToDropDirThread(void*)
 	}
 	
 	DropHelper::writeToDir(m_screen->getDropTarget(), m_dragFileList,
-					m_receivedFileData);
+					*m_fileReceiver);
 }
 
 void
@@ -857,7 +1001,7 @@ Client::dragInfoReceived(UInt32 fileNum, String data)
 bool
 Client::isReceivedFileSizeValid()
 {
-	return m_expectedFileSize == m_receivedFileData.size();
+	return m_fileReceiver->isComplete();
 }
 
 void
@@ -866,7 +1010,9 @@ Client::sendFileToServer(const char* filename)
 	if (m_sendFileThread != NULL) {
 		StreamChunker::interruptFile();
 	}
-	
+
+	// nothing from an earlier transfer is in flight on a new one
+	m_fileSendWindow->reset();
 	m_sendFileThread = new Thread(
 		new TMethodJob<Client>(
 			this, &Client::sendFileThread,
@@ -878,7 +1024,7 @@ Client::sendFileThread(void* filename)
 {
 	try {
 		char* name  = reinterpret_cast<char*>(filename);
-		StreamChunker::sendFile(name, m_events, this);
+		StreamChunker::sendFile(name, m_events, this, m_fileSendWindow, true);
 	}
 	catch (std::runtime_error error) {
 		LOG((CLOG_ERR "failed sending file chunks: %s", error.what()));
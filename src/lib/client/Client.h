@@ -37,6 +37,8 @@ namespace synergy { class IStream; }
 class IEventQueue;
 class Thread;
 class TCPSocket;
+class FileReceiver;
+class FileSendWindow;
 
 //! Synergy client
 /*!
@@ -94,6 +96,19 @@ public:
 	
 	//! Send dragging file information back to server
 	void				sendDragInfo(UInt32 fileCount, String& info, size_t size);
+
+	//! Begin input batch
+	/*!
+	Input from the server until the matching \c endInputBatch() may be
+	held back by the screen and delivered all at once.
+	*/
+	void				beginInputBatch();
+
+	//! End input batch
+	/*!
+	Delivers input held back since \c beginInputBatch().
+	*/
+	void				endInputBatch();
 	
 	//@}
 	//! @name accessors
@@ -122,11 +137,8 @@ public:
 	//! Return true if recieved file size is valid
 	bool				isReceivedFileSizeValid();
 
-	//! Return expected file size
-	size_t&				getExpectedFileSize() { return m_expectedFileSize; }
-
-	//! Return received file data
-	String&				getReceivedFileData() { return m_receivedFileData; }
+	//! Return the file being received
+	FileReceiver&		getFileReceiver() { return *m_fileReceiver; }
 
 	//! Return drag file list
 	DragFileList		getDragFileList() { return m_dragFileList; }
@@ -163,6 +175,8 @@ public:
 	virtual String		getName() const;
 
 private:
+	void				captureClipboards();
+	void				fillClipboards();
 	void				fillClipboard(ClipboardID, Clipboard*);
 	void				sendClipboard(ClipboardID, Clipboard*);
 	void				sendEvent(Event::Type, void*);
@@ -186,12 +200,14 @@ private:
 	void				handleDisconnected(const Event&, void*);
 	void				handleShapeChanged(const Event&, void*);
 	void				handleClipboardGrabbed(const Event&, void*);
+	void				handleFillClipboards(const Event&, void*);
 	void				handleHello(const Event&, void*);
 	void				handleSuspend(const Event& event, void*);
 	void				handleResume(const Event& event, void*);
 	void				handleFileChunkSending(const Event&, void*);
 	void				handleFileRecieveCompleted(const Event&, void*);
 	void				handleStopRetry(const Event&, void*);
+	void				handleOutputFlushed(const Event&, void*);
 	void				onFileRecieveCompleted();
 	void				sendClipboardThread(void*);
 
@@ -215,17 +231,26 @@ private:
 	IClipboard::Time	m_timeClipboard[kClipboardEnd];
 	String				m_dataClipboard[kClipboardEnd];
 	IEventQueue*		m_events;
-	std::size_t			m_expectedFileSize;
-	String				m_receivedFileData;
+	FileReceiver*		m_fileReceiver;
 	DragFileList		m_dragFileList;
 	String				m_dragFileExt;
 	Thread*				m_sendFileThread;
+	FileSendWindow*		m_fileSendWindow;
 	Thread*				m_writeToDropDirThread;
 	TCPSocket*			m_socket;
 	bool				m_useSecureNetwork;
 	ClientArgs&			m_args;
 	Thread*				m_sendClipboardThread;
 	Mutex*				m_mutex;
-	bool				m_condData;
+
+	// true while the clipboard capture thread is running
 	CondVar<bool>*		m_condVar;
+
+	// clipboards read on the event thread waiting for the capture thread
+	// to send them.  these and the sent clipboard state are guarded by
+	// m_mutex.
+	bool				m_fillPending;
+	bool				m_clipboardPending;
+	bool				m_clipboardQueued[kClipboardEnd];
+	Clipboard			m_captureClipboard[kClipboardEnd];
 };
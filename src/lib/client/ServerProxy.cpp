@@ -24,16 +24,42 @@
 #include "synergy/StreamChunker.h"
 #include "synergy/Clipboard.h"
 #include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_messages.h"
 #include "synergy/option_types.h"
 #include "synergy/protocol_types.h"
 #include "io/IStream.h"
+#include "mt/Lock.h"
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
 #include "base/XBase.h"
+#include "arch/Arch.h"
 
 #include <memory>
 
+//
+// InputBatch
+//
+
+// holds back the input synthesized for a batch of messages so it goes
+// to the screen in one go, however handling the batch ends.  it keeps
+// the client rather than the proxy since disconnecting deletes the proxy.
+class InputBatch {
+public:
+	InputBatch(Client* client) : m_client(client)
+	{
+		m_client->beginInputBatch();
+	}
+
+	~InputBatch()
+	{
+		m_client->endInputBatch();
+	}
+
+private:
+	Client*				m_client;
+};
+
 //
 // ServerProxy
 //
@@ -49,6 +75,9 @@ ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue*
 	m_dxMouse(0),
 	m_dyMouse(0),
 	m_ignoreMouse(false),
+	m_traceID(0),
+	m_traceTime(0),
+	m_traceMoved(false),
 	m_keepAliveAlarm(0.0),
 	m_keepAliveAlarmTimer(NULL),
 	m_parser(&ServerProxy::parseHandshakeMessage),
@@ -61,6 +90,33 @@ ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue*
 	for (KeyModifierID id = 0; id < kKeyModifierIDLast; ++id)
 		m_modifierTranslationTable[id] = id;
 
+	// messages handled after the handshake
+	m_messages.set(kMsgDMouseMove, &ServerProxy::mouseMove);
+	m_messages.set(kMsgDMouseRelMove, &ServerProxy::mouseRelativeMove);
+	m_messages.set(kMsgDMouseWheel, &ServerProxy::mouseWheel);
+	m_messages.set(kMsgDKeyDown, &ServerProxy::keyDown);
+	m_messages.set(kMsgDKeyUp, &ServerProxy::keyUp);
+	m_messages.set(kMsgDMouseDown, &ServerProxy::mouseDown);
+	m_messages.set(kMsgDMouseUp, &ServerProxy::mouseUp);
+	m_messages.set(kMsgDKeyRepeat, &ServerProxy::keyRepeat);
+	m_messages.set(kMsgCKeepAlive, &ServerProxy::keepAliveReceived);
+	m_messages.set(kMsgCNoop, &ServerProxy::noop);
+	m_messages.set(kMsgCEnter, &ServerProxy::enter);
+	m_messages.set(kMsgCLeave, &ServerProxy::leave);
+	m_messages.set(kMsgCClipboard, &ServerProxy::grabClipboard);
+	m_messages.set(kMsgCScreenSaver, &ServerProxy::screensaver);
+	m_messages.set(kMsgQInfo, &ServerProxy::queryInfo);
+	m_messages.set(kMsgCInfoAck, &ServerProxy::infoAcknowledgment);
+	m_messages.set(kMsgDClipboard, &ServerProxy::setClipboard);
+	m_messages.set(kMsgDClipboardCached, &ServerProxy::setClipboardCached);
+	m_messages.set(kMsgCResetOptions, &ServerProxy::resetOptions);
+	m_messages.set(kMsgDSetOptions, &ServerProxy::setOptions);
+	m_messages.set(kMsgDFileTransfer, &ServerProxy::fileChunkReceived);
+	m_messages.set(kMsgDDragInfo, &ServerProxy::dragInfoReceived);
+	m_messages.set(kMsgDTraceMark, &ServerProxy::traceMark);
+	m_messages.set(kMsgCClose, &ServerProxy::close);
+	m_messages.set(kMsgEBad, &ServerProxy::protocolError);
+
 	// handle data on stream
 	m_events->adoptHandler(m_events->forIStream().inputReady(),
 							m_stream->getEventTarget(),
@@ -86,6 +142,12 @@ ServerProxy::~ServerProxy()
 void
 ServerProxy::resetKeepAliveAlarm()
 {
+	// push back the alarm in place if we can
+	if (m_keepAliveAlarmTimer != NULL && m_keepAliveAlarm > 0.0) {
+		m_events->resetTimer(m_keepAliveAlarmTimer, m_keepAliveAlarm);
+		return;
+	}
+
 	if (m_keepAliveAlarmTimer != NULL) {
 		m_events->removeHandler(Event::kTimer, m_keepAliveAlarmTimer);
 		m_events->deleteTimer(m_keepAliveAlarmTimer);
@@ -110,37 +172,45 @@ ServerProxy::setKeepAliveRate(double rate)
 void
 ServerProxy::handleData(const Event&, void*)
 {
-	// handle messages until there are no more.  first read message code.
-	UInt8 code[4];
-	UInt32 n = m_stream->read(code, 4);
-	while (n != 0) {
-		// verify we got an entire code
-		if (n != 4) {
-			LOG((CLOG_ERR "incomplete message from server: %d bytes", n));
-			m_client->disconnect("incomplete message from server");
-			return;
-		}
-
-		// parse message
-		LOG((CLOG_DEBUG2 "msg from server: %c%c%c%c", code[0], code[1], code[2], code[3]));
-		switch ((this->*m_parser)(code)) {
-		case kOkay:
-			break;
-
-		case kUnknown:
-			LOG((CLOG_ERR "invalid message from server: %c%c%c%c", code[0], code[1], code[2], code[3]));
-			m_client->disconnect("invalid message from server");
-			return;
-
-		case kDisconnect:
-			return;
+	// the input synthesized for these messages must reach the screen
+	// before the trace echo goes out
+	{
+		InputBatch batch(m_client);
+
+		// handle messages until there are no more.  first read message code.
+		UInt8 code[4];
+		UInt32 n = m_stream->read(code, 4);
+		while (n != 0) {
+			// verify we got an entire code
+			if (n != 4) {
+				LOG((CLOG_ERR "incomplete message from server: %d bytes", n));
+				m_client->disconnect("incomplete message from server");
+				return;
+			}
+
+			// parse message
+			LOG((CLOG_DEBUG2 "msg from server: %c%c%c%c", code[0], code[1], code[2], code[3]));
+			switch ((this->*m_parser)(code)) {
+			case kOkay:
+				break;
+
+			case kUnknown:
+				LOG((CLOG_ERR "invalid message from server: %c%c%c%c", code[0], code[1], code[2], code[3]));
+				m_client->disconnect("invalid message from server");
+				return;
+
+			case kDisconnect:
+				return;
+			}
+
+			// next message
+			n = m_stream->read(code, 4);
 		}
 
-		// next message
-		n = m_stream->read(code, 4);
+		flushCompressedMouse();
 	}
 
-	flushCompressedMouse();
+	sendTraceEcho();
 }
 
 ServerProxy::EResult
@@ -167,9 +237,7 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 	}
 
 	else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
-		// echo keep alives and reset alarm
-		ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
-		resetKeepAliveAlarm();
+		keepAlive();
 	}
 
 	else if (memcmp(code, kMsgCNoop, 4) == 0) {
@@ -177,16 +245,12 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 	}
 
 	else if (memcmp(code, kMsgCClose, 4) == 0) {
-		// server wants us to hangup
-		LOG((CLOG_DEBUG1 "recv close"));
-		m_client->disconnect(NULL);
-		return kDisconnect;
+		return close();
 	}
 
 	else if (memcmp(code, kMsgEIncompatible, 4) == 0) {
-		SInt32 major, minor;
-		ProtocolUtil::readf(m_stream,
-						kMsgEIncompatible + 4, &major, &minor);
+		SInt16 major, minor;
+		MsgEIncompatible::read(m_stream, &major, &minor);
 		LOG((CLOG_ERR "server has incompatible version %d.%d", major, minor));
 		m_client->disconnect("server has incompatible version");
 		return kDisconnect;
@@ -205,9 +269,7 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 	}
 
 	else if (memcmp(code, kMsgEBad, 4) == 0) {
-		LOG((CLOG_ERR "server disconnected due to a protocol error"));
-		m_client->disconnect("server reported a protocol error");
-		return kDisconnect;
+		return protocolError();
 	}
 	else {
 		return kUnknown;
@@ -219,102 +281,14 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 ServerProxy::EResult
 ServerProxy::parseMessage(const UInt8* code)
 {
-	if (memcmp(code, kMsgDMouseMove, 4) == 0) {
-		mouseMove();
-	}
-
-	else if (memcmp(code, kMsgDMouseRelMove, 4) == 0) {
-		mouseRelativeMove();
-	}
-
-	else if (memcmp(code, kMsgDMouseWheel, 4) == 0) {
-		mouseWheel();
-	}
-
-	else if (memcmp(code, kMsgDKeyDown, 4) == 0) {
-		keyDown();
-	}
-
-	else if (memcmp(code, kMsgDKeyUp, 4) == 0) {
-		keyUp();
-	}
-
-	else if (memcmp(code, kMsgDMouseDown, 4) == 0) {
-		mouseDown();
-	}
-
-	else if (memcmp(code, kMsgDMouseUp, 4) == 0) {
-		mouseUp();
-	}
-
-	else if (memcmp(code, kMsgDKeyRepeat, 4) == 0) {
-		keyRepeat();
-	}
-
-	else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
-		keepAlive();
-	}
-
-	else if (memcmp(code, kMsgCNoop, 4) == 0) {
-		// accept and discard no-op
-	}
-
-	else if (memcmp(code, kMsgCEnter, 4) == 0) {
-		enter();
-	}
-
-	else if (memcmp(code, kMsgCLeave, 4) == 0) {
-		leave();
-	}
-
-	else if (memcmp(code, kMsgCClipboard, 4) == 0) {
-		grabClipboard();
-	}
-
-	else if (memcmp(code, kMsgCScreenSaver, 4) == 0) {
-		screensaver();
-	}
-
-	else if (memcmp(code, kMsgQInfo, 4) == 0) {
-		queryInfo();
-	}
-
-	else if (memcmp(code, kMsgCInfoAck, 4) == 0) {
-		infoAcknowledgment();
-	}
-
-	else if (memcmp(code, kMsgDClipboard, 4) == 0) {
-		setClipboard();
-	}
-
-	else if (memcmp(code, kMsgCResetOptions, 4) == 0) {
-		resetOptions();
-	}
-
-	else if (memcmp(code, kMsgDSetOptions, 4) == 0) {
-		setOptions();
-	}
-
-	else if (memcmp(code, kMsgDFileTransfer, 4) == 0) {
-		fileChunkReceived();
-	}
-	else if (memcmp(code, kMsgDDragInfo, 4) == 0) {
-		dragInfoReceived();
+	MessageTable::Handler handler = m_messages.find(code);
+	if (handler == NULL) {
+		return kUnknown;
 	}
 
-	else if (memcmp(code, kMsgCClose, 4) == 0) {
-		// server wants us to hangup
-		LOG((CLOG_DEBUG1 "recv close"));
-		m_client->disconnect(NULL);
-		return kDisconnect;
-	}
-	else if (memcmp(code, kMsgEBad, 4) == 0) {
-		LOG((CLOG_ERR "server disconnected due to a protocol error"));
-		m_client->disconnect("server reported a protocol error");
-		return kDisconnect;
-	}
-	else {
-		return kUnknown;
+	EResult result = (this->*handler)();
+	if (result != kOkay) {
+		return result;
 	}
 
 	// send a reply.  this is intended to work around a delay when
@@ -324,7 +298,7 @@ ServerProxy::parseMessage(const UInt8* code)
 	// on a data packet.  we provide that packet here.  i don't
 	// know why a delayed ACK should cause the server to wait since
 	// TCP_NODELAY is enabled.
-	ProtocolUtil::writef(m_stream, kMsgCNoop);
+	MsgCNoop::write(m_stream);
 
 	return kOkay;
 }
@@ -351,7 +325,7 @@ bool
 ServerProxy::onGrabClipboard(ClipboardID id)
 {
 	LOG((CLOG_DEBUG1 "sending clipboard %d changed", id));
-	ProtocolUtil::writef(m_stream, kMsgCClipboard, id, m_seqNum);
+	MsgCClipboard::write(m_stream, id, m_seqNum);
 	return true;
 }
 
@@ -361,7 +335,16 @@ ServerProxy::onClipboardChanged(ClipboardID id, const IClipboard* clipboard)
 	String data = IClipboard::marshall(clipboard);
 	LOG((CLOG_DEBUG "sending clipboard %d seqnum=%d", id, m_seqNum));
 
-	StreamChunker::sendClipboard(data, data.size(), id, m_seqNum, m_events, this);
+	// the server remembers what we send it
+	{
+		Lock lock(&m_clipboardMutex);
+		m_clipboardCache[id].unmarshall(data, 0);
+	}
+
+	// servers we connect to are never older than us so they all take
+	// compressed chunks
+	StreamChunker::sendClipboard(data, data.size(), id, m_seqNum,
+							m_events, this, true);
 
 	LOG((CLOG_DEBUG "sent clipboard size=%d", data.size()));
 }
@@ -381,11 +364,26 @@ ServerProxy::flushCompressedMouse()
 	}
 }
 
+void
+ServerProxy::sendTraceEcho()
+{
+	if (m_traceID == 0 || !m_traceMoved) {
+		return;
+	}
+
+	// the move has reached the screen
+	UInt64 elapsed = ARCH->nanoseconds() - m_traceTime;
+	MsgDTraceEcho::write(m_stream, m_traceID,
+							static_cast<UInt32>(elapsed / 1000));
+	m_traceID    = 0;
+	m_traceMoved = false;
+}
+
 void
 ServerProxy::sendInfo(const ClientInfo& info)
 {
 	LOG((CLOG_DEBUG1 "sending info shape=%d,%d %dx%d", info.m_x, info.m_y, info.m_w, info.m_h));
-	ProtocolUtil::writef(m_stream, kMsgDInfo,
+	MsgDInfo::write(m_stream,
 								info.m_x, info.m_y,
 								info.m_w, info.m_h, 0,
 								info.m_mx, info.m_my);
@@ -511,14 +509,14 @@ ServerProxy::translateModifierMask(KeyModifierMask mask) const
 	return newMask;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::enter()
 {
 	// parse
 	SInt16 x, y;
 	UInt16 mask;
 	UInt32 seqNum;
-	ProtocolUtil::readf(m_stream, kMsgCEnter + 4, &x, &y, &seqNum, &mask);
+	MsgCEnter::read(m_stream, &x, &y, &seqNum, &mask);
 	LOG((CLOG_DEBUG1 "recv enter, %d,%d %d %04x", x, y, seqNum, mask));
 
 	// discard old compressed mouse motion, if any
@@ -530,9 +528,11 @@ ServerProxy::enter()
 
 	// forward
 	m_client->enter(x, y, seqNum, static_cast<KeyModifierMask>(mask), false);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::leave()
 {
 	// parse
@@ -543,9 +543,11 @@ ServerProxy::leave()
 
 	// forward
 	m_client->leave();
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::setClipboard()
 {
 	// parse
@@ -562,34 +564,68 @@ ServerProxy::setClipboard()
 	else if (r == kFinish) {
 		LOG((CLOG_DEBUG "received clipboard %d size=%d", id, dataCached.size()));
 		
-		// forward
-		Clipboard clipboard;
-		clipboard.unmarshall(dataCached, 0);
-		m_client->setClipboard(id, &clipboard);
+		// keep it and forward
+		Lock lock(&m_clipboardMutex);
+		m_clipboardCache[id].unmarshall(dataCached, 0);
+		m_client->setClipboard(id, &m_clipboardCache[id]);
 
 		LOG((CLOG_INFO "clipboard was updated"));
 	}
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
+ServerProxy::setClipboardCached()
+{
+	// parse
+	ClipboardID id;
+	UInt32 seq;
+	Clipboard::Hash hash;
+	MsgDClipboardCached::read(m_stream, &id, &seq, &hash.m_high, &hash.m_low);
+	LOG((CLOG_DEBUG "recv cached clipboard %d", id));
+
+	// validate
+	if (id >= kClipboardEnd) {
+		return kOkay;
+	}
+
+	Lock lock(&m_clipboardMutex);
+	if (m_clipboardCache[id].getHash() != hash) {
+		// we don't have it after all.  ask for the data.
+		LOG((CLOG_DEBUG "cached clipboard %d is missing", id));
+		MsgCClipboardMissing::write(m_stream, id, hash.m_high, hash.m_low);
+		return kOkay;
+	}
+
+	// forward
+	m_client->setClipboard(id, &m_clipboardCache[id]);
+
+	LOG((CLOG_INFO "clipboard was updated from cache"));
+	return kOkay;
+}
+
+ServerProxy::EResult
 ServerProxy::grabClipboard()
 {
 	// parse
 	ClipboardID id;
 	UInt32 seqNum;
-	ProtocolUtil::readf(m_stream, kMsgCClipboard + 4, &id, &seqNum);
+	MsgCClipboard::read(m_stream, &id, &seqNum);
 	LOG((CLOG_DEBUG "recv grab clipboard %d", id));
 
 	// validate
 	if (id >= kClipboardEnd) {
-		return;
+		return kOkay;
 	}
 
 	// forward
 	m_client->grabClipboard(id);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::keyDown()
 {
 	// get mouse up to date
@@ -597,7 +633,7 @@ ServerProxy::keyDown()
 
 	// parse
 	UInt16 id, mask, button;
-	ProtocolUtil::readf(m_stream, kMsgDKeyDown + 4, &id, &mask, &button);
+	MsgDKeyDown::read(m_stream, &id, &mask, &button);
 	LOG((CLOG_DEBUG1 "recv key down id=0x%08x, mask=0x%04x, button=0x%04x", id, mask, button));
 
 	// translate
@@ -610,9 +646,11 @@ ServerProxy::keyDown()
 
 	// forward
 	m_client->keyDown(id2, mask2, button);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::keyRepeat()
 {
 	// get mouse up to date
@@ -620,7 +658,7 @@ ServerProxy::keyRepeat()
 
 	// parse
 	UInt16 id, mask, count, button;
-	ProtocolUtil::readf(m_stream, kMsgDKeyRepeat + 4,
+	MsgDKeyRepeat::read(m_stream,
 								&id, &mask, &count, &button);
 	LOG((CLOG_DEBUG1 "recv key repeat id=0x%08x, mask=0x%04x, count=%d, button=0x%04x", id, mask, count, button));
 
@@ -634,9 +672,11 @@ ServerProxy::keyRepeat()
 
 	// forward
 	m_client->keyRepeat(id2, mask2, count, button);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::keyUp()
 {
 	// get mouse up to date
@@ -644,7 +684,7 @@ ServerProxy::keyUp()
 
 	// parse
 	UInt16 id, mask, button;
-	ProtocolUtil::readf(m_stream, kMsgDKeyUp + 4, &id, &mask, &button);
+	MsgDKeyUp::read(m_stream, &id, &mask, &button);
 	LOG((CLOG_DEBUG1 "recv key up id=0x%08x, mask=0x%04x, button=0x%04x", id, mask, button));
 
 	// translate
@@ -657,9 +697,11 @@ ServerProxy::keyUp()
 
 	// forward
 	m_client->keyUp(id2, mask2, button);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::mouseDown()
 {
 	// get mouse up to date
@@ -667,14 +709,16 @@ ServerProxy::mouseDown()
 
 	// parse
 	SInt8 id;
-	ProtocolUtil::readf(m_stream, kMsgDMouseDown + 4, &id);
+	MsgDMouseDown::read(m_stream, &id);
 	LOG((CLOG_DEBUG1 "recv mouse down id=%d", id));
 
 	// forward
 	m_client->mouseDown(static_cast<ButtonID>(id));
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::mouseUp()
 {
 	// get mouse up to date
@@ -682,20 +726,25 @@ ServerProxy::mouseUp()
 
 	// parse
 	SInt8 id;
-	ProtocolUtil::readf(m_stream, kMsgDMouseUp + 4, &id);
+	MsgDMouseUp::read(m_stream, &id);
 	LOG((CLOG_DEBUG1 "recv mouse up id=%d", id));
 
 	// forward
 	m_client->mouseUp(static_cast<ButtonID>(id));
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::mouseMove()
 {
 	// parse
 	bool ignore;
 	SInt16 x, y;
-	ProtocolUtil::readf(m_stream, kMsgDMouseMove + 4, &x, &y);
+	MsgDMouseMove::read(m_stream, &x, &y);
+	if (m_traceID != 0) {
+		m_traceMoved = true;
+	}
 
 	// note if we should ignore the move
 	ignore = m_ignoreMouse;
@@ -720,15 +769,20 @@ ServerProxy::mouseMove()
 	if (!ignore) {
 		m_client->mouseMove(x, y);
 	}
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::mouseRelativeMove()
 {
 	// parse
 	bool ignore;
 	SInt16 dx, dy;
-	ProtocolUtil::readf(m_stream, kMsgDMouseRelMove + 4, &dx, &dy);
+	MsgDMouseRelMove::read(m_stream, &dx, &dy);
+	if (m_traceID != 0) {
+		m_traceMoved = true;
+	}
 
 	// note if we should ignore the move
 	ignore = m_ignoreMouse;
@@ -750,9 +804,11 @@ ServerProxy::mouseRelativeMove()
 	if (!ignore) {
 		m_client->mouseRelativeMove(dx, dy);
 	}
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::mouseWheel()
 {
 	// get mouse up to date
@@ -760,26 +816,30 @@ ServerProxy::mouseWheel()
 
 	// parse
 	SInt16 xDelta, yDelta;
-	ProtocolUtil::readf(m_stream, kMsgDMouseWheel + 4, &xDelta, &yDelta);
+	MsgDMouseWheel::read(m_stream, &xDelta, &yDelta);
 	LOG((CLOG_DEBUG2 "recv mouse wheel %+d,%+d", xDelta, yDelta));
 
 	// forward
 	m_client->mouseWheel(xDelta, yDelta);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::screensaver()
 {
 	// parse
 	SInt8 on;
-	ProtocolUtil::readf(m_stream, kMsgCScreenSaver + 4, &on);
+	MsgCScreenSaver::read(m_stream, &on);
 	LOG((CLOG_DEBUG1 "recv screen saver on=%d", on));
 
 	// forward
 	m_client->screensaver(on != 0);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::resetOptions()
 {
 	// parse
@@ -795,9 +855,11 @@ ServerProxy::resetOptions()
 	for (KeyModifierID id = 0; id < kKeyModifierIDLast; ++id) {
 		m_modifierTranslationTable[id] = id;
 	}
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::setOptions()
 {
 	// parse
@@ -839,31 +901,36 @@ ServerProxy::setOptions()
 			LOG((CLOG_DEBUG1 "modifier %d mapped to %d", id, m_modifierTranslationTable[id]));
 		}
 	}
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::queryInfo()
 {
 	ClientInfo info;
 	m_client->getShape(info.m_x, info.m_y, info.m_w, info.m_h);
 	m_client->getCursorPos(info.m_mx, info.m_my);
 	sendInfo(info);
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::infoAcknowledgment()
 {
 	LOG((CLOG_DEBUG1 "recv info acknowledgment"));
 	m_ignoreMouse = false;
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::fileChunkReceived()
 {
 	int result = FileChunk::assemble(
 					m_stream,
-					m_client->getReceivedFileData(),
-					m_client->getExpectedFileSize());
+					m_client->getFileReceiver());
 
 	if (result == kFinish) {
 		m_events->addEvent(Event(m_events->forFile().fileRecieveCompleted(), m_client));
@@ -874,9 +941,11 @@ ServerProxy::fileChunkReceived()
 			LOG((CLOG_DEBUG "start receiving %s", filename.c_str()));
 		}
 	}
+
+	return kOkay;
 }
 
-void
+ServerProxy::EResult
 ServerProxy::dragInfoReceived()
 {
 	// parse
@@ -885,6 +954,22 @@ ServerProxy::dragInfoReceived()
 	ProtocolUtil::readf(m_stream, kMsgDDragInfo + 4, &fileNum, &content);
 
 	m_client->dragInfoReceived(fileNum, content);
+
+	return kOkay;
+}
+
+ServerProxy::EResult
+ServerProxy::traceMark()
+{
+	// parse.  the move this mark is for follows it.
+	UInt32 id;
+	MsgDTraceMark::read(m_stream, &id);
+	LOG((CLOG_DEBUG2 "recv trace mark %u", id));
+
+	m_traceID    = id;
+	m_traceTime  = ARCH->nanoseconds();
+	m_traceMoved = false;
+	return kOkay;
 }
 
 void
@@ -897,10 +982,41 @@ ServerProxy::handleClipboardSendingEvent(const Event& event, void*)
 void ServerProxy::keepAlive()
 {
 	// echo keep alives and reset alarm
-	ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
+	MsgCKeepAlive::write(m_stream);
 	resetKeepAliveAlarm();
 }
 
+ServerProxy::EResult
+ServerProxy::keepAliveReceived()
+{
+	keepAlive();
+	return kOkay;
+}
+
+ServerProxy::EResult
+ServerProxy::noop()
+{
+	// accept and discard no-op
+	return kOkay;
+}
+
+ServerProxy::EResult
+ServerProxy::close()
+{
+	// server wants us to hangup
+	LOG((CLOG_DEBUG1 "recv close"));
+	m_client->disconnect(NULL);
+	return kDisconnect;
+}
+
+ServerProxy::EResult
+ServerProxy::protocolError()
+{
+	LOG((CLOG_ERR "server disconnected due to a protocol error"));
+	m_client->disconnect("server reported a protocol error");
+	return kDisconnect;
+}
+
 void
 ServerProxy::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
 {
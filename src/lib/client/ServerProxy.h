@@ -18,8 +18,11 @@
 
 #pragma once
 
+#include "synergy/Clipboard.h"
 #include "synergy/clipboard_types.h"
 #include "synergy/key_types.h"
+#include "synergy/TMessageTable.h"
+#include "mt/Mutex.h"
 #include "base/Event.h"
 #include "base/Stopwatch.h"
 #include "base/String.h"
@@ -73,6 +76,9 @@ private:
 	// if compressing mouse motion then send the last motion now
 	void				flushCompressedMouse();
 
+	// answer a traced mouse move once it's been synthesized
+	void				sendTraceEcho();
+
 	void				sendInfo(const ClientInfo&);
 
 	void				resetKeepAliveAlarm();
@@ -87,30 +93,37 @@ private:
 	void				handleKeepAliveAlarm(const Event&, void*);
 
 	// message handlers
-	void				enter();
-	void				leave();
-	void				setClipboard();
-	void				grabClipboard();
-	void				keyDown();
-	void				keyRepeat();
-	void				keyUp();
-	void				mouseDown();
-	void				mouseUp();
-	void				mouseMove();
-	void				mouseRelativeMove();
-	void				mouseWheel();
-	void				screensaver();
-	void				resetOptions();
-	void				setOptions();
-	void				queryInfo();
-	void				infoAcknowledgment();
-	void				fileChunkReceived();
-	void				dragInfoReceived();
+	EResult				enter();
+	EResult				leave();
+	EResult				setClipboard();
+	EResult				setClipboardCached();
+	EResult				grabClipboard();
+	EResult				keyDown();
+	EResult				keyRepeat();
+	EResult				keyUp();
+	EResult				mouseDown();
+	EResult				mouseUp();
+	EResult				mouseMove();
+	EResult				mouseRelativeMove();
+	EResult				mouseWheel();
+	EResult				screensaver();
+	EResult				resetOptions();
+	EResult				setOptions();
+	EResult				queryInfo();
+	EResult				infoAcknowledgment();
+	EResult				fileChunkReceived();
+	EResult				dragInfoReceived();
+	EResult				traceMark();
+	EResult				keepAliveReceived();
+	EResult				noop();
+	EResult				close();
+	EResult				protocolError();
 	void				handleClipboardSendingEvent(const Event&, void*);
 	void				keepAlive();
 
 private:
 	typedef EResult (ServerProxy::*MessageParser)(const UInt8*);
+	typedef TMessageTable<ServerProxy, EResult> MessageTable;
 
 	Client*			m_client;
 	synergy::IStream*	m_stream;
@@ -124,11 +137,24 @@ private:
 
 	bool				m_ignoreMouse;
 
+	// the latency sample the server marked, when we read the mark and
+	// whether the move it's for has been read
+	UInt32				m_traceID;
+	UInt64				m_traceTime;
+	bool				m_traceMoved;
+
 	KeyModifierID		m_modifierTranslationTable[kKeyModifierIDLast];
 
 	double				m_keepAliveAlarm;
 	EventQueueTimer*	m_keepAliveAlarmTimer;
 
 	MessageParser		m_parser;
+	MessageTable		m_messages;
+
+	// the last clipboard sent or received for each identifier.  the
+	// server can tell us to use one instead of sending it again.
+	Mutex				m_clipboardMutex;
+	Clipboard			m_clipboardCache[kClipboardEnd];
+
 	IEventQueue*		m_events;
 };
@@ -45,6 +45,14 @@
 #	else
 #		define TYPE_OF_SIZE_4 long
 #	endif
+#endif
+
+#if !defined(TYPE_OF_SIZE_8)
+#	if defined(_MSC_VER)
+#		define TYPE_OF_SIZE_8 __int64
+#	else
+#		define TYPE_OF_SIZE_8 long long
+#	endif
 #endif
 
 	//
@@ -60,6 +68,9 @@
 #if !defined(TYPE_OF_SIZE_4)
 #	error No 4 byte integer type
 #endif
+#if !defined(TYPE_OF_SIZE_8)
+#	error No 8 byte integer type
+#endif
 
 
 //
@@ -81,6 +92,8 @@ typedef signed TYPE_OF_SIZE_4	SInt32;
 typedef unsigned TYPE_OF_SIZE_1	UInt8;
 typedef unsigned TYPE_OF_SIZE_2	UInt16;
 typedef unsigned TYPE_OF_SIZE_4	UInt32;
+typedef signed TYPE_OF_SIZE_8	SInt64;
+typedef unsigned TYPE_OF_SIZE_8	UInt64;
 #endif
 #endif
 //
@@ -90,3 +103,4 @@ typedef unsigned TYPE_OF_SIZE_4	UInt32;
 #undef TYPE_OF_SIZE_1
 #undef TYPE_OF_SIZE_2
 #undef TYPE_OF_SIZE_4
+#undef TYPE_OF_SIZE_8
@@ -65,6 +65,19 @@ public:
 	*/
 	virtual void		write(const void* buffer, UInt32 n) = 0;
 
+	//! Write bulk data to stream
+	/*!
+	Like \c write() but for bulk data such as file and clipboard chunks.
+	Streams that keep bulk data in a separate lane send data written with
+	\c write() ahead of any bulk data that hasn't started going out, and
+	never split the \c n bytes written here with other data.  Streams
+	without a bulk lane simply write the data.
+	*/
+	virtual void		writeBulk(const void* buffer, UInt32 n)
+	{
+		write(buffer, n);
+	}
+
 	//! Flush the stream
 	/*!
 	Waits until all buffered data has been written to the stream.
@@ -0,0 +1,98 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "io/OutputLanes.h"
+
+//
+// OutputLanes
+//
+
+OutputLanes::OutputLanes(UInt32 sliceSize) :
+	m_sliceSize(sliceSize)
+{
+	// do nothing
+}
+
+OutputLanes::~OutputLanes()
+{
+	// do nothing
+}
+
+void
+OutputLanes::write(const void* data, UInt32 n)
+{
+	m_output.write(data, n);
+}
+
+void
+OutputLanes::writeBulk(const void* data, UInt32 n)
+{
+	if (n == 0) {
+		return;
+	}
+	m_bulk.write(data, n);
+	m_units.push_back(n);
+}
+
+StreamBuffer&
+OutputLanes::next()
+{
+	if (m_output.getSize() != 0) {
+		return m_output;
+	}
+
+	// move whole units until there's a slice to send
+	while (!m_units.empty() && m_output.getSize() < m_sliceSize) {
+		UInt32 n = m_units.front();
+		m_units.pop_front();
+
+		// the unit may wrap around the end of the ring
+		while (n > 0) {
+			IArchNetwork::WriteBuffer buf;
+			m_bulk.peekChunks(&buf, 1);
+			UInt32 size = static_cast<UInt32>(buf.m_size);
+			if (size > n) {
+				size = n;
+			}
+			m_output.write(buf.m_data, size);
+			m_bulk.pop(size);
+			n -= size;
+		}
+	}
+	return m_output;
+}
+
+void
+OutputLanes::clear()
+{
+	m_output.pop(m_output.getSize());
+	m_bulk.pop(m_bulk.getSize());
+	m_units.clear();
+}
+
+UInt32
+OutputLanes::getSize() const
+{
+	return m_output.getSize() + m_bulk.getSize();
+}
+
+UInt32
+OutputLanes::getBulkSize() const
+{
+	return m_bulk.getSize();
+}
@@ -0,0 +1,104 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "io/StreamBuffer.h"
+#include "common/stddeque.h"
+
+//! Output buffer with priority lanes
+/*!
+Holds a stream's output in two lanes.  Data in the normal lane, such as
+input events and control messages, goes out ahead of any bulk data that
+hasn't started going out yet.  Bulk data is written in units, typically
+whole packets, which normal data never splits.  Units are moved to the
+outgoing buffer a slice at a time and only once it has drained, so
+normal data waits behind at most one slice of bulk data.
+*/
+class OutputLanes {
+public:
+	enum {
+		//! Default bulk slice size
+		kDefaultSliceSize = 64 * 1024
+	};
+
+	/*!
+	Bulk units are moved to the outgoing buffer until it holds at least
+	\p sliceSize bytes.  A unit is never split, so a slice may be larger
+	when units are.
+	*/
+	OutputLanes(UInt32 sliceSize = kDefaultSliceSize);
+	~OutputLanes();
+
+	//! @name manipulators
+	//@{
+
+	//! Write to the normal lane
+	/*!
+	Appends \p n bytes from \p data to the outgoing buffer.
+	*/
+	void				write(const void* data, UInt32 n);
+
+	//! Write to the bulk lane
+	/*!
+	Appends \p n bytes from \p data to the bulk lane as one unit.
+	*/
+	void				writeBulk(const void* data, UInt32 n);
+
+	//! Get the outgoing buffer
+	/*!
+	Returns the buffer to send from.  If it's empty then the next slice
+	of bulk data is moved into it first.  The caller pops what it sends.
+	*/
+	StreamBuffer&		next();
+
+	//! Discard all data
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get size
+	/*!
+	Returns the number of bytes waiting in both lanes.
+	*/
+	UInt32				getSize() const;
+
+	//! Get bulk size
+	/*!
+	Returns the number of bulk bytes not yet moved to the outgoing
+	buffer.
+	*/
+	UInt32				getBulkSize() const;
+
+	//@}
+
+private:
+	// not implemented
+	OutputLanes(const OutputLanes&);
+	OutputLanes&		operator=(const OutputLanes&);
+
+private:
+	typedef std::deque<UInt32> UnitSizes;
+
+	UInt32				m_sliceSize;
+	StreamBuffer		m_output;
+	StreamBuffer		m_bulk;
+	UnitSizes			m_units;
+};
@@ -18,22 +18,29 @@
 
 #include "io/StreamBuffer.h"
 
+#include <cstring>
+#include <new>
+
 //
 // StreamBuffer
 //
 
-const UInt32			StreamBuffer::kChunkSize = 4096;
+const UInt32			StreamBuffer::kMinCapacity     = 4096;
+const UInt32			StreamBuffer::kMaxIdleCapacity = 65536;
+const UInt32			StreamBuffer::kMaxCapacity     = 0x80000000u;
 
 StreamBuffer::StreamBuffer() :
-	m_size(0),
-	m_headUsed(0)
+	m_data(NULL),
+	m_capacity(0),
+	m_head(0),
+	m_size(0)
 {
 	// do nothing
 }
 
 StreamBuffer::~StreamBuffer()
 {
-	// do nothing
+	delete[] m_data;
 }
 
 const void*
@@ -42,54 +49,38 @@ StreamBuffer::peek(UInt32 n)
 	assert(n <= m_size);
 
 	// if requesting no data then return NULL so we don't try to access
-	// an empty list.
+	// an empty buffer.
 	if (n == 0) {
 		return NULL;
 	}
 
-	// reserve space in first chunk
-	ChunkList::iterator head = m_chunks.begin();
-	head->reserve(n + m_headUsed);
-
-	// consolidate chunks into the first chunk until it has n bytes
-	ChunkList::iterator scan = head;
-	++scan;
-	while (head->size() - m_headUsed < n && scan != m_chunks.end()) {
-		head->insert(head->end(), scan->begin(), scan->end());
-		scan = m_chunks.erase(scan);
+	// move the data to the start of the ring if the bytes wrap around
+	// its end.  this happens at most once per wrap.
+	if (m_head + n > m_capacity) {
+		reallocate(m_capacity);
 	}
 
-	return reinterpret_cast<const void*>(&(head->begin()[m_headUsed]));
+	return m_data + m_head;
 }
 
 void
 StreamBuffer::pop(UInt32 n)
 {
-	// discard all chunks if n is greater than or equal to m_size
+	// discard everything if n is greater than or equal to m_size.  a
+	// large ring isn't kept around while it's idle.
 	if (n >= m_size) {
-		m_size     = 0;
-		m_headUsed = 0;
-		m_chunks.clear();
+		m_head = 0;
+		m_size = 0;
+		if (m_capacity > kMaxIdleCapacity) {
+			delete[] m_data;
+			m_data     = NULL;
+			m_capacity = 0;
+		}
 		return;
 	}
 
-	// update size
+	m_head  = (m_head + n) & (m_capacity - 1);
 	m_size -= n;
-
-	// discard chunks until more than n bytes would've been discarded
-	ChunkList::iterator scan = m_chunks.begin();
-	assert(scan != m_chunks.end());
-	while (scan->size() - m_headUsed <= n) {
-		n         -= (UInt32)scan->size() - m_headUsed;
-		m_headUsed = 0;
-		scan       = m_chunks.erase(scan);
-		assert(scan != m_chunks.end());
-	}
-
-	// remove left over bytes from the head chunk
-	if (n > 0) {
-		m_headUsed += n;
-	}
 }
 
 void
@@ -97,50 +88,91 @@ StreamBuffer::write(const void* vdata, UInt32 n)
 {
 	assert(vdata != NULL);
 
-	// ignore if no data, otherwise update size
+	// ignore if no data
 	if (n == 0) {
 		return;
 	}
-	m_size += n;
+	if (n > kMaxCapacity - m_size) {
+		throw std::bad_alloc();
+	}
+	reserve(m_size + n);
 
-	// cast data to bytes
+	// copy up to the end of the ring then wrap around to the start
 	const UInt8* data = reinterpret_cast<const UInt8*>(vdata);
+	UInt32 tail  = (m_head + m_size) & (m_capacity - 1);
+	UInt32 count = m_capacity - tail;
+	if (count > n) {
+		count = n;
+	}
+	memcpy(m_data + tail, data, count);
+	memcpy(m_data, data + count, n - count);
+	m_size += n;
+}
 
-	// point to last chunk if it has space, otherwise append an empty chunk
-	ChunkList::iterator scan = m_chunks.end();
-	if (scan != m_chunks.begin()) {
-		--scan;
-		if (scan->size() >= kChunkSize) {
-			++scan;
-		}
+UInt32
+StreamBuffer::getSize() const
+{
+	return m_size;
+}
+
+UInt32
+StreamBuffer::peekChunks(IArchNetwork::WriteBuffer* bufs, UInt32 num) const
+{
+	if (m_size == 0 || num == 0) {
+		return 0;
+	}
+
+	// the data is in one piece unless it wraps around the end of the ring
+	UInt32 first = m_capacity - m_head;
+	if (first >= m_size) {
+		bufs[0].m_data = m_data + m_head;
+		bufs[0].m_size = m_size;
+		return 1;
 	}
-	if (scan == m_chunks.end()) {
-		scan = m_chunks.insert(scan, Chunk());
+	bufs[0].m_data = m_data + m_head;
+	bufs[0].m_size = first;
+	if (num == 1) {
+		return 1;
 	}
+	bufs[1].m_data = m_data;
+	bufs[1].m_size = m_size - first;
+	return 2;
+}
 
-	// append data in chunks
-	while (n > 0) {
-		// choose number of bytes for next chunk
-		assert(scan->size() <= kChunkSize);
-		UInt32 count = kChunkSize - (UInt32)scan->size();
-		if (count > n)
-			count = n;
-
-		// transfer data
-		scan->insert(scan->end(), data, data + count);
-		n    -= count;
-		data += count;
-
-		// append another empty chunk if we're not done yet
-		if (n > 0) {
-			++scan;
-			scan = m_chunks.insert(scan, Chunk());
-		}
+void
+StreamBuffer::reserve(UInt32 n)
+{
+	if (n <= m_capacity) {
+		return;
 	}
+
+	// grow to the next power of two.  the largest one that fits in a
+	// UInt32 is the limit.
+	if (n > kMaxCapacity) {
+		throw std::bad_alloc();
+	}
+	UInt32 capacity = (m_capacity == 0) ? kMinCapacity : m_capacity;
+	while (capacity < n) {
+		capacity <<= 1;
+	}
+	reallocate(capacity);
 }
 
-UInt32
-StreamBuffer::getSize() const
+void
+StreamBuffer::reallocate(UInt32 capacity)
 {
-	return m_size;
+	// copy the data to the start of a new ring
+	UInt8* data = new UInt8[capacity];
+	IArchNetwork::WriteBuffer bufs[2];
+	UInt32 num = peekChunks(bufs, 2);
+	UInt8* dst = data;
+	for (UInt32 i = 0; i < num; ++i) {
+		memcpy(dst, bufs[i].m_data, bufs[i].m_size);
+		dst += bufs[i].m_size;
+	}
+
+	delete[] m_data;
+	m_data     = data;
+	m_capacity = capacity;
+	m_head     = 0;
 }
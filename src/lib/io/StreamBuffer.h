@@ -19,12 +19,14 @@
 #pragma once
 
 #include "base/EventTypes.h"
-#include "common/stdlist.h"
-#include "common/stdvector.h"
+#include "arch/IArchNetwork.h"
 
 //! FIFO of bytes
 /*!
-This class maintains a FIFO (first-in, last-out) buffer of bytes.
+This class maintains a FIFO (first-in, last-out) buffer of bytes.  The
+bytes are kept in a ring whose size is a power of two and which doubles
+when it fills, so writing and popping don't copy existing data except
+when growing.
 */
 class StreamBuffer {
 public:
@@ -38,7 +40,8 @@ public:
 	/*!
 	Return a pointer to memory with the next \c n bytes in the buffer
 	(which must be <= getSize()).  The caller must not modify the returned
-	memory nor delete it.
+	memory nor delete it.  If the bytes wrap around the end of the ring
+	then all of the data is first moved so it's contiguous.
 	*/
 	const void*			peek(UInt32 n);
 
@@ -51,7 +54,8 @@ public:
 
 	//! Write data to buffer
 	/*!
-	Appends \c n bytes from \c data to the buffer.
+	Appends \c n bytes from \c data to the buffer.  Throws
+	\c std::bad_alloc if the buffer would hold more than 2GB.
 	*/
 	void				write(const void* data, UInt32 n);
 
@@ -65,15 +69,33 @@ public:
 	*/
 	UInt32				getSize() const;
 
+	//! Get data as it's stored
+	/*!
+	Fills up to \c num entries of \c bufs with the buffer's data, in
+	order, without copying or consolidating it, and returns the number
+	of entries filled.  At most two entries are needed.  The pointers
+	are valid until the buffer is next changed.
+	*/
+	UInt32				peekChunks(IArchNetwork::WriteBuffer* bufs,
+							UInt32 num) const;
+
 	//@}
 
 private:
-	static const UInt32	kChunkSize;
+	// not implemented
+	StreamBuffer(const StreamBuffer&);
+	StreamBuffer&		operator=(const StreamBuffer&);
 
-	typedef std::vector<UInt8> Chunk;
-	typedef std::list<Chunk> ChunkList;
+	void				reserve(UInt32 n);
+	void				reallocate(UInt32 capacity);
+
+private:
+	static const UInt32	kMinCapacity;
+	static const UInt32	kMaxIdleCapacity;
+	static const UInt32	kMaxCapacity;
 
-	ChunkList			m_chunks;
+	UInt8*				m_data;
+	UInt32				m_capacity;
+	UInt32				m_head;
 	UInt32				m_size;
-	UInt32				m_headUsed;
 };
@@ -62,6 +62,12 @@ StreamFilter::write(const void* buffer, UInt32 n)
 	getStream()->write(buffer, n);
 }
 
+void
+StreamFilter::writeBulk(const void* buffer, UInt32 n)
+{
+	getStream()->writeBulk(buffer, n);
+}
+
 void
 StreamFilter::flush()
 {
@@ -42,6 +42,7 @@ public:
 	virtual void		close();
 	virtual UInt32		read(void* buffer, UInt32 n);
 	virtual void		write(const void* buffer, UInt32 n);
+	virtual void		writeBulk(const void* buffer, UInt32 n);
 	virtual void		flush();
 	virtual void		shutdownInput();
 	virtual void		shutdownOutput();
@@ -26,6 +26,7 @@ enum EIpcMessage {
 	kIpcLogLine,
 	kIpcCommand,
 	kIpcShutdown,
+	kIpcLatencyReport,
 };
 
 enum EIpcClientType {
@@ -50,3 +51,7 @@ extern const char*		kIpcMsgCommand;
 // shutdown: daemon -> node
 // the daemon tells synergys/c to shut down gracefully.
 extern const char*		kIpcMsgShutdown;
+
+// latency report: node -> daemon -> gui
+// $1 = input latency report from synergys, when it's tracing latency.
+extern const char*		kIpcMsgLatencyReport;
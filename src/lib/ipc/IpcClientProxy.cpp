@@ -117,6 +117,9 @@ IpcClientProxy::handleData(const Event&, void*)
 		else if (memcmp(code, kIpcMsgCommand, 4) == 0) {
 			m = parseCommand();
 		}
+		else if (memcmp(code, kIpcMsgLatencyReport, 4) == 0) {
+			m = parseLatencyReport();
+		}
 		else {
 			LOG((CLOG_ERR "invalid ipc message"));
 			disconnect();
@@ -155,6 +158,13 @@ IpcClientProxy::send(const IpcMessage& message)
 		ProtocolUtil::writef(&m_stream, kIpcMsgShutdown);
 		break;
 
+	case kIpcLatencyReport: {
+		const IpcLatencyReportMessage& lrm = static_cast<const IpcLatencyReportMessage&>(message);
+		String report = lrm.report();
+		ProtocolUtil::writef(&m_stream, kIpcMsgLatencyReport, &report);
+		break;
+	}
+
 	default:
 		LOG((CLOG_ERR "ipc message not supported: %d", message.type()));
 		break;
@@ -184,6 +194,16 @@ IpcClientProxy::parseCommand()
 	return new IpcCommandMessage(command, elevate != 0);
 }
 
+IpcLatencyReportMessage*
+IpcClientProxy::parseLatencyReport()
+{
+	String report;
+	ProtocolUtil::readf(&m_stream, kIpcMsgLatencyReport + 4, &report);
+
+	// must be deleted by event handler.
+	return new IpcLatencyReportMessage(report);
+}
+
 void
 IpcClientProxy::disconnect()
 {
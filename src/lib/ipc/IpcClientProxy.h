@@ -27,6 +27,7 @@ namespace synergy { class IStream; }
 class IpcMessage;
 class IpcCommandMessage;
 class IpcHelloMessage;
+class IpcLatencyReportMessage;
 class IEventQueue;
 
 class IpcClientProxy {
@@ -43,6 +44,8 @@ private:
 	void				handleWriteError(const Event&, void*);
 	IpcHelloMessage*	parseHello();
 	IpcCommandMessage*	parseCommand();
+	IpcLatencyReportMessage*
+						parseLatencyReport();
 	void				disconnect();
 	
 private:
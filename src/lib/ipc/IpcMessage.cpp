@@ -67,3 +67,13 @@ m_elevate(elevate)
 IpcCommandMessage::~IpcCommandMessage()
 {
 }
+
+IpcLatencyReportMessage::IpcLatencyReportMessage(const String& report) :
+IpcMessage(kIpcLatencyReport),
+m_report(report)
+{
+}
+
+IpcLatencyReportMessage::~IpcLatencyReportMessage()
+{
+}
@@ -83,3 +83,15 @@ private:
 	String				m_command;
 	bool				m_elevate;
 };
+
+class IpcLatencyReportMessage : public IpcMessage {
+public:
+	IpcLatencyReportMessage(const String& report);
+	virtual ~IpcLatencyReportMessage();
+
+	//! Gets the report.
+	String				report() const { return m_report; }
+
+private:
+	String				m_report;
+};
@@ -64,6 +64,9 @@ IpcServerProxy::handleData(const Event&, void*)
 		else if (memcmp(code, kIpcMsgShutdown, 4) == 0) {
 			m = new IpcShutdownMessage();
 		}
+		else if (memcmp(code, kIpcMsgLatencyReport, 4) == 0) {
+			m = parseLatencyReport();
+		}
 		else {
 			LOG((CLOG_ERR "invalid ipc message"));
 			disconnect();
@@ -99,6 +102,13 @@ IpcServerProxy::send(const IpcMessage& message)
 		break;
 	}
 
+	case kIpcLatencyReport: {
+		const IpcLatencyReportMessage& lrm = static_cast<const IpcLatencyReportMessage&>(message);
+		String report = lrm.report();
+		ProtocolUtil::writef(&m_stream, kIpcMsgLatencyReport, &report);
+		break;
+	}
+
 	default:
 		LOG((CLOG_ERR "ipc message not supported: %d", message.type()));
 		break;
@@ -115,6 +125,16 @@ IpcServerProxy::parseLogLine()
 	return new IpcLogLineMessage(logLine);
 }
 
+IpcLatencyReportMessage*
+IpcServerProxy::parseLatencyReport()
+{
+	String report;
+	ProtocolUtil::readf(&m_stream, kIpcMsgLatencyReport + 4, &report);
+
+	// must be deleted by event handler.
+	return new IpcLatencyReportMessage(report);
+}
+
 void
 IpcServerProxy::disconnect()
 {
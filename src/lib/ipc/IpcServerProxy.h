@@ -24,6 +24,7 @@
 namespace synergy { class IStream; }
 class IpcMessage;
 class IpcLogLineMessage;
+class IpcLatencyReportMessage;
 class IEventQueue;
 
 class IpcServerProxy {
@@ -38,6 +39,8 @@ private:
 
 	void				handleData(const Event&, void*);
 	IpcLogLineMessage*	parseLogLine();
+	IpcLatencyReportMessage*
+						parseLatencyReport();
 	void				disconnect();
 
 private:
@@ -0,0 +1,273 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	pragma intrinsic(_InterlockedCompareExchange)
+#	pragma intrinsic(_InterlockedExchangeAdd)
+#	pragma intrinsic(_InterlockedExchangePointer)
+#	pragma intrinsic(_ReadWriteBarrier)
+#endif
+
+//! Atomic 32 bit integer
+/*!
+A 32 bit unsigned integer that can be read and modified by several
+threads without a mutex.  Loads have acquire semantics and stores have
+release semantics;  the read-modify-write operations are full barriers.
+Arithmetic wraps around on overflow.
+*/
+class AtomicUInt32 {
+public:
+	AtomicUInt32(UInt32 value = 0) : m_value(value) { }
+
+	//! @name manipulators
+	//@{
+
+	//! Set the value
+	void				store(UInt32 value);
+
+	//! Add to the value
+	/*!
+	Adds \p n and returns the value from before the addition.
+	*/
+	UInt32				fetchAdd(UInt32 n);
+
+	//! Subtract from the value
+	/*!
+	Subtracts \p n and returns the value from before the subtraction.
+	*/
+	UInt32				fetchSub(UInt32 n);
+
+	//! Compare and swap
+	/*!
+	Sets the value to \p desired iff it currently equals \p expected.
+	Returns true if the value was changed.
+	*/
+	bool				compareAndSwap(UInt32 expected, UInt32 desired);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the value
+	UInt32				load() const;
+
+	//@}
+
+private:
+	// not implemented
+	AtomicUInt32(const AtomicUInt32&);
+	AtomicUInt32& operator=(const AtomicUInt32&);
+
+private:
+#if defined(_MSC_VER)
+	volatile long		m_value;
+#else
+	volatile UInt32		m_value;
+#endif
+};
+
+#if defined(_MSC_VER)
+
+inline
+UInt32
+AtomicUInt32::load() const
+{
+	// volatile reads have acquire semantics with msvc
+	UInt32 value = static_cast<UInt32>(m_value);
+	_ReadWriteBarrier();
+	return value;
+}
+
+inline
+void
+AtomicUInt32::store(UInt32 value)
+{
+	// volatile writes have release semantics with msvc
+	_ReadWriteBarrier();
+	m_value = static_cast<long>(value);
+}
+
+inline
+UInt32
+AtomicUInt32::fetchAdd(UInt32 n)
+{
+	return static_cast<UInt32>(
+		_InterlockedExchangeAdd(&m_value, static_cast<long>(n)));
+}
+
+inline
+UInt32
+AtomicUInt32::fetchSub(UInt32 n)
+{
+	return static_cast<UInt32>(
+		_InterlockedExchangeAdd(&m_value, -static_cast<long>(n)));
+}
+
+inline
+bool
+AtomicUInt32::compareAndSwap(UInt32 expected, UInt32 desired)
+{
+	return (_InterlockedCompareExchange(&m_value,
+				static_cast<long>(desired),
+				static_cast<long>(expected)) == static_cast<long>(expected));
+}
+
+#else // !_MSC_VER
+
+inline
+UInt32
+AtomicUInt32::load() const
+{
+	return __atomic_load_n(&m_value, __ATOMIC_ACQUIRE);
+}
+
+inline
+void
+AtomicUInt32::store(UInt32 value)
+{
+	__atomic_store_n(&m_value, value, __ATOMIC_RELEASE);
+}
+
+inline
+UInt32
+AtomicUInt32::fetchAdd(UInt32 n)
+{
+	return __sync_fetch_and_add(&m_value, n);
+}
+
+inline
+UInt32
+AtomicUInt32::fetchSub(UInt32 n)
+{
+	return __sync_fetch_and_sub(&m_value, n);
+}
+
+inline
+bool
+AtomicUInt32::compareAndSwap(UInt32 expected, UInt32 desired)
+{
+	return __sync_bool_compare_and_swap(&m_value, expected, desired);
+}
+
+#endif
+
+//! Atomic pointer
+/*!
+A pointer that can be read and replaced by several threads without a
+mutex.  Loads have acquire semantics and stores have release semantics;
+exchange is a full barrier.  Only the pointer is atomic, not the object
+it points to.
+*/
+template <class T>
+class AtomicPointer {
+public:
+	AtomicPointer(T* value = NULL) : m_value(value) { }
+
+	//! @name manipulators
+	//@{
+
+	//! Set the pointer
+	void				store(T* value);
+
+	//! Swap the pointer
+	/*!
+	Sets the pointer to \p value and returns the previous one.
+	*/
+	T*					exchange(T* value);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the pointer
+	T*					load() const;
+
+	//@}
+
+private:
+	// not implemented
+	AtomicPointer(const AtomicPointer&);
+	AtomicPointer& operator=(const AtomicPointer&);
+
+private:
+	T* volatile			m_value;
+};
+
+#if defined(_MSC_VER)
+
+template <class T>
+inline
+T*
+AtomicPointer<T>::load() const
+{
+	T* value = m_value;
+	_ReadWriteBarrier();
+	return value;
+}
+
+template <class T>
+inline
+void
+AtomicPointer<T>::store(T* value)
+{
+	_ReadWriteBarrier();
+	m_value = value;
+}
+
+template <class T>
+inline
+T*
+AtomicPointer<T>::exchange(T* value)
+{
+	return static_cast<T*>(_InterlockedExchangePointer(
+		reinterpret_cast<void* volatile*>(&m_value), value));
+}
+
+#else // !_MSC_VER
+
+template <class T>
+inline
+T*
+AtomicPointer<T>::load() const
+{
+	return __atomic_load_n(&m_value, __ATOMIC_ACQUIRE);
+}
+
+template <class T>
+inline
+void
+AtomicPointer<T>::store(T* value)
+{
+	__atomic_store_n(&m_value, value, __ATOMIC_RELEASE);
+}
+
+template <class T>
+inline
+T*
+AtomicPointer<T>::exchange(T* value)
+{
+	return __atomic_exchange_n(&m_value, value, __ATOMIC_SEQ_CST);
+}
+
+#endif
@@ -84,6 +84,12 @@ Thread::setPriority(int n)
 	ARCH->setPriorityOfThread(m_thread, n);
 }
 
+void
+Thread::setAffinity(UInt32 cpus)
+{
+	ARCH->setAffinityOfThread(m_thread, cpus);
+}
+
 void
 Thread::unblockPollSocket()
 {
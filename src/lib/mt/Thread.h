@@ -126,6 +126,14 @@ public:
 	*/
 	void				setPriority(int n);
 
+	//! Restrict thread to CPUs
+	/*!
+	Let the thread run only on the CPUs whose bits are set in \c cpus,
+	bit 0 being the first CPU.  Zero lets it run on any CPU.  This is
+	silently ignored where it isn't supported.
+	*/
+	void				setAffinity(UInt32 cpus);
+
 	//! Force pollSocket() to return
 	/*!
 	Forces a currently blocked pollSocket() in the thread to return
@@ -29,6 +29,9 @@
 #include "base/TMethodJob.h"
 #include "common/stdvector.h"
 
+// most socket events handled per wakeup of the service thread
+static const int		kMaxSocketEvents = 64;
+
 //
 // SocketMultiplexer
 //
@@ -36,17 +39,14 @@
 SocketMultiplexer::SocketMultiplexer() :
 	m_mutex(new Mutex),
 	m_thread(NULL),
-	m_update(false),
+	m_pollSet(NULL),
 	m_jobsReady(new CondVar<bool>(m_mutex, false)),
 	m_jobListLock(new CondVar<bool>(m_mutex, false)),
 	m_jobListLockLocked(new CondVar<bool>(m_mutex, false)),
 	m_jobListLocker(NULL),
 	m_jobListLockLocker(NULL)
 {
-	// this pointer just has to be unique and not NULL.  it will
-	// never be dereferenced.  it's used to identify cursor nodes
-	// in the jobs list.
-	m_cursorMark = reinterpret_cast<ISocketMultiplexerJob*>(this);
+	m_pollSet = ARCH->newPollSet();
 
 	// start thread
 	m_thread = new Thread(new TMethodJob<SocketMultiplexer>(
@@ -71,6 +71,8 @@ SocketMultiplexer::~SocketMultiplexer()
 						i != m_socketJobMap.end(); ++i) {
 		delete *(i->second);
 	}
+
+	ARCH->closePollSet(m_pollSet);
 }
 
 void
@@ -82,29 +84,23 @@ SocketMultiplexer::addSocket(ISocket* socket, ISocketMultiplexerJob* job)
 	// prevent other threads from locking the job list
 	lockJobListLock();
 
-	// break thread out of poll
-	m_thread->unblockPollSocket();
-
 	// lock the job list
 	lockJobList();
 
 	// insert/replace job
 	SocketJobMap::iterator i = m_socketJobMap.find(socket);
 	if (i == m_socketJobMap.end()) {
-		// we *must* put the job at the end so the order of jobs in
-		// the list continue to match the order of jobs in pfds in
-		// serviceThread().
 		JobCursor j = m_socketJobs.insert(m_socketJobs.end(), job);
-		m_update     = true;
 		m_socketJobMap.insert(std::make_pair(socket, j));
+		updatePollSet(&*j, NULL, job);
 	}
 	else {
 		JobCursor j = i->second;
+		updatePollSet(&*j, *j, job);
 		if (*j != job) {
 			delete *j;
 			*j = job;
 		}
-		m_update = true;
 	}
 
 	// unlock the job list
@@ -119,21 +115,18 @@ SocketMultiplexer::removeSocket(ISocket* socket)
 	// prevent other threads from locking the job list
 	lockJobListLock();
 
-	// break thread out of poll
-	m_thread->unblockPollSocket();
-
 	// lock the job list
 	lockJobList();
 
 	// remove job.  rather than removing it from the map we put NULL
-	// in the list instead so the order of jobs in the list continues
-	// to match the order of jobs in pfds in serviceThread().
+	// in the list instead because the service thread may be about to
+	// handle an event for it.  the service thread removes it later.
 	SocketJobMap::iterator i = m_socketJobMap.find(socket);
 	if (i != m_socketJobMap.end()) {
 		if (*(i->second) != NULL) {
+			updatePollSet(&*(i->second), *(i->second), NULL);
 			delete *(i->second);
 			*(i->second) = NULL;
-			m_update     = true;
 		}
 	}
 
@@ -141,11 +134,22 @@ SocketMultiplexer::removeSocket(ISocket* socket)
 	unlockJobList();
 }
 
+void
+SocketMultiplexer::setThreadPriority(int n)
+{
+	m_thread->setPriority(n);
+}
+
+void
+SocketMultiplexer::setThreadAffinity(UInt32 cpus)
+{
+	m_thread->setAffinity(cpus);
+}
+
 void
 SocketMultiplexer::serviceThread(void*)
 {
-	std::vector<IArchNetwork::PollEntry> pfds;
-	IArchNetwork::PollEntry pfd;
+	IArchNetwork::PollSetEvent events[kMaxSocketEvents];
 
 	// service the connections
 	for (;;) {
@@ -159,93 +163,56 @@ SocketMultiplexer::serviceThread(void*)
 			}
 		}
 
-		// lock the job list
-		lockJobListLock();
-		lockJobList();
-
-		// collect poll entries
-		if (m_update) {
-			m_update = false;
-			pfds.clear();
-			pfds.reserve(m_socketJobMap.size());
-
-			JobCursor cursor    = newCursor();
-			JobCursor jobCursor = nextCursor(cursor);
-			while (jobCursor != m_socketJobs.end()) {
-				ISocketMultiplexerJob* job = *jobCursor;
-				if (job != NULL) {
-					pfd.m_socket = job->getSocket();
-					pfd.m_events = 0;
-					if (job->isReadable()) {
-						pfd.m_events |= IArchNetwork::kPOLLIN;
-					}
-					if (job->isWritable()) {
-						pfd.m_events |= IArchNetwork::kPOLLOUT;
-					}
-					pfds.push_back(pfd);
-				}				
-				jobCursor = nextCursor(cursor);
-			}
-			deleteCursor(cursor);
-		}
-
-		int status;
+		// wait for events.  the job list is not locked so other
+		// threads can add and remove sockets meanwhile.
+		int n;
 		try {
-			// check for status
-			if (!pfds.empty()) {
-				status = ARCH->pollSocket(&pfds[0], (int)pfds.size(), -1);
-			}
-			else {
-				status = 0;
-			}
+			n = ARCH->waitPollSet(m_pollSet, events, kMaxSocketEvents, -1);
 		}
 		catch (XArchNetwork& e) {
 			LOG((CLOG_WARN "error in socket multiplexer: %s", e.what()));
-			status = 0;
+			n = 0;
 		}
 
-		if (status != 0) {
-			// iterate over socket jobs, invoking each and saving the
-			// new job.
-			UInt32 i             = 0;
-			JobCursor cursor    = newCursor();
-			JobCursor jobCursor = nextCursor(cursor);
-			while (i < pfds.size() && jobCursor != m_socketJobs.end()) {
-				if (*jobCursor != NULL) {
-					// get poll state
-					unsigned short revents = pfds[i].m_revents;
-					bool read  = ((revents & IArchNetwork::kPOLLIN) != 0);
-					bool write = ((revents & IArchNetwork::kPOLLOUT) != 0);
-					bool error = ((revents & (IArchNetwork::kPOLLERR |
-											  IArchNetwork::kPOLLNVAL)) != 0);
-
-					// run job
-					ISocketMultiplexerJob* job    = *jobCursor;
-					ISocketMultiplexerJob* newJob = job->run(read, write, error);
-
-					// save job, if different
-					if (newJob != job) {
-						Lock lock(m_mutex);
-						delete job;
-						*jobCursor = newJob;
-						m_update   = true;
-					}
-					++i;
-				}
-
-				// next job
-				jobCursor = nextCursor(cursor);
+		// lock the job list
+		lockJobListLock();
+		lockJobList();
+
+		// invoke the job for each socket with events, saving the new job
+		for (int i = 0; i < n; ++i) {
+			ISocketMultiplexerJob*& slot =
+				*static_cast<ISocketMultiplexerJob**>(events[i].m_data);
+			ISocketMultiplexerJob* job = slot;
+			if (job == NULL) {
+				// removed while we were waiting
+				continue;
+			}
+
+			// get poll state
+			unsigned short revents = events[i].m_revents;
+			bool read  = ((revents & IArchNetwork::kPOLLIN) != 0);
+			bool write = ((revents & IArchNetwork::kPOLLOUT) != 0);
+			bool error = ((revents & (IArchNetwork::kPOLLERR |
+									  IArchNetwork::kPOLLNVAL)) != 0);
+
+			// run job
+			ISocketMultiplexerJob* newJob = job->run(read, write, error);
+
+			// save job, if different
+			if (newJob != job) {
+				updatePollSet(&slot, job, newJob);
+				delete job;
+				slot = newJob;
 			}
-			deleteCursor(cursor);
 		}
 
-		// delete any removed socket jobs
+		// delete any removed socket jobs.  the poll set can no longer
+		// report them since they were removed before we locked the list.
 		for (SocketJobMap::iterator i = m_socketJobMap.begin();
 							i != m_socketJobMap.end();) {
 			if (*(i->second) == NULL) {
 				m_socketJobs.erase(i->second);
 				m_socketJobMap.erase(i++);
-				m_update = true;
 			}
 			else {
 				++i;
@@ -257,37 +224,30 @@ SocketMultiplexer::serviceThread(void*)
 	}
 }
 
-SocketMultiplexer::JobCursor
-SocketMultiplexer::newCursor()
-{
-	Lock lock(m_mutex);
-	return m_socketJobs.insert(m_socketJobs.begin(), m_cursorMark);
-}
-
-SocketMultiplexer::JobCursor
-SocketMultiplexer::nextCursor(JobCursor cursor)
+void
+SocketMultiplexer::updatePollSet(ISocketMultiplexerJob** slot,
+				ISocketMultiplexerJob* oldJob, ISocketMultiplexerJob* newJob)
 {
-	Lock lock(m_mutex);
-	JobCursor j = m_socketJobs.end();
-	JobCursor i = cursor;
-	while (++i != m_socketJobs.end()) {
-		if (*i != m_cursorMark) {
-			// found a real job (as opposed to a cursor)
-			j = i;
-
-			// move our cursor just past the job
-			m_socketJobs.splice(++i, m_socketJobs, cursor);
-			break;
+	try {
+		if (oldJob != NULL &&
+			(newJob == NULL || newJob->getSocket() != oldJob->getSocket())) {
+			ARCH->removePollSetSocket(m_pollSet, oldJob->getSocket());
+		}
+		if (newJob != NULL) {
+			unsigned short events = 0;
+			if (newJob->isReadable()) {
+				events |= IArchNetwork::kPOLLIN;
+			}
+			if (newJob->isWritable()) {
+				events |= IArchNetwork::kPOLLOUT;
+			}
+			ARCH->setPollSetSocket(m_pollSet, newJob->getSocket(),
+							events, slot);
 		}
 	}
-	return j;
-}
-
-void
-SocketMultiplexer::deleteCursor(JobCursor cursor)
-{
-	Lock lock(m_mutex);
-	m_socketJobs.erase(cursor);
+	catch (XArchNetwork& e) {
+		LOG((CLOG_WARN "error in socket multiplexer: %s", e.what()));
+	}
 }
 
 void
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "arch/IArchNetwork.h"
+#include "common/basic_types.h"
 #include "common/stdlist.h"
 #include "common/stdmap.h"
 
@@ -45,6 +46,18 @@ public:
 
 	void				removeSocket(ISocket*);
 
+	//! Set service thread priority
+	/*!
+	See Thread::setPriority().
+	*/
+	void				setThreadPriority(int n);
+
+	//! Restrict service thread to CPUs
+	/*!
+	See Thread::setAffinity().
+	*/
+	void				setThreadAffinity(UInt32 cpus);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -56,30 +69,25 @@ public:
 	//@}
 
 private:
-	// list of jobs.  we use a list so we can safely iterate over it
-	// while other threads modify it.
+	// list of jobs.  the poll set refers to each socket's job by the
+	// address of its list item so items must stay put until the
+	// service thread knows the poll set can't report them.
 	typedef std::list<ISocketMultiplexerJob*> SocketJobs;
 	typedef SocketJobs::iterator JobCursor;
 	typedef std::map<ISocket*, JobCursor> SocketJobMap;
 
-	// service sockets.  the service thread will only access m_sockets
-	// and m_update while m_pollable and m_polling are true.  all other
-	// threads must only modify these when m_pollable and m_polling are
-	// false.  only the service thread sets m_polling.
+	// service sockets.  the service thread waits on the poll set
+	// without locking the job list then locks it to run the jobs for
+	// the sockets with events.  other threads change the poll set
+	// directly so they never have to break the thread out of its wait.
 	void				serviceThread(void*);
 
-	// create, iterate, and destroy a cursor.  a cursor is used to
-	// safely iterate through the job list while other threads modify
-	// the list.  it works by inserting a dummy item in the list and
-	// moving that item through the list.  the dummy item will never
-	// be removed by other edits so an iterator pointing at the item
-	// remains valid until we remove the dummy item in deleteCursor().
-	// nextCursor() finds the next non-dummy item, moves our dummy
-	// item just past it, and returns an iterator for the non-dummy
-	// item.  all cursor calls lock the mutex for their duration.
-	JobCursor			newCursor();
-	JobCursor			nextCursor(JobCursor);
-	void				deleteCursor(JobCursor);
+	// update the poll set entry for a socket whose job in the list
+	// item at slot has changed from oldJob to newJob (either of which
+	// may be NULL).  the job list must be locked.
+	void				updatePollSet(ISocketMultiplexerJob** slot,
+							ISocketMultiplexerJob* oldJob,
+							ISocketMultiplexerJob* newJob);
 
 	// lock out locking the job list.  this blocks if another thread
 	// has already locked out locking.  once it returns, only the
@@ -97,7 +105,7 @@ private:
 private:
 	Mutex*				m_mutex;
 	Thread*				m_thread;
-	bool				m_update;
+	ArchPollSet			m_pollSet;
 	CondVar<bool>*		m_jobsReady;
 	CondVar<bool>*		m_jobListLock;
 	CondVar<bool>*		m_jobListLockLocked;
@@ -106,6 +114,4 @@ private:
 
 	SocketJobs			m_socketJobs;
 	SocketJobMap		m_socketJobMap;
-	ISocketMultiplexerJob*
-						m_cursorMark;
 };
@@ -33,6 +33,9 @@
 #include <cstdlib>
 #include <memory>
 
+// the most output buffer chunks written with one call
+static const UInt32		kMaxWriteBuffers = 64;
+
 //
 // TCPSocket
 //
@@ -153,6 +156,18 @@ TCPSocket::read(void* buffer, UInt32 n)
 
 void
 TCPSocket::write(const void* buffer, UInt32 n)
+{
+	write(buffer, n, false);
+}
+
+void
+TCPSocket::writeBulk(const void* buffer, UInt32 n)
+{
+	write(buffer, n, true);
+}
+
+void
+TCPSocket::write(const void* buffer, UInt32 n, bool bulk)
 {
 	bool wasEmpty;
 	{
@@ -170,8 +185,13 @@ TCPSocket::write(const void* buffer, UInt32 n)
 		}
 
 		// copy data to the output buffer
-		wasEmpty = (m_outputBuffer.getSize() == 0);
-		m_outputBuffer.write(buffer, n);
+		wasEmpty = (m_output.getSize() == 0);
+		if (bulk) {
+			m_output.writeBulk(buffer, n);
+		}
+		else {
+			m_output.write(buffer, n);
+		}
 
 		// there's data to write
 		m_flushed = false;
@@ -353,13 +373,13 @@ TCPSocket::newJob()
 								m_socket, m_readable, m_writable);
 	}
 	else {
-		if (!(m_readable || (m_writable && (m_outputBuffer.getSize() > 0)))) {
+		if (!(m_readable || (m_writable && (m_output.getSize() > 0)))) {
 			return NULL;
 		}
 		return new TSocketMultiplexerMethodJob<TCPSocket>(
 								this, &TCPSocket::serviceConnected,
 								m_socket, m_readable,
-								m_writable && (m_outputBuffer.getSize() > 0));
+								m_writable && (m_output.getSize() > 0));
 	}
 }
 
@@ -395,7 +415,7 @@ TCPSocket::onInputShutdown()
 void
 TCPSocket::onOutputShutdown()
 {
-	m_outputBuffer.pop(m_outputBuffer.getSize());
+	m_output.clear();
 	m_writable = false;
 
 	// we're now flushed
@@ -469,64 +489,49 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 	}
 
 	bool needNewJob = false;
-	
-	static bool s_retry = false;
-	static int s_retrySize = 0;
-	static void* s_staticBuffer = NULL;
 
 	if (write) {
 		try {
 			// write data
-			int bufferSize = 0;
 			int bytesWrote = 0;
-			int status = 0;
 
-			if (s_retry) {
-				bufferSize = s_retrySize;
-			}
-			else {
-				bufferSize = m_outputBuffer.getSize();
-				s_staticBuffer = malloc(bufferSize);
-				memcpy(s_staticBuffer, m_outputBuffer.peek(bufferSize), bufferSize);
- 			}
-
-			if (bufferSize == 0) {
-				return job;
-			}
+			// bulk data only moves to the outgoing buffer once
+			// everything ahead of it has gone
+			StreamBuffer& output = m_output.next();
 
 			if (isSecure()) {
-				if (isSecureReady()) {
-					status = secureWrite(s_staticBuffer, bufferSize, bytesWrote);
-					if (status > 0) {
-						s_retry = false;
-						bufferSize = 0;
-						free(s_staticBuffer);
-						s_staticBuffer = NULL;
-					}
-					else if (status < 0) {
-						return NULL;
-					}
-					else if (status == 0) {
-						s_retry = true;
-						s_retrySize = bufferSize;
-						return newJob();
-					}
-				}
-				else {
+				if (!isSecureReady() || output.getSize() == 0) {
 					return job;
 				}
+
+				// the secure socket discards what it manages to encrypt
+				int status = secureWrite(output, bytesWrote);
+				if (status < 0) {
+					return NULL;
+				}
+				else if (status == 0) {
+					return newJob();
+				}
 			}
 			else {
-				bytesWrote = (UInt32)ARCH->writeSocket(m_socket, s_staticBuffer, bufferSize);
-				bufferSize = 0;
-				free(s_staticBuffer);
-				s_staticBuffer = NULL;
+				// write straight from the output buffer's chunks
+				IArchNetwork::WriteBuffer bufs[kMaxWriteBuffers];
+				UInt32 num = output.peekChunks(bufs, kMaxWriteBuffers);
+				if (num == 0) {
+					return job;
+				}
+				bytesWrote = (int)ARCH->writevSocket(m_socket, bufs, num);
+
+				// discard written data
+				output.pop(bytesWrote);
 			}
 
-			// discard written data
 			if (bytesWrote > 0) {
-				m_outputBuffer.pop(bytesWrote);
-				if (m_outputBuffer.getSize() == 0) {
+				// everything but bulk data still to come has gone
+				if (output.getSize() == 0) {
+					sendEvent(m_events->forIStream().priorityFlushed());
+				}
+				if (m_output.getSize() == 0) {
 					sendEvent(m_events->forIStream().outputFlushed());
 					m_flushed = true;
 					m_flushed.broadcast();
@@ -563,8 +568,8 @@ TCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 
 	if (read && m_readable) {
 		try {
-			static UInt8 buffer[4096];
-			memset(buffer, 0, sizeof(buffer));
+			// big enough for a whole TLS record
+			UInt8 buffer[16384];
 			int bytesRead = 0;
 			int status = 0;
 
@@ -20,6 +20,7 @@
 
 #include "net/IDataSocket.h"
 #include "io/StreamBuffer.h"
+#include "io/OutputLanes.h"
 #include "mt/CondVar.h"
 #include "mt/Mutex.h"
 #include "arch/IArchNetwork.h"
@@ -48,6 +49,7 @@ public:
 	// IStream overrides
 	virtual UInt32		read(void* buffer, UInt32 n);
 	virtual void		write(const void* buffer, UInt32 n);
+	virtual void		writeBulk(const void* buffer, UInt32 n);
 	virtual void		flush();
 	virtual void		shutdownInput();
 	virtual void		shutdownOutput();
@@ -68,7 +70,7 @@ protected:
 	virtual bool		isSecureReady() { return false; }
 	virtual bool		isSecure() { return false; }
 	virtual int			secureRead(void* buffer, int, int& ) { return 0; }
-	virtual int			secureWrite(const void*, int, int& ) { return 0; }
+	virtual int			secureWrite(StreamBuffer&, int& ) { return 0; }
 
 	void				setJob(ISocketMultiplexerJob*);
 	ISocketMultiplexerJob*
@@ -82,6 +84,7 @@ protected:
 
 private:
 	void				init();
+	void				write(const void* buffer, UInt32 n, bool bulk);
 
 	void				sendConnectionFailedEvent(const char*);
 	void				onConnected();
@@ -104,7 +107,7 @@ private:
 	Mutex				m_mutex;
 	ArchSocket			m_socket;
 	StreamBuffer		m_inputBuffer;
-	StreamBuffer		m_outputBuffer;
+	OutputLanes			m_output;
 	CondVar<bool>		m_flushed;
 	bool				m_connected;
 	IEventQueue*		m_events;
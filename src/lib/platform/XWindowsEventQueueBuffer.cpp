@@ -53,11 +53,13 @@ class EventQueueTimer { };
 //
 
 XWindowsEventQueueBuffer::XWindowsEventQueueBuffer(
-		Display* display, Window window, IEventQueue* events) :
+		Display* display, Window window, bool sharedDisplay,
+		IEventQueue* events) :
 	m_events(events),
 	m_display(display),
 	m_window(window),
-	m_waiting(false)
+	m_waiting(false),
+	m_sharedDisplay(sharedDisplay)
 {
 	assert(m_display != NULL);
 	assert(m_window  != None);
@@ -86,33 +88,39 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 {
 	Thread::testCancel();
 
-	// clear out the pipe in preparation for waiting.
-
-	char buf[16];
-	ssize_t read_response = read(m_pipefd[0], buf, 15);
-	
-	// with linux automake, warnings are treated as errors by default
-	if (read_response < 0)
-	{
-		// todo: handle read response
-	}
+	// clear out the pipe in preparation for waiting
+	drainPipe();
 
 	{
 		Lock lock(&m_mutex);
 		// we're now waiting for events
 		m_waiting = true;
 
-		// push out pending events
+		// push out pending events.  xlib may read events into its own
+		// queue while flushing and those never make the connection
+		// readable, so don't sleep if there are any.
 		flush();
+		if (XEventsQueued(m_display, QueuedAfterFlush) != 0) {
+			m_waiting = false;
+			Thread::testCancel();
+			return;
+		}
 	}
-	// calling flush may have queued up a new event.
-	if (!XWindowsEventQueueBuffer::isEmpty()) {
-		Thread::testCancel();
-		return;
+
+	// wait for the X server or for addEvent().  addEvent() flushes on
+	// this thread's behalf while we're waiting, which can also pull
+	// events into xlib's queue, so it always writes to the pipe to
+	// wake us.  but any other thread using the display can read events
+	// into xlib's queue without making the connection readable or
+	// telling us, so if there may be such threads we wake up now and
+	// then to check.  the human eye can notice 60hz (16ms) so 25ms
+	// keeps input timely without starving the cpu.
+	static const double kSharedDisplayTimeout = 0.025;
+	if (m_sharedDisplay &&
+		(dtimeout < 0.0 || dtimeout > kSharedDisplayTimeout)) {
+		dtimeout = kSharedDisplayTimeout;
 	}
 
-	// use poll() to wait for a message from the X server or for timeout.
-	// this is a good deal more efficient than polling and sleeping.
 #if HAVE_POLL
 	struct pollfd pfds[2];
 	pfds[0].fd     = ConnectionNumber(m_display);
@@ -121,8 +129,8 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 	pfds[1].events = POLLIN;
 	int timeout    = (dtimeout < 0.0) ? -1 :
 						static_cast<int>(1000.0 * dtimeout);
-	int remaining  =  timeout;
-	int retval     =  0;
+
+	poll(pfds, 2, timeout);
 #else
 	struct timeval timeout;
 	struct timeval* timeoutPtr;
@@ -141,53 +149,21 @@ XWindowsEventQueueBuffer::waitForEvent(double dtimeout)
 	FD_ZERO(&rfds);
 	FD_SET(ConnectionNumber(m_display), &rfds);
 	FD_SET(m_pipefd[0], &rfds);
- 	int nfds;
- 	if (ConnectionNumber(m_display) > m_pipefd[0]) {
- 		nfds = ConnectionNumber(m_display) + 1;
- 	}
- 	else {
- 		nfds = m_pipefd[0] + 1;
- 	}
-#endif
-	// It's possible that the X server has queued events locally
-	// in xlib's event buffer and not pushed on to the fd. Hence we
-	// can't simply monitor the fd as we may never be woken up.
-	// ie addEvent calls flush, XFlush may not send via the fd hence
-	// there is an event waiting to be sent but we must exit the poll
-	// before it can.
-	// Instead we poll for a brief period of time (so if events
-	// queued locally in the xlib buffer can be processed)
-	// and continue doing this until timeout is reached.
-	// The human eye can notice 60hz (ansi) which is 16ms, however
-	// we want to give the cpu a chance s owe up this to 25ms
-#define TIMEOUT_DELAY 25
-
-	while (((dtimeout < 0.0) || (remaining > 0)) && QLength(m_display)==0 && retval==0){
-#if HAVE_POLL
-	retval = poll(pfds, 2, TIMEOUT_DELAY); //16ms = 60hz, but we make it > to play nicely with the cpu
- 	if (pfds[1].revents & POLLIN) {
- 		ssize_t read_response = read(m_pipefd[0], buf, 15);
-		
-		// with linux automake, warnings are treated as errors by default
-		if (read_response < 0)
-		{
-			// todo: handle read response
-		}
-
- 	}
-#else
-	retval = select(nfds,
-						SELECT_TYPE_ARG234 &rfds,
-						SELECT_TYPE_ARG234 NULL,
-						SELECT_TYPE_ARG234 NULL,
-						SELECT_TYPE_ARG5   TIMEOUT_DELAY);
-	if (FD_SET(m_pipefd[0], &rfds)) {
-		read(m_pipefd[0], buf, 15);
+	int nfds;
+	if (ConnectionNumber(m_display) > m_pipefd[0]) {
+		nfds = ConnectionNumber(m_display) + 1;
 	}
-#endif
-	    remaining-=TIMEOUT_DELAY;
+	else {
+		nfds = m_pipefd[0] + 1;
 	}
 
+	select(nfds,
+			SELECT_TYPE_ARG234 &rfds,
+			SELECT_TYPE_ARG234 NULL,
+			SELECT_TYPE_ARG234 NULL,
+			SELECT_TYPE_ARG5   timeoutPtr);
+#endif
+
 	{
 		// we're no longer waiting for events
 		Lock lock(&m_mutex);
@@ -277,6 +253,16 @@ XWindowsEventQueueBuffer::deleteTimer(EventQueueTimer* timer) const
 	delete timer;
 }
 
+void
+XWindowsEventQueueBuffer::drainPipe()
+{
+	// the pipe is non-blocking so this stops once it's empty
+	char buf[64];
+	while (read(m_pipefd[0], buf, sizeof(buf)) > 0) {
+		// do nothing
+	}
+}
+
 void
 XWindowsEventQueueBuffer::flush()
 {
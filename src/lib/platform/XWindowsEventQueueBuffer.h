@@ -33,7 +33,12 @@ class IEventQueue;
 //! Event queue buffer for X11
 class XWindowsEventQueueBuffer : public IEventQueueBuffer {
 public:
-	XWindowsEventQueueBuffer(Display*, Window, IEventQueue* events);
+	/*!
+	\p sharedDisplay is true if threads other than the one waiting for
+	events may use the display.
+	*/
+	XWindowsEventQueueBuffer(Display*, Window, bool sharedDisplay,
+							IEventQueue* events);
 	virtual ~XWindowsEventQueueBuffer();
 
 	// IEventQueueBuffer overrides
@@ -47,6 +52,7 @@ public:
 	virtual void		deleteTimer(EventQueueTimer*) const;
 
 private:
+	void				drainPipe();
 	void				flush();
 
 private:
@@ -59,6 +65,7 @@ private:
 	XEvent				m_event;
 	EventList			m_postedEvents;
 	bool				m_waiting;
+	bool				m_sharedDisplay;
 	int					m_pipefd[2];
 	IEventQueue*		m_events;
 };
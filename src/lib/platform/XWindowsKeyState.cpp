@@ -45,7 +45,8 @@ XWindowsKeyState::XWindowsKeyState(
 		IEventQueue* events) :
 	KeyState(events),
 	m_display(display),
-	m_modifierFromX(ModifiersFromXDefaultSize)
+	m_modifierFromX(ModifiersFromXDefaultSize),
+	m_flushDeferred(false)
 {
 	init(display, useXKB);
 }
@@ -55,7 +56,8 @@ XWindowsKeyState::XWindowsKeyState(
 	IEventQueue* events, synergy::KeyMap& keyMap) :
 	KeyState(events, keyMap),
 	m_display(display),
-	m_modifierFromX(ModifiersFromXDefaultSize)
+	m_modifierFromX(ModifiersFromXDefaultSize),
+	m_flushDeferred(false)
 {
 	init(display, useXKB);
 }
@@ -109,6 +111,12 @@ XWindowsKeyState::setAutoRepeat(const XKeyboardState& state)
 	m_keyboardState = state;
 }
 
+void
+XWindowsKeyState::setFlushDeferred(bool deferred)
+{
+	m_flushDeferred = deferred;
+}
+
 KeyModifierMask
 XWindowsKeyState::mapModifiersFromX(unsigned int state) const
 {
@@ -293,7 +301,9 @@ XWindowsKeyState::fakeKey(const Keystroke& keystroke)
 		}
 		break;
 	}
-	XFlush(m_display);
+	if (!m_flushDeferred) {
+		XFlush(m_display);
+	}
 }
 
 void
@@ -74,6 +74,13 @@ public:
 	*/
 	void				setAutoRepeat(const XKeyboardState&);
 
+	//! Defer flushing
+	/*!
+	While \p deferred is true, synthesized keys are left in xlib's
+	output buffer for the caller to flush.
+	*/
+	void				setFlushDeferred(bool deferred);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -165,6 +172,8 @@ private:
 	// autorepeat state
 	XKeyboardState		m_keyboardState;
 
+	bool				m_flushDeferred;
+
 #ifdef TEST_ENV
 public:
 	SInt32                  group() const { return m_group; }
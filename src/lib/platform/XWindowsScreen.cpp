@@ -34,6 +34,8 @@
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <cstdlib>
 #if X_DISPLAY_MISSING
@@ -73,6 +75,13 @@
 
 static int xi_opcode;
 
+// raw motion asks the server where the pointer is at least this often
+static const UInt32 kXIResyncEvents = 32;
+
+// and always when the pointer is within this many pixels of the jump
+// zone at an edge of the screen
+static const double kXIEdgeSlop = 16.0;
+
 //
 // XWindowsScreen
 //
@@ -119,6 +128,17 @@ XWindowsScreen::XWindowsScreen(
 	m_preserveFocus(false),
 	m_xkb(false),
 	m_xi2detected(false),
+	m_xiTracking(false),
+	m_xiX(0.0), m_xiY(0.0),
+	m_xiSinceSync(0),
+	m_xiTracked(0),
+	m_xiQueries(0),
+	m_fakeInputBatch(0),
+	m_pipelineWarps(true),
+	m_warpPending(false),
+	m_warpSerial(0),
+	m_warpX(0), m_warpY(0),
+	m_eventTime(0),
 	m_xrandr(false),
 	m_events(events),
 	PlatformScreen(events)
@@ -191,9 +211,10 @@ XWindowsScreen::XWindowsScreen(
 							new TMethodEventJob<XWindowsScreen>(this,
 								&XWindowsScreen::handleSystemEvent));
 
-	// install the platform event queue
+	// install the platform event queue.  other threads may only use
+	// the display if xlib was initialized for them.
 	m_events->adoptBuffer(new XWindowsEventQueueBuffer(
-		m_display, m_window, m_events));
+		m_display, m_window, !disableXInitThreads, m_events));
 }
 
 XWindowsScreen::~XWindowsScreen()
@@ -379,6 +400,10 @@ XWindowsScreen::leave()
 	// now off screen
 	m_isOnScreen = false;
 
+	if (m_xi2detected) {
+		LOG((CLOG_DEBUG1 "raw motion: %u tracked, %u pointer queries", m_xiTracked, m_xiQueries));
+	}
+
 	return true;
 }
 
@@ -448,6 +473,7 @@ XWindowsScreen::resetOptions()
 {
 	m_xtestIsXineramaUnaware = true;
 	m_preserveFocus = false;
+	m_pipelineWarps = true;
 }
 
 void
@@ -462,6 +488,10 @@ XWindowsScreen::setOptions(const OptionsList& options)
 			m_preserveFocus = (options[i + 1] != 0);
 			LOG((CLOG_DEBUG1 "Preserve Focus = %s", m_preserveFocus ? "true" : "false"));
 		}
+		else if (options[i] == kOptionXPipelineWarps) {
+			m_pipelineWarps = (options[i + 1] != 0);
+			LOG((CLOG_DEBUG1 "pipeline warps %s", m_pipelineWarps ? "true" : "false"));
+		}
 	}
 }
 
@@ -793,6 +823,27 @@ XWindowsScreen::fakeInputEnd()
 	// FIXME -- not implemented
 }
 
+void
+XWindowsScreen::fakeInputBatchBegin()
+{
+	if (m_fakeInputBatch++ == 0) {
+		m_keyState->setFlushDeferred(true);
+	}
+}
+
+void
+XWindowsScreen::fakeInputBatchEnd()
+{
+	assert(m_fakeInputBatch > 0);
+
+	if (--m_fakeInputBatch == 0) {
+		m_keyState->setFlushDeferred(false);
+
+		// one write for everything since the batch began
+		XFlush(m_display);
+	}
+}
+
 SInt32
 XWindowsScreen::getJumpZoneSize() const
 {
@@ -829,7 +880,7 @@ XWindowsScreen::fakeMouseButton(ButtonID button, bool press)
 	if (xButton != 0) {
 		XTestFakeButtonEvent(m_display, xButton,
 							press ? True : False, CurrentTime);
-		XFlush(m_display);
+		flushFakeInput();
 	}
 }
 
@@ -843,7 +894,7 @@ XWindowsScreen::fakeMouseMove(SInt32 x, SInt32 y)
 		XTestFakeMotionEvent(m_display, DefaultScreen(m_display),
 							x, y, CurrentTime);
 	}
-	XFlush(m_display);
+	flushFakeInput();
 }
 
 void
@@ -856,7 +907,7 @@ XWindowsScreen::fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const
 	else {
 		XTestFakeRelativeMotionEvent(m_display, dx, dy, CurrentTime);
 	}
-	XFlush(m_display);
+	flushFakeInput();
 }
 
 void
@@ -884,6 +935,7 @@ XWindowsScreen::fakeMouseWheel(SInt32, SInt32 yDelta) const
 		if (keycode != 0) {
 			XTestFakeKeyEvent(m_display, keycode, True,  CurrentTime);
 			XTestFakeKeyEvent(m_display, keycode, False, CurrentTime);
+			flushFakeInput();
 		}
 		return;
 	}
@@ -902,7 +954,7 @@ XWindowsScreen::fakeMouseWheel(SInt32, SInt32 yDelta) const
 		XTestFakeButtonEvent(m_display, xButton, True, CurrentTime);
 		XTestFakeButtonEvent(m_display, xButton, False, CurrentTime);
 	}
-	XFlush(m_display);
+	flushFakeInput();
 }
 
 Display*
@@ -1181,6 +1233,10 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 	XEvent* xevent = reinterpret_cast<XEvent*>(event.getData());
 	assert(xevent != NULL);
 
+	if (m_isPrimary) {
+		m_eventTime = ARCH->nanoseconds();
+	}
+
 	// update key state
 	bool isRepeat = false;
 	if (m_isPrimary) {
@@ -1271,25 +1327,9 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 				cookie->type == GenericEvent &&
 				cookie->extension == xi_opcode) {
 			if (cookie->evtype == XI_RawMotion) {
-				// Get current pointer's position
-				Window root, child;
-				XMotionEvent xmotion;
-				xmotion.type = MotionNotify;
-				xmotion.send_event = False; // Raw motion
-				xmotion.display = m_display;
-				xmotion.window = m_window;
-				/* xmotion's time, state and is_hint are not used */
-				unsigned int msk;
-					xmotion.same_screen = XQueryPointer(
-						m_display, m_root, &xmotion.root, &xmotion.subwindow,
-						&xmotion.x_root,
-						&xmotion.y_root,
-						&xmotion.x,
-						&xmotion.y,
-						&msk);
-					onMouseMove(xmotion);
-					XFreeEventData(m_display, cookie);
-					return;
+				onRawMotion(cookie);
+				XFreeEventData(m_display, cookie);
+				return;
 			}
         		XFreeEventData(m_display, cookie);
 		}
@@ -1591,6 +1631,23 @@ XWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 {
 	LOG((CLOG_DEBUG2 "event: MotionNotify %d,%d", xmotion.x_root, xmotion.y_root));
 
+	if (m_warpPending && !xmotion.send_event) {
+		if (!isAfterWarp(xmotion.serial)) {
+			// motion from before a pipelined warp.  it still counts as
+			// motion off screen but the position is stale on screen.
+			if (m_isOnScreen) {
+				return;
+			}
+		}
+		else {
+			// first motion since the warp.  measure from where the
+			// warp put the pointer.
+			m_warpPending = false;
+			m_xCursor     = m_warpX;
+			m_yCursor     = m_warpY;
+		}
+	}
+
 	// compute motion delta (relative to the last known
 	// mouse position)
 	SInt32 x = xmotion.x_root - m_xCursor;
@@ -1619,8 +1676,9 @@ XWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 	}
 	else if (m_isOnScreen) {
 		// motion on primary screen
-		sendEvent(m_events->forIPrimaryScreen().motionOnPrimary(),
-							MotionInfo::alloc(m_xCursor, m_yCursor));
+		MotionInfo* info = MotionInfo::alloc(m_xCursor, m_yCursor);
+		info->m_time     = m_eventTime;
+		sendEvent(m_events->forIPrimaryScreen().motionOnPrimary(), info);
 	}
 	else {
 		// motion on secondary screen.  warp mouse back to
@@ -1636,11 +1694,16 @@ XWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 		// it we only warp when the mouse has moved more
 		// than s_size pixels from the center.
 		static const SInt32 s_size = 32;
-		if (xmotion.x_root - m_xCenter < -s_size ||
+		if (!m_warpPending && (xmotion.x_root - m_xCenter < -s_size ||
 			xmotion.x_root - m_xCenter >  s_size ||
 			xmotion.y_root - m_yCenter < -s_size ||
-			xmotion.y_root - m_yCenter >  s_size) {
-			warpCursorNoFlush(m_xCenter, m_yCenter);
+			xmotion.y_root - m_yCenter >  s_size)) {
+			if (m_pipelineWarps) {
+				warpCursorPipelined(m_xCenter, m_yCenter);
+			}
+			else {
+				warpCursorNoFlush(m_xCenter, m_yCenter);
+			}
 		}
 
 		// send event if mouse moved.  do this after warping
@@ -1650,7 +1713,9 @@ XWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 		// warping to the primary screen's enter position,
 		// effectively overriding it.
 		if (x != 0 || y != 0) {
-			sendEvent(m_events->forIPrimaryScreen().motionOnSecondary(), MotionInfo::alloc(x, y));
+			MotionInfo* info = MotionInfo::alloc(x, y);
+			info->m_time     = m_eventTime;
+			sendEvent(m_events->forIPrimaryScreen().motionOnSecondary(), info);
 		}
 	}
 }
@@ -1919,6 +1984,8 @@ XWindowsScreen::warpCursorNoFlush(SInt32 x, SInt32 y)
 {
 	assert(m_window != None);
 
+	Stopwatch timer;
+
 	// send an event that we can recognize before the mouse warp
 	XEvent eventBefore;
 	eventBefore.type                = MotionNotify;
@@ -1937,14 +2004,54 @@ XWindowsScreen::warpCursorNoFlush(SInt32 x, SInt32 y)
 	XEvent eventAfter               = eventBefore;
 	XSendEvent(m_display, m_window, False, 0, &eventBefore);
 
-	// warp mouse
+	// warp mouse.  raw motion can't see warps so it has to ask where
+	// the pointer is next time.  this also supersedes any pipelined
+	// warp.
 	XWarpPointer(m_display, None, m_root, 0, 0, 0, 0, x, y);
+	m_xiTracking  = false;
+	m_warpPending = false;
 
 	// send an event that we can recognize after the mouse warp
 	XSendEvent(m_display, m_window, False, 0, &eventAfter);
 	XSync(m_display, False);
 
-	LOG((CLOG_DEBUG2 "warped to %d,%d", x, y));
+	LOG((CLOG_DEBUG2 "warped to %d,%d in %.3f ms", x, y, 1000.0 * timer.getTime()));
+}
+
+void
+XWindowsScreen::flushFakeInput() const
+{
+	// in a batch the synthesized events stay in xlib's output buffer,
+	// in order, until the batch ends
+	if (m_fakeInputBatch == 0) {
+		XFlush(m_display);
+	}
+}
+
+void
+XWindowsScreen::warpCursorPipelined(SInt32 x, SInt32 y)
+{
+	Stopwatch timer;
+
+	// don't wait for the server.  every event carries the serial of the
+	// last request the server had processed when it generated the event
+	// so motion from before the warp has a serial less than the warp's.
+	// see onMouseMove().
+	m_warpSerial  = NextRequest(m_display);
+	m_warpPending = true;
+	m_warpX       = x;
+	m_warpY       = y;
+	XWarpPointer(m_display, None, m_root, 0, 0, 0, 0, x, y);
+	XFlush(m_display);
+
+	LOG((CLOG_DEBUG2 "warped to %d,%d in %.3f ms", x, y, 1000.0 * timer.getTime()));
+}
+
+bool
+XWindowsScreen::isAfterWarp(unsigned long serial) const
+{
+	// serials wrap so compare the difference
+	return (static_cast<long>(serial - m_warpSerial) >= 0);
 }
 
 void
@@ -2084,6 +2191,147 @@ XWindowsScreen::detectXI2()
 }
 
 #ifdef HAVE_XI2
+static
+void
+getRawDelta(const XIRawEvent* raw, double& dx, double& dy)
+{
+	// valuators 0 and 1 are x and y.  only the valuators set in the
+	// mask have values, in order.
+	dx = dy = 0.0;
+	const double* value = raw->valuators.values;
+	int n = raw->valuators.mask_len * 8;
+	for (int i = 0; i < n && i < 2; ++i) {
+		if (XIMaskIsSet(raw->valuators.mask, i)) {
+			if (i == 0) {
+				dx = *value;
+			}
+			else {
+				dy = *value;
+			}
+			++value;
+		}
+	}
+}
+
+void
+XWindowsScreen::onRawMotion(XGenericEventCookie* cookie)
+{
+	const XIRawEvent* raw = static_cast<const XIRawEvent*>(cookie->data);
+
+	XMotionEvent xmotion;
+	xmotion.type        = MotionNotify;
+	xmotion.send_event  = False; // Raw motion
+	xmotion.display     = m_display;
+	xmotion.window      = m_window;
+	xmotion.root        = m_root;
+	xmotion.subwindow   = None;
+	xmotion.same_screen = True;
+	xmotion.serial      = cookie->serial;
+	/* xmotion's time, state and is_hint are not used */
+
+	// the first motion after a pipelined warp starts from where the
+	// warp put the pointer
+	if (m_warpPending && isAfterWarp(cookie->serial)) {
+		m_xiX         = m_warpX;
+		m_xiY         = m_warpY;
+		m_xiTracking  = true;
+		m_xiSinceSync = 0;
+	}
+
+	// follow relative devices using the (accelerated) deltas in the
+	// event rather than asking the server where the pointer went,
+	// which is a round trip per event.  the server clamps the pointer
+	// to the screen so we do the same.  anything we can't follow, and
+	// every so often anyway, we ask.  we also ask near the edges since
+	// switching screens mustn't depend on a position that may be off.
+	double dx, dy;
+	getRawDelta(raw, dx, dy);
+	bool follow = (m_xiTracking && m_xiSinceSync < kXIResyncEvents &&
+					isRelativeXIDevice(raw->sourceid) &&
+					fabs(dx) < m_w && fabs(dy) < m_h);
+	double x = 0.0, y = 0.0;
+	if (follow) {
+		x = std::max(static_cast<double>(m_x),
+				std::min(m_xiX + dx, static_cast<double>(m_x + m_w) - 1.0));
+		y = std::max(static_cast<double>(m_y),
+				std::min(m_xiY + dy, static_cast<double>(m_y + m_h) - 1.0));
+		follow = !isNearJumpZone(x, y);
+	}
+	if (follow) {
+		m_xiX = x;
+		m_xiY = y;
+		++m_xiSinceSync;
+		++m_xiTracked;
+		xmotion.x_root = static_cast<int>(floor(m_xiX));
+		xmotion.y_root = static_cast<int>(floor(m_xiY));
+	}
+	else {
+		unsigned int msk;
+		xmotion.same_screen = XQueryPointer(
+			m_display, m_root, &xmotion.root, &xmotion.subwindow,
+			&xmotion.x_root,
+			&xmotion.y_root,
+			&xmotion.x,
+			&xmotion.y,
+			&msk);
+		m_xiX         = xmotion.x_root;
+		m_xiY         = xmotion.y_root;
+		m_xiTracking  = true;
+		m_xiSinceSync = 0;
+		++m_xiQueries;
+
+		// the reply is newer than any warp we've made
+		if (m_warpPending && !isAfterWarp(xmotion.serial)) {
+			xmotion.serial = m_warpSerial;
+		}
+	}
+	xmotion.x = xmotion.x_root;
+	xmotion.y = xmotion.y_root;
+
+	onMouseMove(xmotion);
+}
+
+bool
+XWindowsScreen::isNearJumpZone(double x, double y) const
+{
+	// a followed position can be a few pixels out so look beyond the
+	// jump zone too
+	double zone = getJumpZoneSize() + kXIEdgeSlop;
+	return (x < m_x + zone || x >= m_x + m_w - zone ||
+			y < m_y + zone || y >= m_y + m_h - zone);
+}
+
+bool
+XWindowsScreen::isRelativeXIDevice(int deviceID)
+{
+	XIDeviceModes::const_iterator i = m_xiDeviceModes.find(deviceID);
+	if (i != m_xiDeviceModes.end()) {
+		return i->second;
+	}
+
+	// tablets and touch screens report absolute positions
+	bool relative = false;
+	int n;
+	XIDeviceInfo* info = XIQueryDevice(m_display, deviceID, &n);
+	if (info != NULL) {
+		for (int j = 0; j < info->num_classes; ++j) {
+			const XIAnyClassInfo* any = info->classes[j];
+			if (any->type == XIValuatorClass) {
+				const XIValuatorClassInfo* valuator =
+					reinterpret_cast<const XIValuatorClassInfo*>(any);
+				if (valuator->number == 0) {
+					relative = (valuator->mode == XIModeRelative);
+				}
+			}
+		}
+		XIFreeDeviceInfo(info);
+	}
+	LOG((CLOG_DEBUG1 "input device %d is %s", deviceID, relative ? "relative" : "absolute"));
+
+	m_xiDeviceModes.insert(std::make_pair(deviceID, relative));
+	return relative;
+}
+
 void
 XWindowsScreen::selectXIRawMotion()
 {
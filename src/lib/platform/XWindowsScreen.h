@@ -20,6 +20,7 @@
 
 #include "synergy/PlatformScreen.h"
 #include "synergy/KeyMap.h"
+#include "common/stdmap.h"
 #include "common/stdset.h"
 #include "common/stdvector.h"
 
@@ -69,6 +70,8 @@ public:
 	virtual void		fakeMouseMove(SInt32 x, SInt32 y);
 	virtual void		fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const;
 	virtual void		fakeMouseWheel(SInt32 xDelta, SInt32 yDelta) const;
+	virtual void		fakeInputBatchBegin();
+	virtual void		fakeInputBatchEnd();
 
 	// IPlatformScreen overrides
 	virtual void		enable();
@@ -138,6 +141,9 @@ private:
 
 	bool				detectXI2();
 #ifdef HAVE_XI2
+	void				onRawMotion(XGenericEventCookie*);
+	bool				isRelativeXIDevice(int deviceID);
+	bool				isNearJumpZone(double x, double y) const;
 	void				selectXIRawMotion();
 #endif
 	void				selectEvents(Window) const;
@@ -148,6 +154,9 @@ private:
 	unsigned int		mapButtonToX(ButtonID id) const;
 
 	void				warpCursorNoFlush(SInt32 x, SInt32 y);
+	void				warpCursorPipelined(SInt32 x, SInt32 y);
+	void				flushFakeInput() const;
+	bool				isAfterWarp(unsigned long serial) const;
 
 	void				refreshKeyboard(XEvent*);
 
@@ -239,6 +248,31 @@ private:
 
 	bool				m_xi2detected;
 
+	// pointer position followed from raw motion.  m_xiTracking is false
+	// when the position has to be queried from the server.
+	typedef std::map<int, bool> XIDeviceModes;
+	bool				m_xiTracking;
+	double				m_xiX, m_xiY;
+	UInt32				m_xiSinceSync;
+	UInt32				m_xiTracked;
+	UInt32				m_xiQueries;
+	XIDeviceModes		m_xiDeviceModes;
+
+	// nesting depth of fake input batches
+	UInt32				m_fakeInputBatch;
+
+	// pipelined warps back to the center while off screen.
+	// m_warpPending is true until the first motion event generated
+	// after the warp at serial m_warpSerial.
+	bool				m_pipelineWarps;
+	bool				m_warpPending;
+	unsigned long		m_warpSerial;
+	SInt32				m_warpX, m_warpY;
+
+	// when handleSystemEvent() got the event it's handling.  motion
+	// events are stamped with it for latency tracing.
+	UInt64				m_eventTime;
+
 	// XRandR extension stuff
 	bool                m_xrandr;
 	int                 m_xrandrEventBase;
@@ -40,6 +40,9 @@
 static const int s_maxRetry = 1000;
 static const float s_retryDelay = 0.01f;
 
+// largest payload of a single TLS record
+static const int kMaxRecordSize = 16384;
+
 static const char kFingerprintDirName[] = "SSL/Fingerprints";
 //static const char kFingerprintLocalFilename[] = "Local.txt";
 static const char kFingerprintTrustedServersFilename[] = "TrustedServers.txt";
@@ -55,7 +58,11 @@ SecureSocket::SecureSocket(
 		SocketMultiplexer* socketMultiplexer) :
 	TCPSocket(events, socketMultiplexer),
 	m_secureReady(false),
-	m_fatal(false)
+	m_fatal(false),
+	m_readRetry(0),
+	m_writeRetry(0),
+	m_handshakeRetry(0),
+	m_writeRetrySize(0)
 {
 }
 
@@ -65,7 +72,11 @@ SecureSocket::SecureSocket(
 		ArchSocket socket) :
 	TCPSocket(events, socketMultiplexer, socket),
 	m_secureReady(false),
-	m_fatal(false)
+	m_fatal(false),
+	m_readRetry(0),
+	m_writeRetry(0),
+	m_handshakeRetry(0),
+	m_writeRetrySize(0)
 {
 }
 
@@ -118,13 +129,11 @@ SecureSocket::secureRead(void* buffer, int size, int& read)
 	if (m_ssl->m_ssl != NULL) {
 		LOG((CLOG_DEBUG2 "reading secure socket"));
 		read = SSL_read(m_ssl->m_ssl, buffer, size);
-		
-		static int retry;
 
 		// Check result will cleanup the connection in the case of a fatal
-		checkResult(read, retry);
+		checkResult(read, m_readRetry);
 		
-		if (retry) {
+		if (m_readRetry) {
 			return 0;
 		}
 
@@ -139,30 +148,53 @@ SecureSocket::secureRead(void* buffer, int size, int& read)
 }
 
 int
-SecureSocket::secureWrite(const void* buffer, int size, int& wrote)
+SecureSocket::secureWrite(StreamBuffer& buffer, int& wrote)
 {
-	if (m_ssl->m_ssl != NULL) {
-		LOG((CLOG_DEBUG2 "writing secure socket:%p", this));
-
-		wrote = SSL_write(m_ssl->m_ssl, buffer, size);
-		
-		static int retry;
+	wrote = 0;
+	if (m_ssl->m_ssl == NULL) {
+		return 0;
+	}
 
-		// Check result will cleanup the connection in the case of a fatal
-		checkResult(wrote, retry);
+	// the output may have been discarded since a write was refused
+	if (m_writeRetrySize > (int)buffer.getSize()) {
+		m_writeRetrySize = 0;
+	}
 
-		if (retry) {
-			return 0;
+	// encrypt the queued output as full sized records.  a refused write
+	// must be tried again with the same length, though not necessarily
+	// from the same address since the buffer may have been reallocated.
+	while (buffer.getSize() > 0) {
+		int size = m_writeRetrySize;
+		if (size == 0) {
+			size = (int)buffer.getSize();
+			if (size > kMaxRecordSize) {
+				size = kMaxRecordSize;
+			}
 		}
 
+		LOG((CLOG_DEBUG2 "writing secure socket:%p", this));
+		int n = SSL_write(m_ssl->m_ssl, buffer.peek(size), size);
+
+		// Check result will cleanup the connection in the case of a fatal
+		checkResult(n, m_writeRetry);
+
 		if (isFatal()) {
+			m_writeRetrySize = 0;
 			return -1;
 		}
+
+		if (m_writeRetry) {
+			m_writeRetrySize = size;
+			return 0;
+		}
+
+		// with SSL_MODE_ENABLE_PARTIAL_WRITE n may be less than size
+		m_writeRetrySize = 0;
+		buffer.pop(n);
+		wrote += n;
 	}
-	// According to SSL spec, r must not be negative and not have an error code
-	// from SSL_get_error(). If this happens, it is itself an error. Let the
-	// parent handle the case
-	return wrote;
+
+	return 1;
 }
 
 bool
@@ -248,12 +280,19 @@ SecureSocket::initContext(bool server)
 	SSL_METHOD* m = const_cast<SSL_METHOD*>(method);
 	m_ssl->m_context = SSL_CTX_new(m);
 
-	// drop SSLv3 support
-	SSL_CTX_set_options(m_ssl->m_context, SSL_OP_NO_SSLv3);
-
 	if (m_ssl->m_context == NULL) {
 		showError();
+		return;
 	}
+
+	// drop SSLv3 support
+	SSL_CTX_set_options(m_ssl->m_context, SSL_OP_NO_SSLv3);
+
+	// a retried write may be passed the output buffer at a new address
+	// after it has been consolidated.  partial writes let a write return
+	// after each record instead of after the whole buffer.
+	SSL_CTX_set_mode(m_ssl->m_context,
+		SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER | SSL_MODE_ENABLE_PARTIAL_WRITE);
 }
 
 void
@@ -276,9 +315,8 @@ SecureSocket::secureAccept(int socket)
 	
 	LOG((CLOG_DEBUG2 "accepting secure socket"));
 	int r = SSL_accept(m_ssl->m_ssl);
-	
-	static int retry;
 
+	int& retry = m_handshakeRetry;
 	checkResult(r, retry);
 
 	if (isFatal()) {
@@ -320,9 +358,8 @@ SecureSocket::secureConnect(int socket)
 	
 	LOG((CLOG_DEBUG2 "connecting secure socket"));
 	int r = SSL_connect(m_ssl->m_ssl);
-	
-	static int retry;
 
+	int& retry = m_handshakeRetry;
 	checkResult(r, retry);
 
 	if (isFatal()) {
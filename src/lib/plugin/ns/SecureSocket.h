@@ -49,7 +49,7 @@ public:
 	bool				isSecureReady();
 	bool				isSecure() { return true; }
 	int					secureRead(void* buffer, int size, int& read);
-	int					secureWrite(const void* buffer, int size, int& wrote);
+	int					secureWrite(StreamBuffer& buffer, int& wrote);
 	void				initSsl(bool server);
 	bool				loadCertificates(String& CertFile);
 
@@ -81,4 +81,12 @@ private:
 	Ssl*				m_ssl;
 	bool				m_secureReady;
 	bool				m_fatal;
+
+	// retries of the operation in progress
+	int					m_readRetry;
+	int					m_writeRetry;
+	int					m_handshakeRetry;
+
+	// length of a record that must be written again, or 0
+	int					m_writeRetrySize;
 };
@@ -25,7 +25,9 @@
 BaseClientProxy::BaseClientProxy(const String& name) :
 	m_name(name),
 	m_x(0),
-	m_y(0)
+	m_y(0),
+	m_movesSent(0),
+	m_movesMerged(0)
 {
 	// do nothing
 }
@@ -49,6 +51,31 @@ BaseClientProxy::getJumpCursorPos(SInt32& x, SInt32& y) const
 	y = m_y;
 }
 
+void
+BaseClientProxy::addMouseMoves(UInt32 sent, UInt32 merged)
+{
+	m_movesSent   += sent;
+	m_movesMerged += merged;
+}
+
+void
+BaseClientProxy::traceMouseMove(UInt32)
+{
+	// do nothing
+}
+
+UInt32
+BaseClientProxy::getMouseMovesSent() const
+{
+	return m_movesSent;
+}
+
+UInt32
+BaseClientProxy::getMouseMovesMerged() const
+{
+	return m_movesMerged;
+}
+
 String
 BaseClientProxy::getName() const
 {
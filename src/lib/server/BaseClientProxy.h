@@ -41,6 +41,20 @@ public:
 	*/
 	void				setJumpCursorPos(SInt32 x, SInt32 y);
 
+	//! Count mouse motion
+	/*!
+	Record that \p sent moves were sent to the client and \p merged
+	moves were folded into them by motion coalescing.
+	*/
+	void				addMouseMoves(UInt32 sent, UInt32 merged);
+
+	//! Trace mouse move
+	/*!
+	Traces the next mouse move sent to the client as latency sample
+	\p id.  Does nothing unless isLatencyTraceSupported().
+	*/
+	virtual void		traceMouseMove(UInt32 id);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -51,12 +65,38 @@ public:
 	*/
 	void				getJumpCursorPos(SInt32& x, SInt32& y) const;
 
+	//! Get mouse moves sent
+	/*!
+	Returns the number of mouse moves sent to the client.
+	*/
+	UInt32				getMouseMovesSent() const;
+
+	//! Get mouse moves merged
+	/*!
+	Returns the number of mouse moves that were never sent to the client
+	because a later move replaced them.
+	*/
+	UInt32				getMouseMovesMerged() const;
+
 	//! Get cursor position
 	/*!
 	Return if this proxy is for client or primary.
 	*/
 	virtual bool		isPrimary() const { return false; }
 
+	//! Test for compression
+	/*!
+	Returns true if the client accepts compressed clipboard and file
+	chunks.
+	*/
+	virtual bool		isCompressionSupported() const { return false; }
+
+	//! Test for latency tracing
+	/*!
+	Returns true if the client echoes latency samples.
+	*/
+	virtual bool		isLatencyTraceSupported() const { return false; }
+
 	//@}
 
 	// IScreen
@@ -96,4 +136,6 @@ public:
 private:
 	String				m_name;
 	SInt32				m_x, m_y;
+	UInt32				m_movesSent;
+	UInt32				m_movesMerged;
 };
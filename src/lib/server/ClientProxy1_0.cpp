@@ -19,8 +19,10 @@
 #include "server/ClientProxy1_0.h"
 
 #include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_messages.h"
 #include "synergy/XSynergy.h"
 #include "io/IStream.h"
+#include "mt/Lock.h"
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
@@ -60,8 +62,14 @@ ClientProxy1_0::ClientProxy1_0(const String& name, synergy::IStream* stream, IEv
 
 	setHeartbeatRate(kHeartRate, kHeartRate * kHeartBeatsUntilDeath);
 
+	// messages handled after the handshake
+	setMessageHandler(kMsgDInfo, &ClientProxy1_0::recvInfoUpdate);
+	setMessageHandler(kMsgCNoop, &ClientProxy1_0::recvNoop);
+	setMessageHandler(kMsgCClipboard, &ClientProxy1_0::recvGrabClipboard);
+	setMessageHandler(kMsgDClipboard, &ClientProxy1_0::recvClipboard);
+
 	LOG((CLOG_DEBUG1 "querying client \"%s\" info", getName().c_str()));
-	ProtocolUtil::writef(getStream(), kMsgQInfo);
+	MsgQInfo::write(getStream());
 }
 
 ClientProxy1_0::~ClientProxy1_0()
@@ -116,8 +124,21 @@ void
 ClientProxy1_0::resetHeartbeatTimer()
 {
 	// reset the alarm
-	removeHeartbeatTimer();
-	addHeartbeatTimer();
+	if (!rearmHeartbeatTimer()) {
+		removeHeartbeatTimer();
+		addHeartbeatTimer();
+	}
+}
+
+bool
+ClientProxy1_0::rearmHeartbeatTimer()
+{
+	// push back the existing alarm rather than making a new one
+	if (m_heartbeatTimer == NULL || m_heartbeatAlarm <= 0.0) {
+		return false;
+	}
+	m_events->resetTimer(m_heartbeatTimer, m_heartbeatAlarm);
+	return true;
 }
 
 void
@@ -185,26 +206,17 @@ ClientProxy1_0::parseHandshakeMessage(const UInt8* code)
 bool
 ClientProxy1_0::parseMessage(const UInt8* code)
 {
-	if (memcmp(code, kMsgDInfo, 4) == 0) {
-		if (recvInfo()) {
-			m_events->addEvent(
-							Event(m_events->forIScreen().shapeChanged(), getEventTarget()));
-			return true;
-		}
+	MessageHandler handler = m_messages.find(code);
+	if (handler == NULL) {
 		return false;
 	}
-	else if (memcmp(code, kMsgCNoop, 4) == 0) {
-		// discard no-ops
-		LOG((CLOG_DEBUG2 "no-op from", getName().c_str()));
-		return true;
-	}
-	else if (memcmp(code, kMsgCClipboard, 4) == 0) {
-		return recvGrabClipboard();
-	}
-	else if (memcmp(code, kMsgDClipboard, 4) == 0) {
-		return recvClipboard();
-	}
-	return false;
+	return (this->*handler)();
+}
+
+void
+ClientProxy1_0::setMessageHandler(const char* code, MessageHandler handler)
+{
+	m_messages.set(code, handler);
 }
 
 void
@@ -232,6 +244,7 @@ ClientProxy1_0::handleFlatline(const Event&, void*)
 bool
 ClientProxy1_0::getClipboard(ClipboardID id, IClipboard* clipboard) const
 {
+	Lock lock(&m_clipboardMutex);
 	Clipboard::copy(clipboard, &m_clipboard[id].m_clipboard);
 	return true;
 }
@@ -258,7 +271,7 @@ ClientProxy1_0::enter(SInt32 xAbs, SInt32 yAbs,
 				UInt32 seqNum, KeyModifierMask mask, bool)
 {
 	LOG((CLOG_DEBUG1 "send enter to \"%s\", %d,%d %d %04x", getName().c_str(), xAbs, yAbs, seqNum, mask));
-	ProtocolUtil::writef(getStream(), kMsgCEnter,
+	MsgCEnter::write(getStream(),
 								xAbs, yAbs, seqNum, mask);
 }
 
@@ -266,7 +279,7 @@ bool
 ClientProxy1_0::leave()
 {
 	LOG((CLOG_DEBUG1 "send leave to \"%s\"", getName().c_str()));
-	ProtocolUtil::writef(getStream(), kMsgCLeave);
+	MsgCLeave::write(getStream());
 
 	// we can never prevent the user from leaving
 	return true;
@@ -282,15 +295,17 @@ void
 ClientProxy1_0::grabClipboard(ClipboardID id)
 {
 	LOG((CLOG_DEBUG "send grab clipboard %d to \"%s\"", id, getName().c_str()));
-	ProtocolUtil::writef(getStream(), kMsgCClipboard, id, 0);
+	MsgCClipboard::write(getStream(), id, 0);
 
 	// this clipboard is now dirty
+	Lock lock(&m_clipboardMutex);
 	m_clipboard[id].m_dirty = true;
 }
 
 void
 ClientProxy1_0::setClipboardDirty(ClipboardID id, bool dirty)
 {
+	Lock lock(&m_clipboardMutex);
 	m_clipboard[id].m_dirty = dirty;
 }
 
@@ -298,7 +313,7 @@ void
 ClientProxy1_0::keyDown(KeyID key, KeyModifierMask mask, KeyButton)
 {
 	LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
-	ProtocolUtil::writef(getStream(), kMsgDKeyDown1_0, key, mask);
+	MsgDKeyDown1_0::write(getStream(), key, mask);
 }
 
 void
@@ -306,35 +321,35 @@ ClientProxy1_0::keyRepeat(KeyID key, KeyModifierMask mask,
 				SInt32 count, KeyButton)
 {
 	LOG((CLOG_DEBUG1 "send key repeat to \"%s\" id=%d, mask=0x%04x, count=%d", getName().c_str(), key, mask, count));
-	ProtocolUtil::writef(getStream(), kMsgDKeyRepeat1_0, key, mask, count);
+	MsgDKeyRepeat1_0::write(getStream(), key, mask, count);
 }
 
 void
 ClientProxy1_0::keyUp(KeyID key, KeyModifierMask mask, KeyButton)
 {
 	LOG((CLOG_DEBUG1 "send key up to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
-	ProtocolUtil::writef(getStream(), kMsgDKeyUp1_0, key, mask);
+	MsgDKeyUp1_0::write(getStream(), key, mask);
 }
 
 void
 ClientProxy1_0::mouseDown(ButtonID button)
 {
 	LOG((CLOG_DEBUG1 "send mouse down to \"%s\" id=%d", getName().c_str(), button));
-	ProtocolUtil::writef(getStream(), kMsgDMouseDown, button);
+	MsgDMouseDown::write(getStream(), button);
 }
 
 void
 ClientProxy1_0::mouseUp(ButtonID button)
 {
 	LOG((CLOG_DEBUG1 "send mouse up to \"%s\" id=%d", getName().c_str(), button));
-	ProtocolUtil::writef(getStream(), kMsgDMouseUp, button);
+	MsgDMouseUp::write(getStream(), button);
 }
 
 void
 ClientProxy1_0::mouseMove(SInt32 xAbs, SInt32 yAbs)
 {
 	LOG((CLOG_DEBUG2 "send mouse move to \"%s\" %d,%d", getName().c_str(), xAbs, yAbs));
-	ProtocolUtil::writef(getStream(), kMsgDMouseMove, xAbs, yAbs);
+	MsgDMouseMove::write(getStream(), xAbs, yAbs);
 }
 
 void
@@ -348,7 +363,7 @@ ClientProxy1_0::mouseWheel(SInt32, SInt32 yDelta)
 {
 	// clients prior to 1.3 only support the y axis
 	LOG((CLOG_DEBUG2 "send mouse wheel to \"%s\" %+d", getName().c_str(), yDelta));
-	ProtocolUtil::writef(getStream(), kMsgDMouseWheel1_0, yDelta);
+	MsgDMouseWheel1_0::write(getStream(), yDelta);
 }
 
 void
@@ -369,14 +384,14 @@ void
 ClientProxy1_0::screensaver(bool on)
 {
 	LOG((CLOG_DEBUG1 "send screen saver to \"%s\" on=%d", getName().c_str(), on ? 1 : 0));
-	ProtocolUtil::writef(getStream(), kMsgCScreenSaver, on ? 1 : 0);
+	MsgCScreenSaver::write(getStream(), on ? 1 : 0);
 }
 
 void
 ClientProxy1_0::resetOptions()
 {
 	LOG((CLOG_DEBUG1 "send reset options to \"%s\"", getName().c_str()));
-	ProtocolUtil::writef(getStream(), kMsgCResetOptions);
+	MsgCResetOptions::write(getStream());
 
 	// reset heart rate and death
 	resetHeartbeatRate();
@@ -409,7 +424,7 @@ ClientProxy1_0::recvInfo()
 {
 	// parse the message
 	SInt16 x, y, w, h, dummy1, mx, my;
-	if (!ProtocolUtil::readf(getStream(), kMsgDInfo + 4,
+	if (!MsgDInfo::read(getStream(),
 							&x, &y, &w, &h, &dummy1, &mx, &my)) {
 		return false;
 	}
@@ -434,7 +449,26 @@ ClientProxy1_0::recvInfo()
 
 	// acknowledge receipt
 	LOG((CLOG_DEBUG1 "send info ack to \"%s\"", getName().c_str()));
-	ProtocolUtil::writef(getStream(), kMsgCInfoAck);
+	MsgCInfoAck::write(getStream());
+	return true;
+}
+
+bool
+ClientProxy1_0::recvInfoUpdate()
+{
+	if (recvInfo()) {
+		m_events->addEvent(
+						Event(m_events->forIScreen().shapeChanged(), getEventTarget()));
+		return true;
+	}
+	return false;
+}
+
+bool
+ClientProxy1_0::recvNoop()
+{
+	// discard no-ops
+	LOG((CLOG_DEBUG2 "no-op from", getName().c_str()));
 	return true;
 }
 
@@ -451,7 +485,7 @@ ClientProxy1_0::recvGrabClipboard()
 	// parse message
 	ClipboardID id;
 	UInt32 seqNum;
-	if (!ProtocolUtil::readf(getStream(), kMsgCClipboard + 4, &id, &seqNum)) {
+	if (!MsgCClipboard::read(getStream(), &id, &seqNum)) {
 		return false;
 	}
 	LOG((CLOG_DEBUG "received client \"%s\" grabbed clipboard %d seqnum=%d", getName().c_str(), id, seqNum));
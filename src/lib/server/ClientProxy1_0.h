@@ -21,6 +21,8 @@
 #include "server/ClientProxy.h"
 #include "synergy/Clipboard.h"
 #include "synergy/protocol_types.h"
+#include "synergy/TMessageTable.h"
+#include "mt/Mutex.h"
 
 class Event;
 class EventQueueTimer;
@@ -62,14 +64,27 @@ public:
 	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize);
 
 protected:
+	typedef TMessageTable<ClientProxy1_0, bool> MessageTable;
+	typedef MessageTable::Handler MessageHandler;
+
 	virtual bool		parseHandshakeMessage(const UInt8* code);
-	virtual bool		parseMessage(const UInt8* code);
+	bool				parseMessage(const UInt8* code);
+
+	//! Set message handler
+	/*!
+	Handle messages with code \c code using \c handler.  Proxies for
+	later protocol versions call this from their constructor to add
+	messages or to replace the handler for an existing message.
+	*/
+	void				setMessageHandler(const char* code,
+							MessageHandler handler);
 
 	virtual void		resetHeartbeatRate();
 	virtual void		setHeartbeatRate(double rate, double alarm);
 	virtual void		resetHeartbeatTimer();
 	virtual void		addHeartbeatTimer();
 	virtual void		removeHeartbeatTimer();
+	bool				rearmHeartbeatTimer();
 	virtual bool		recvClipboard();
 private:
 	void				disconnect();
@@ -81,6 +96,8 @@ private:
 	void				handleFlatline(const Event&, void*);
 
 	bool				recvInfo();
+	bool				recvInfoUpdate();
+	bool				recvNoop();
 	bool				recvGrabClipboard();
 
 protected:
@@ -96,6 +113,9 @@ protected:
 
 	ClientClipboard	m_clipboard[kClipboardEnd];
 
+	// guards m_clipboard, which the server's clipboard thread uses too
+	mutable Mutex	m_clipboardMutex;
+
 private:
 	typedef bool (ClientProxy1_0::*MessageParser)(const UInt8*);
 
@@ -103,5 +123,6 @@ private:
 	double				m_heartbeatAlarm;
 	EventQueueTimer*	m_heartbeatTimer;
 	MessageParser		m_parser;
+	MessageTable		m_messages;
 	IEventQueue*		m_events;
 };
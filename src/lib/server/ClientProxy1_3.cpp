@@ -19,6 +19,7 @@
 #include "server/ClientProxy1_3.h"
 
 #include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_messages.h"
 #include "base/Log.h"
 #include "base/IEventQueue.h"
 #include "base/TMethodEventJob.h"
@@ -37,6 +38,9 @@ ClientProxy1_3::ClientProxy1_3(const String& name, synergy::IStream* stream, IEv
 	m_events(events)
 {
 	setHeartbeatRate(kKeepAliveRate, kKeepAliveRate * kKeepAlivesUntilDeath);
+
+	setMessageHandler(kMsgCKeepAlive,
+		static_cast<MessageHandler>(&ClientProxy1_3::recvKeepAlive));
 }
 
 ClientProxy1_3::~ClientProxy1_3()
@@ -49,21 +53,15 @@ void
 ClientProxy1_3::mouseWheel(SInt32 xDelta, SInt32 yDelta)
 {
 	LOG((CLOG_DEBUG2 "send mouse wheel to \"%s\" %+d,%+d", getName().c_str(), xDelta, yDelta));
-	ProtocolUtil::writef(getStream(), kMsgDMouseWheel, xDelta, yDelta);
+	MsgDMouseWheel::write(getStream(), xDelta, yDelta);
 }
 
 bool
-ClientProxy1_3::parseMessage(const UInt8* code)
+ClientProxy1_3::recvKeepAlive()
 {
-	// process message
-	if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
-		// reset alarm
-		resetHeartbeatTimer();
-		return true;
-	}
-	else {
-		return ClientProxy1_2::parseMessage(code);
-	}
+	// reset alarm
+	resetHeartbeatTimer();
+	return true;
 }
 
 void
@@ -83,8 +81,10 @@ void
 ClientProxy1_3::resetHeartbeatTimer()
 {
 	// reset the alarm but not the keep alive timer
-	ClientProxy1_2::removeHeartbeatTimer();
-	ClientProxy1_2::addHeartbeatTimer();
+	if (!rearmHeartbeatTimer()) {
+		ClientProxy1_2::removeHeartbeatTimer();
+		ClientProxy1_2::addHeartbeatTimer();
+	}
 }
 
 void
@@ -125,5 +125,5 @@ ClientProxy1_3::handleKeepAlive(const Event&, void*)
 void
 ClientProxy1_3::keepAlive()
 {
-	ProtocolUtil::writef(getStream(), kMsgCKeepAlive);
+	MsgCKeepAlive::write(getStream());
 }
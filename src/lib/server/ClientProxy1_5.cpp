@@ -18,6 +18,7 @@
 #include "server/ClientProxy1_5.h"
 
 #include "server/Server.h"
+#include "synergy/ChunkCompressor.h"
 #include "synergy/FileChunk.h"
 #include "synergy/StreamChunker.h"
 #include "synergy/ProtocolUtil.h"
@@ -35,6 +36,10 @@ ClientProxy1_5::ClientProxy1_5(const String& name, synergy::IStream* stream, Ser
 	ClientProxy1_4(name, stream, server, events),
 	m_events(events)
 {
+	setMessageHandler(kMsgDFileTransfer,
+		static_cast<MessageHandler>(&ClientProxy1_5::fileChunkReceived));
+	setMessageHandler(kMsgDDragInfo,
+		static_cast<MessageHandler>(&ClientProxy1_5::dragInfoReceived));
 }
 
 ClientProxy1_5::~ClientProxy1_5()
@@ -53,33 +58,29 @@ void
 ClientProxy1_5::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
 {
 	keepAlive();
-	FileChunk::send(getStream(), mark, data, dataSize);
-}
 
-bool
-ClientProxy1_5::parseMessage(const UInt8* code)
-{
-	if (memcmp(code, kMsgDFileTransfer, 4) == 0) {
-		fileChunkReceived();
-	}
-	else if (memcmp(code, kMsgDDragInfo, 4) == 0) {
-		dragInfoReceived();
-	}
-	else {
-		return ClientProxy1_4::parseMessage(code);
+	// the transfer may have started for a screen that could take
+	// compressed chunks
+	if (mark == kDataCompressed && !isCompressionSupported()) {
+		String chunk;
+		if (!ChunkCompressor::decompress(String(data, dataSize), chunk)) {
+			LOG((CLOG_ERR "dropped corrupted compressed file chunk"));
+			return;
+		}
+		FileChunk::send(getStream(), kDataChunk, &chunk[0], chunk.size());
+		return;
 	}
 
-	return true;
+	FileChunk::send(getStream(), mark, data, dataSize);
 }
 
-void
+bool
 ClientProxy1_5::fileChunkReceived()
 {
 	Server* server = getServer();
 	int result = FileChunk::assemble(
 					getStream(),
-					server->getReceivedFileData(),
-					server->getExpectedFileSize());
+					server->getFileReceiver());
 	
 
 	if (result == kFinish) {
@@ -91,9 +92,11 @@ ClientProxy1_5::fileChunkReceived()
 			LOG((CLOG_DEBUG "start receiving %s", filename.c_str()));
 		}
 	}
+
+	return true;
 }
 
-void
+bool
 ClientProxy1_5::dragInfoReceived()
 {
 	// parse
@@ -102,4 +105,6 @@ ClientProxy1_5::dragInfoReceived()
 	ProtocolUtil::readf(getStream(), kMsgDDragInfo + 4, &fileNum, &content);
 	
 	m_server->dragInfoReceived(fileNum, content);
+
+	return true;
 }
@@ -32,9 +32,8 @@ public:
 
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info, size_t size);
 	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize);
-	virtual bool		parseMessage(const UInt8* code);
-	void				fileChunkReceived();
-	void				dragInfoReceived();
+	bool				fileChunkReceived();
+	bool				dragInfoReceived();
 
 private:
 	IEventQueue*		m_events;
@@ -22,6 +22,7 @@
 #include "synergy/StreamChunker.h"
 #include "synergy/ClipboardChunk.h"
 #include "io/IStream.h"
+#include "mt/Lock.h"
 #include "base/TMethodEventJob.h"
 #include "base/Log.h"
 
@@ -47,26 +48,51 @@ void
 ClientProxy1_6::setClipboard(ClipboardID id, const IClipboard* clipboard)
 {
 	// ignore if this clipboard is already clean
-	if (m_clipboard[id].m_dirty) {
+	{
+		Lock lock(&m_clipboardMutex);
+		if (!m_clipboard[id].m_dirty) {
+			return;
+		}
+
 		// this clipboard is now clean
 		m_clipboard[id].m_dirty = false;
+	}
 
-		// add keep alive message before we do clipboard copy
-		// in case there is a big data inside and time that would
-		// comsume will cause connecton being dropped 
-		keepAlive();
+	// add keep alive message before we do clipboard copy
+	// in case there is a big data inside and time that would
+	// comsume will cause connecton being dropped 
+	keepAlive();
 
+	{
+		Lock lock(&m_clipboardMutex);
 		Clipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
+	}
 
-		String data = m_clipboard[id].m_clipboard.marshall();
+	sendClipboard(id);
+}
 
-		size_t size = data.size();
-		LOG((CLOG_DEBUG "sending clipboard %d to \"%s\"", id, getName().c_str()));
+void
+ClientProxy1_6::sendClipboard(ClipboardID id)
+{
+	String data;
+	{
+		Lock lock(&m_clipboardMutex);
+		data = m_clipboard[id].m_clipboard.marshall();
+	}
 
-		StreamChunker::sendClipboard(data, size, id, 0, m_events, this);
+	size_t size = data.size();
+	LOG((CLOG_DEBUG "sending clipboard %d to \"%s\"", id, getName().c_str()));
 
-		LOG((CLOG_DEBUG "sent clipboard size=%d", size));
-	}
+	StreamChunker::sendClipboard(data, size, id, 0, m_events, this,
+								isCompressionSupported());
+
+	LOG((CLOG_DEBUG "sent clipboard size=%d", size));
+}
+
+void
+ClientProxy1_6::onClipboardReceived(ClipboardID)
+{
+	// do nothing
 }
 
 void
@@ -96,9 +122,13 @@ ClientProxy1_6::recvClipboard()
 		LOG((CLOG_DEBUG "received client \"%s\" clipboard %d seqnum=%d, size=%d",
 				getName().c_str(), id, seq, dataCached.size()));
 		// save clipboard
-		m_clipboard[id].m_clipboard.unmarshall(dataCached, 0);
-		m_clipboard[id].m_sequenceNumber = seq;
-		
+		{
+			Lock lock(&m_clipboardMutex);
+			m_clipboard[id].m_clipboard.unmarshall(dataCached, 0);
+			m_clipboard[id].m_sequenceNumber = seq;
+			onClipboardReceived(id);
+		}
+
 		// notify
 		ClipboardInfo* info = new ClipboardInfo;
 		info->m_id = id;
@@ -31,6 +31,21 @@ public:
 	virtual void		setClipboard(ClipboardID id, const IClipboard* clipboard);
 	virtual bool		recvClipboard();
 
+protected:
+	//! Send clipboard
+	/*!
+	Streams clipboard \p id, which setClipboard() has just copied, to
+	the client.
+	*/
+	virtual void		sendClipboard(ClipboardID id);
+
+	//! Clipboard received
+	/*!
+	Called after clipboard \p id has been received from the client and
+	saved, with m_clipboardMutex held.
+	*/
+	virtual void		onClipboardReceived(ClipboardID id);
+
 private:
 	void				handleClipboardSendingEvent(const Event&, void*);
 
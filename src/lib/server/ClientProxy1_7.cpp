@@ -0,0 +1,115 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "server/ClientProxy1_7.h"
+
+#include "server/Server.h"
+#include "synergy/ClipboardChunk.h"
+#include "synergy/protocol_messages.h"
+#include "mt/Lock.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+
+//
+// ClientProxy1_7
+//
+
+ClientProxy1_7::ClientProxy1_7(const String& name, synergy::IStream* stream, Server* server, IEventQueue* events) :
+	ClientProxy1_6(name, stream, server, events),
+	m_events(events)
+{
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		m_cached[id] = false;
+	}
+
+	setMessageHandler(kMsgCClipboardMissing,
+		static_cast<MessageHandler>(&ClientProxy1_7::recvClipboardMissing));
+}
+
+ClientProxy1_7::~ClientProxy1_7()
+{
+}
+
+void
+ClientProxy1_7::sendClipboard(ClipboardID id)
+{
+	// runs on the server's clipboard thread
+	Clipboard::Hash hash;
+	{
+		Lock lock(&m_clipboardMutex);
+		hash = m_clipboard[id].m_clipboard.getHash();
+		if (m_cached[id] && hash == m_cachedHash[id]) {
+			// the client already has it
+			LOG((CLOG_DEBUG "sending cached clipboard %d to \"%s\"", id, getName().c_str()));
+			ClipboardChunk* notice = ClipboardChunk::cached(id, 0,
+									hash.m_high, hash.m_low);
+			m_events->addEvent(Event(m_events->forClipboard().clipboardSending(),
+									this, notice));
+			return;
+		}
+	}
+
+	ClientProxy1_6::sendClipboard(id);
+
+	Lock lock(&m_clipboardMutex);
+	m_cached[id]     = true;
+	m_cachedHash[id] = hash;
+}
+
+void
+ClientProxy1_7::onClipboardReceived(ClipboardID id)
+{
+	// the client keeps what it sends us
+	m_cached[id]     = true;
+	m_cachedHash[id] = m_clipboard[id].m_clipboard.getHash();
+}
+
+bool
+ClientProxy1_7::recvClipboardMissing()
+{
+	// parse message
+	ClipboardID id;
+	Clipboard::Hash hash;
+	if (!MsgCClipboardMissing::read(getStream(), &id,
+							&hash.m_high, &hash.m_low)) {
+		return false;
+	}
+	LOG((CLOG_DEBUG "recv client \"%s\" missing clipboard %d", getName().c_str(), id));
+
+	// validate
+	if (id >= kClipboardEnd) {
+		return false;
+	}
+
+	{
+		Lock lock(&m_clipboardMutex);
+
+		// ignore a reply about a clipboard we've since replaced
+		if (!m_cached[id] || hash != m_cachedHash[id]) {
+			return true;
+		}
+
+		// send the data after all
+		m_cached[id]            = false;
+		m_clipboard[id].m_dirty = true;
+	}
+
+	// let the server's clipboard thread do the sending
+	getServer()->resendClipboards(this);
+	return true;
+}
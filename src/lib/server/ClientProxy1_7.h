@@ -0,0 +1,52 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "server/ClientProxy1_6.h"
+
+class Server;
+class IEventQueue;
+
+//! Proxy for client implementing protocol version 1.7
+/*!
+The client keeps the last clipboard it sent or received for each
+clipboard identifier.  The proxy tracks the hash of that clipboard and
+when it's what the client should get it sends just the hash instead of
+all of the data.
+*/
+class ClientProxy1_7 : public ClientProxy1_6 {
+public:
+	ClientProxy1_7(const String& name, synergy::IStream* adoptedStream, Server* server, IEventQueue* events);
+	~ClientProxy1_7();
+
+protected:
+	// ClientProxy1_6 overrides
+	virtual void		sendClipboard(ClipboardID id);
+	virtual void		onClipboardReceived(ClipboardID id);
+
+private:
+	bool				recvClipboardMissing();
+
+private:
+	// hash of the clipboard the client has kept for each identifier
+	bool				m_cached[kClipboardEnd];
+	Clipboard::Hash		m_cachedHash[kClipboardEnd];
+
+	IEventQueue*		m_events;
+};
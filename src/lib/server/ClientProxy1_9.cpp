@@ -0,0 +1,100 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "server/ClientProxy1_9.h"
+
+#include "server/Server.h"
+#include "synergy/LatencyTrace.h"
+#include "synergy/protocol_messages.h"
+#include "base/Log.h"
+#include "arch/Arch.h"
+
+//
+// ClientProxy1_9
+//
+
+ClientProxy1_9::ClientProxy1_9(const String& name, synergy::IStream* stream, Server* server, IEventQueue* events) :
+	ClientProxy1_8(name, stream, server, events),
+	m_traceID(0)
+{
+	setMessageHandler(kMsgDTraceEcho,
+		static_cast<MessageHandler>(&ClientProxy1_9::recvTraceEcho));
+}
+
+ClientProxy1_9::~ClientProxy1_9()
+{
+}
+
+void
+ClientProxy1_9::traceMouseMove(UInt32 id)
+{
+	m_traceID = id;
+}
+
+bool
+ClientProxy1_9::isLatencyTraceSupported() const
+{
+	return true;
+}
+
+void
+ClientProxy1_9::mouseMove(SInt32 xAbs, SInt32 yAbs)
+{
+	if (m_traceID != 0) {
+		sendTraceMark();
+	}
+	ClientProxy1_8::mouseMove(xAbs, yAbs);
+}
+
+void
+ClientProxy1_9::mouseRelativeMove(SInt32 xRel, SInt32 yRel)
+{
+	if (m_traceID != 0) {
+		sendTraceMark();
+	}
+	ClientProxy1_8::mouseRelativeMove(xRel, yRel);
+}
+
+void
+ClientProxy1_9::sendTraceMark()
+{
+	// the mark goes out just ahead of the move it's for
+	LatencyTrace* trace = getServer()->getLatencyTrace();
+	if (trace != NULL) {
+		MsgDTraceMark::write(getStream(), m_traceID);
+		trace->sent(m_traceID, ARCH->nanoseconds());
+	}
+	m_traceID = 0;
+}
+
+bool
+ClientProxy1_9::recvTraceEcho()
+{
+	UInt32 id, clientTime;
+	if (!MsgDTraceEcho::read(getStream(), &id, &clientTime)) {
+		return false;
+	}
+	LOG((CLOG_DEBUG2 "recv trace echo %u from \"%s\": %u us", id, getName().c_str(), clientTime));
+
+	LatencyTrace* trace = getServer()->getLatencyTrace();
+	if (trace != NULL) {
+		trace->echoed(id, static_cast<UInt64>(clientTime) * 1000,
+							ARCH->nanoseconds());
+	}
+	return true;
+}
@@ -0,0 +1,52 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "server/ClientProxy1_8.h"
+
+class Server;
+class IEventQueue;
+
+//! Proxy for client implementing protocol version 1.9
+/*!
+The client echoes latency trace samples.  When the server traces a
+mouse move the proxy sends a kMsgDTraceMark ahead of it and passes the
+client's kMsgDTraceEcho on to the server's LatencyTrace.
+*/
+class ClientProxy1_9 : public ClientProxy1_8 {
+public:
+	ClientProxy1_9(const String& name, synergy::IStream* adoptedStream, Server* server, IEventQueue* events);
+	~ClientProxy1_9();
+
+	// BaseClientProxy overrides
+	virtual void		traceMouseMove(UInt32 id);
+	virtual bool		isLatencyTraceSupported() const;
+
+	// IClient overrides
+	virtual void		mouseMove(SInt32 xAbs, SInt32 yAbs);
+	virtual void		mouseRelativeMove(SInt32 xRel, SInt32 yRel);
+
+private:
+	void				sendTraceMark();
+	bool				recvTraceEcho();
+
+private:
+	// the sample to mark the next move with, or zero
+	UInt32				m_traceID;
+};
@@ -26,8 +26,12 @@
 #include "server/ClientProxy1_4.h"
 #include "server/ClientProxy1_5.h"
 #include "server/ClientProxy1_6.h"
+#include "server/ClientProxy1_7.h"
+#include "server/ClientProxy1_8.h"
+#include "server/ClientProxy1_9.h"
 #include "synergy/protocol_types.h"
 #include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_messages.h"
 #include "synergy/XSynergy.h"
 #include "io/IStream.h"
 #include "io/XIO.h"
@@ -232,6 +236,18 @@ ClientProxyUnknown::handleData(const Event&, void*)
 			case 6:
 				m_proxy = new ClientProxy1_6(name, m_stream, m_server, m_events);
 				break;
+
+			case 7:
+				m_proxy = new ClientProxy1_7(name, m_stream, m_server, m_events);
+				break;
+
+			case 8:
+				m_proxy = new ClientProxy1_8(name, m_stream, m_server, m_events);
+				break;
+
+			case 9:
+				m_proxy = new ClientProxy1_9(name, m_stream, m_server, m_events);
+				break;
 			}
 		}
 
@@ -258,7 +274,7 @@ ClientProxyUnknown::handleData(const Event&, void*)
 	catch (XBadClient&) {
 		// client not behaving
 		LOG((CLOG_WARN "protocol error from client \"%s\"", name.c_str()));
-		ProtocolUtil::writef(m_stream, kMsgEBad);
+		MsgEBad::write(m_stream);
 	}
 	catch (XBase& e) {
 		// misc error
@@ -765,6 +765,9 @@ Config::readSectionOptions(ConfigReadContext& s)
 		else if (name == "win32KeepForeground") {
 			addOption("", kOptionWin32KeepForeground, s.parseBoolean(value));
 		}
+		else if (name == "mouseMoveCoalesce") {
+			addOption("", kOptionMouseMoveCoalesce, s.parseInt(value));
+		}
 		else {
 			handled = false;
 		}
@@ -920,6 +923,10 @@ Config::readSectionScreens(ConfigReadContext& s)
 				addOption(screen, kOptionScreenPreserveFocus,
 					s.parseBoolean(value));
 			}
+			else if (name == "pipelineWarps") {
+				addOption(screen, kOptionXPipelineWarps,
+					s.parseBoolean(value));
+			}
 			else {
 				// unknown argument
 				throw XConfigRead(s, "unknown argument \"%{1}\"", name);
@@ -1376,6 +1383,12 @@ Config::getOptionName(OptionID id)
 	if (id == kOptionScreenPreserveFocus) {
 		return "preserveFocus";
 	}
+	if (id == kOptionMouseMoveCoalesce) {
+		return "mouseMoveCoalesce";
+	}
+	if (id == kOptionXPipelineWarps) {
+		return "pipelineWarps";
+	}
 	return NULL;
 }
 
@@ -1392,7 +1405,8 @@ Config::getOptionValue(OptionID id, OptionValue value)
 		id == kOptionXTestXineramaUnaware ||
 		id == kOptionRelativeMouseMoves ||
 		id == kOptionWin32KeepForeground ||
-		id == kOptionScreenPreserveFocus) {
+		id == kOptionScreenPreserveFocus ||
+		id == kOptionXPipelineWarps) {
 		return (value != 0) ? "true" : "false";
 	}
 	if (id == kOptionModifierMapForShift ||
@@ -1427,7 +1441,8 @@ Config::getOptionValue(OptionID id, OptionValue value)
 	if (id == kOptionHeartbeat ||
 		id == kOptionScreenSwitchCornerSize ||
 		id == kOptionScreenSwitchDelay ||
-		id == kOptionScreenSwitchTwoTap) {
+		id == kOptionScreenSwitchTwoTap ||
+		id == kOptionMouseMoveCoalesce) {
 		return synergy::string::sprintf("%d", value);
 	}
 	if (id == kOptionScreenSwitchCorners) {
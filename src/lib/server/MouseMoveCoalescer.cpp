@@ -0,0 +1,211 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/MouseMoveCoalescer.h"
+
+#include "server/BaseClientProxy.h"
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/Log.h"
+
+//
+// MouseMoveCoalescer
+//
+
+MouseMoveCoalescer::MouseMoveCoalescer(IEventQueue* events) :
+	m_events(events),
+	m_client(NULL),
+	m_timer(NULL),
+	m_window(0.0),
+	m_busy(false),
+	m_pending(false),
+	m_relative(false),
+	m_x(0),
+	m_y(0),
+	m_merged(0)
+{
+	m_events->adoptHandler(Event::kTimer, this,
+							new TMethodEventJob<MouseMoveCoalescer>(this,
+								&MouseMoveCoalescer::handleTimer));
+}
+
+MouseMoveCoalescer::~MouseMoveCoalescer()
+{
+	discard();
+	setClient(NULL);
+	m_events->removeHandler(Event::kTimer, this);
+}
+
+void
+MouseMoveCoalescer::setWindow(double window)
+{
+	if (window <= 0.0) {
+		flush();
+		window = 0.0;
+	}
+	m_window = window;
+}
+
+void
+MouseMoveCoalescer::setClient(BaseClientProxy* client)
+{
+	if (client == m_client) {
+		return;
+	}
+
+	flush();
+	if (m_client != NULL) {
+		LOG((CLOG_DEBUG1 "mouse moves to \"%s\": %u sent, %u merged", m_client->getName().c_str(), m_client->getMouseMovesSent(), m_client->getMouseMovesMerged()));
+	}
+
+	// a new client starts out idle
+	m_client = client;
+	m_busy   = false;
+}
+
+void
+MouseMoveCoalescer::mouseMove(SInt32 x, SInt32 y)
+{
+	if (m_client == NULL) {
+		return;
+	}
+
+	if (m_pending) {
+		if (!m_relative) {
+			// the newer position replaces the held one
+			m_x = x;
+			m_y = y;
+			++m_merged;
+			return;
+		}
+
+		// can't merge absolute with relative motion
+		send();
+	}
+
+	m_pending  = true;
+	m_relative = false;
+	m_x        = x;
+	m_y        = y;
+	hold();
+}
+
+void
+MouseMoveCoalescer::mouseRelativeMove(SInt32 dx, SInt32 dy)
+{
+	if (m_client == NULL) {
+		return;
+	}
+
+	if (m_pending) {
+		if (m_relative) {
+			m_x += dx;
+			m_y += dy;
+			++m_merged;
+			return;
+		}
+
+		// can't merge relative with absolute motion
+		send();
+	}
+
+	m_pending  = true;
+	m_relative = true;
+	m_x        = dx;
+	m_y        = dy;
+	hold();
+}
+
+void
+MouseMoveCoalescer::outputFlushed()
+{
+	m_busy = false;
+	send();
+}
+
+void
+MouseMoveCoalescer::flush()
+{
+	send();
+}
+
+void
+MouseMoveCoalescer::discard()
+{
+	if (m_timer != NULL) {
+		m_events->deleteTimer(m_timer);
+		m_timer = NULL;
+	}
+	m_pending = false;
+	m_merged  = 0;
+}
+
+double
+MouseMoveCoalescer::getWindow() const
+{
+	return m_window;
+}
+
+bool
+MouseMoveCoalescer::isPending() const
+{
+	return m_pending;
+}
+
+void
+MouseMoveCoalescer::hold()
+{
+	// send right away unless the client is still working on the last
+	// move.  in that case wait for it to catch up, but no longer than
+	// the merge window.
+	if (!m_busy || m_window == 0.0) {
+		send();
+	}
+	else if (m_timer == NULL) {
+		m_timer = m_events->newOneShotTimer(m_window, this);
+	}
+}
+
+void
+MouseMoveCoalescer::send()
+{
+	if (!m_pending) {
+		return;
+	}
+
+	SInt32 x      = m_x;
+	SInt32 y      = m_y;
+	UInt32 merged = m_merged;
+	bool relative = m_relative;
+	discard();
+
+	if (relative) {
+		m_client->mouseRelativeMove(x, y);
+	}
+	else {
+		m_client->mouseMove(x, y);
+	}
+	m_client->addMouseMoves(1, merged);
+	m_busy = true;
+}
+
+void
+MouseMoveCoalescer::handleTimer(const Event&, void*)
+{
+	// send() deletes the expired timer
+	send();
+}
@@ -0,0 +1,121 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/Event.h"
+#include "common/basic_types.h"
+
+class BaseClientProxy;
+class EventQueueTimer;
+class IEventQueue;
+
+//! Mouse motion coalescer
+/*!
+Sits between the server and the active client and merges mouse motion
+that the client can't take yet.  Motion is sent at once while the
+client's stream is idle.  Once a move is on the wire, later moves are
+held back and merged until the stream reports that it has flushed or
+the merge window expires, whichever comes first.
+
+The server must call flush() before sending the client anything else
+so that motion is never reordered with respect to keys and buttons.
+*/
+class MouseMoveCoalescer {
+public:
+	MouseMoveCoalescer(IEventQueue* events);
+	~MouseMoveCoalescer();
+
+	//! @name manipulators
+	//@{
+
+	//! Set merge window
+	/*!
+	Motion is held back for at most \p window seconds.  Zero disables
+	coalescing so every move is sent as it arrives.
+	*/
+	void				setWindow(double window);
+
+	//! Set client
+	/*!
+	Sends any held motion to the current client then directs motion to
+	\p client, which may be NULL.
+	*/
+	void				setClient(BaseClientProxy* client);
+
+	//! Absolute motion
+	/*!
+	Sends, or holds back and merges, a move to \p x,\p y.
+	*/
+	void				mouseMove(SInt32 x, SInt32 y);
+
+	//! Relative motion
+	/*!
+	Sends, or holds back and adds up, a move by \p dx,\p dy.
+	*/
+	void				mouseRelativeMove(SInt32 dx, SInt32 dy);
+
+	//! Output flushed
+	/*!
+	Tells the coalescer that the client has taken everything written
+	so far apart from bulk data.  Held motion is sent.  The server
+	calls this when the client's stream sends \c priorityFlushed, so
+	a file transfer doesn't hold up motion.
+	*/
+	void				outputFlushed();
+
+	//! Send held motion
+	/*!
+	Sends held motion, if any, to the client now.
+	*/
+	void				flush();
+
+	//! Drop held motion
+	/*!
+	Forgets held motion without sending it, e.g. because the client has
+	gone away.
+	*/
+	void				discard();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get merge window
+	double				getWindow() const;
+
+	//! Test for held motion
+	bool				isPending() const;
+
+	//@}
+
+private:
+	void				hold();
+	void				send();
+	void				handleTimer(const Event&, void*);
+
+private:
+	IEventQueue*		m_events;
+	BaseClientProxy*	m_client;
+	EventQueueTimer*	m_timer;
+	double				m_window;
+	bool				m_busy;
+	bool				m_pending;
+	bool				m_relative;
+	SInt32				m_x, m_y;
+	UInt32				m_merged;
+};
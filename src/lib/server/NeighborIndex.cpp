@@ -0,0 +1,215 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/NeighborIndex.h"
+
+#include "server/Config.h"
+
+#include <algorithm>
+
+//
+// NeighborIndex
+//
+
+static
+float
+mapPosition(float x, float from0, float from1, float to0, float to1)
+{
+	// exact at the ends so that undivided links keep their bounds
+	if (x == from0) {
+		return to0;
+	}
+	if (x == from1) {
+		return to1;
+	}
+	return to0 + (x - from0) / (from1 - from0) * (to1 - to0);
+}
+
+NeighborIndex::NeighborIndex()
+{
+	// do nothing
+}
+
+void
+NeighborIndex::build(const Config& config, const ClientList& clients)
+{
+	m_links.clear();
+	m_resolved.clear();
+	m_clients.clear();
+	m_ids.clear();
+
+	// number the screens
+	typedef std::map<String, UInt32,
+					synergy::string::CaselessCmp> ScreenIDs;
+	ScreenIDs screens;
+	for (Config::const_iterator i = config.begin(); i != config.end(); ++i) {
+		UInt32 id = static_cast<UInt32>(screens.size());
+		screens.insert(std::make_pair(*i, id));
+	}
+	m_links.resize(screens.size() * kNumDirections);
+	m_resolved.resize(screens.size() * kNumDirections);
+	m_clients.resize(screens.size(), NULL);
+
+	// copy the links.  the config keeps them sorted by side and then
+	// by start so each table comes out sorted.
+	for (ScreenIDs::const_iterator i = screens.begin();
+								i != screens.end(); ++i) {
+		for (Config::link_const_iterator j = config.beginNeighbor(i->first);
+								j != config.endNeighbor(i->first); ++j) {
+			ScreenIDs::const_iterator dst =
+				screens.find(config.getCanonicalName(j->second.getName()));
+			if (dst == screens.end()) {
+				continue;
+			}
+
+			Link link;
+			link.m_start    = j->first.getInterval().first;
+			link.m_end      = j->first.getInterval().second;
+			link.m_dst      = dst->second;
+			link.m_dstStart = j->second.getInterval().first;
+			link.m_dstEnd   = j->second.getInterval().second;
+			EDirection side = j->first.getSide();
+			m_links[i->second * kNumDirections + side - kFirstDirection]
+				.push_back(link);
+		}
+	}
+
+	// note the connected screens
+	for (ClientList::const_iterator i = clients.begin();
+								i != clients.end(); ++i) {
+		ScreenIDs::const_iterator id =
+			screens.find(config.getCanonicalName(i->first));
+		if (id != screens.end()) {
+			m_clients[id->second] = i->second;
+			m_ids.insert(std::make_pair(i->second, id->second));
+		}
+	}
+
+	// resolve links from connected screens to connected screens
+	for (ClientIDs::const_iterator i = m_ids.begin(); i != m_ids.end(); ++i) {
+		for (int dir = kFirstDirection; dir <= kLastDirection; ++dir) {
+			resolve(i->second, static_cast<EDirection>(dir),
+							0.0f, 1.0f, 0.0f, 1.0f, 0,
+							m_resolved[i->second * kNumDirections +
+										dir - kFirstDirection]);
+		}
+	}
+}
+
+BaseClientProxy*
+NeighborIndex::getNeighbor(const BaseClientProxy* src,
+				EDirection dir, float t, float& tOut) const
+{
+	const Links* links = getLinks(m_resolved, src, dir);
+	if (links == NULL) {
+		return NULL;
+	}
+	const Link* link = findLink(*links, t);
+	if (link == NULL) {
+		return NULL;
+	}
+
+	// same arithmetic as Config::getNeighbor()
+	float x = (t - link->m_start) / (link->m_end - link->m_start);
+	tOut = x * (link->m_dstEnd - link->m_dstStart) + link->m_dstStart;
+	return m_clients[link->m_dst];
+}
+
+bool
+NeighborIndex::hasLink(const BaseClientProxy* src,
+				EDirection dir, float t) const
+{
+	const Links* links = getLinks(m_links, src, dir);
+	return (links != NULL && findLink(*links, t) != NULL);
+}
+
+const NeighborIndex::Links*
+NeighborIndex::getLinks(const std::vector<Links>& tables,
+				const BaseClientProxy* src, EDirection dir) const
+{
+	assert(dir >= kFirstDirection && dir <= kLastDirection);
+
+	ClientIDs::const_iterator id = m_ids.find(src);
+	if (id == m_ids.end()) {
+		return NULL;
+	}
+	return &tables[id->second * kNumDirections + dir - kFirstDirection];
+}
+
+const NeighborIndex::Link*
+NeighborIndex::findLink(const Links& links, float t) const
+{
+	// find the last link starting at or before t
+	size_t lo = 0;
+	size_t hi = links.size();
+	while (lo < hi) {
+		size_t mid = (lo + hi) >> 1;
+		if (links[mid].m_start <= t) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	if (lo == 0) {
+		return NULL;
+	}
+	const Link& link = links[lo - 1];
+	if (t < link.m_end) {
+		return &link;
+	}
+	return NULL;
+}
+
+void
+NeighborIndex::resolve(UInt32 screen, EDirection dir,
+				float start, float end, float srcStart, float srcEnd,
+				UInt32 depth, Links& out) const
+{
+	// [start,end) on screen corresponds to [srcStart,srcEnd) on the
+	// screen we're resolving for.  screens that aren't connected are
+	// passed through, the way Server used to skip them on each lookup.
+	const Links& links = m_links[screen * kNumDirections + dir - kFirstDirection];
+	for (Links::const_iterator i = links.begin(); i != links.end(); ++i) {
+		float p = std::max(start, i->m_start);
+		float q = std::min(end, i->m_end);
+		if (q <= p) {
+			continue;
+		}
+
+		float sp = mapPosition(p, start, end, srcStart, srcEnd);
+		float sq = mapPosition(q, start, end, srcStart, srcEnd);
+		float dp = mapPosition(p, i->m_start, i->m_end,
+							i->m_dstStart, i->m_dstEnd);
+		float dq = mapPosition(q, i->m_start, i->m_end,
+							i->m_dstStart, i->m_dstEnd);
+
+		if (m_clients[i->m_dst] != NULL) {
+			Link link;
+			link.m_start    = sp;
+			link.m_end      = sq;
+			link.m_dst      = i->m_dst;
+			link.m_dstStart = dp;
+			link.m_dstEnd   = dq;
+			out.push_back(link);
+		}
+		else if (depth < m_clients.size()) {
+			// the depth limit stops loops through unconnected screens
+			resolve(i->m_dst, dir, dp, dq, sp, sq, depth + 1, out);
+		}
+	}
+}
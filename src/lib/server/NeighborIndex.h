@@ -0,0 +1,107 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/protocol_types.h"
+#include "base/String.h"
+#include "common/stdmap.h"
+#include "common/stdvector.h"
+
+class BaseClientProxy;
+class Config;
+
+//! Screen adjacency index
+/*!
+A snapshot of the links in a Config resolved against the connected
+clients.  Screens are numbered and each side of each screen has a
+sorted table of intervals, so finding a neighbor is a binary search
+instead of a walk through the configuration's name maps.  Intervals
+that lead to screens that aren't connected are followed through to
+the nearest connected screen when the index is built.
+
+The index must be rebuilt whenever the configuration or the set of
+connected clients changes.
+*/
+class NeighborIndex {
+public:
+	typedef std::map<String, BaseClientProxy*> ClientList;
+
+	NeighborIndex();
+
+	//! @name manipulators
+	//@{
+
+	//! Rebuild index
+	/*!
+	Indexes the links in \p config.  \p clients maps canonical screen
+	names to the connected clients.
+	*/
+	void				build(const Config& config, const ClientList& clients);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get connected neighbor
+	/*!
+	Returns the nearest connected client on side \p dir of \p src at
+	position \p t along that side, skipping screens that aren't
+	connected.  The position on the neighbor is saved in \p tOut.
+	Returns NULL if there's no connected neighbor there.
+	*/
+	BaseClientProxy*	getNeighbor(const BaseClientProxy* src,
+							EDirection dir, float t, float& tOut) const;
+
+	//! Test for link
+	/*!
+	Returns true if side \p dir of \p src links to any screen, connected
+	or not, at position \p t.
+	*/
+	bool				hasLink(const BaseClientProxy* src,
+							EDirection dir, float t) const;
+
+	//@}
+
+private:
+	class Link {
+	public:
+		float			m_start;
+		float			m_end;
+		UInt32			m_dst;
+		float			m_dstStart;
+		float			m_dstEnd;
+	};
+	typedef std::vector<Link> Links;
+	typedef std::map<const BaseClientProxy*, UInt32> ClientIDs;
+
+	const Links*		getLinks(const std::vector<Links>& tables,
+							const BaseClientProxy* src, EDirection) const;
+	const Link*			findLink(const Links&, float t) const;
+	void				resolve(UInt32 screen, EDirection dir,
+							float start, float end,
+							float srcStart, float srcEnd,
+							UInt32 depth, Links& out) const;
+
+private:
+	// one table per side of each screen, indexed by screen ID
+	// times kNumDirections plus side
+	std::vector<Links>	m_links;
+	std::vector<Links>	m_resolved;
+	std::vector<BaseClientProxy*>	m_clients;
+	ClientIDs			m_ids;
+};
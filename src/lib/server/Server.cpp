@@ -22,7 +22,10 @@
 #include "server/ClientProxyUnknown.h"
 #include "server/PrimaryClient.h"
 #include "server/ClientListener.h"
+#include "server/MouseMoveCoalescer.h"
 #include "synergy/FileChunk.h"
+#include "synergy/FileReceiver.h"
+#include "synergy/FileSendWindow.h"
 #include "synergy/IPlatformScreen.h"
 #include "synergy/DropHelper.h"
 #include "synergy/option_types.h"
@@ -34,10 +37,13 @@
 #include "synergy/Screen.h"
 #include "synergy/PacketStreamFilter.h"
 #include "synergy/DpiHelper.h"
+#include "synergy/LatencyTrace.h"
 #include "net/TCPSocket.h"
 #include "net/IDataSocket.h"
 #include "net/IListenSocket.h"
 #include "net/XSocket.h"
+#include "io/IStream.h"
+#include "mt/Lock.h"
 #include "mt/Thread.h"
 #include "arch/Arch.h"
 #include "base/TMethodJob.h"
@@ -84,16 +90,26 @@ Server::Server(
 	m_switchNeedsControl(false),
 	m_switchNeedsAlt(false),
 	m_relativeMoves(false),
+	m_mouseMoves(NULL),
+	m_latencyTrace(NULL),
+	m_motionTime(0),
+	m_outputTarget(NULL),
 	m_keyboardBroadcasting(false),
 	m_lockedToScreen(false),
 	m_screen(screen),
 	m_events(events),
+	m_fileReceiver(NULL),
 	m_sendFileThread(NULL),
+	m_fileSendWindow(NULL),
 	m_writeToDropDirThread(NULL),
 	m_ignoreFileTransfer(false),
 	m_enableDragDrop(enableDragDrop),
 	m_sendDragInfoThread(NULL),
 	m_waitDragInfoThread(true),
+	m_clipboardMutex(NULL),
+	m_clipboardSendingTo(NULL),
+	m_clipboardTarget(NULL),
+	m_clipboardPending(false),
 	m_sendClipboardThread(NULL)
 {
 	// must have a primary client and it must have a canonical name
@@ -215,6 +231,13 @@ Server::Server(
 
 	initPluginFeedback();
 
+	m_mouseMoves = new MouseMoveCoalescer(m_events);
+	m_fileReceiver = new FileReceiver;
+	m_fileSendWindow = new FileSendWindow;
+	m_clipboardMutex = new Mutex;
+	m_clipboardSendingTo = new CondVar<BaseClientProxy*>(m_clipboardMutex, NULL);
+	setOutputClient(m_active);
+
 	// add connection
 	addClient(m_primaryClient);
 
@@ -267,6 +290,7 @@ Server::~Server()
 							m_inputFilter);
 	m_events->removeHandler(Event::kTimer, this);
 	stopSwitch();
+	stopSendingClipboards(NULL);
 
 	// force immediate disconnection of secondary clients
 	disconnect();
@@ -285,6 +309,13 @@ Server::~Server()
 	// disable and disconnect primary client
 	m_primaryClient->disable();
 	removeClient(m_primaryClient);
+
+	setOutputClient(NULL);
+	delete m_mouseMoves;
+	delete m_fileSendWindow;
+	delete m_fileReceiver;
+	delete m_clipboardSendingTo;
+	delete m_clipboardMutex;
 }
 
 bool
@@ -301,6 +332,7 @@ Server::setConfig(const Config& config)
 
 	// cut over
 	processOptions();
+	m_neighbors.build(*m_config, m_clients);
 
 	// add ScrollLock as a hotkey to lock to the screen.  this was a
 	// built-in feature in earlier releases and is now supported via
@@ -384,6 +416,18 @@ Server::disconnect()
 	}
 }
 
+void
+Server::setLatencyTrace(LatencyTrace* trace)
+{
+	m_latencyTrace = trace;
+}
+
+LatencyTrace*
+Server::getLatencyTrace() const
+{
+	return m_latencyTrace;
+}
+
 UInt32
 Server::getNumClients() const
 {
@@ -486,6 +530,9 @@ Server::switchScreen(BaseClientProxy* dst,
 	// stop waiting to switch
 	stopSwitch();
 
+	// motion on the old position must arrive first
+	m_mouseMoves->flush();
+
 	// record new position
 	m_x       = x;
 	m_y       = y;
@@ -519,6 +566,7 @@ Server::switchScreen(BaseClientProxy* dst,
 
 		// cut over
 		m_active = dst;
+		setOutputClient(m_active);
 
 		// increment enter sequence number
 		++m_seqNum;
@@ -527,21 +575,10 @@ Server::switchScreen(BaseClientProxy* dst,
 		m_active->enter(x, y, m_seqNum,
 								m_primaryClient->getToggleMask(),
 								forScreensaver);
-		// if already sending clipboard, we need to interupt it, otherwise
-		// clipboard data could be corrupted on the other side
-		if (m_sendClipboardThread != NULL) {
-			StreamChunker::interruptClipboard();
-			m_sendClipboardThread->wait();
-			delete m_sendClipboardThread;
-			m_sendClipboardThread = NULL;
-		}
-		
-		// send the clipboard data to new active screen
-		m_sendClipboardThread = new Thread(
-									new TMethodJob<Server>(
-										this,
-										&Server::sendClipboardThread,
-										NULL));
+		// send the clipboard data to new active screen.  if already
+		// sending clipboard, we need to interupt it, otherwise clipboard
+		// data could be corrupted on the other side
+		sendClipboards(true);
 
 		Server::SwitchToScreenInfo* info =
 			Server::SwitchToScreenInfo::alloc(m_active->getName());
@@ -628,44 +665,22 @@ Server::getNeighbor(BaseClientProxy* src,
 
 	assert(src != NULL);
 
-	// get source screen name
-	String srcName = getName(src);
-	assert(!srcName.empty());
-	LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
+	LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), getName(src).c_str()));
 
 	// convert position to fraction
 	float t = mapToFraction(src, dir, x, y);
 
-	// search for the closest neighbor that exists in direction dir
+	// the index skips over unconnected screens for us
 	float tTmp;
-	for (;;) {
-		String dstName(m_config->getNeighbor(srcName, dir, t, &tTmp));
-
-		// if nothing in that direction then return NULL. if the
-		// destination is the source then we can make no more
-		// progress in this direction.  since we haven't found a
-		// connected neighbor we return NULL.
-		if (dstName.empty()) {
-			LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
-			return NULL;
-		}
-
-		// look up neighbor cell.  if the screen is connected and
-		// ready then we can stop.
-		ClientList::const_iterator index = m_clients.find(dstName);
-		if (index != m_clients.end()) {
-			LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", dstName.c_str(), Config::dirName(dir), srcName.c_str(), t));
-			mapToPixel(index->second, dir, tTmp, x, y);
-			return index->second;
-		}
-
-		// skip over unconnected screen
-		LOG((CLOG_DEBUG2 "ignored \"%s\" on %s of \"%s\"", dstName.c_str(), Config::dirName(dir), srcName.c_str()));
-		srcName = dstName;
-
-		// use position on skipped screen
-		t = tTmp;
+	BaseClientProxy* dst = m_neighbors.getNeighbor(src, dir, t, tTmp);
+	if (dst == NULL) {
+		LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), getName(src).c_str()));
+		return NULL;
 	}
+
+	LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", getName(dst).c_str(), Config::dirName(dir), getName(src).c_str(), t));
+	mapToPixel(dst, dir, tTmp, x, y);
+	return dst;
 }
 
 BaseClientProxy*
@@ -784,7 +799,6 @@ Server::avoidJumpZone(BaseClientProxy* dst,
 		return;
 	}
 
-	const String dstName(getName(dst));
 	SInt32 dx, dy, dw, dh;
 	dst->getShape(dx, dy, dw, dh);
 	float t = mapToFraction(dst, dir, x, y);
@@ -795,25 +809,25 @@ Server::avoidJumpZone(BaseClientProxy* dst,
 	// don't need to move inwards because that side can't provoke a jump.
 	switch (dir) {
 	case kLeft:
-		if (!m_config->getNeighbor(dstName, kRight, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kRight, t) &&
 			x > dx + dw - 1 - z)
 			x = dx + dw - 1 - z;
 		break;
 
 	case kRight:
-		if (!m_config->getNeighbor(dstName, kLeft, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kLeft, t) &&
 			x < dx + z)
 			x = dx + z;
 		break;
 
 	case kTop:
-		if (!m_config->getNeighbor(dstName, kBottom, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kBottom, t) &&
 			y > dy + dh - 1 - z)
 			y = dy + dh - 1 - z;
 		break;
 
 	case kBottom:
-		if (!m_config->getNeighbor(dstName, kTop, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kTop, t) &&
 			y < dy + z)
 			y = dy + z;
 		break;
@@ -1116,6 +1130,7 @@ Server::stopRelativeMoves()
 		m_xDelta2 = 0;
 		m_yDelta2 = 0;
 		LOG((CLOG_DEBUG2 "synchronize move on %s by %d,%d", getName(m_active).c_str(), m_x, m_y));
+		m_mouseMoves->flush();
 		m_active->mouseMove(m_x, m_y);
 	}
 }
@@ -1168,6 +1183,7 @@ Server::processOptions()
 	m_switchNeedsAlt = false;		// doesnt' work correct.
 
 	bool newRelativeMoves = m_relativeMoves;
+	double newCoalesceWindow = 0.0;
 	for (Config::ScreenOptions::const_iterator index = options->begin();
 								index != options->end(); ++index) {
 		const OptionID id       = index->first;
@@ -1198,7 +1214,11 @@ Server::processOptions()
 		else if (id == kOptionRelativeMouseMoves) {
 			newRelativeMoves = (value != 0);
 		}
+		else if (id == kOptionMouseMoveCoalesce) {
+			newCoalesceWindow = 1.0e-3 * static_cast<double>(value);
+		}
 	}
+	m_mouseMoves->setWindow(newCoalesceWindow);
 	if (m_relativeMoves && !newRelativeMoves) {
 		stopRelativeMoves();
 	}
@@ -1350,7 +1370,9 @@ Server::handleMotionSecondaryEvent(const Event& event, void*)
 {
 	IPlatformScreen::MotionInfo* info =
 		reinterpret_cast<IPlatformScreen::MotionInfo*>(event.getData());
+	m_motionTime = info->m_time;
 	onMouseMoveSecondary(info->m_x, info->m_y);
+	m_motionTime = 0;
 }
 
 void
@@ -1398,6 +1420,7 @@ Server::handleClientDisconnected(const Event&, void* vclient)
 
 	PacketStreamFilter* streamFileter = dynamic_cast<PacketStreamFilter*>(client->getStream());
 	TCPSocket* socket = dynamic_cast<TCPSocket*>(streamFileter->getStream());
+	stopSendingClipboards(client);
 	delete client;
 	m_clientListener->deleteSocket(socket);
 }
@@ -1411,6 +1434,7 @@ Server::handleClientCloseTimeout(const Event&, void* vclient)
 	removeOldClient(client);
 	PacketStreamFilter* streamFileter = dynamic_cast<PacketStreamFilter*>(client->getStream());
 	TCPSocket* socket = dynamic_cast<TCPSocket*>(streamFileter->getStream());
+	stopSendingClipboards(client);
 	delete client;
 	m_clientListener->deleteSocket(socket);
 }
@@ -1528,7 +1552,7 @@ Server::handleFakeInputEndEvent(const Event&, void*)
 void
 Server::handleFileChunkSendingEvent(const Event& event, void*)
 {
-	onFileChunkSending(event.getData());
+	onFileChunkSending(event.getDataObject());
 }
 
 void
@@ -1537,6 +1561,21 @@ Server::handleFileRecieveCompletedEvent(const Event& event, void*)
 	onFileRecieveCompleted();
 }
 
+void
+Server::handleOutputFlushedEvent(const Event&, void*)
+{
+	// the active client has taken everything sent so far
+	m_fileSendWindow->outputFlushed();
+}
+
+void
+Server::handlePriorityFlushedEvent(const Event&, void*)
+{
+	// the active client has taken everything sent so far apart from
+	// bulk data such as file chunks
+	m_mouseMoves->outputFlushed();
+}
+
 void
 Server::onClipboardChanged(BaseClientProxy* sender,
 				ClipboardID id, UInt32 seqNum)
@@ -1573,8 +1612,11 @@ Server::onClipboardChanged(BaseClientProxy* sender,
 		client->setClipboardDirty(id, client != sender);
 	}
 
-	// send the new clipboard to the active screen
-	m_active->setClipboard(id, &clipboard.m_clipboard);
+	// send the new clipboard to the active screen.  that's done on the
+	// clipboard thread so that compressing it doesn't hold up events.
+	// a clipboard already on its way is for the same screen so let it
+	// finish.
+	sendClipboards(false);
 }
 
 void
@@ -1640,6 +1682,7 @@ Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button,
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
 	if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
 		m_active->keyDown(id, mask, button);
 	}
@@ -1667,6 +1710,7 @@ Server::onKeyUp(KeyID id, KeyModifierMask mask, KeyButton button,
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
 	if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
 		m_active->keyUp(id, mask, button);
 	}
@@ -1694,6 +1738,7 @@ Server::onKeyRepeat(KeyID id, KeyModifierMask mask,
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
 	m_active->keyRepeat(id, mask, count, button);
 }
 
@@ -1704,6 +1749,7 @@ Server::onMouseDown(ButtonID id)
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
 	m_active->mouseDown(id);
 
 	// reset this variable back to default value true
@@ -1717,6 +1763,7 @@ Server::onMouseUp(ButtonID id)
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
 	m_active->mouseUp(id);
 
 	if (m_ignoreFileTransfer) {
@@ -1882,10 +1929,97 @@ Server::sendDragInfo(BaseClientProxy* newScreen)
 }
 
 void
-Server::sendClipboardThread(void*)
+Server::sendClipboards(bool interrupt)
 {
+	if (interrupt) {
+		StreamChunker::interruptClipboard();
+	}
+
+	// the primary screen's clipboards belong to this thread and there's
+	// nothing to compress for them
+	if (m_active == m_primaryClient) {
+		{
+			Lock lock(m_clipboardMutex);
+			m_clipboardPending = false;
+		}
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			m_active->setClipboard(id, &m_clipboards[id].m_clipboard);
+		}
+		return;
+	}
+
+	// queue copies so the thread never reads m_clipboards
+	Lock lock(m_clipboardMutex);
+	m_clipboardTarget = m_active;
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-		m_active->setClipboard(id, &m_clipboards[id].m_clipboard);
+		m_clipboardQueue[id] = m_clipboards[id].m_clipboard;
+	}
+	m_clipboardPending = true;
+
+	// a running thread picks up the queue when it's done
+	if (m_sendClipboardThread == NULL) {
+		m_sendClipboardThread = new Thread(
+									new TMethodJob<Server>(
+										this,
+										&Server::sendClipboardThread,
+										NULL));
+	}
+}
+
+void
+Server::resendClipboards(BaseClientProxy* client)
+{
+	if (client == m_active) {
+		sendClipboards(false);
+	}
+}
+
+void
+Server::stopSendingClipboards(BaseClientProxy* client)
+{
+	Lock lock(m_clipboardMutex);
+	if (client == NULL || client == m_clipboardTarget) {
+		m_clipboardPending = false;
+	}
+
+	// keep interrupting in case the thread moves on to another clipboard
+	while (client == NULL ? m_sendClipboardThread != NULL :
+							*m_clipboardSendingTo == client) {
+		StreamChunker::interruptClipboard();
+		m_clipboardSendingTo->wait(0.1);
+	}
+}
+
+void
+Server::sendClipboardThread(void*)
+{
+	for (;;) {
+		BaseClientProxy* target;
+		Clipboard clipboard[kClipboardEnd];
+		{
+			Lock lock(m_clipboardMutex);
+			if (!m_clipboardPending) {
+				// done.  this is under the same lock as the check so a
+				// send queued from now on starts a new thread.
+				delete m_sendClipboardThread;
+				m_sendClipboardThread = NULL;
+				*m_clipboardSendingTo = NULL;
+				m_clipboardSendingTo->broadcast();
+				return;
+			}
+			m_clipboardPending = false;
+			target = m_clipboardTarget;
+			for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+				clipboard[id] = m_clipboardQueue[id];
+			}
+			*m_clipboardSendingTo = target;
+			m_clipboardSendingTo->broadcast();
+		}
+
+		// the proxy only sends clipboards that are dirty
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			target->setClipboard(id, &clipboard[id]);
+		}
 	}
 }
 
@@ -1909,7 +2043,8 @@ Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 	// have no idea where it really is.
 	if (m_relativeMoves && isLockedToScreenServer()) {
 		LOG((CLOG_DEBUG2 "relative move on %s by %d,%d", getName(m_active).c_str(), dx, dy));
-		m_active->mouseRelativeMove(dx, dy);
+		traceMouseMove();
+		m_mouseMoves->mouseRelativeMove(dx, dy);
 		return;
 	}
 
@@ -2061,11 +2196,27 @@ Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 		// warp cursor if it moved.
 		if (m_x != xOld || m_y != yOld) {
 			LOG((CLOG_DEBUG2 "move on %s to %d,%d", getName(m_active).c_str(), m_x, m_y));
-			m_active->mouseMove(m_x, m_y);
+			traceMouseMove();
+			m_mouseMoves->mouseMove(m_x, m_y);
 		}
 	}
 }
 
+void
+Server::traceMouseMove()
+{
+	// the active client marks the next move it sends, which is the one
+	// the coalescer sends or merges this motion into
+	if (m_latencyTrace == NULL || m_motionTime == 0 ||
+		!m_active->isLatencyTraceSupported()) {
+		return;
+	}
+	UInt32 id;
+	if (m_latencyTrace->begin(m_motionTime, ARCH->nanoseconds(), id)) {
+		m_active->traceMouseMove(id);
+	}
+}
+
 void
 Server::onMouseWheel(SInt32 xDelta, SInt32 yDelta)
 {
@@ -2073,6 +2224,7 @@ Server::onMouseWheel(SInt32 xDelta, SInt32 yDelta)
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
 	m_active->mouseWheel(xDelta, yDelta);
 }
 
@@ -2085,6 +2237,7 @@ Server::onFileChunkSending(const void* data)
 	assert(m_active != NULL);
 
 	// relay
+	m_mouseMoves->flush();
  	m_active->fileChunkSending(chunk->m_chunk[0], &chunk->m_chunk[1], chunk->m_dataSize);
 }
 
@@ -2108,7 +2261,7 @@ Server::writeToDropDirThread(void*)
 	}
 
 	DropHelper::writeToDir(m_screen->getDropTarget(), m_fakeDragFileList,
-					m_receivedFileData);
+					*m_fileReceiver);
 }
 
 bool
@@ -2136,6 +2289,7 @@ Server::addClient(BaseClientProxy* client)
 	// add to list
 	m_clientSet.insert(client);
 	m_clients.insert(std::make_pair(name, client));
+	m_neighbors.build(*m_config, m_clients);
 
 	// initialize client data
 	SInt32 x, y;
@@ -2168,6 +2322,7 @@ Server::removeClient(BaseClientProxy* client)
 	// remove from list
 	m_clients.erase(getName(client));
 	m_clientSet.erase(i);
+	m_neighbors.build(*m_config, m_clients);
 
 	return true;
 }
@@ -2278,8 +2433,15 @@ Server::forceLeaveClient(BaseClientProxy* client)
 		// disconnected.
 		LOG((CLOG_INFO "jump from \"%s\" to \"%s\" at %d,%d", getName(active).c_str(), getName(m_primaryClient).c_str(), m_x, m_y));
 
-		// cut over
+		// cut over.  motion and file data for the client are lost
+		// with it.
+		if (m_sendFileThread != NULL) {
+			StreamChunker::interruptFile();
+			m_sendFileThread = NULL;
+		}
 		m_active = m_primaryClient;
+		m_mouseMoves->discard();
+		setOutputClient(m_active);
 
 		// enter new screen (unless we already have because of the
 		// screen saver)
@@ -2300,6 +2462,33 @@ Server::forceLeaveClient(BaseClientProxy* client)
 	m_primaryClient->reconfigure(getActivePrimarySides());
 }
 
+void
+Server::setOutputClient(BaseClientProxy* client)
+{
+	m_mouseMoves->setClient(client);
+
+	if (m_outputTarget != NULL) {
+		m_events->removeHandler(m_events->forIStream().outputFlushed(),
+							m_outputTarget);
+		m_events->removeHandler(m_events->forIStream().priorityFlushed(),
+							m_outputTarget);
+		m_outputTarget = NULL;
+	}
+
+	// the primary client has no stream
+	if (client != NULL && client->getStream() != NULL) {
+		m_outputTarget = client->getStream()->getEventTarget();
+		m_events->adoptHandler(m_events->forIStream().outputFlushed(),
+							m_outputTarget,
+							new TMethodEventJob<Server>(this,
+								&Server::handleOutputFlushedEvent));
+		m_events->adoptHandler(m_events->forIStream().priorityFlushed(),
+							m_outputTarget,
+							new TMethodEventJob<Server>(this,
+								&Server::handlePriorityFlushedEvent));
+	}
+}
+
 
 //
 // Server::ClipboardInfo
@@ -2385,7 +2574,7 @@ Server::KeyboardBroadcastInfo::alloc(State state, const String& screens)
 bool
 Server::isReceivedFileSizeValid()
 {
-	return m_expectedFileSize == m_receivedFileData.size();
+	return m_fileReceiver->isComplete();
 }
 
 void
@@ -2394,7 +2583,9 @@ Server::sendFileToClient(const char* filename)
 	if (m_sendFileThread != NULL) {
 		StreamChunker::interruptFile();
 	}
-	
+
+	// nothing from an earlier transfer is in flight on a new one
+	m_fileSendWindow->reset();
 	m_sendFileThread = new Thread(
 		new TMethodJob<Server>(
 			this, &Server::sendFileThread,
@@ -2407,7 +2598,8 @@ Server::sendFileThread(void* data)
 	try {
 		char* filename = reinterpret_cast<char*>(data);
 		LOG((CLOG_DEBUG "sending file to client, filename=%s", filename));
-		StreamChunker::sendFile(filename, m_events, this);
+		StreamChunker::sendFile(filename, m_events, this, m_fileSendWindow,
+							m_active->isCompressionSupported());
 	}
 	catch (std::runtime_error error) {
 		LOG((CLOG_ERR "failed sending file chunks, error: %s", error.what()));
@@ -2449,6 +2641,7 @@ void Server::mouseMove(SInt32 x, SInt32 y) {
 	m_xDelta2 = 0;
 	m_yDelta2 = 0;
 
+	m_mouseMoves->flush();
 	m_active->mouseMove( x, y );
 }
 
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "server/Config.h"
+#include "server/NeighborIndex.h"
 #include "synergy/clipboard_types.h"
 #include "synergy/Clipboard.h"
 #include "synergy/key_types.h"
@@ -28,6 +29,7 @@
 #include "base/Event.h"
 #include "base/Stopwatch.h"
 #include "base/EventTypes.h"
+#include "mt/CondVar.h"
 #include "common/stdmap.h"
 #include "common/stdset.h"
 #include "common/stdvector.h"
@@ -42,6 +44,10 @@ namespace synergy { class Screen; }
 class IEventQueue;
 class Thread;
 class ClientListener;
+class MouseMoveCoalescer;
+class LatencyTrace;
+class FileReceiver;
+class FileSendWindow;
 
 // predclare class, defined in ServerPluginCommand.h, so handle can be used
 // by Server::submitPluginCommand
@@ -158,11 +164,26 @@ public:
 	//! Received dragging information from client
 	void				dragInfoReceived(UInt32 fileNum, String content);
 
+	//! Send clipboards again
+	/*!
+	Queues the dirty clipboards of \p client for the clipboard thread if
+	it's the active screen.  Otherwise they go when it's next entered.
+	*/
+	void				resendClipboards(BaseClientProxy* client);
+
 	//! Store ClientListener pointer
 	void				setListener(ClientListener* p) { m_clientListener = p; }
 
 	//! move mouse on active screen
 	void				mouseMove(SInt32 x, SInt32 y);
+
+	//! Set latency trace
+	/*!
+	Samples the latency of mouse moves to clients that support it into
+	\p trace, which the caller owns.  NULL, the default, disables
+	tracing.
+	*/
+	void				setLatencyTrace(LatencyTrace* trace);
 	
 	//@}
 	//! @name accessors
@@ -183,11 +204,8 @@ public:
 	//! Return true if recieved file size is valid
 	bool				isReceivedFileSizeValid();
 
-	//! Return expected file data size
-	size_t&				getExpectedFileSize() { return m_expectedFileSize; }
-
-	//! Return received file data
-	String&				getReceivedFileData() { return m_receivedFileData; }
+	//! Return the file being received
+	FileReceiver&		getFileReceiver() { return *m_fileReceiver; }
 
 	//! Return fake drag file list
 	DragFileList		getFakeDragFileList() { return m_fakeDragFileList; }
@@ -197,6 +215,12 @@ public:
 
 	BaseClientProxy*	activeClient() const { return m_active; }
 
+	//! Get latency trace
+	/*!
+	Returns the latency trace set with setLatencyTrace(), or NULL.
+	*/
+	LatencyTrace*		getLatencyTrace() const;
+
 	//@}
 
 private:
@@ -336,6 +360,8 @@ private:
 	void				handleFakeInputEndEvent(const Event&, void*);
 	void				handleFileChunkSendingEvent(const Event&, void*);
 	void				handleFileRecieveCompletedEvent(const Event&, void*);
+	void				handleOutputFlushedEvent(const Event&, void*);
+	void				handlePriorityFlushedEvent(const Event&, void*);
 
 public:
 	// plugin access
@@ -357,6 +383,7 @@ private:
 	void				onMouseUp(ButtonID);
 	bool				onMouseMovePrimary(SInt32 x, SInt32 y);
 	void				onMouseMoveSecondary(SInt32 dx, SInt32 dy);
+	void				traceMouseMove();
 	void				onMouseWheel(SInt32 xDelta, SInt32 yDelta);
 	void				onFileChunkSending(const void* data);
 	void				onFileRecieveCompleted();
@@ -383,6 +410,9 @@ private:
 
 	// force the cursor off of \p client
 	void				forceLeaveClient(BaseClientProxy* client);
+
+	// direct motion to \p client and watch its stream for flushes
+	void				setOutputClient(BaseClientProxy* client);
 	
 	// thread funciton for sending file
 	void				sendFileThread(void*);
@@ -396,6 +426,17 @@ private:
 	// send drag info to new client screen
 	void				sendDragInfo(BaseClientProxy* newScreen);
 
+	// send dirty clipboards to the active screen on the clipboard
+	// thread.  the thread gets copies of the clipboards and starts on
+	// them once any send in progress is done or, if interrupt is true,
+	// interrupted.  this never waits for the thread.
+	void				sendClipboards(bool interrupt);
+
+	// stop the clipboard thread sending to client, or sending at all if
+	// client is NULL, and wait until it has.  must be done before a
+	// client it may be sending to is deleted.
+	void				stopSendingClipboards(BaseClientProxy* client);
+
 	// thread funciton for sending clipboard
 	void				sendClipboardThread(void*);
 
@@ -430,6 +471,9 @@ private:
 	// the client with focus
 	BaseClientProxy*	m_active;
 
+	// links between connected screens
+	NeighborIndex		m_neighbors;
+
 	// the sequence number of enter messages
 	UInt32				m_seqNum;
 
@@ -482,6 +526,17 @@ private:
 	// relative mouse move option
 	bool				m_relativeMoves;
 
+	// merges motion sent to the active client
+	MouseMoveCoalescer*	m_mouseMoves;
+
+	// samples mouse move latency.  m_motionTime is when the motion being
+	// handled was captured, or zero.
+	LatencyTrace*		m_latencyTrace;
+	UInt64				m_motionTime;
+
+	// event target of the active client's stream, if it has one
+	void*				m_outputTarget;
+
 	// flag whether or not we have broadcasting enabled and the screens to
 	// which we should send broadcasted keys.
 	bool				m_keyboardBroadcasting;
@@ -496,11 +551,11 @@ private:
 	IEventQueue*		m_events;
 
 	// file transfer
-	size_t				m_expectedFileSize;
-	String				m_receivedFileData;
+	FileReceiver*		m_fileReceiver;
 	DragFileList		m_dragFileList;
 	DragFileList		m_fakeDragFileList;
 	Thread*				m_sendFileThread;
+	FileSendWindow*		m_fileSendWindow;
 	Thread*				m_writeToDropDirThread;
 	String				m_dragFileExt;
 	bool				m_ignoreFileTransfer;
@@ -511,6 +566,14 @@ private:
 
 	ClientListener*		m_clientListener;
 
+	// clipboards waiting for the clipboard thread to send them to
+	// m_clipboardTarget.  these are guarded by m_clipboardMutex.
+	// m_clipboardSendingTo is the client the thread is sending to.
+	Mutex*				m_clipboardMutex;
+	CondVar<BaseClientProxy*>*	m_clipboardSendingTo;
+	BaseClientProxy*	m_clipboardTarget;
+	bool				m_clipboardPending;
+	Clipboard			m_clipboardQueue[kClipboardEnd];
 	Thread*				m_sendClipboardThread;
 	PluginFeedbackPtr 	m_pluginFeedback;
 };
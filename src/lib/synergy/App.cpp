@@ -32,6 +32,8 @@
 #include "ipc/IpcMessage.h"
 #include "ipc/Ipc.h"
 #include "base/EventQueue.h"
+#include "mt/Thread.h"
+#include "net/SocketMultiplexer.h"
 
 #if SYSAPI_WIN32
 #include "arch/win32/ArchMiscWindows.h"
@@ -190,6 +192,9 @@ App::initApp(int argc, const char** argv)
 
 	// setup file logging after parsing args
 	setupFileLogging();
+	if (argsBase().m_asyncLog) {
+		CLOG->setAsync(true);
+	}
 
 	// load configuration
 	loadConfig();
@@ -224,6 +229,26 @@ App::cleanupIpcClient()
 	m_ipcClient->disconnect();
 	m_events->removeHandler(m_events->forIpcClient().messageReceived(), m_ipcClient);
 	delete m_ipcClient;
+	m_ipcClient = NULL;
+}
+
+void
+App::initThreadScheduling()
+{
+	// events are dispatched on this thread and the socket multiplexer
+	// moves them over the network, so these two carry all the input
+	int priority = argsBase().m_threadPriority;
+	UInt32 cpus  = argsBase().m_threadAffinity;
+	if (priority != 0) {
+		LOG((CLOG_DEBUG "thread priority %d", priority));
+		Thread::getCurrentThread().setPriority(priority);
+		m_socketMultiplexer->setThreadPriority(priority);
+	}
+	if (cpus != 0) {
+		LOG((CLOG_DEBUG "thread affinity 0x%x", cpus));
+		Thread::getCurrentThread().setAffinity(cpus);
+		m_socketMultiplexer->setThreadAffinity(cpus);
+	}
 }
 
 void
@@ -106,6 +106,8 @@ private:
 protected:
 	void				initIpcClient();
 	void				cleanupIpcClient();
+	void				initThreadScheduling();
+	IpcClient*			getIpcClient() const { return m_ipcClient; }
 	void				runEventsLoop(void*);
 
 	IArchTaskBarReceiver* m_taskBarReceiver;
@@ -162,6 +164,13 @@ private:
 	"  -1, --no-restart         do not try to restart on failure.\n" \
 	"*     --restart            restart the server automatically if it fails.\n" \
 	"  -l  --log <file>         write log messages to file.\n" \
+	"      --async-log          write log messages from a background thread.\n" \
+	"      --thread-priority <n>\n" \
+	"                           change the priority of the event and network\n" \
+	"                             threads, negative is higher.\n" \
+	"      --thread-affinity <mask>\n" \
+	"                           run the event and network threads only on the\n" \
+	"                             cpus in mask, e.g. 0x3 for the first two.\n" \
 	"      --no-tray            disable the system tray icon.\n" \
 	"      --enable-drag-drop   enable file drag & drop.\n"
 
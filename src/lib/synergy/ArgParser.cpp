@@ -17,7 +17,6 @@
 
 #include "synergy/ArgParser.h"
 
-#include "synergy/StreamChunker.h"
 #include "synergy/App.h"
 #include "synergy/ServerArgs.h"
 #include "synergy/ClientArgs.h"
@@ -27,6 +26,8 @@
 #include "base/Log.h"
 #include "base/String.h"
 
+#include <stdlib.h>
+
 ArgsBase* ArgParser::m_argsBase = NULL;
 
 ArgParser::ArgParser(App* app) :
@@ -70,6 +71,10 @@ ArgParser::parseServerArgs(ServerArgs& args, int argc, const char* const* argv)
 		else if (isArg(i, argc, argv, "", "--prm-hc", 1)) {
 			DpiHelper::s_primaryHeightCenter = synergy::string::stringToSizeType(argv[++i]);
 		}
+		else if (isArg(i, argc, argv, "", "--trace-latency", 1)) {
+			// save latency report path
+			args.m_latencyTraceFile = argv[++i];
+		}
 		else {
 			LOG((CLOG_PRINT "%s: unrecognized option `%s'" BYE, args.m_pname, argv[i], args.m_pname));
 			return false;
@@ -243,6 +248,17 @@ ArgParser::parseGenericArgs(int argc, const char* const* argv, int& i)
 	else if (isArg(i, argc, argv, "-l", "--log", 1)) {
 		argsBase().m_logFile = argv[++i];
 	}
+	else if (isArg(i, argc, argv, NULL, "--async-log")) {
+		argsBase().m_asyncLog = true;
+	}
+	else if (isArg(i, argc, argv, NULL, "--thread-priority", 1)) {
+		argsBase().m_threadPriority = atoi(argv[++i]);
+	}
+	else if (isArg(i, argc, argv, NULL, "--thread-affinity", 1)) {
+		// a cpu mask, in hex with a leading 0x
+		argsBase().m_threadAffinity =
+			static_cast<UInt32>(strtoul(argv[++i], NULL, 0));
+	}
 	else if (isArg(i, argc, argv, "-f", "--no-daemon")) {
 		// not a daemon
 		argsBase().m_daemon = false;
@@ -322,7 +338,6 @@ ArgParser::parseGenericArgs(int argc, const char* const* argv, int& i)
 	}
 	else if (isArg(i, argc, argv, NULL, "--enable-crypto")) {
 		argsBase().m_enableCrypto = true;
-		StreamChunker::updateChunkSize(true);
 	}
 	else if (isArg(i, argc, argv, NULL, "--profile-dir", 1)) {
 		argsBase().m_profileDirectory = argv[++i];
@@ -36,10 +36,13 @@ m_noHooks(false),
 m_pname(NULL),
 m_logFilter(NULL),
 m_logFile(NULL),
+m_asyncLog(false),
 m_display(NULL),
 m_disableTray(false),
 m_enableIpc(false),
 m_enableDragDrop(false),
+m_threadPriority(0),
+m_threadAffinity(0),
 m_shouldExit(false),
 m_synergyAddress(),
 m_enableCrypto(false),
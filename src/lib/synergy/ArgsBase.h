@@ -19,6 +19,7 @@
 #pragma once
 
 #include "base/String.h"
+#include "common/basic_types.h"
 
 class ArgsBase {
 public:
@@ -33,11 +34,14 @@ public:
 	const char*			m_pname;
 	const char*			m_logFilter;
 	const char*			m_logFile;
+	bool				m_asyncLog;
 	const char*			m_display;
 	String				m_name;
 	bool				m_disableTray;
 	bool				m_enableIpc;
 	bool				m_enableDragDrop;
+	int					m_threadPriority;
+	UInt32				m_threadAffinity;
 #if SYSAPI_WIN32
 	bool				m_debugServiceWait;
 	bool				m_pauseOnExit;
@@ -22,6 +22,11 @@
 
 class Chunk : public EventData {
 public:
+	enum {
+		//! Largest payload sent as one bulk message
+		kMaxSendSize = 64 * 1024
+	};
+
 	Chunk(size_t size);
 	virtual ~Chunk();
 
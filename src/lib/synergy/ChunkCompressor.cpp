@@ -0,0 +1,159 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy/ChunkCompressor.h"
+
+#include "base/LZ4.h"
+
+#include <cstring>
+
+// chunks smaller than this aren't worth the header
+static const size_t		kMinChunkSize   = 64;
+
+// largest chunk decompress() will accept
+static const size_t		kMaxChunkSize   = 16 * 1024 * 1024;
+
+// give up on the payload after this many chunks in a row that don't
+// shrink by at least an eighth
+static const UInt32		kMaxMisses      = 2;
+
+static const size_t		kHeaderSize     = 4;
+
+// signatures of formats that are already compressed
+static const struct {
+	const char*			m_magic;
+	size_t				m_size;
+} s_signatures[] = {
+	{ "\x89PNG",			4 },	// png
+	{ "\xff\xd8\xff",		3 },	// jpeg
+	{ "GIF8",				4 },	// gif
+	{ "PK\x03\x04",			4 },	// zip, docx, jar
+	{ "\x1f\x8b",			2 },	// gzip
+	{ "\xfd" "7zXZ",		5 },	// xz
+	{ "7z\xbc\xaf",			4 },	// 7z
+	{ "\x28\xb5\x2f\xfd",	4 },	// zstd
+	{ "BZh",				3 }		// bzip2
+};
+
+//
+// ChunkCompressor
+//
+
+ChunkCompressor::ChunkCompressor() :
+	m_first(true),
+	m_enabled(true),
+	m_misses(0),
+	m_bytesIn(0),
+	m_bytesOut(0)
+{
+	// do nothing
+}
+
+bool
+ChunkCompressor::compress(const char* data, size_t size, String& out)
+{
+	m_bytesIn += size;
+
+	// look at the start of the payload once
+	if (m_first) {
+		m_first = false;
+		if (isCompressedFormat(data, size)) {
+			m_enabled = false;
+		}
+	}
+
+	if (!m_enabled || size < kMinChunkSize || size > kMaxChunkSize) {
+		m_bytesOut += size;
+		return false;
+	}
+
+	String block;
+	block.resize(kHeaderSize + synergy::lz4::compressBound(size));
+	size_t n = synergy::lz4::compress(data, size,
+							&block[kHeaderSize], block.size() - kHeaderSize);
+	if (n == 0 || kHeaderSize + n > size - size / 8) {
+		if (++m_misses >= kMaxMisses) {
+			m_enabled = false;
+		}
+		m_bytesOut += size;
+		return false;
+	}
+	m_misses = 0;
+
+	block[0] = static_cast<char>((size >> 24) & 0xff);
+	block[1] = static_cast<char>((size >> 16) & 0xff);
+	block[2] = static_cast<char>((size >>  8) & 0xff);
+	block[3] = static_cast<char>( size        & 0xff);
+	block.resize(kHeaderSize + n);
+	out.swap(block);
+
+	m_bytesOut += out.size();
+	return true;
+}
+
+bool
+ChunkCompressor::decompress(const String& data, String& out)
+{
+	if (data.size() < kHeaderSize) {
+		return false;
+	}
+
+	const UInt8* header = reinterpret_cast<const UInt8*>(data.data());
+	size_t size = (static_cast<size_t>(header[0]) << 24) |
+				  (static_cast<size_t>(header[1]) << 16) |
+				  (static_cast<size_t>(header[2]) <<  8) |
+				   static_cast<size_t>(header[3]);
+	if (size > kMaxChunkSize) {
+		return false;
+	}
+
+	String result;
+	result.resize(size);
+	if (!synergy::lz4::decompress(data.data() + kHeaderSize,
+							data.size() - kHeaderSize,
+							size == 0 ? NULL : &result[0], size)) {
+		return false;
+	}
+	out.swap(result);
+	return true;
+}
+
+bool
+ChunkCompressor::isCompressedFormat(const char* data, size_t size)
+{
+	static const size_t n = sizeof(s_signatures) / sizeof(s_signatures[0]);
+	for (size_t i = 0; i < n; ++i) {
+		if (size >= s_signatures[i].m_size &&
+			memcmp(data, s_signatures[i].m_magic, s_signatures[i].m_size) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+size_t
+ChunkCompressor::getBytesIn() const
+{
+	return m_bytesIn;
+}
+
+size_t
+ChunkCompressor::getBytesOut() const
+{
+	return m_bytesOut;
+}
@@ -0,0 +1,91 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+//! Adaptive chunk compressor
+/*!
+Compresses the chunks of one clipboard or file transfer with LZ4.  The
+compressor adapts to the payload:  chunks too small to be worth it are
+left alone, data that starts like an already compressed format (PNG,
+JPEG, zip and so on) isn't tried at all, and once a couple of chunks
+in a row fail to shrink the rest of the transfer goes out as is.
+
+A compressed chunk is the uncompressed size as 4 bytes, most
+significant first, followed by an LZ4 block.
+
+Compressing is too slow for the event thread;  use it on the thread
+that chunks the payload.
+*/
+class ChunkCompressor {
+public:
+	ChunkCompressor();
+
+	//! @name manipulators
+	//@{
+
+	//! Compress a chunk
+	/*!
+	Compresses the \p size bytes at \p data into \p out.  Returns false,
+	leaving \p out untouched, if the chunk should be sent as is.
+	*/
+	bool				compress(const char* data, size_t size, String& out);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Decompress a chunk
+	/*!
+	Decompresses a chunk made by compress() into \p out.  Returns false
+	if \p data isn't a valid compressed chunk.
+	*/
+	static bool			decompress(const String& data, String& out);
+
+	//! Test for compressed formats
+	/*!
+	Returns true if \p data starts with the signature of a format that's
+	already compressed.
+	*/
+	static bool			isCompressedFormat(const char* data, size_t size);
+
+	//! Get bytes in
+	/*!
+	Returns the number of bytes passed to compress().
+	*/
+	size_t				getBytesIn() const;
+
+	//! Get bytes out
+	/*!
+	Returns the number of bytes compress() passed on, counting chunks
+	that were left alone at their original size.
+	*/
+	size_t				getBytesOut() const;
+
+	//@}
+
+private:
+	bool				m_first;
+	bool				m_enabled;
+	UInt32				m_misses;
+	size_t				m_bytesIn;
+	size_t				m_bytesOut;
+};
@@ -119,7 +119,7 @@ ClientApp::help()
 #  define WINAPI_INFO
 #endif
 
-	char buffer[2000];
+	char buffer[3000];
 	sprintf(
 		buffer,
 		"Usage: %s"
@@ -454,6 +454,7 @@ ClientApp::mainLoop()
 	// on unix because threads evaporate across a fork().
 	SocketMultiplexer multiplexer;
 	setSocketMultiplexer(&multiplexer);
+	initThreadScheduling();
 
 	// load all available plugins.
 	ARCH->plugin().load();
@@ -18,6 +18,61 @@
 
 #include "synergy/Clipboard.h"
 #include "synergy/IClipboardAccess.h"
+#include "base/Hash.h"
+
+// seeds for the two halves of a hash
+static const UInt32		kHashSeedHigh = 0x53594e45;
+static const UInt32		kHashSeedLow  = 0;
+
+static
+Clipboard::Hash
+hashData(const void* data, size_t size)
+{
+	return Clipboard::Hash(
+				synergy::hash::xxHash32(data, size, kHashSeedHigh),
+				synergy::hash::xxHash32(data, size, kHashSeedLow));
+}
+
+static
+void
+putUInt32(UInt8*& dst, UInt32 v)
+{
+	*dst++ = static_cast<UInt8>( v        & 0xff);
+	*dst++ = static_cast<UInt8>((v >>  8) & 0xff);
+	*dst++ = static_cast<UInt8>((v >> 16) & 0xff);
+	*dst++ = static_cast<UInt8>((v >> 24) & 0xff);
+}
+
+//
+// Clipboard::Hash
+//
+
+Clipboard::Hash::Hash() :
+	m_high(0),
+	m_low(0)
+{
+	// do nothing
+}
+
+Clipboard::Hash::Hash(UInt32 high, UInt32 low) :
+	m_high(high),
+	m_low(low)
+{
+	// do nothing
+}
+
+bool
+Clipboard::Hash::operator==(const Hash& other) const
+{
+	return (m_high == other.m_high && m_low == other.m_low);
+}
+
+bool
+Clipboard::Hash::operator!=(const Hash& other) const
+{
+	return !operator==(other);
+}
+
 
 //
 // Clipboard
@@ -44,8 +99,9 @@ Clipboard::v_empty()
 
 	// clear all data
 	for (SInt32 index = 0; index < kNumFormats; ++index) {
-		m_data[index]  = "";
-		m_added[index] = false;
+		m_data[index]   = "";
+		m_added[index]  = false;
+		m_hashed[index] = false;
 	}
 
 	// save time
@@ -63,8 +119,9 @@ Clipboard::v_add(EFormat format, const String& data)
 	assert(m_open);
 	assert(m_owner);
 
-	m_data[format]  = data;
-	m_added[format] = true;
+	m_data[format]   = data;
+	m_added[format]  = true;
+	m_hashed[format] = false;
 }
 
 bool
@@ -124,3 +181,33 @@ Clipboard::marshall() const
 {
 	return IClipboard::marshall(this);
 }
+
+Clipboard::Hash
+Clipboard::getHash(EFormat format) const
+{
+	if (!m_hashed[format]) {
+		const String& data = m_data[format];
+		m_hash[format]   = hashData(data.data(), data.size());
+		m_hashed[format] = true;
+	}
+	return m_hash[format];
+}
+
+Clipboard::Hash
+Clipboard::getHash() const
+{
+	// hash the format hashes.  the bytes are laid out the same way on
+	// every platform so both ends of a connection agree.
+	UInt8 buffer[kNumFormats * 12];
+	UInt8* dst = buffer;
+	for (SInt32 index = 0; index < kNumFormats; ++index) {
+		if (m_added[index]) {
+			EFormat format = static_cast<EFormat>(index);
+			Hash hash      = getHash(format);
+			putUInt32(dst, static_cast<UInt32>(index));
+			putUInt32(dst, hash.m_high);
+			putUInt32(dst, hash.m_low);
+		}
+	}
+	return hashData(buffer, dst - buffer);
+}
@@ -26,6 +26,24 @@ This class implements a clipboard that stores data in memory.
 */
 class Clipboard : public IClipboard {
 public:
+	//! Content hash
+	/*!
+	A 64-bit hash of clipboard data, kept as two 32-bit halves.  Equal
+	hashes mean the data is all but certainly the same.
+	*/
+	class Hash {
+	public:
+		Hash();
+		Hash(UInt32 high, UInt32 low);
+
+		bool			operator==(const Hash&) const;
+		bool			operator!=(const Hash&) const;
+
+	public:
+		UInt32			m_high;
+		UInt32			m_low;
+	};
+
 	Clipboard();
 	virtual ~Clipboard();
 
@@ -50,6 +68,21 @@ public:
 	*/
 	String				marshall() const;
 
+	//! Get format hash
+	/*!
+	Returns the hash of the data in \p format.  Each format is hashed
+	the first time it's asked for after it changes.
+	*/
+	Hash				getHash(EFormat format) const;
+
+	//! Get content hash
+	/*!
+	Returns a hash of every format in the clipboard.  Clipboards with
+	the same formats holding the same data have the same hash whatever
+	their times, on any platform.
+	*/
+	Hash				getHash() const;
+
 	//@}
 
 	// IClipboard overrides
@@ -69,4 +102,6 @@ private:
 	Time				m_timeOwned;
 	bool				m_added[kNumFormats];
 	String				m_data[kNumFormats];
+	mutable bool		m_hashed[kNumFormats];
+	mutable Hash		m_hash[kNumFormats];
 };
@@ -17,6 +17,7 @@
 
 #include "synergy/ClipboardChunk.h"
 
+#include "synergy/ChunkCompressor.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/protocol_types.h"
 #include "io/IStream.h"
@@ -55,6 +56,25 @@ ClipboardChunk::data(
 					ClipboardID id,
 					UInt32 sequence,
 					const String& data)
+{
+	return payload(id, sequence, kDataChunk, data);
+}
+
+ClipboardChunk*
+ClipboardChunk::compressed(
+					ClipboardID id,
+					UInt32 sequence,
+					const String& data)
+{
+	return payload(id, sequence, kDataCompressed, data);
+}
+
+ClipboardChunk*
+ClipboardChunk::payload(
+					ClipboardID id,
+					UInt32 sequence,
+					UInt8 mark,
+					const String& data)
 {
 	size_t dataSize = data.size();
 	ClipboardChunk* chunk = new ClipboardChunk(dataSize + CLIPBOARD_CHUNK_META_SIZE);
@@ -63,7 +83,7 @@ ClipboardChunk::data(
 	chunkData[0] = id;
 	UInt32* seq = reinterpret_cast<UInt32*>(&chunkData[1]);
 	*seq = sequence;
-	chunkData[5] = kDataChunk;
+	chunkData[5] = mark;
 	memcpy(&chunkData[6], data.c_str(), dataSize);
 	chunkData[dataSize + CLIPBOARD_CHUNK_META_SIZE - 1] = '\0';
 
@@ -85,6 +105,18 @@ ClipboardChunk::end(ClipboardID id, UInt32 sequence)
 	return end;
 }
 
+ClipboardChunk*
+ClipboardChunk::cached(
+					ClipboardID id,
+					UInt32 sequence,
+					UInt32 hashHigh,
+					UInt32 hashLow)
+{
+	UInt32 hash[2] = { hashHigh, hashLow };
+	return payload(id, sequence, kDataCached,
+					String(reinterpret_cast<const char*>(hash), sizeof(hash)));
+}
+
 int
 ClipboardChunk::assemble(synergy::IStream* stream,
 					String& dataCached,
@@ -108,6 +140,15 @@ ClipboardChunk::assemble(synergy::IStream* stream,
 		dataCached.append(data);
 		return kNotFinish;
 	}
+	else if (mark == kDataCompressed) {
+		String chunk;
+		if (!ChunkCompressor::decompress(data, chunk)) {
+			LOG((CLOG_ERR "corrupted compressed clipboard chunk"));
+			return kError;
+		}
+		dataCached.append(chunk);
+		return kNotFinish;
+	}
 	else if (mark == kDataEnd) {
 		// validate
 		if (id >= kClipboardEnd) {
@@ -151,10 +192,38 @@ ClipboardChunk::send(synergy::IStream* stream, void* data)
 		LOG((CLOG_DEBUG2 "sending clipboard chunk data: size=%i", dataChunk.size()));
 		break;
 
+	case kDataCompressed:
+		LOG((CLOG_DEBUG2 "sending compressed clipboard chunk: size=%i", dataChunk.size()));
+		break;
+
 	case kDataEnd:
 		LOG((CLOG_DEBUG2 "sending clipboard finished"));
 		break;
+
+	case kDataCached:
+		LOG((CLOG_DEBUG2 "sending cached clipboard notice"));
+		break;
+	}
+
+	// same lane as the data so it can't overtake what's still queued
+	if (mark == kDataCached) {
+		UInt32 hash[2];
+		memcpy(hash, dataChunk.data(), sizeof(hash));
+		ProtocolUtil::writefBulk(stream, kMsgDClipboardCached,
+							id, sequence, hash[0], hash[1]);
+		return;
+	}
+
+	// split raw data so that input can go out between the pieces
+	if (mark == kDataChunk) {
+		for (size_t offset = 0; offset < dataChunk.size();
+							offset += kMaxSendSize) {
+			String piece(dataChunk, offset, kMaxSendSize);
+			ProtocolUtil::writefBulk(stream, kMsgDClipboard,
+							id, sequence, mark, &piece);
+		}
+		return;
 	}
 
-	ProtocolUtil::writef(stream, kMsgDClipboard, id, sequence, mark, &dataChunk);
+	ProtocolUtil::writefBulk(stream, kMsgDClipboard, id, sequence, mark, &dataChunk);
 }
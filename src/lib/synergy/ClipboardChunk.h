@@ -42,8 +42,19 @@ public:
 							ClipboardID id,
 							UInt32 sequence,
 							const String& data);
+	static ClipboardChunk*
+						compressed(
+							ClipboardID id,
+							UInt32 sequence,
+							const String& data);
 	static ClipboardChunk*
 						end(ClipboardID id, UInt32 sequence);
+	static ClipboardChunk*
+						cached(
+							ClipboardID id,
+							UInt32 sequence,
+							UInt32 hashHigh,
+							UInt32 hashLow);
 
 	static int			assemble(
 							synergy::IStream* stream,
@@ -55,6 +66,14 @@ public:
 
 	static size_t		getExpectedSize() { return s_expectedSize; }
 
+private:
+	static ClipboardChunk*
+						payload(
+							ClipboardID id,
+							UInt32 sequence,
+							UInt8 mark,
+							const String& data);
+
 private:
 	static size_t		s_expectedSize;
 };
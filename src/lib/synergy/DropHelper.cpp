@@ -17,17 +17,15 @@
 
 #include "synergy/DropHelper.h"
 
+#include "synergy/FileReceiver.h"
 #include "base/Log.h"
 
-#include <fstream>
-
 void
-DropHelper::writeToDir(const String& destination, DragFileList& fileList, String& data)
+DropHelper::writeToDir(const String& destination, DragFileList& fileList, FileReceiver& file)
 {
 	LOG((CLOG_DEBUG "dropping file, files=%i target=%s", fileList.size(), destination.c_str()));
 
 	if (!destination.empty() && fileList.size() > 0) {
-		std::fstream file;
 		String dropTarget = destination;
 #ifdef SYSAPI_WIN32
 		dropTarget.append("\\");
@@ -35,15 +33,12 @@ DropHelper::writeToDir(const String& destination, DragFileList& fileList, String
 		dropTarget.append("/");
 #endif
 		dropTarget.append(fileList.at(0).getFilename());
-		file.open(dropTarget.c_str(), std::ios::out | std::ios::binary);
-		if (!file.is_open()) {
-			LOG((CLOG_ERR "drop file failed: can not open %s", dropTarget.c_str()));
+		if (!file.moveTo(dropTarget)) {
+			LOG((CLOG_ERR "drop file failed: can not save %s", dropTarget.c_str()));
+		}
+		else {
+			LOG((CLOG_DEBUG "%s is saved to %s", fileList.at(0).getFilename().c_str(), destination.c_str()));
 		}
-		
-		file.write(data.c_str(), data.size());
-		file.close();
-
-		LOG((CLOG_DEBUG "%s is saved to %s", fileList.at(0).getFilename().c_str(), destination.c_str()));
 
 		fileList.clear();
 	}
@@ -20,8 +20,10 @@
 #include "synergy/DragInformation.h"
 #include "base/String.h"
 
+class FileReceiver;
+
 class DropHelper {
 public:
 	static void			writeToDir(const String& destination,
-							DragFileList& fileList, String& data);
+							DragFileList& fileList, FileReceiver& file);
 };
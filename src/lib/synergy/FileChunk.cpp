@@ -17,12 +17,17 @@
 
 #include "synergy/FileChunk.h"
 
+#include "synergy/ChunkCompressor.h"
+#include "synergy/FileReceiver.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/protocol_types.h"
 #include "io/IStream.h"
 #include "base/Stopwatch.h"
 #include "base/Log.h"
 
+#include <algorithm>
+#include <istream>
+
 static const UInt16 kIntervalThreshold = 1;
 
 FileChunk::FileChunk(size_t size) :
@@ -56,6 +61,36 @@ FileChunk::data(UInt8* data, size_t dataSize)
 	return chunk;
 }
 
+FileChunk*
+FileChunk::compressed(const String& data)
+{
+	size_t dataSize = data.size();
+	FileChunk* chunk = new FileChunk(dataSize + FILE_CHUNK_META_SIZE);
+	char* chunkData = chunk->m_chunk;
+	chunkData[0] = kDataCompressed;
+	memcpy(&chunkData[1], data.data(), dataSize);
+	chunkData[dataSize + 1] = '\0';
+
+	return chunk;
+}
+
+FileChunk*
+FileChunk::data(std::istream& file, size_t dataSize)
+{
+	// read straight into the chunk rather than through a copy
+	FileChunk* chunk = new FileChunk(dataSize + FILE_CHUNK_META_SIZE);
+	char* chunkData = chunk->m_chunk;
+	chunkData[0] = kDataChunk;
+	file.read(&chunkData[1], dataSize);
+	if (static_cast<size_t>(file.gcount()) != dataSize) {
+		delete chunk;
+		return NULL;
+	}
+	chunkData[dataSize + 1] = '\0';
+
+	return chunk;
+}
+
 FileChunk*
 FileChunk::end()
 {
@@ -68,7 +103,7 @@ FileChunk::end()
 }
 
 int
-FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expectedSize)
+FileChunk::assemble(synergy::IStream* stream, FileReceiver& receiver)
 {
 	// parse
 	UInt8 mark = 0;
@@ -83,8 +118,11 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 
 	switch (mark) {
 	case kDataStart:
-		dataReceived.clear();
-		expectedSize = synergy::string::stringToSizeType(content);
+		// each chunk goes straight to disk so memory use doesn't grow
+		// with the size of the file
+		if (!receiver.start(synergy::string::stringToSizeType(content))) {
+			return kError;
+		}
 		receivedDataSize = 0;
 		elapsedTime = 0;
 		stopwatch.reset();
@@ -95,8 +133,17 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 		}
 		return kStart;
 
+	case kDataCompressed:
+		if (!ChunkCompressor::decompress(content, content)) {
+			LOG((CLOG_ERR "corrupted compressed file chunk"));
+			return kError;
+		}
+		// fall through
+
 	case kDataChunk:
-		dataReceived.append(content);
+		if (!receiver.write(content.data(), content.size())) {
+			return kError;
+		}
 		if (CLOG->getFilter() >= kDEBUG2) {
 				LOG((CLOG_DEBUG2 "recv file data from client: chunck size=%i", content.size()));
 				double interval = stopwatch.getTime();
@@ -114,14 +161,14 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 		return kNotFinish;
 
 	case kDataEnd:
-		if (expectedSize != dataReceived.size()) {
-			LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", expectedSize, dataReceived.size()));
+		if (!receiver.finish()) {
 			return kError;
 		}
 
 		if (CLOG->getFilter() >= kDEBUG2) {
 			LOG((CLOG_DEBUG2 "file data transfer finished"));
 			elapsedTime += stopwatch.getTime();
+			size_t expectedSize = receiver.getExpectedSize();
 			double averageSpeed = expectedSize / elapsedTime / 1000;
 			LOG((CLOG_DEBUG2 "file data transfer finished: total time consumed=%f s", elapsedTime));
 			LOG((CLOG_DEBUG2 "file data transfer finished: total data received=%i kb", expectedSize / 1000));
@@ -136,15 +183,17 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 void
 FileChunk::send(synergy::IStream* stream, UInt8 mark, char* data, size_t dataSize)
 {
-	String chunk(data, dataSize);
-
 	switch (mark) {
 	case kDataStart:
 		LOG((CLOG_DEBUG2 "sending file chunk start: size=%s", data));
 		break;
 
 	case kDataChunk:
-		LOG((CLOG_DEBUG2 "sending file chunk: size=%i", chunk.size()));
+		LOG((CLOG_DEBUG2 "sending file chunk: size=%i", dataSize));
+		break;
+
+	case kDataCompressed:
+		LOG((CLOG_DEBUG2 "sending compressed file chunk: size=%i", dataSize));
 		break;
 
 	case kDataEnd:
@@ -152,5 +201,12 @@ FileChunk::send(synergy::IStream* stream, UInt8 mark, char* data, size_t dataSiz
 		break;
 	}
 
-	ProtocolUtil::writef(stream, kMsgDFileTransfer, mark, &chunk);
+	// split raw data so that input can go out between the pieces
+	size_t maxSize = (mark == kDataChunk) ? kMaxSendSize : dataSize;
+	size_t offset  = 0;
+	do {
+		String piece(data + offset, std::min(maxSize, dataSize - offset));
+		ProtocolUtil::writefBulk(stream, kMsgDFileTransfer, mark, &piece);
+		offset += piece.size();
+	} while (offset < dataSize);
 }
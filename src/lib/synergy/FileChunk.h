@@ -21,11 +21,14 @@
 #include "base/String.h"
 #include "common/basic_types.h"
 
+#include <iosfwd>
+
 #define FILE_CHUNK_META_SIZE 2
 
 namespace synergy {
 class IStream;
 };
+class FileReceiver;
 
 class FileChunk : public Chunk {
 public:
@@ -33,11 +36,12 @@ public:
 
 	static FileChunk*	start(const String& size);
 	static FileChunk*	data(UInt8* data, size_t dataSize);
+	static FileChunk*	data(std::istream& file, size_t dataSize);
+	static FileChunk*	compressed(const String& data);
 	static FileChunk*	end();
 	static int			assemble(
 							synergy::IStream* stream,
-							String& dataCached,
-							size_t& expectedSize);
+							FileReceiver& receiver);
 	static void			send(
 							synergy::IStream* stream,
 							UInt8 mark,
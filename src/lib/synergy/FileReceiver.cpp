@@ -0,0 +1,295 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy/FileReceiver.h"
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if SYSAPI_WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//
+// FileReceiver
+//
+
+static
+unsigned long
+getProcessID()
+{
+#if SYSAPI_WIN32
+	return static_cast<unsigned long>(GetCurrentProcessId());
+#else
+	return static_cast<unsigned long>(getpid());
+#endif
+}
+
+static
+bool
+renameFile(const String& from, const String& to, bool& crossDevice)
+{
+#if SYSAPI_WIN32
+	// rename() won't replace an existing file on windows
+	if (MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+		crossDevice = false;
+		return true;
+	}
+	crossDevice = (GetLastError() == ERROR_NOT_SAME_DEVICE);
+	return false;
+#else
+	if (std::rename(from.c_str(), to.c_str()) == 0) {
+		crossDevice = false;
+		return true;
+	}
+	crossDevice = (errno == EXDEV);
+	return false;
+#endif
+}
+
+FileReceiver::FileReceiver() :
+	m_directory(ARCH->getProfileDirectory()),
+	m_file(NULL),
+	m_expectedSize(0),
+	m_receivedSize(0),
+	m_complete(false)
+{
+	// do nothing
+}
+
+FileReceiver::~FileReceiver()
+{
+	discard();
+}
+
+void
+FileReceiver::setDirectory(const String& directory)
+{
+	m_directory = directory;
+}
+
+bool
+FileReceiver::start(size_t expectedSize)
+{
+	discard();
+
+	// the profile directory may not have been created yet
+	if (!open(m_directory) && !open(ARCH->getUserDirectory())) {
+		LOG((CLOG_ERR "can't create a file to receive into"));
+		return false;
+	}
+
+	m_expectedSize = expectedSize;
+	m_receivedSize = 0;
+	preallocate();
+
+	LOG((CLOG_DEBUG1 "receiving %u bytes into %s", m_expectedSize, m_path.c_str()));
+	return true;
+}
+
+bool
+FileReceiver::write(const char* data, size_t size)
+{
+	if (m_file == NULL) {
+		return false;
+	}
+
+	if (size > m_expectedSize - m_receivedSize) {
+		LOG((CLOG_ERR "received more file data than expected, expected size=%u", m_expectedSize));
+		discard();
+		return false;
+	}
+
+	if (std::fwrite(data, 1, size, m_file) != size) {
+		LOG((CLOG_ERR "can't write received file data to %s", m_path.c_str()));
+		discard();
+		return false;
+	}
+
+	m_receivedSize += size;
+	return true;
+}
+
+bool
+FileReceiver::finish()
+{
+	if (m_file == NULL) {
+		return false;
+	}
+
+	bool closed = (std::fclose(m_file) == 0);
+	m_file = NULL;
+	if (!closed) {
+		LOG((CLOG_ERR "can't write received file data to %s", m_path.c_str()));
+		discard();
+		return false;
+	}
+	if (m_receivedSize != m_expectedSize) {
+		LOG((CLOG_ERR "corrupted file data, expected size=%u actual size=%u", m_expectedSize, m_receivedSize));
+		discard();
+		return false;
+	}
+
+	m_complete = true;
+	return true;
+}
+
+bool
+FileReceiver::moveTo(const String& path)
+{
+	if (!m_complete) {
+		return false;
+	}
+
+	bool crossDevice;
+	if (!renameFile(m_path, path, crossDevice)) {
+		if (!crossDevice) {
+			LOG((CLOG_ERR "can't move %s to %s", m_path.c_str(), path.c_str()));
+			return false;
+		}
+
+		// copy to the destination's volume then rename over the target
+		// so that nobody sees a partial file there
+		String part = path + ".part";
+		if (!copy(m_path, part) || !renameFile(part, path, crossDevice)) {
+			LOG((CLOG_ERR "can't copy %s to %s", m_path.c_str(), path.c_str()));
+			std::remove(part.c_str());
+			return false;
+		}
+		std::remove(m_path.c_str());
+	}
+
+	m_complete = false;
+	m_path.clear();
+	return true;
+}
+
+void
+FileReceiver::discard()
+{
+	if (m_file != NULL) {
+		std::fclose(m_file);
+		m_file = NULL;
+	}
+	if (!m_path.empty()) {
+		std::remove(m_path.c_str());
+		m_path.clear();
+	}
+	m_complete = false;
+}
+
+bool
+FileReceiver::isReceiving() const
+{
+	return (m_file != NULL);
+}
+
+bool
+FileReceiver::isComplete() const
+{
+	return m_complete;
+}
+
+size_t
+FileReceiver::getExpectedSize() const
+{
+	return m_expectedSize;
+}
+
+size_t
+FileReceiver::getReceivedSize() const
+{
+	return m_receivedSize;
+}
+
+const String&
+FileReceiver::getPath() const
+{
+	return m_path;
+}
+
+bool
+FileReceiver::open(const String& directory)
+{
+	static UInt32 s_count = 0;
+
+	if (directory.empty()) {
+		return false;
+	}
+
+	String name = synergy::string::sprintf("synergy-%lu-%u.part",
+							getProcessID(), ++s_count);
+	String path = ARCH->concatPath(directory, name);
+	m_file = std::fopen(path.c_str(), "wb");
+	if (m_file == NULL) {
+		return false;
+	}
+
+	m_path = path;
+	return true;
+}
+
+void
+FileReceiver::preallocate()
+{
+#if HAVE_POSIX_FALLOCATE
+	// reserve the space up front so the file isn't fragmented and a
+	// full disk shows up now rather than part way through.  this is
+	// only a hint so failure is fine.
+	if (m_expectedSize > 0) {
+		int result = posix_fallocate(fileno(m_file), 0,
+							static_cast<off_t>(m_expectedSize));
+		if (result != 0) {
+			LOG((CLOG_DEBUG1 "can't preallocate %s: %s", m_path.c_str(), strerror(result)));
+		}
+	}
+#endif
+}
+
+bool
+FileReceiver::copy(const String& from, const String& to) const
+{
+	std::FILE* src = std::fopen(from.c_str(), "rb");
+	if (src == NULL) {
+		return false;
+	}
+	std::FILE* dst = std::fopen(to.c_str(), "wb");
+	if (dst == NULL) {
+		std::fclose(src);
+		return false;
+	}
+
+	// a fixed buffer keeps memory use flat however large the file is
+	char buffer[64 * 1024];
+	bool okay = true;
+	size_t n;
+	while (okay && (n = std::fread(buffer, 1, sizeof(buffer), src)) > 0) {
+		okay = (std::fwrite(buffer, 1, n, dst) == n);
+	}
+	okay = okay && !std::ferror(src);
+	std::fclose(src);
+	okay = (std::fclose(dst) == 0) && okay;
+	return okay;
+}
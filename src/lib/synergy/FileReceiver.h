@@ -0,0 +1,126 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+#include <cstdio>
+
+//! Received file
+/*!
+Writes a file that arrives in chunks straight to disk so receiving it
+takes the same memory however large it is.  The data goes to a
+temporary file, preallocated to the announced size where the platform
+can, which is renamed into place once it's complete.  An incomplete or
+abandoned file is deleted.
+*/
+class FileReceiver {
+public:
+	FileReceiver();
+	~FileReceiver();
+
+	//! @name manipulators
+	//@{
+
+	//! Set temporary directory
+	/*!
+	Files are received into \p directory.  It should be on the same
+	volume as the drop targets so that moveTo() only has to rename.
+	The default is the user's profile directory.
+	*/
+	void				setDirectory(const String& directory);
+
+	//! Start a file
+	/*!
+	Discards any file in progress, then creates a temporary file for
+	\p expectedSize bytes.  Returns false if it can't be created.
+	*/
+	bool				start(size_t expectedSize);
+
+	//! Write data
+	/*!
+	Appends \p size bytes to the file.  Returns false, and discards the
+	file, if there's no file in progress, the data runs past the
+	expected size or the write fails.
+	*/
+	bool				write(const char* data, size_t size);
+
+	//! Finish the file
+	/*!
+	Closes the file.  Returns true if it has the expected size,
+	otherwise discards it and returns false.
+	*/
+	bool				finish();
+
+	//! Move the file into place
+	/*!
+	Renames the finished file to \p path, replacing anything already
+	there.  If \p path is on another volume the file is copied next to
+	\p path first so the final rename is still atomic.  Returns false
+	if there's no finished file or it can't be moved; the file is kept
+	in that case.
+	*/
+	bool				moveTo(const String& path);
+
+	//! Drop the file
+	/*!
+	Closes and deletes the temporary file, e.g. because the transfer
+	was interrupted.
+	*/
+	void				discard();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Test for a file in progress
+	bool				isReceiving() const;
+
+	//! Test for a finished file
+	/*!
+	Returns true once finish() has succeeded and until the file is
+	moved or discarded.
+	*/
+	bool				isComplete() const;
+
+	//! Get the announced size
+	size_t				getExpectedSize() const;
+
+	//! Get the amount written
+	size_t				getReceivedSize() const;
+
+	//! Get the temporary file's path
+	const String&		getPath() const;
+
+	//@}
+
+private:
+	bool				open(const String& directory);
+	void				preallocate();
+	bool				copy(const String& from, const String& to) const;
+
+private:
+	String				m_directory;
+	String				m_path;
+	std::FILE*			m_file;
+	size_t				m_expectedSize;
+	size_t				m_receivedSize;
+	bool				m_complete;
+};
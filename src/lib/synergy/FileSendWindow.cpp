@@ -0,0 +1,85 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileSendWindow.h"
+
+#include "mt/Lock.h"
+#include "base/Stopwatch.h"
+
+//
+// FileSendWindow
+//
+
+FileSendWindow::FileSendWindow(size_t size) :
+	m_size(size),
+	m_mutex(),
+	m_inFlight(&m_mutex, 0)
+{
+	assert(m_size > 0);
+}
+
+FileSendWindow::~FileSendWindow()
+{
+	// do nothing
+}
+
+bool
+FileSendWindow::waitForRoom(double timeout)
+{
+	Stopwatch timer(true);
+	Lock lock(&m_mutex);
+	while (m_inFlight >= m_size) {
+		if (!m_inFlight.wait(timer, timeout)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+FileSendWindow::add(size_t n)
+{
+	Lock lock(&m_mutex);
+	m_inFlight = m_inFlight + n;
+}
+
+void
+FileSendWindow::outputFlushed()
+{
+	reset();
+}
+
+void
+FileSendWindow::reset()
+{
+	Lock lock(&m_mutex);
+	m_inFlight = 0;
+	m_inFlight.broadcast();
+}
+
+size_t
+FileSendWindow::getSize() const
+{
+	return m_size;
+}
+
+size_t
+FileSendWindow::getInFlight() const
+{
+	Lock lock(&m_mutex);
+	return m_inFlight;
+}
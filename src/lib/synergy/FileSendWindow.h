@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mt/CondVar.h"
+#include "mt/Mutex.h"
+#include "common/basic_types.h"
+
+//! File send flow control
+/*!
+Limits how much file data a sending thread may queue ahead of the
+stream that carries it.  The sender adds the size of each chunk it
+queues and, before queuing the next one, waits until there is room.
+The event thread reports when the stream's output buffer has drained,
+which makes room again.  So the data in flight stays close to the
+window size no matter how slow the connection is, and the sender
+sleeps instead of polling while it waits.
+*/
+class FileSendWindow {
+public:
+	enum {
+		//! Default high-water mark, two file chunks
+		kDefaultSize = 1024 * 1024
+	};
+
+	/*!
+	\p size is the high-water mark in bytes.  A chunk may be queued
+	whenever less than \p size bytes are in flight.
+	*/
+	FileSendWindow(size_t size = kDefaultSize);
+	~FileSendWindow();
+
+	//! @name manipulators
+	//@{
+
+	//! Wait for room
+	/*!
+	Blocks the sending thread until less than the window size is in
+	flight.  Returns false if there's still no room after \p timeout
+	seconds, so the sender can check whether it should give up.
+	*/
+	bool				waitForRoom(double timeout);
+
+	//! Add queued data
+	/*!
+	Counts \p n bytes as in flight.
+	*/
+	void				add(size_t n);
+
+	//! Output flushed
+	/*!
+	Tells the window that everything written to the stream so far has
+	gone out and wakes the sender.  Call this from the event thread when
+	the stream sends \c outputFlushed.
+	*/
+	void				outputFlushed();
+
+	//! Forget data in flight
+	/*!
+	Starts counting from zero, e.g. for a new transfer.
+	*/
+	void				reset();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the window size
+	size_t				getSize() const;
+
+	//! Get the amount in flight
+	size_t				getInFlight() const;
+
+	//@}
+
+private:
+	size_t				m_size;
+	Mutex				m_mutex;
+	CondVar<size_t>		m_inFlight;
+};
@@ -168,6 +168,8 @@ public:
 	virtual void		fakeMouseMove(SInt32 x, SInt32 y) = 0;
 	virtual void		fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const = 0;
 	virtual void		fakeMouseWheel(SInt32 xDelta, SInt32 yDelta) const = 0;
+	virtual void		fakeInputBatchBegin() = 0;
+	virtual void		fakeInputBatchEnd() = 0;
 
 	// IKeyState overrides
 	virtual void		updateKeyMap() = 0;
@@ -18,6 +18,7 @@
 
 #include "synergy/IPrimaryScreen.h"
 #include "base/EventQueue.h"
+#include "arch/Arch.h"
 
 #include <cstdlib>
 
@@ -58,8 +59,9 @@ IPrimaryScreen::MotionInfo*
 IPrimaryScreen::MotionInfo::alloc(SInt32 x, SInt32 y)
 {
 	MotionInfo* info = (MotionInfo*)malloc(sizeof(MotionInfo));
-	info->m_x = x;
-	info->m_y = y;
+	info->m_x    = x;
+	info->m_y    = y;
+	info->m_time = ARCH->nanoseconds();
 	return info;
 }
 
@@ -51,6 +51,8 @@ public:
 	public:
 		SInt32			m_x;
 		SInt32			m_y;
+		//! When the motion was captured, from ARCH->nanoseconds()
+		UInt64			m_time;
 	};
 	//! Wheel motion event data
 	class WheelInfo {
@@ -57,5 +57,19 @@ public:
 	*/
 	virtual void		fakeMouseWheel(SInt32 xDelta, SInt32 yDelta) const = 0;
 
+	//! Begin fake input batch
+	/*!
+	Until the matching \c fakeInputBatchEnd(), the screen may hold
+	synthesized events back and deliver them together.  Order is kept.
+	Calls may be nested;  only the outermost have an effect.
+	*/
+	virtual void		fakeInputBatchBegin() = 0;
+
+	//! End fake input batch
+	/*!
+	Delivers the events held back since \c fakeInputBatchBegin().
+	*/
+	virtual void		fakeInputBatchEnd() = 0;
+
 	//@}
 };
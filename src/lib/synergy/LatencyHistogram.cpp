@@ -0,0 +1,138 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyHistogram.h"
+
+//
+// LatencyHistogram
+//
+
+LatencyHistogram::LatencyHistogram()
+{
+	clear();
+}
+
+void
+LatencyHistogram::add(UInt64 ns)
+{
+	++m_buckets[getBucket(ns)];
+	++m_count;
+	m_sum += ns;
+	if (ns > m_max) {
+		m_max = ns;
+	}
+}
+
+void
+LatencyHistogram::clear()
+{
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		m_buckets[i] = 0;
+	}
+	m_count = 0;
+	m_sum   = 0;
+	m_max   = 0;
+}
+
+UInt32
+LatencyHistogram::getCount() const
+{
+	return m_count;
+}
+
+UInt64
+LatencyHistogram::getMean() const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+	return m_sum / m_count;
+}
+
+UInt64
+LatencyHistogram::getMax() const
+{
+	return m_max;
+}
+
+UInt64
+LatencyHistogram::getPercentile(double percent) const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	// the sample at the percentile, counting from 1
+	UInt32 rank = static_cast<UInt32>(percent / 100.0 * m_count + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+	else if (rank > m_count) {
+		rank = m_count;
+	}
+
+	UInt32 seen = 0;
+	for (UInt32 i = 0; i < kNumBuckets - 1; ++i) {
+		seen += m_buckets[i];
+		if (seen >= rank) {
+			UInt64 top = getBucketStart(i + 1) - 1;
+			return (top < m_max) ? top : m_max;
+		}
+	}
+	return m_max;
+}
+
+UInt32
+LatencyHistogram::getNumBuckets()
+{
+	return kNumBuckets;
+}
+
+UInt32
+LatencyHistogram::getBucketCount(UInt32 bucket) const
+{
+	return (bucket < kNumBuckets) ? m_buckets[bucket] : 0;
+}
+
+UInt64
+LatencyHistogram::getBucketStart(UInt32 bucket)
+{
+	// the first four buckets are a microsecond wide.  after that each
+	// power of two is split into four.
+	if (bucket < 4) {
+		return static_cast<UInt64>(bucket) * 1000;
+	}
+	UInt32 octave = bucket / 4 + 1;
+	UInt64 us     = static_cast<UInt64>(4 + bucket % 4) << (octave - 2);
+	return us * 1000;
+}
+
+UInt32
+LatencyHistogram::getBucket(UInt64 ns)
+{
+	UInt64 us = ns / 1000;
+	if (us < 4) {
+		return static_cast<UInt32>(us);
+	}
+
+	UInt32 octave = 2;
+	while ((us >> (octave + 1)) != 0) {
+		++octave;
+	}
+	UInt32 bucket = 4 * (octave - 1) + static_cast<UInt32>((us >> (octave - 2)) & 3);
+	return (bucket < kNumBuckets) ? bucket : kNumBuckets - 1;
+}
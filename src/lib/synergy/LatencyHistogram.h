@@ -0,0 +1,94 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+//! Latency histogram
+/*!
+Counts latencies in buckets a quarter of a power of two wide, starting
+at one microsecond, so any percentile is known to within 25% without
+keeping the samples.  Latencies of more than two hours go in the last
+bucket.
+*/
+class LatencyHistogram {
+public:
+	LatencyHistogram();
+
+	//! @name manipulators
+	//@{
+
+	//! Add a sample
+	/*!
+	Counts a latency of \p ns nanoseconds.
+	*/
+	void				add(UInt64 ns);
+
+	//! Forget all samples
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the number of samples
+	UInt32				getCount() const;
+
+	//! Get the mean latency
+	/*!
+	Returns the mean of the samples in nanoseconds, or zero if there are
+	none.
+	*/
+	UInt64				getMean() const;
+
+	//! Get the largest latency
+	UInt64				getMax() const;
+
+	//! Get a percentile
+	/*!
+	Returns, in nanoseconds, a latency that at least \p percent percent
+	of the samples don't exceed.  It's the top of the bucket the
+	percentile falls in, or the largest sample if that's smaller.
+	*/
+	UInt64				getPercentile(double percent) const;
+
+	//! Get the number of buckets
+	static UInt32		getNumBuckets();
+
+	//! Get a bucket's count
+	UInt32				getBucketCount(UInt32 bucket) const;
+
+	//! Get the start of a bucket
+	/*!
+	Returns the smallest latency, in nanoseconds, counted in \p bucket.
+	*/
+	static UInt64		getBucketStart(UInt32 bucket);
+
+	//@}
+
+private:
+	static UInt32		getBucket(UInt64 ns);
+
+private:
+	enum { kNumBuckets = 128 };
+
+	UInt32				m_buckets[kNumBuckets];
+	UInt32				m_count;
+	UInt64				m_sum;
+	UInt64				m_max;
+};
@@ -0,0 +1,157 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy/LatencyTrace.h"
+
+// a sample that hasn't come back after this many nanoseconds was lost,
+// e.g. because the move was dropped when leaving the screen
+static const UInt64		kSampleTimeout = 1000000000;
+
+static const char*		s_hopNames[] = {
+	"server queue",
+	"server send",
+	"network",
+	"client",
+	"total"
+};
+
+//
+// LatencyTrace
+//
+
+LatencyTrace::LatencyTrace(double interval) :
+	m_interval(static_cast<UInt64>(interval * 1.0e+9)),
+	m_nextID(0),
+	m_id(0),
+	m_captured(0),
+	m_handled(0),
+	m_sent(0)
+{
+	// do nothing
+}
+
+bool
+LatencyTrace::begin(UInt64 captured, UInt64 handled, UInt32& id)
+{
+	if (m_handled != 0) {
+		UInt64 age = handled - m_handled;
+		if (age < m_interval || (m_id != 0 && age < kSampleTimeout)) {
+			return false;
+		}
+	}
+
+	// zero means no sample
+	if (++m_nextID == 0) {
+		++m_nextID;
+	}
+	m_id       = m_nextID;
+	m_captured = (captured < handled) ? captured : handled;
+	m_handled  = handled;
+	m_sent     = 0;
+	id         = m_id;
+	return true;
+}
+
+void
+LatencyTrace::sent(UInt32 id, UInt64 time)
+{
+	if (id == m_id && m_sent == 0) {
+		m_sent = time;
+	}
+}
+
+void
+LatencyTrace::echoed(UInt32 id, UInt64 clientTime, UInt64 time)
+{
+	if (id != m_id || m_sent == 0) {
+		return;
+	}
+	m_id = 0;
+
+	UInt64 roundTrip = time - m_sent;
+	UInt64 network   = 0;
+	if (roundTrip > clientTime) {
+		network = (roundTrip - clientTime) / 2;
+	}
+	UInt64 queue     = m_handled - m_captured;
+	UInt64 send      = m_sent - m_handled;
+
+	m_hops[kServerQueue].add(queue);
+	m_hops[kServerSend].add(send);
+	m_hops[kNetwork].add(network);
+	m_hops[kClient].add(clientTime);
+	m_hops[kTotal].add(queue + send + network + clientTime);
+}
+
+void
+LatencyTrace::clear()
+{
+	for (int i = 0; i < kNumHops; ++i) {
+		m_hops[i].clear();
+	}
+	m_id      = 0;
+	m_handled = 0;
+}
+
+const LatencyHistogram&
+LatencyTrace::getHistogram(EHop hop) const
+{
+	return m_hops[hop];
+}
+
+const char*
+LatencyTrace::getHopName(EHop hop)
+{
+	return s_hopNames[hop];
+}
+
+String
+LatencyTrace::getReport() const
+{
+	String report = synergy::string::sprintf(
+		"input latency, %u samples, microseconds\n"
+		"%-14s %8s %8s %8s %8s %8s\n",
+		m_hops[kTotal].getCount(),
+		"hop", "mean", "p50", "p90", "p99", "max");
+	for (int i = 0; i < kNumHops; ++i) {
+		const LatencyHistogram& hop = m_hops[i];
+		report += synergy::string::sprintf(
+			"%-14s %8u %8u %8u %8u %8u\n",
+			s_hopNames[i],
+			static_cast<UInt32>(hop.getMean() / 1000),
+			static_cast<UInt32>(hop.getPercentile(50.0) / 1000),
+			static_cast<UInt32>(hop.getPercentile(90.0) / 1000),
+			static_cast<UInt32>(hop.getPercentile(99.0) / 1000),
+			static_cast<UInt32>(hop.getMax() / 1000));
+	}
+
+	// then each histogram, a line per non-empty bucket with the
+	// bucket's start and count
+	for (int i = 0; i < kNumHops; ++i) {
+		const LatencyHistogram& hop = m_hops[i];
+		report += synergy::string::sprintf("\n%s:\n", s_hopNames[i]);
+		for (UInt32 j = 0; j < LatencyHistogram::getNumBuckets(); ++j) {
+			if (hop.getBucketCount(j) != 0) {
+				report += synergy::string::sprintf("%10u %8u\n",
+					static_cast<UInt32>(LatencyHistogram::getBucketStart(j) / 1000),
+					hop.getBucketCount(j));
+			}
+		}
+	}
+	return report;
+}
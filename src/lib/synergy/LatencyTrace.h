@@ -0,0 +1,112 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "synergy/LatencyHistogram.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+
+//! Input latency trace
+/*!
+Follows sampled mouse moves from the primary screen to the client that
+synthesizes them and keeps a histogram of the time spent in each hop.
+At most one sample is in flight at a time and a new one starts at most
+once per sampling interval, so tracing costs next to nothing.
+
+A sample is timestamped when the primary screen captured the motion,
+when the server handled it and when the client proxy sent it.  The
+client reports how long it took from reading the move to synthesizing
+it.  The clocks of the two machines aren't compared;  the network hop
+is half of the round trip less the time the client spent.
+
+All times are ARCH->nanoseconds().
+*/
+class LatencyTrace {
+public:
+	enum EHop {
+		kServerQueue,		//!< Capture to the server handling it
+		kServerSend,		//!< Server handling it to the proxy sending it
+		kNetwork,			//!< Proxy sending it to the client reading it
+		kClient,			//!< Client reading it to synthesizing it
+		kTotal,				//!< Capture to synthesizing it
+		kNumHops
+	};
+
+	/*!
+	Samples are started at most every \p interval seconds.
+	*/
+	LatencyTrace(double interval = 0.05);
+
+	//! @name manipulators
+	//@{
+
+	//! Start a sample
+	/*!
+	Starts a sample for motion that was captured at \p captured and
+	handled by the server at \p handled, if it's time for a new one.
+	Returns true and the sample's identifier in \p id if it started
+	one.  A sample that isn't finished within a second is dropped.
+	*/
+	bool				begin(UInt64 captured, UInt64 handled, UInt32& id);
+
+	//! Note a sample was sent
+	/*!
+	Records that the move for sample \p id was sent at \p time.
+	*/
+	void				sent(UInt32 id, UInt64 time);
+
+	//! Finish a sample
+	/*!
+	Finishes sample \p id when its echo arrives at \p time.  The client
+	took \p clientTime to synthesize the move.
+	*/
+	void				echoed(UInt32 id, UInt64 clientTime, UInt64 time);
+
+	//! Forget all samples
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get a hop's histogram
+	const LatencyHistogram&
+						getHistogram(EHop hop) const;
+
+	//! Get a hop's name
+	static const char*	getHopName(EHop hop);
+
+	//! Format a report
+	/*!
+	Returns a table of the percentiles of each hop followed by the
+	non-empty buckets of each histogram, in microseconds.
+	*/
+	String				getReport() const;
+
+	//@}
+
+private:
+	UInt64				m_interval;
+	UInt32				m_nextID;
+	UInt32				m_id;
+	UInt64				m_captured;
+	UInt64				m_handled;
+	UInt64				m_sent;
+	LatencyHistogram	m_hops[kNumHops];
+};
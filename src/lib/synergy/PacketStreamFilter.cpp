@@ -20,6 +20,7 @@
 #include "base/IEventQueue.h"
 #include "mt/Lock.h"
 #include "base/TMethodEventJob.h"
+#include "common/stdvector.h"
 
 #include <cstring>
 #include <memory>
@@ -104,6 +105,20 @@ PacketStreamFilter::write(const void* buffer, UInt32 count)
 	getStream()->write(buffer, count);
 }
 
+void
+PacketStreamFilter::writeBulk(const void* buffer, UInt32 count)
+{
+	// the length and payload go as one unit so nothing can come
+	// between them
+	std::vector<UInt8> packet(count + 4);
+	packet[0] = (UInt8)((count >> 24) & 0xff);
+	packet[1] = (UInt8)((count >> 16) & 0xff);
+	packet[2] = (UInt8)((count >>  8) & 0xff);
+	packet[3] = (UInt8)( count        & 0xff);
+	memcpy(&packet[4], buffer, count);
+	getStream()->writeBulk(&packet[0], (UInt32)packet.size());
+}
+
 void
 PacketStreamFilter::shutdownInput()
 {
@@ -37,6 +37,7 @@ public:
 	virtual void		close();
 	virtual UInt32		read(void* buffer, UInt32 n);
 	virtual void		write(const void* buffer, UInt32 n);
+	virtual void		writeBulk(const void* buffer, UInt32 n);
 	virtual void		shutdownInput();
 	virtual bool		isReady() const;
 	virtual UInt32		getSize() const;
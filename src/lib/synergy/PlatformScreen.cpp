@@ -32,6 +32,18 @@ PlatformScreen::~PlatformScreen()
 	// do nothing
 }
 
+void
+PlatformScreen::fakeInputBatchBegin()
+{
+	// do nothing
+}
+
+void
+PlatformScreen::fakeInputBatchEnd()
+{
+	// do nothing
+}
+
 void
 PlatformScreen::updateKeyMap()
 {
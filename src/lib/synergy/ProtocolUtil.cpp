@@ -40,7 +40,23 @@ ProtocolUtil::writef(synergy::IStream* stream, const char* fmt, ...)
 	UInt32 size = getLength(fmt, args);
 	va_end(args);
 	va_start(args, fmt);
-	vwritef(stream, fmt, size, args);
+	vwritef(stream, fmt, size, false, args);
+	va_end(args);
+}
+
+void
+ProtocolUtil::writefBulk(synergy::IStream* stream, const char* fmt, ...)
+{
+	assert(stream != NULL);
+	assert(fmt != NULL);
+	LOG((CLOG_DEBUG2 "writefBulk(%s)", fmt));
+
+	va_list args;
+	va_start(args, fmt);
+	UInt32 size = getLength(fmt, args);
+	va_end(args);
+	va_start(args, fmt);
+	vwritef(stream, fmt, size, true, args);
 	va_end(args);
 }
 
@@ -65,9 +81,21 @@ ProtocolUtil::readf(synergy::IStream* stream, const char* fmt, ...)
 	return result;
 }
 
+bool
+ProtocolUtil::readAll(synergy::IStream* stream, void* buffer, UInt32 n)
+{
+	try {
+		read(stream, buffer, n);
+		return true;
+	}
+	catch (XIO&) {
+		return false;
+	}
+}
+
 void
 ProtocolUtil::vwritef(synergy::IStream* stream,
-				const char* fmt, UInt32 size, va_list args)
+				const char* fmt, UInt32 size, bool bulk, va_list args)
 {
 	assert(stream != NULL);
 	assert(fmt != NULL);
@@ -83,7 +111,12 @@ ProtocolUtil::vwritef(synergy::IStream* stream,
 
 	try {
 		// write buffer
-		stream->write(buffer, size);
+		if (bulk) {
+			stream->writeBulk(buffer, size);
+		}
+		else {
+			stream->write(buffer, size);
+		}
 		LOG((CLOG_DEBUG2 "wrote %d bytes", size));
 
 		delete[] buffer;
@@ -53,6 +53,14 @@ public:
 	static void			writef(synergy::IStream*,
 							const char* fmt, ...);
 
+	//! Write formatted bulk data
+	/*!
+	Like writef() but writes the message with IStream::writeBulk(), so
+	it goes behind input and other messages still waiting to be sent.
+	*/
+	static void			writefBulk(synergy::IStream*,
+							const char* fmt, ...);
+
 	//! Read formatted data
 	/*!
 	Read formatted binary data from a buffer.  This performs the
@@ -72,9 +80,17 @@ public:
 	static bool			readf(synergy::IStream*,
 							const char* fmt, ...);
 
+	//! Read raw data
+	/*!
+	Reads exactly \c n bytes from the stream into \c buffer.  Returns
+	false if the stream ends first.
+	*/
+	static bool			readAll(synergy::IStream*, void* buffer, UInt32 n);
+
 private:
 	static void			vwritef(synergy::IStream*,
-							const char* fmt, UInt32 size, va_list);
+							const char* fmt, UInt32 size, bool bulk,
+							va_list);
 	static void			vreadf(synergy::IStream*,
 							const char* fmt, va_list);
 
@@ -248,6 +248,20 @@ Screen::mouseWheel(SInt32 xDelta, SInt32 yDelta)
 	m_screen->fakeMouseWheel(xDelta, yDelta);
 }
 
+void
+Screen::beginInputBatch()
+{
+	assert(!m_isPrimary);
+	m_screen->fakeInputBatchBegin();
+}
+
+void
+Screen::endInputBatch()
+{
+	assert(!m_isPrimary);
+	m_screen->fakeInputBatchEnd();
+}
+
 void
 Screen::resetOptions()
 {
@@ -174,6 +174,19 @@ public:
 	*/
 	void				mouseWheel(SInt32 xDelta, SInt32 yDelta);
 
+	//! Begin input batch
+	/*!
+	Lets the screen hold back the input synthesized until the matching
+	\c endInputBatch() and deliver it all at once.  Calls may be nested.
+	*/
+	void				beginInputBatch();
+
+	//! End input batch
+	/*!
+	Delivers input held back since \c beginInputBatch().
+	*/
+	void				endInputBatch();
+
 	//! Notify of options changes
 	/*!
 	Resets all options to their default values.
@@ -27,6 +27,8 @@
 #include "synergy/XScreen.h"
 #include "synergy/ServerTaskBarReceiver.h"
 #include "synergy/ServerArgs.h"
+#include "synergy/LatencyTrace.h"
+#include "ipc/IpcMessage.h"
 #include "net/SocketMultiplexer.h"
 #include "net/TCPSocketFactory.h"
 #include "net/XSocket.h"
@@ -61,6 +63,9 @@
 #include <stdio.h>
 #include <fstream>
 
+// seconds between latency reports
+static const double		kLatencyReportInterval = 10.0;
+
 //
 // ServerApp
 //
@@ -73,7 +78,10 @@ ServerApp::ServerApp(IEventQueue* events, CreateTaskBarReceiverFunc createTaskBa
 	m_primaryClient(NULL),
 	m_listener(NULL),
 	m_timer(NULL),
-	m_synergyAddress(NULL)
+	m_synergyAddress(NULL),
+	m_latencyTrace(NULL),
+	m_latencyTimer(NULL),
+	m_latencyReported(0)
 {
 }
 
@@ -121,12 +129,13 @@ ServerApp::help()
 #  define WINAPI_INFO
 #endif
 
-	char buffer[2000];
+	char buffer[3000];
 	sprintf(
 		buffer,
 		"Usage: %s"
 		" [--address <address>]"
 		" [--config <pathname>]"
+		" [--trace-latency <pathname>]"
 		WINAPI_ARGS
 		HELP_SYS_ARGS
 		HELP_COMMON_ARGS
@@ -135,6 +144,9 @@ ServerApp::help()
 		"\n"
 		"  -a, --address <address>  listen for clients on the given address.\n"
 		"  -c, --config <pathname>  use the named configuration file instead.\n"
+		"      --trace-latency <pathname>\n"
+		"                           measure input latency to clients and write\n"
+		"                             a report to the named file.\n"
 		HELP_COMMON_INFO_1
 		WINAPI_INFO
 		HELP_SYS_INFO
@@ -281,6 +293,8 @@ ServerApp::closeServer(Server* server)
 		return;
 	}
 
+	stopLatencyTrace(server);
+
 	// tell all clients to disconnect
 	server->disconnect();
 
@@ -663,9 +677,78 @@ ServerApp::openServer(Config& config, PrimaryClient* primaryClient)
 		throw ba;
 	}
 
+	if (!args().m_latencyTraceFile.empty()) {
+		startLatencyTrace(server);
+	}
+
 	return server;
 }
 
+void
+ServerApp::startLatencyTrace(Server* server)
+{
+	assert(m_latencyTrace == NULL);
+
+	LOG((CLOG_NOTE "tracing input latency to %s", args().m_latencyTraceFile.c_str()));
+	m_latencyTrace    = new LatencyTrace;
+	m_latencyReported = 0;
+	server->setLatencyTrace(m_latencyTrace);
+
+	// report every so often so a long session needn't be stopped to
+	// see the results
+	m_latencyTimer = m_events->newTimer(kLatencyReportInterval, NULL);
+	m_events->adoptHandler(Event::kTimer, m_latencyTimer,
+		new TMethodEventJob<ServerApp>(this, &ServerApp::handleLatencyReport));
+}
+
+void
+ServerApp::stopLatencyTrace(Server* server)
+{
+	if (m_latencyTrace == NULL) {
+		return;
+	}
+
+	server->setLatencyTrace(NULL);
+	m_events->removeHandler(Event::kTimer, m_latencyTimer);
+	m_events->deleteTimer(m_latencyTimer);
+	m_latencyTimer = NULL;
+
+	writeLatencyReport();
+	delete m_latencyTrace;
+	m_latencyTrace = NULL;
+}
+
+void
+ServerApp::writeLatencyReport()
+{
+	// nothing new since the last report
+	UInt32 count = m_latencyTrace->getHistogram(LatencyTrace::kTotal).getCount();
+	if (count == m_latencyReported) {
+		return;
+	}
+	m_latencyReported = count;
+
+	String report = m_latencyTrace->getReport();
+	std::ofstream file(args().m_latencyTraceFile.c_str(),
+					std::ios::out | std::ios::trunc);
+	if (file.is_open()) {
+		file << report;
+	}
+	if (!file) {
+		LOG((CLOG_WARN "failed to write latency report to %s", args().m_latencyTraceFile.c_str()));
+	}
+
+	if (getIpcClient() != NULL) {
+		getIpcClient()->send(IpcLatencyReportMessage(report));
+	}
+}
+
+void
+ServerApp::handleLatencyReport(const Event&, void*)
+{
+	writeLatencyReport();
+}
+
 void
 ServerApp::handleNoClients(const Event&, void*)
 {
@@ -688,6 +771,7 @@ ServerApp::mainLoop()
 	// on unix because threads evaporate across a fork().
 	SocketMultiplexer multiplexer;
 	setSocketMultiplexer(&multiplexer);
+	initThreadScheduling();
 
 	// if configuration has no screens then add this system
 	// as the default
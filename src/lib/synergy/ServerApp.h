@@ -46,6 +46,7 @@ class EventQueueTimer;
 class ILogOutputter;
 class IEventQueue;
 class ServerArgs;
+class LatencyTrace;
 
 class ServerApp : public App {
 public:
@@ -93,6 +94,10 @@ public:
 	void handleResume(const Event&, void*);
 	ClientListener* openClientListener(const NetworkAddress& address);
 	Server* openServer(Config& config, PrimaryClient* primaryClient);
+	void startLatencyTrace(Server* server);
+	void stopLatencyTrace(Server* server);
+	void writeLatencyReport();
+	void handleLatencyReport(const Event&, void*);
 	void handleNoClients(const Event&, void*);
 	bool startServer();
 	int mainLoop();
@@ -112,6 +117,9 @@ public:
 	ClientListener*		m_listener;
 	EventQueueTimer*	m_timer;
 	NetworkAddress*		m_synergyAddress;
+	LatencyTrace*		m_latencyTrace;
+	EventQueueTimer*	m_latencyTimer;
+	UInt32				m_latencyReported;
 
 private:
 	void handleScreenSwitched(const Event&, void*  data);
@@ -17,7 +17,9 @@
 
 #include "synergy/StreamChunker.h"
 
+#include "synergy/ChunkCompressor.h"
 #include "synergy/FileChunk.h"
+#include "synergy/FileSendWindow.h"
 #include "synergy/ClipboardChunk.h"
 #include "synergy/protocol_types.h"
 #include "base/EventTypes.h"
@@ -32,11 +34,11 @@
 #include <fstream>
 
 #define SEND_THRESHOLD 0.005f
+#define FILE_INTERRUPT_CHECK_INTERVAL 0.1
 
 using namespace std;
 
 #define SOCKET_CHUNK_SIZE 512 * 1024; // 512kb
-#define SECURE_SOCKET_CHUNK_SIZE 2 * 1024; // 2kb
 
 size_t StreamChunker::s_chunkSize = SOCKET_CHUNK_SIZE;
 bool StreamChunker::s_isChunkingClipboard = false;
@@ -49,19 +51,22 @@ void
 StreamChunker::sendFile(
 				char* filename,
 				IEventQueue* events,
-				void* eventTarget)
+				void* eventTarget,
+				FileSendWindow* window,
+				bool compress)
 {
-	s_isChunkingFile = true;
-	
-	std::fstream file(reinterpret_cast<char*>(filename), std::ios::in | std::ios::binary);
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
 
 	if (!file.is_open()) {
 		throw runtime_error("failed to open file");
 	}
 
+	s_isChunkingFile = true;
+
 	// check file size
 	file.seekg (0, std::ios::end);
 	size_t size = (size_t)file.tellg();
+	file.seekg (0, std::ios::beg);
 
 	// send first message (file size)
 	String fileSize = synergy::string::sizeTypeToString(size);
@@ -69,43 +74,66 @@ StreamChunker::sendFile(
 
 	events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, sizeMessage));
 
-	// send chunk messages with a fixed chunk size
+	// send chunk messages with a fixed chunk size, each one once the
+	// stream has room for it
+	ChunkCompressor compressor;
 	size_t sentLength = 0;
-	size_t chunkSize = s_chunkSize;
-	Stopwatch sendStopwatch;
-	sendStopwatch.start();
-	file.seekg (0, std::ios::beg);
-
-	while (true) {
+	while (sentLength < size) {
 		if (s_interruptFile) {
 			s_interruptFile = false;
 			LOG((CLOG_DEBUG "file transmission interrupted"));
 			break;
 		}
-		
-		if (sendStopwatch.getTime() > SEND_THRESHOLD) {
-			// make sure we don't read too much from the mock data.
-			if (sentLength + chunkSize > size) {
-				chunkSize = size - sentLength;
-			}
 
-			char* chunkData = new char[chunkSize];
-			file.read(chunkData, chunkSize);
-			UInt8* data = reinterpret_cast<UInt8*>(chunkData);
-			FileChunk* fileChunk = FileChunk::data(data, chunkSize);
-			delete[] chunkData;
+		// wake up now and then to check for interruption
+		if (!window->waitForRoom(FILE_INTERRUPT_CHECK_INTERVAL)) {
+			continue;
+		}
 
-			events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, fileChunk));
+		size_t chunkSize = s_chunkSize;
+		if (sentLength + chunkSize > size) {
+			chunkSize = size - sentLength;
+		}
 
-			sentLength += chunkSize;
-			file.seekg (sentLength, std::ios::beg);
+		FileChunk* fileChunk = FileChunk::data(file, chunkSize);
+		if (fileChunk == NULL) {
+			LOG((CLOG_ERR "failed to read file at offset %d", sentLength));
+			break;
+		}
 
-			if (sentLength == size) {
-				break;
+		if (!compress) {
+			// the window counts what goes on the wire
+			window->add(fileChunk->m_dataSize);
+			events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, fileChunk));
+		}
+		else {
+			// compress in pieces small enough to go out as one message
+			// each, so input isn't stuck behind a whole chunk
+			UInt8* data = reinterpret_cast<UInt8*>(&fileChunk->m_chunk[1]);
+			for (size_t offset = 0; offset < chunkSize;
+								offset += Chunk::kMaxSendSize) {
+				size_t pieceSize = chunkSize - offset;
+				if (pieceSize > Chunk::kMaxSendSize) {
+					pieceSize = Chunk::kMaxSendSize;
+				}
+
+				FileChunk* piece;
+				String packed;
+				if (compressor.compress(reinterpret_cast<char*>(data + offset),
+								pieceSize, packed)) {
+					piece = FileChunk::compressed(packed);
+				}
+				else {
+					piece = FileChunk::data(data + offset, pieceSize);
+				}
+
+				window->add(piece->m_dataSize);
+				events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, piece));
 			}
-
-			sendStopwatch.reset();
+			delete fileChunk;
 		}
+
+		sentLength += chunkSize;
 	}
 
 	// send last message
@@ -114,6 +142,10 @@ StreamChunker::sendFile(
 	events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, end));
 
 	file.close();
+
+	if (compress) {
+		LOG((CLOG_DEBUG1 "file compressed from %u to %u bytes", compressor.getBytesIn(), compressor.getBytesOut()));
+	}
 	
 	s_isChunkingFile = false;
 }
@@ -125,8 +157,11 @@ StreamChunker::sendClipboard(
 				ClipboardID id,
 				UInt32 sequence,
 				IEventQueue* events,
-				void* eventTarget)
+				void* eventTarget,
+				bool compress)
 {
+	// an interrupt that came after the last send finished was for it
+	s_interruptClipboard = false;
 	s_isChunkingClipboard = true;
 	
 	// send first message (data size)
@@ -138,6 +173,7 @@ StreamChunker::sendClipboard(
 	// send clipboard chunk with a fixed size
 	size_t sentLength = 0;
 	size_t chunkSize = s_chunkSize;
+	ChunkCompressor compressor;
 	Stopwatch sendStopwatch;
 	sendStopwatch.start();
 	
@@ -154,10 +190,35 @@ StreamChunker::sendClipboard(
 				chunkSize = size - sentLength;
 			}
 
-			String chunk(data.substr(sentLength, chunkSize).c_str(), chunkSize);
-			ClipboardChunk* dataChunk = ClipboardChunk::data(id, sequence, chunk);
-			
-			events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, dataChunk));
+			if (!compress) {
+				String chunk(data, sentLength, chunkSize);
+				ClipboardChunk* dataChunk = ClipboardChunk::data(id, sequence, chunk);
+				events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, dataChunk));
+			}
+			else {
+				// compress in pieces small enough to go out as one
+				// message each
+				for (size_t offset = 0; offset < chunkSize;
+									offset += Chunk::kMaxSendSize) {
+					size_t pieceSize = chunkSize - offset;
+					if (pieceSize > Chunk::kMaxSendSize) {
+						pieceSize = Chunk::kMaxSendSize;
+					}
+
+					ClipboardChunk* dataChunk;
+					String packed;
+					if (compressor.compress(data.data() + sentLength + offset,
+									pieceSize, packed)) {
+						dataChunk = ClipboardChunk::compressed(id, sequence, packed);
+					}
+					else {
+						String chunk(data, sentLength + offset, pieceSize);
+						dataChunk = ClipboardChunk::data(id, sequence, chunk);
+					}
+
+					events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, dataChunk));
+				}
+			}
 
 			sentLength += chunkSize;
 			if (sentLength == size) {
@@ -172,19 +233,12 @@ StreamChunker::sendClipboard(
 	ClipboardChunk* end = ClipboardChunk::end(id, sequence);
 
 	events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, end));
-	
-	s_isChunkingClipboard = false;
-}
 
-void
-StreamChunker::updateChunkSize(bool useSecureSocket)
-{
-	if (useSecureSocket) {
-		s_chunkSize = SECURE_SOCKET_CHUNK_SIZE;
-	}
-	else {
-		s_chunkSize = SOCKET_CHUNK_SIZE;
+	if (compress) {
+		LOG((CLOG_DEBUG1 "clipboard compressed from %u to %u bytes", compressor.getBytesIn(), compressor.getBytesOut()));
 	}
+
+	s_isChunkingClipboard = false;
 }
 
 void
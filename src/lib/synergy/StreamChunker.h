@@ -21,21 +21,38 @@
 #include "base/String.h"
 
 class IEventQueue;
+class FileSendWindow;
 
 class StreamChunker {
 public:
+	//! Send a file
+	/*!
+	Queues \c fileChunkSending events for \p filename on \p eventTarget.
+	Each chunk waits for room in \p window, so the caller's thread sleeps
+	while the stream is backed up.  Chunks are compressed if \p compress
+	is true.  Call from a thread other than the event thread.
+	*/
 	static void			sendFile(
 							char* filename,
 							IEventQueue* events,
-							void* eventTarget);
+							void* eventTarget,
+							FileSendWindow* window,
+							bool compress);
+
+	//! Send a clipboard
+	/*!
+	Queues \c clipboardSending events for the marshalled clipboard
+	\p data.  Chunks are compressed if \p compress is true, which the
+	peer must support.  Call from a thread other than the event thread.
+	*/
 	static void			sendClipboard(
 							String& data,
 							size_t size,
 							ClipboardID id,
 							UInt32 sequence,
 							IEventQueue* events,
-							void* eventTarget);
-	static void			updateChunkSize(bool useSecureSocket);
+							void* eventTarget,
+							bool compress);
 	static void			interruptFile();
 	static void			interruptClipboard();
 	
@@ -0,0 +1,145 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/EventTypes.h"
+
+//! Message code to handler map
+/*!
+Maps 4 byte protocol message codes, such as \c kMsgDMouseMove, to member
+functions of \c T that read and handle the rest of the message and
+return an \c R.  The codes are kept in a small open addressed hash table
+so finding a handler takes the same time for every message.
+*/
+template <class T, class R>
+class TMessageTable {
+public:
+	typedef R (T::*Handler)();
+
+	TMessageTable();
+
+	//! @name manipulators
+	//@{
+
+	//! Set handler
+	/*!
+	Sets the handler for the message whose code is the first 4 bytes of
+	\c code, replacing any handler already set for it.  Subclasses that
+	implement a later protocol version use this to add or override
+	messages.
+	*/
+	void				set(const char* code, Handler handler);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Find handler
+	/*!
+	Returns the handler for the 4 byte message code \c code, or NULL if
+	there isn't one.
+	*/
+	Handler				find(const UInt8* code) const;
+
+	//@}
+
+private:
+	static UInt32		toKey(const UInt8* code);
+	static UInt32		toSlot(UInt32 key);
+
+private:
+	// more than twice the number of messages in the protocol
+	enum { kSize = 64, kBits = 6 };
+
+	struct Entry {
+	public:
+		UInt32			m_key;
+		Handler			m_handler;
+	};
+
+	Entry				m_entries[kSize];
+	UInt32				m_count;
+};
+
+template <class T, class R>
+inline
+TMessageTable<T, R>::TMessageTable() :
+	m_count(0)
+{
+	for (UInt32 i = 0; i < kSize; ++i) {
+		m_entries[i].m_key     = 0;
+		m_entries[i].m_handler = NULL;
+	}
+}
+
+template <class T, class R>
+inline
+void
+TMessageTable<T, R>::set(const char* code, Handler handler)
+{
+	UInt32 key = toKey(reinterpret_cast<const UInt8*>(code));
+	for (UInt32 i = toSlot(key); ; i = (i + 1) & (kSize - 1)) {
+		if (m_entries[i].m_key == 0) {
+			assert(m_count < kSize - 1);
+			++m_count;
+		}
+		if (m_entries[i].m_key == 0 || m_entries[i].m_key == key) {
+			m_entries[i].m_key     = key;
+			m_entries[i].m_handler = handler;
+			return;
+		}
+	}
+}
+
+template <class T, class R>
+inline
+typename TMessageTable<T, R>::Handler
+TMessageTable<T, R>::find(const UInt8* code) const
+{
+	// the table is never full so this stops at an empty entry
+	UInt32 key = toKey(code);
+	for (UInt32 i = toSlot(key); ; i = (i + 1) & (kSize - 1)) {
+		if (m_entries[i].m_key == key) {
+			return m_entries[i].m_handler;
+		}
+		if (m_entries[i].m_key == 0) {
+			return NULL;
+		}
+	}
+}
+
+template <class T, class R>
+inline
+UInt32
+TMessageTable<T, R>::toKey(const UInt8* code)
+{
+	// message codes are printable so no key is 0
+	return (static_cast<UInt32>(code[0]) << 24) |
+			(static_cast<UInt32>(code[1]) << 16) |
+			(static_cast<UInt32>(code[2]) <<  8) |
+			 static_cast<UInt32>(code[3]);
+}
+
+template <class T, class R>
+inline
+UInt32
+TMessageTable<T, R>::toSlot(UInt32 key)
+{
+	// fibonacci hashing spreads the similar codes across the table
+	return (key * 2654435769u) >> (32 - kBits);
+}
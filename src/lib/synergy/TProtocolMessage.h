@@ -0,0 +1,363 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/ProtocolUtil.h"
+#include "io/IStream.h"
+#include "base/EventTypes.h"
+
+//! Compile time check
+/*!
+Only TProtocolCheck<true> is defined so naming TProtocolCheck<false>
+fails to compile.
+*/
+template <bool>
+struct TProtocolCheck;
+
+template <>
+struct TProtocolCheck<true> {
+	enum { kOkay = 1 };
+};
+
+//! Integer field of a protocol message
+/*!
+Encodes and decodes a \c Width byte integer in network byte order.  A
+\c Width of 0 is an absent field.
+*/
+template <int Width>
+struct TProtocolField;
+
+template <>
+struct TProtocolField<0> {
+	static void			put(UInt8*&, UInt32) { }
+	template <class T>
+	static void			get(const UInt8*&, T*) { }
+};
+
+template <>
+struct TProtocolField<1> {
+	static void			put(UInt8*& dst, UInt32 v)
+	{
+		*dst++ = static_cast<UInt8>(v & 0xff);
+	}
+
+	template <class T>
+	static void			get(const UInt8*& src, T* v)
+	{
+		(void)sizeof(TProtocolCheck<sizeof(T) == 1>);
+		*v = static_cast<T>(*src++);
+	}
+};
+
+template <>
+struct TProtocolField<2> {
+	static void			put(UInt8*& dst, UInt32 v)
+	{
+		*dst++ = static_cast<UInt8>((v >> 8) & 0xff);
+		*dst++ = static_cast<UInt8>( v       & 0xff);
+	}
+
+	template <class T>
+	static void			get(const UInt8*& src, T* v)
+	{
+		(void)sizeof(TProtocolCheck<sizeof(T) == 2>);
+		*v = static_cast<T>((static_cast<UInt16>(src[0]) << 8) |
+							 static_cast<UInt16>(src[1]));
+		src += 2;
+	}
+};
+
+template <>
+struct TProtocolField<4> {
+	static void			put(UInt8*& dst, UInt32 v)
+	{
+		*dst++ = static_cast<UInt8>((v >> 24) & 0xff);
+		*dst++ = static_cast<UInt8>((v >> 16) & 0xff);
+		*dst++ = static_cast<UInt8>((v >>  8) & 0xff);
+		*dst++ = static_cast<UInt8>( v        & 0xff);
+	}
+
+	template <class T>
+	static void			get(const UInt8*& src, T* v)
+	{
+		(void)sizeof(TProtocolCheck<sizeof(T) == 4>);
+		*v = static_cast<T>((static_cast<UInt32>(src[0]) << 24) |
+							(static_cast<UInt32>(src[1]) << 16) |
+							(static_cast<UInt32>(src[2]) <<  8) |
+							 static_cast<UInt32>(src[3]));
+		src += 4;
+	}
+};
+
+//! Fixed size protocol message
+/*!
+A protocol message made of the 4 byte code \c C0 \c C1 \c C2 \c C3
+followed by up to 7 integer fields that are \c W0 to \c W6 bytes wide.
+This is the same as the message ProtocolUtil::writef() writes for the
+format "C0C1C2C3%W0i%W1i..." but the message size and layout are fixed
+at compile time.  write() fills a buffer on the stack and writes it to
+the stream in one call, and read() reads all of the fields with one
+call.
+
+Passing the wrong number of fields to write() or read(), or reading
+into a variable that isn't as wide as the field, doesn't compile.
+*/
+template <char C0, char C1, char C2, char C3,
+			int W0 = 0, int W1 = 0, int W2 = 0, int W3 = 0,
+			int W4 = 0, int W5 = 0, int W6 = 0>
+class TProtocolMessage {
+public:
+	enum {
+		//! Number of fields after the code
+		kFields = (W0 != 0) + (W1 != 0) + (W2 != 0) + (W3 != 0) +
+					(W4 != 0) + (W5 != 0) + (W6 != 0),
+
+		//! Size of the fields after the code
+		kBodySize = W0 + W1 + W2 + W3 + W4 + W5 + W6,
+
+		//! Size of the whole message
+		kSize = 4 + kBodySize
+	};
+
+	//! @name manipulators
+	//@{
+
+	//! Write message
+	/*!
+	Writes the message with the given field values to \c stream.
+	*/
+	static void			write(synergy::IStream* stream);
+	static void			write(synergy::IStream* stream, UInt32 a0);
+	static void			write(synergy::IStream* stream, UInt32 a0,
+							UInt32 a1);
+	static void			write(synergy::IStream* stream, UInt32 a0,
+							UInt32 a1, UInt32 a2);
+	static void			write(synergy::IStream* stream, UInt32 a0,
+							UInt32 a1, UInt32 a2, UInt32 a3);
+	static void			write(synergy::IStream* stream, UInt32 a0,
+							UInt32 a1, UInt32 a2, UInt32 a3, UInt32 a4,
+							UInt32 a5, UInt32 a6);
+
+	//! Read message
+	/*!
+	Reads the fields of the message from \c stream.  The code must
+	already have been read.  Returns false if the stream ends first.
+	*/
+	template <class A0>
+	static bool			read(synergy::IStream* stream, A0* a0);
+	template <class A0, class A1>
+	static bool			read(synergy::IStream* stream, A0* a0, A1* a1);
+	template <class A0, class A1, class A2>
+	static bool			read(synergy::IStream* stream, A0* a0, A1* a1,
+							A2* a2);
+	template <class A0, class A1, class A2, class A3>
+	static bool			read(synergy::IStream* stream, A0* a0, A1* a1,
+							A2* a2, A3* a3);
+	template <class A0, class A1, class A2, class A3, class A4, class A5,
+				class A6>
+	static bool			read(synergy::IStream* stream, A0* a0, A1* a1,
+							A2* a2, A3* a3, A4* a4, A5* a5, A6* a6);
+
+	//@}
+
+private:
+	static void			encode(synergy::IStream* stream,
+							UInt32 a0, UInt32 a1, UInt32 a2, UInt32 a3,
+							UInt32 a4, UInt32 a5, UInt32 a6);
+	template <class A0, class A1, class A2, class A3, class A4, class A5,
+				class A6>
+	static bool			decode(synergy::IStream* stream,
+							A0* a0, A1* a1, A2* a2, A3* a3,
+							A4* a4, A5* a5, A6* a6);
+};
+
+#define TPROTOCOL_MESSAGE_TEMPLATE										\
+	template <char C0, char C1, char C2, char C3,						\
+				int W0, int W1, int W2, int W3, int W4, int W5, int W6>
+#define TPROTOCOL_MESSAGE												\
+	TProtocolMessage<C0, C1, C2, C3, W0, W1, W2, W3, W4, W5, W6>
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::write(synergy::IStream* stream)
+{
+	(void)sizeof(TProtocolCheck<kFields == 0>);
+	encode(stream, 0, 0, 0, 0, 0, 0, 0);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::write(synergy::IStream* stream, UInt32 a0)
+{
+	(void)sizeof(TProtocolCheck<kFields == 1>);
+	encode(stream, a0, 0, 0, 0, 0, 0, 0);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::write(synergy::IStream* stream, UInt32 a0, UInt32 a1)
+{
+	(void)sizeof(TProtocolCheck<kFields == 2>);
+	encode(stream, a0, a1, 0, 0, 0, 0, 0);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::write(synergy::IStream* stream, UInt32 a0, UInt32 a1,
+				UInt32 a2)
+{
+	(void)sizeof(TProtocolCheck<kFields == 3>);
+	encode(stream, a0, a1, a2, 0, 0, 0, 0);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::write(synergy::IStream* stream, UInt32 a0, UInt32 a1,
+				UInt32 a2, UInt32 a3)
+{
+	(void)sizeof(TProtocolCheck<kFields == 4>);
+	encode(stream, a0, a1, a2, a3, 0, 0, 0);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::write(synergy::IStream* stream, UInt32 a0, UInt32 a1,
+				UInt32 a2, UInt32 a3, UInt32 a4, UInt32 a5, UInt32 a6)
+{
+	(void)sizeof(TProtocolCheck<kFields == 7>);
+	encode(stream, a0, a1, a2, a3, a4, a5, a6);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+template <class A0>
+inline
+bool
+TPROTOCOL_MESSAGE::read(synergy::IStream* stream, A0* a0)
+{
+	(void)sizeof(TProtocolCheck<kFields == 1>);
+	UInt8* none = NULL;
+	return decode(stream, a0, none, none, none, none, none, none);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+template <class A0, class A1>
+inline
+bool
+TPROTOCOL_MESSAGE::read(synergy::IStream* stream, A0* a0, A1* a1)
+{
+	(void)sizeof(TProtocolCheck<kFields == 2>);
+	UInt8* none = NULL;
+	return decode(stream, a0, a1, none, none, none, none, none);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+template <class A0, class A1, class A2>
+inline
+bool
+TPROTOCOL_MESSAGE::read(synergy::IStream* stream, A0* a0, A1* a1, A2* a2)
+{
+	(void)sizeof(TProtocolCheck<kFields == 3>);
+	UInt8* none = NULL;
+	return decode(stream, a0, a1, a2, none, none, none, none);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+template <class A0, class A1, class A2, class A3>
+inline
+bool
+TPROTOCOL_MESSAGE::read(synergy::IStream* stream, A0* a0, A1* a1, A2* a2,
+				A3* a3)
+{
+	(void)sizeof(TProtocolCheck<kFields == 4>);
+	UInt8* none = NULL;
+	return decode(stream, a0, a1, a2, a3, none, none, none);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+template <class A0, class A1, class A2, class A3, class A4, class A5,
+			class A6>
+inline
+bool
+TPROTOCOL_MESSAGE::read(synergy::IStream* stream, A0* a0, A1* a1, A2* a2,
+				A3* a3, A4* a4, A5* a5, A6* a6)
+{
+	(void)sizeof(TProtocolCheck<kFields == 7>);
+	return decode(stream, a0, a1, a2, a3, a4, a5, a6);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+inline
+void
+TPROTOCOL_MESSAGE::encode(synergy::IStream* stream,
+				UInt32 a0, UInt32 a1, UInt32 a2, UInt32 a3,
+				UInt32 a4, UInt32 a5, UInt32 a6)
+{
+	assert(stream != NULL);
+
+	UInt8 buffer[kSize];
+	buffer[0] = static_cast<UInt8>(C0);
+	buffer[1] = static_cast<UInt8>(C1);
+	buffer[2] = static_cast<UInt8>(C2);
+	buffer[3] = static_cast<UInt8>(C3);
+
+	UInt8* dst = buffer + 4;
+	TProtocolField<W0>::put(dst, a0);
+	TProtocolField<W1>::put(dst, a1);
+	TProtocolField<W2>::put(dst, a2);
+	TProtocolField<W3>::put(dst, a3);
+	TProtocolField<W4>::put(dst, a4);
+	TProtocolField<W5>::put(dst, a5);
+	TProtocolField<W6>::put(dst, a6);
+
+	stream->write(buffer, kSize);
+}
+
+TPROTOCOL_MESSAGE_TEMPLATE
+template <class A0, class A1, class A2, class A3, class A4, class A5,
+			class A6>
+inline
+bool
+TPROTOCOL_MESSAGE::decode(synergy::IStream* stream,
+				A0* a0, A1* a1, A2* a2, A3* a3, A4* a4, A5* a5, A6* a6)
+{
+	assert(stream != NULL);
+
+	UInt8 buffer[kBodySize];
+	if (!ProtocolUtil::readAll(stream, buffer, kBodySize)) {
+		return false;
+	}
+
+	const UInt8* src = buffer;
+	TProtocolField<W0>::get(src, a0);
+	TProtocolField<W1>::get(src, a1);
+	TProtocolField<W2>::get(src, a2);
+	TProtocolField<W3>::get(src, a3);
+	TProtocolField<W4>::get(src, a4);
+	TProtocolField<W5>::get(src, a5);
+	TProtocolField<W6>::get(src, a6);
+	return true;
+}
+
+#undef TPROTOCOL_MESSAGE_TEMPLATE
+#undef TPROTOCOL_MESSAGE
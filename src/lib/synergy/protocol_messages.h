@@ -0,0 +1,65 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/TProtocolMessage.h"
+
+//
+// fixed size protocol messages.  each matches the message with the same
+// name in protocol_types.h, which documents it, and is written and read
+// with a single stream call.
+//
+
+// commands
+typedef TProtocolMessage<'C','N','O','P'>			MsgCNoop;
+typedef TProtocolMessage<'C','B','Y','E'>			MsgCClose;
+typedef TProtocolMessage<'C','I','N','N', 2, 2, 4, 2>	MsgCEnter;
+typedef TProtocolMessage<'C','O','U','T'>			MsgCLeave;
+typedef TProtocolMessage<'C','C','L','P', 1, 4>		MsgCClipboard;
+typedef TProtocolMessage<'C','C','M','S', 1, 4, 4>	MsgCClipboardMissing;
+typedef TProtocolMessage<'C','S','E','C', 1>		MsgCScreenSaver;
+typedef TProtocolMessage<'C','R','O','P'>			MsgCResetOptions;
+typedef TProtocolMessage<'C','I','A','K'>			MsgCInfoAck;
+typedef TProtocolMessage<'C','A','L','V'>			MsgCKeepAlive;
+
+// data
+typedef TProtocolMessage<'D','K','D','N', 2, 2, 2>	MsgDKeyDown;
+typedef TProtocolMessage<'D','K','D','N', 2, 2>		MsgDKeyDown1_0;
+typedef TProtocolMessage<'D','K','R','P', 2, 2, 2, 2>	MsgDKeyRepeat;
+typedef TProtocolMessage<'D','K','R','P', 2, 2, 2>	MsgDKeyRepeat1_0;
+typedef TProtocolMessage<'D','K','U','P', 2, 2, 2>	MsgDKeyUp;
+typedef TProtocolMessage<'D','K','U','P', 2, 2>		MsgDKeyUp1_0;
+typedef TProtocolMessage<'D','M','D','N', 1>		MsgDMouseDown;
+typedef TProtocolMessage<'D','M','U','P', 1>		MsgDMouseUp;
+typedef TProtocolMessage<'D','M','M','V', 2, 2>		MsgDMouseMove;
+typedef TProtocolMessage<'D','M','R','M', 2, 2>		MsgDMouseRelMove;
+typedef TProtocolMessage<'D','M','W','M', 2, 2>		MsgDMouseWheel;
+typedef TProtocolMessage<'D','M','W','M', 2>		MsgDMouseWheel1_0;
+typedef TProtocolMessage<'D','I','N','F', 2, 2, 2, 2, 2, 2, 2>	MsgDInfo;
+typedef TProtocolMessage<'D','C','C','H', 1, 4, 4, 4>	MsgDClipboardCached;
+typedef TProtocolMessage<'D','T','R','M', 4>		MsgDTraceMark;
+typedef TProtocolMessage<'D','T','R','E', 4, 4>		MsgDTraceEcho;
+
+// queries
+typedef TProtocolMessage<'Q','I','N','F'>			MsgQInfo;
+
+// errors
+typedef TProtocolMessage<'E','I','C','V', 2, 2>		MsgEIncompatible;
+typedef TProtocolMessage<'E','B','S','Y'>			MsgEBusy;
+typedef TProtocolMessage<'E','U','N','K'>			MsgEUnknown;
+typedef TProtocolMessage<'E','B','A','D'>			MsgEBad;
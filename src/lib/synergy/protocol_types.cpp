@@ -25,6 +25,7 @@ const char*				kMsgCClose 			= "CBYE";
 const char*				kMsgCEnter 			= "CINN%2i%2i%4i%2i";
 const char*				kMsgCLeave 			= "COUT";
 const char*				kMsgCClipboard 		= "CCLP%1i%4i";
+const char*				kMsgCClipboardMissing	= "CCMS%1i%4i%4i";
 const char*				kMsgCScreenSaver 	= "CSEC%1i";
 const char*				kMsgCResetOptions	= "CROP";
 const char*				kMsgCInfoAck		= "CIAK";
@@ -42,10 +43,13 @@ const char*				kMsgDMouseRelMove	= "DMRM%2i%2i";
 const char*				kMsgDMouseWheel		= "DMWM%2i%2i";
 const char*				kMsgDMouseWheel1_0	= "DMWM%2i";
 const char*				kMsgDClipboard		= "DCLP%1i%4i%1i%s";
+const char*				kMsgDClipboardCached	= "DCCH%1i%4i%4i%4i";
 const char*				kMsgDInfo			= "DINF%2i%2i%2i%2i%2i%2i%2i";
 const char*				kMsgDSetOptions		= "DSOP%4I";
 const char*				kMsgDFileTransfer	= "DFTR%1i%s";
 const char*				kMsgDDragInfo		= "DDRG%2i%s";
+const char*				kMsgDTraceMark		= "DTRM%4i";
+const char*				kMsgDTraceEcho		= "DTRE%4i%4i";
 const char*				kMsgQInfo			= "QINF";
 const char*				kMsgEIncompatible	= "EICV%2i%2i";
 const char*				kMsgEBusy 			= "EBSY";
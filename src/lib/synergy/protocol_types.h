@@ -29,9 +29,12 @@
 // 1.4:  adds crypto support
 // 1.5:  adds file transfer and removes home brew crypto
 // 1.6:  adds clipboard streaming
+// 1.7:  adds cached clipboards
+// 1.8:  adds compressed clipboard and file chunks
+// 1.9:  adds input latency tracing
 // NOTE: with new version, synergy minor version should increment
 static const SInt16		kProtocolMajorVersion = 1;
-static const SInt16		kProtocolMinorVersion = 6;
+static const SInt16		kProtocolMinorVersion = 9;
 
 // default contact port number
 static const UInt16		kDefaultPort = 24800;
@@ -74,7 +77,9 @@ enum EDirectionMask {
 enum EDataTransfer {
 	kDataStart = 1,
 	kDataChunk = 2,
-	kDataEnd = 3
+	kDataEnd = 3,
+	kDataCompressed = 4,
+	kDataCached = 5			// queued locally, goes out as kMsgDClipboardCached
 };
 
 // Data received constants
@@ -148,6 +153,13 @@ extern const char*		kMsgCLeave;
 // most recent kMsgCEnter.  the primary always sends 0.
 extern const char*		kMsgCClipboard;
 
+// clipboard missing:  secondary -> primary
+// sent in response to a kMsgDClipboardCached when the secondary
+// doesn't have the clipboard it names.  $1 = the clipboard
+// identifier, $2, $3 = the high and low halves of the clipboard's
+// hash.  the primary should send the data with kMsgDClipboard.
+extern const char*		kMsgCClipboardMissing;
+
 // screensaver change:  primary -> secondary
 // screensaver on primary has started ($1 == 1) or closed ($1 == 0)
 extern const char*		kMsgCScreenSaver;
@@ -236,9 +248,19 @@ extern const char*		kMsgDMouseWheel1_0;
 // $2 = sequence number, $3 = mark $4 = clipboard data.  the sequence number
 // is 0 when sent by the primary.  secondary screens should use the
 // sequence number from the most recent kMsgCEnter.  $1 = clipboard
-// identifier.
+// identifier.  since 1.8 a kDataCompressed mark may be used instead of
+// kDataChunk, see ChunkCompressor for the format.
 extern const char*		kMsgDClipboard;
 
+// cached clipboard:  primary -> secondary
+// like kMsgDClipboard but without the data.  $1 = clipboard identifier,
+// $2 = sequence number, $3, $4 = the high and low halves of the hash
+// of the clipboard data.  the secondary keeps the last clipboard it
+// sent or received for each identifier and should set the clipboard
+// to that if its hash matches, otherwise reply with a
+// kMsgCClipboardMissing.
+extern const char*		kMsgDClipboardCached;
+
 // client data:  secondary -> primary
 // $1 = coordinate of leftmost pixel on secondary screen,
 // $2 = coordinate of topmost pixel on secondary screen,
@@ -265,6 +287,7 @@ extern const char*		kMsgDSetOptions;
 // 0 means the content followed is the file size.
 // 1 means the content followed is the chunk data.
 // 2 means the file transfer is finished.
+// since 1.8, 4 means the content is a compressed chunk of data.
 extern const char*		kMsgDFileTransfer;
 
 // drag infomation:  primary <-> secondary
@@ -273,6 +296,17 @@ extern const char*		kMsgDFileTransfer;
 // of each object's directory.
 extern const char*		kMsgDDragInfo;
 
+// latency trace mark:  primary -> secondary
+// $1 = sample identifier.  the mouse move that follows is traced.  the
+// secondary notes when it read this message and replies with a
+// kMsgDTraceEcho once it has synthesized that move.  since 1.9.
+extern const char*		kMsgDTraceMark;
+
+// latency trace echo:  secondary -> primary
+// $1 = sample identifier from the kMsgDTraceMark, $2 = microseconds
+// from reading the mark to having synthesized the move.  since 1.9.
+extern const char*		kMsgDTraceEcho;
+
 //
 // query codes
 //
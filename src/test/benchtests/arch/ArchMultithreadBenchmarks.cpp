@@ -0,0 +1,69 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mt/Thread.h"
+#include "arch/Arch.h"
+#include "base/FunctionJob.h"
+#include "base/Log.h"
+
+#include "test/global/gtest.h"
+
+#include <vector>
+
+#define TEST_CANCEL_CHECKS 1000000
+#define TEST_THREADS 4
+
+static
+void
+testCancelLoop(void* vns)
+{
+	UInt64 start = ARCH->nanoseconds();
+	for (int i = 0; i < TEST_CANCEL_CHECKS; ++i) {
+		Thread::testCancel();
+	}
+	*static_cast<UInt64*>(vns) = ARCH->nanoseconds() - start;
+}
+
+static
+double
+runTestCancel(int threads)
+{
+	std::vector<UInt64> ns(threads, 0);
+	std::vector<Thread*> workers;
+	for (int i = 0; i < threads; ++i) {
+		workers.push_back(new Thread(new FunctionJob(&testCancelLoop, &ns[i])));
+	}
+	UInt64 total = 0;
+	for (int i = 0; i < threads; ++i) {
+		workers[i]->wait();
+		delete workers[i];
+		total += ns[i];
+	}
+	return static_cast<double>(total) / threads / TEST_CANCEL_CHECKS;
+}
+
+// measures a cancellation point, the way the socket multiplexer and
+// other worker loops hit it, alone and with other threads doing the
+// same
+TEST(ArchMultithreadBenchmarks, testCancelThread_contended)
+{
+	double alone     = runTestCancel(1);
+	double contended = runTestCancel(TEST_THREADS);
+
+	LOG((CLOG_INFO "testCancel: %.1f ns alone, %.1f ns with %d threads",
+		alone, contended, TEST_THREADS));
+}
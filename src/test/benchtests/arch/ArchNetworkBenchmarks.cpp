@@ -0,0 +1,182 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+#include "common/stdvector.h"
+
+#include "test/global/gtest.h"
+
+#define TEST_PORT 24810
+#define TEST_ROUNDS 10000
+
+// measures how long it takes pollSocket() and waitPollSet() to report
+// one readable socket out of many idle ones.
+class PollBenchmark {
+public:
+	PollBenchmark(int sockets);
+	~PollBenchmark();
+
+	double				timePollSocket();
+	double				timeWaitPollSet();
+
+private:
+	void				makeReadable(int round);
+	void				drain(int round);
+
+private:
+	int					m_sockets;
+	ArchSocket			m_listen;
+	std::vector<ArchSocket>	m_clients;
+	std::vector<ArchSocket>	m_servers;
+};
+
+PollBenchmark::PollBenchmark(int sockets) :
+	m_sockets(sockets)
+{
+	ArchNetAddress addr = ARCH->nameToAddr("127.0.0.1");
+	ARCH->setAddrPort(addr, TEST_PORT);
+
+	m_listen = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+	ARCH->setReuseAddrOnSocket(m_listen, true);
+	ARCH->bindSocket(m_listen, addr);
+	ARCH->listenOnSocket(m_listen);
+
+	IArchNetwork::PollEntry pe;
+	pe.m_socket = m_listen;
+	pe.m_events = IArchNetwork::kPOLLIN;
+	for (int i = 0; i < sockets; ++i) {
+		ArchSocket client = ARCH->newSocket(
+							IArchNetwork::kINET, IArchNetwork::kSTREAM);
+		ARCH->setNoDelayOnSocket(client, true);
+		ARCH->connectSocket(client, addr);
+		m_clients.push_back(client);
+
+		ArchSocket server = NULL;
+		while (server == NULL) {
+			ARCH->pollSocket(&pe, 1, -1.0);
+			server = ARCH->acceptSocket(m_listen, NULL);
+		}
+		m_servers.push_back(server);
+	}
+
+	ARCH->closeAddr(addr);
+}
+
+PollBenchmark::~PollBenchmark()
+{
+	for (int i = 0; i < m_sockets; ++i) {
+		ARCH->closeSocket(m_clients[i]);
+		ARCH->closeSocket(m_servers[i]);
+	}
+	ARCH->closeSocket(m_listen);
+}
+
+double
+PollBenchmark::timePollSocket()
+{
+	// built once, as the multiplexer did when nothing changed
+	std::vector<IArchNetwork::PollEntry> pfds(m_sockets);
+	for (int i = 0; i < m_sockets; ++i) {
+		pfds[i].m_socket = m_servers[i];
+		pfds[i].m_events = IArchNetwork::kPOLLIN;
+	}
+
+	double total = 0.0;
+	for (int round = 0; round < TEST_ROUNDS; ++round) {
+		makeReadable(round);
+		double start = ARCH->time();
+		int n = 0;
+		while (n == 0) {
+			n = ARCH->pollSocket(&pfds[0], m_sockets, -1.0);
+		}
+		total += ARCH->time() - start;
+		drain(round);
+	}
+	return total / TEST_ROUNDS;
+}
+
+double
+PollBenchmark::timeWaitPollSet()
+{
+	ArchPollSet pollSet = ARCH->newPollSet();
+	for (int i = 0; i < m_sockets; ++i) {
+		ARCH->setPollSetSocket(pollSet, m_servers[i],
+							IArchNetwork::kPOLLIN, m_servers[i]);
+	}
+
+	IArchNetwork::PollSetEvent events[64];
+	double total = 0.0;
+	for (int round = 0; round < TEST_ROUNDS; ++round) {
+		makeReadable(round);
+		double start = ARCH->time();
+		int n = 0;
+		while (n == 0) {
+			n = ARCH->waitPollSet(pollSet, events, 64, -1.0);
+		}
+		total += ARCH->time() - start;
+		drain(round);
+	}
+
+	ARCH->closePollSet(pollSet);
+	return total / TEST_ROUNDS;
+}
+
+void
+PollBenchmark::makeReadable(int round)
+{
+	char data = 0;
+	ARCH->writeSocket(m_clients[round % m_sockets], &data, 1);
+}
+
+void
+PollBenchmark::drain(int round)
+{
+	// only this socket is readable so the wait returned for it
+	char data;
+	while (ARCH->readSocket(m_servers[round % m_sockets], &data, 1) == 0) {
+		// spin
+	}
+}
+
+static
+void
+runPollBenchmark(int sockets)
+{
+	PollBenchmark benchmark(sockets);
+
+	double poll = benchmark.timePollSocket();
+	double set  = benchmark.timeWaitPollSet();
+
+	LOG((CLOG_INFO "%4d sockets: pollSocket %.2f us, waitPollSet %.2f us",
+		sockets, 1.0e+6 * poll, 1.0e+6 * set));
+}
+
+TEST(ArchNetworkBenchmarks, poll_10Sockets)
+{
+	runPollBenchmark(10);
+}
+
+TEST(ArchNetworkBenchmarks, poll_100Sockets)
+{
+	runPollBenchmark(100);
+}
+
+TEST(ArchNetworkBenchmarks, poll_1000Sockets)
+{
+	runPollBenchmark(1000);
+}
@@ -0,0 +1,56 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include "test/global/gtest.h"
+
+#if SYSAPI_UNIX
+#include <sys/time.h>
+#endif
+
+#define TEST_READS 10000000
+
+// measures how long it takes to read the clock, against the wall clock
+// that time() used to read on unix
+TEST(ArchTimeBenchmarks, nanoseconds_read)
+{
+	UInt64 sum   = 0;
+	UInt64 start = ARCH->nanoseconds();
+	for (int i = 0; i < TEST_READS; ++i) {
+		sum += ARCH->nanoseconds();
+	}
+	double monotonic =
+		static_cast<double>(ARCH->nanoseconds() - start) / TEST_READS;
+
+	double wall = 0.0;
+#if SYSAPI_UNIX
+	start = ARCH->nanoseconds();
+	for (int i = 0; i < TEST_READS; ++i) {
+		struct timeval t;
+		gettimeofday(&t, NULL);
+		sum += t.tv_usec;
+	}
+	wall = static_cast<double>(ARCH->nanoseconds() - start) / TEST_READS;
+#endif
+
+	LOG((CLOG_INFO "read clock: %.1f ns nanoseconds(), %.1f ns gettimeofday",
+		monotonic, wall));
+
+	EXPECT_NE(0u, sum);
+}
@@ -0,0 +1,463 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/EventQueue.h"
+#include "base/PriorityQueue.h"
+#include "base/IEventJob.h"
+#include "base/TMethodEventJob.h"
+#include "base/TMethodJob.h"
+#include "base/Log.h"
+#include "mt/Thread.h"
+#include "arch/Arch.h"
+#include "common/stdmap.h"
+#include "common/stdvector.h"
+
+#include "test/global/gtest.h"
+
+#include <algorithm>
+
+// measures the time from addEvent() on another thread to dispatch on
+// the event queue's thread, with events posted at a steady rate.
+class EventLatencyBenchmark {
+public:
+	EventLatencyBenchmark(UInt32 rate, double duration);
+
+	void				run();
+
+	void				producer(void*);
+	void				handleStart(const Event&, void*);
+	void				handleEvent(const Event&, void*);
+
+public:
+	UInt32				m_rate;
+	UInt32				m_count;
+	EventQueue			m_events;
+	Event::Type			m_startType;
+	Event::Type			m_type;
+	Thread*				m_producer;
+	std::vector<double>	m_latencies;
+};
+
+EventLatencyBenchmark::EventLatencyBenchmark(UInt32 rate, double duration) :
+	m_rate(rate),
+	m_count(static_cast<UInt32>(rate * duration)),
+	m_startType(Event::kUnknown),
+	m_type(Event::kUnknown),
+	m_producer(NULL)
+{
+	m_events.registerTypeOnce(m_startType,
+		"EventLatencyBenchmark::m_startType");
+	m_events.registerTypeOnce(m_type, "EventLatencyBenchmark::m_type");
+	m_latencies.reserve(m_count);
+}
+
+void
+EventLatencyBenchmark::run()
+{
+	m_events.adoptHandler(m_startType, this,
+		new TMethodEventJob<EventLatencyBenchmark>(
+			this, &EventLatencyBenchmark::handleStart));
+	m_events.adoptHandler(m_type, this,
+		new TMethodEventJob<EventLatencyBenchmark>(
+			this, &EventLatencyBenchmark::handleEvent));
+
+	// the producer is started by the first event so that it can't post
+	// events before the queue is ready for other threads.
+	m_events.addEvent(Event(m_startType, this));
+	m_events.loop();
+	m_producer->wait();
+	delete m_producer;
+
+	m_events.removeHandlers(this);
+
+	std::sort(m_latencies.begin(), m_latencies.end());
+	double total = 0.0;
+	for (size_t i = 0; i < m_latencies.size(); ++i) {
+		total += m_latencies[i];
+	}
+	size_t n = m_latencies.size();
+	LOG((CLOG_INFO "%6d events/s: mean %.1f us, median %.1f us, p99 %.1f us, max %.1f us",
+		m_rate,
+		1.0e+6 * total / n,
+		1.0e+6 * m_latencies[n / 2],
+		1.0e+6 * m_latencies[n * 99 / 100],
+		1.0e+6 * m_latencies[n - 1]));
+}
+
+void
+EventLatencyBenchmark::producer(void*)
+{
+	const double interval = 1.0 / m_rate;
+	double next = ARCH->time();
+	for (UInt32 i = 0; i < m_count; ++i) {
+		// busy wait because sleep() can't pace 100k events a second
+		while (ARCH->time() < next) {
+			// spin
+		}
+		next += interval;
+
+		double* sent = static_cast<double*>(malloc(sizeof(double)));
+		*sent = ARCH->time();
+		m_events.addEvent(Event(m_type, this, sent));
+	}
+	m_events.addEvent(Event(Event::kQuit));
+}
+
+void
+EventLatencyBenchmark::handleStart(const Event&, void*)
+{
+	m_producer = new Thread(new TMethodJob<EventLatencyBenchmark>(
+			this, &EventLatencyBenchmark::producer));
+}
+
+void
+EventLatencyBenchmark::handleEvent(const Event& event, void*)
+{
+	double sent = *static_cast<double*>(event.getData());
+	m_latencies.push_back(ARCH->time() - sent);
+}
+
+TEST(EventQueueBenchmarks, addEvent_1kPerSecond)
+{
+	EventLatencyBenchmark benchmark(1000, 1.0);
+
+	benchmark.run();
+
+	EXPECT_EQ(benchmark.m_count, benchmark.m_latencies.size());
+}
+
+TEST(EventQueueBenchmarks, addEvent_10kPerSecond)
+{
+	EventLatencyBenchmark benchmark(10000, 1.0);
+
+	benchmark.run();
+
+	EXPECT_EQ(benchmark.m_count, benchmark.m_latencies.size());
+}
+
+TEST(EventQueueBenchmarks, addEvent_100kPerSecond)
+{
+	EventLatencyBenchmark benchmark(100000, 1.0);
+
+	benchmark.run();
+
+	EXPECT_EQ(benchmark.m_count, benchmark.m_latencies.size());
+}
+
+// the timer queue EventQueue used to have:  a heap of countdowns that a
+// cancel searched linearly and then rebuilt.
+class LinearTimerQueue {
+public:
+	void				push(void* timer, double time)
+	{
+		m_queue.push(Entry(timer, time));
+	}
+
+	void				erase(void* timer)
+	{
+		for (Queue::iterator i = m_queue.begin(); i != m_queue.end(); ++i) {
+			if (i->m_timer == timer) {
+				m_queue.erase(i);
+				return;
+			}
+		}
+	}
+
+private:
+	class Entry {
+	public:
+		Entry(void* timer, double time) : m_timer(timer), m_time(time) { }
+		bool			operator>(const Entry& e) const { return m_time > e.m_time; }
+
+		void*			m_timer;
+		double			m_time;
+	};
+	typedef PriorityQueue<Entry> Queue;
+
+	Queue				m_queue;
+};
+
+// pushes back one of 10k heartbeat alarms per received message, the way
+// the client proxies do, first by deleting and recreating the timer and
+// then with resetTimer().
+TEST(EventQueueBenchmarks, resetTimer_10kTimers)
+{
+	static const UInt32 kTimers = 10000;
+	static const UInt32 kResets = 1000000;
+
+	EventQueue events;
+	std::vector<EventQueueTimer*> timers;
+	for (UInt32 i = 0; i < kTimers; ++i) {
+		timers.push_back(events.newOneShotTimer(60.0 + i * 0.001, NULL));
+	}
+
+	double start = ARCH->time();
+	for (UInt32 i = 0; i < kResets; ++i) {
+		EventQueueTimer*& timer = timers[(i * 7919) % kTimers];
+		events.deleteTimer(timer);
+		timer = events.newOneShotTimer(60.0, NULL);
+	}
+	double recreate = (ARCH->time() - start) / kResets;
+
+	start = ARCH->time();
+	for (UInt32 i = 0; i < kResets; ++i) {
+		events.resetTimer(timers[(i * 7919) % kTimers], 60.0);
+	}
+	double reset = (ARCH->time() - start) / kResets;
+
+	for (UInt32 i = 0; i < kTimers; ++i) {
+		events.deleteTimer(timers[i]);
+	}
+
+	// the old queue is too slow for a million
+	static const UInt32 kLinearResets = 1000;
+	LinearTimerQueue linear;
+	for (UInt32 i = 0; i < kTimers; ++i) {
+		linear.push(&timers[i], 60.0 + i * 0.001);
+	}
+	start = ARCH->time();
+	for (UInt32 i = 0; i < kLinearResets; ++i) {
+		void* timer = &timers[(i * 7919) % kTimers];
+		linear.erase(timer);
+		linear.push(timer, 60.0);
+	}
+	double old = (ARCH->time() - start) / kLinearResets;
+
+	LOG((CLOG_INFO "rearm one of %u timers: %.2f us linear queue, %.2f us delete and create, %.2f us resetTimer",
+		kTimers, 1.0e+6 * old, 1.0e+6 * recreate, 1.0e+6 * reset));
+
+	EXPECT_LT(reset, old);
+}
+
+// fires 10k recurring timers with periods from 10 to 110 ms and measures
+// how long it takes to get each timer event.
+TEST(EventQueueBenchmarks, timerEvents_10kTimers)
+{
+	static const UInt32 kTimers = 10000;
+
+	EventQueue events;
+	std::vector<EventQueueTimer*> timers;
+	for (UInt32 i = 0; i < kTimers; ++i) {
+		timers.push_back(events.newTimer(0.010 + (i % 1000) * 0.0001, NULL));
+	}
+
+	UInt32 fired = 0;
+	double busy  = 0.0;
+	double start = ARCH->time();
+	while (ARCH->time() - start < 1.0) {
+		double before = ARCH->time();
+		Event event;
+		if (events.getEvent(event, 0.0) && event.getType() == Event::kTimer) {
+			busy += ARCH->time() - before;
+			++fired;
+		}
+	}
+
+	for (UInt32 i = 0; i < kTimers; ++i) {
+		events.deleteTimer(timers[i]);
+	}
+
+	LOG((CLOG_INFO "%u timers: %u timer events in 1 s, %.2f us each",
+		kTimers, fired, 1.0e+6 * busy / fired));
+
+	EXPECT_LT(0u, fired);
+}
+
+// the handler table EventQueue used to have:  a map of maps behind the
+// queue's mutex.
+class LockedHandlerMap {
+public:
+	LockedHandlerMap() : m_mutex(ARCH->newMutex()) { }
+	~LockedHandlerMap() { ARCH->closeMutex(m_mutex); }
+
+	void				adopt(Event::Type type, void* target, IEventJob* job)
+	{
+		ArchMutexLock lock(m_mutex);
+		m_handlers[target][type] = job;
+	}
+
+	void				remove(Event::Type type, void* target)
+	{
+		ArchMutexLock lock(m_mutex);
+		m_handlers[target].erase(type);
+	}
+
+	IEventJob*			find(Event::Type type, void* target) const
+	{
+		ArchMutexLock lock(m_mutex);
+		Handlers::const_iterator index = m_handlers.find(target);
+		if (index != m_handlers.end()) {
+			TypeHandlers::const_iterator index2 = index->second.find(type);
+			if (index2 != index->second.end()) {
+				return index2->second;
+			}
+		}
+		return NULL;
+	}
+
+private:
+	typedef std::map<Event::Type, IEventJob*> TypeHandlers;
+	typedef std::map<void*, TypeHandlers> Handlers;
+
+	ArchMutex			m_mutex;
+	Handlers			m_handlers;
+};
+
+// counts the events it's run for
+class CountingEventJob : public IEventJob {
+public:
+	CountingEventJob(UInt32* count) : m_count(count) { }
+
+	virtual void		run(const Event&) { ++*m_count; }
+
+private:
+	UInt32*				m_count;
+};
+
+// dispatches events round robin to 4 event types on each of 1000
+// targets, the way the main loop does, first through the old map and
+// then through EventQueue::dispatchEvent().  with \c churn a second
+// thread keeps adding and removing a handler while events dispatch.
+class DispatchBenchmark {
+public:
+	enum { kTargets = 1000, kTypes = 4 };
+
+	DispatchBenchmark(bool churn);
+	~DispatchBenchmark();
+
+	void				run(UInt32 dispatches);
+
+	void				churn(void*);
+
+public:
+	bool				m_churn;
+	EventQueue			m_events;
+	LockedHandlerMap	m_map;
+	Event::Type			m_types[kTypes];
+	std::vector<int>	m_targets;
+	CountingEventJob	m_job;
+	UInt32				m_count;
+	AtomicUInt32		m_stop;
+};
+
+DispatchBenchmark::DispatchBenchmark(bool churn) :
+	m_churn(churn),
+	m_targets(kTargets),
+	m_job(&m_count),
+	m_count(0)
+{
+	for (int i = 0; i < kTypes; ++i) {
+		m_types[i] = Event::kUnknown;
+		m_events.registerTypeOnce(m_types[i], "DispatchBenchmark::m_types");
+	}
+	for (int i = 0; i < kTargets; ++i) {
+		for (int j = 0; j < kTypes; ++j) {
+			m_map.adopt(m_types[j], &m_targets[i], &m_job);
+			m_events.adoptHandler(m_types[j], &m_targets[i],
+							new CountingEventJob(&m_count));
+		}
+	}
+}
+
+DispatchBenchmark::~DispatchBenchmark()
+{
+	for (int i = 0; i < kTargets; ++i) {
+		m_events.removeHandlers(&m_targets[i]);
+	}
+}
+
+void
+DispatchBenchmark::run(UInt32 dispatches)
+{
+	std::vector<Event> events;
+	for (int i = 0; i < kTargets; ++i) {
+		for (int j = 0; j < kTypes; ++j) {
+			events.push_back(Event(m_types[j],
+							&m_targets[(i * 7919) % kTargets]));
+		}
+	}
+	size_t n = events.size();
+
+	Thread* churner = NULL;
+	if (m_churn) {
+		churner = new Thread(new TMethodJob<DispatchBenchmark>(
+							this, &DispatchBenchmark::churn));
+	}
+
+	double start = ARCH->time();
+	for (UInt32 i = 0; i < dispatches; ++i) {
+		const Event& event = events[i % n];
+		IEventJob* job = m_map.find(event.getType(), event.getTarget());
+		if (job == NULL) {
+			job = m_map.find(Event::kUnknown, event.getTarget());
+		}
+		if (job != NULL) {
+			job->run(event);
+		}
+	}
+	double old = (ARCH->time() - start) / dispatches;
+
+	start = ARCH->time();
+	for (UInt32 i = 0; i < dispatches; ++i) {
+		m_events.dispatchEvent(events[i % n]);
+	}
+	double now = (ARCH->time() - start) / dispatches;
+
+	if (churner != NULL) {
+		m_stop.store(1);
+		churner->wait();
+		delete churner;
+	}
+
+	LOG((CLOG_INFO "dispatch to %d handlers%s: %.1f ns map and mutex, %.1f ns dispatchEvent",
+		kTargets * kTypes, m_churn ? " while adding handlers" : "",
+		1.0e+9 * old, 1.0e+9 * now));
+}
+
+void
+DispatchBenchmark::churn(void*)
+{
+	int target;
+	while (m_stop.load() == 0) {
+		m_map.adopt(m_types[0], &target, &m_job);
+		m_map.remove(m_types[0], &target);
+		m_events.adoptHandler(m_types[0], &target,
+							new CountingEventJob(&m_count));
+		m_events.removeHandler(m_types[0], &target);
+		ARCH->sleep(0.0001);
+	}
+}
+
+TEST(EventQueueBenchmarks, dispatchEvent_4kHandlers)
+{
+	static const UInt32 kDispatches = 4000000;
+	DispatchBenchmark benchmark(false);
+
+	benchmark.run(kDispatches);
+
+	EXPECT_EQ(2 * kDispatches, benchmark.m_count);
+}
+
+TEST(EventQueueBenchmarks, dispatchEvent_4kHandlersWhileAdding)
+{
+	static const UInt32 kDispatches = 4000000;
+	DispatchBenchmark benchmark(true);
+
+	benchmark.run(kDispatches);
+
+	EXPECT_EQ(2 * kDispatches, benchmark.m_count);
+}
@@ -0,0 +1,77 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Log.h"
+#include "base/log_outputters.h"
+#include "arch/Arch.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdio>
+
+// measures the time a thread spends in LOG() while logging to a file,
+// in bursts that fit in the asynchronous ring.
+static
+void
+benchmarkFileLog(bool async)
+{
+	const int kBursts       = 10;
+	const int kBurstSize    = 256;
+	const char* kFileName   = "LogBenchmarks.log";
+
+	// the stop outputter keeps the messages off the console
+	StopLogOutputter* stop = new StopLogOutputter;
+	FileLogOutputter* file = new FileLogOutputter(kFileName);
+	int filter = CLOG->getFilter();
+	CLOG->insert(stop);
+	CLOG->insert(file);
+	CLOG->setFilter(kDEBUG1);
+	CLOG->setAsync(async);
+
+	double total = 0.0;
+	for (int i = 0; i < kBursts; ++i) {
+		double start = ARCH->time();
+		for (int j = 0; j < kBurstSize; ++j) {
+			LOG((CLOG_DEBUG1 "mouse move to %d,%d", i, j));
+		}
+		total += ARCH->time() - start;
+
+		// let the writer catch up between bursts
+		ARCH->sleep(0.02);
+	}
+
+	CLOG->setAsync(false);
+	UInt32 dropped = CLOG->getDropped();
+	CLOG->setFilter(filter);
+	CLOG->pop_front();
+	CLOG->pop_front();
+	remove(kFileName);
+
+	LOG((CLOG_INFO "%s file log: %.2f us per message, %u dropped",
+		async ? "async" : "sync",
+		1.0e+6 * total / (kBursts * kBurstSize), dropped));
+}
+
+TEST(LogBenchmarks, print_fileSync)
+{
+	benchmarkFileLog(false);
+}
+
+TEST(LogBenchmarks, print_fileAsync)
+{
+	benchmarkFileLog(true);
+}
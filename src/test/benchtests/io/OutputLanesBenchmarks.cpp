@@ -0,0 +1,171 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "io/OutputLanes.h"
+#include "io/IStream.h"
+#include "synergy/FileChunk.h"
+#include "synergy/protocol_messages.h"
+#include "synergy/protocol_types.h"
+#include "base/Log.h"
+#include "common/stddeque.h"
+
+#include "test/global/gtest.h"
+
+#include <algorithm>
+
+// a 100 Mbit/s link simulated in 100 us steps
+#define STEP_TIME 0.0001
+#define STEP_BYTES 1250
+
+// a stream whose output goes over a simulated link.  with lanes off,
+// bulk writes queue behind everything else the way they used to.  the
+// simulation leaves out the kernel's socket buffer, which adds the same
+// delay either way.
+class SimulatedLink : public synergy::IStream {
+public:
+	SimulatedLink(bool useLanes) : m_useLanes(useLanes), m_match(0) { }
+
+	// IStream overrides
+	virtual void		close() { }
+	virtual UInt32		read(void*, UInt32) { return 0; }
+	virtual void		write(const void* buffer, UInt32 n)
+	{
+		m_lanes.write(buffer, n);
+	}
+	virtual void		writeBulk(const void* buffer, UInt32 n)
+	{
+		if (m_useLanes) {
+			m_lanes.writeBulk(buffer, n);
+		}
+		else {
+			m_lanes.write(buffer, n);
+		}
+	}
+	virtual void		flush() { }
+	virtual void		shutdownInput() { }
+	virtual void		shutdownOutput() { }
+	virtual void*		getEventTarget() const
+	{
+		return const_cast<SimulatedLink*>(this);
+	}
+	virtual bool		isReady() const { return false; }
+	virtual UInt32		getSize() const { return 0; }
+
+	// sends up to n bytes and returns how many mouse moves went out
+	UInt32				send(UInt32 n);
+
+	UInt32				getQueued() const { return m_lanes.getSize(); }
+
+private:
+	bool				m_useLanes;
+	OutputLanes			m_lanes;
+	UInt32				m_match;
+};
+
+UInt32
+SimulatedLink::send(UInt32 n)
+{
+	// the file is all zeros so any mouse move code is a mouse move
+	static const char code[] = "DMMV";
+	UInt32 moves = 0;
+	while (n > 0) {
+		StreamBuffer& output = m_lanes.next();
+		if (output.getSize() == 0) {
+			break;
+		}
+		IArchNetwork::WriteBuffer buf;
+		output.peekChunks(&buf, 1);
+		UInt32 size = std::min(n, static_cast<UInt32>(buf.m_size));
+		const char* data = static_cast<const char*>(buf.m_data);
+		for (UInt32 i = 0; i < size; ++i) {
+			if (data[i] == code[m_match]) {
+				if (++m_match == 4) {
+					++moves;
+					m_match = 0;
+				}
+			}
+			else {
+				m_match = (data[i] == code[0]) ? 1 : 0;
+			}
+		}
+		output.pop(size);
+		n -= size;
+	}
+	return moves;
+}
+
+// moves the mouse at 1 kHz while a file goes over the link in 512 KB
+// chunks with a 1 MB send window, and measures how long each move waits
+// to go out.
+static
+void
+measureInputLatency(bool useLanes, double& average, double& worst)
+{
+	static const size_t kFileSize  = 32 * 1024 * 1024;
+	static const size_t kChunkSize = 512 * 1024;
+	static const UInt32 kWindow    = 1024 * 1024;
+	static char chunk[kChunkSize];
+
+	SimulatedLink link(useLanes);
+	std::deque<double> queued;
+	size_t sent  = 0;
+	UInt32 moves = 0;
+	double total = 0.0;
+	worst        = 0.0;
+
+	for (UInt32 step = 0; sent < kFileSize || link.getQueued() > 0; ++step) {
+		double now = step * STEP_TIME;
+
+		while (sent < kFileSize && link.getQueued() < kWindow) {
+			FileChunk::send(&link, kDataChunk, chunk, kChunkSize);
+			sent += kChunkSize;
+		}
+
+		if (step % 10 == 0) {
+			MsgDMouseMove::write(&link, 100, 100);
+			queued.push_back(now);
+		}
+
+		// each move counts as gone once its code is on the wire
+		UInt32 done = link.send(STEP_BYTES);
+		for (UInt32 i = 0; i < done; ++i) {
+			double latency = now + STEP_TIME - queued.front();
+			queued.pop_front();
+			total += latency;
+			worst  = std::max(worst, latency);
+			++moves;
+		}
+	}
+
+	average = total / moves;
+}
+
+TEST(OutputLanesBenchmarks, inputLatencyDuringFileTransfer)
+{
+	double fifoAverage, fifoWorst;
+	measureInputLatency(false, fifoAverage, fifoWorst);
+	double lanesAverage, lanesWorst;
+	measureInputLatency(true, lanesAverage, lanesWorst);
+
+	LOG((CLOG_INFO "mouse move latency during file transfer at 100 Mbit/s, one queue: %.1f ms average, %.1f ms worst",
+		fifoAverage * 1000.0, fifoWorst * 1000.0));
+	LOG((CLOG_INFO "mouse move latency during file transfer at 100 Mbit/s, bulk lane: %.1f ms average, %.1f ms worst",
+		lanesAverage * 1000.0, lanesWorst * 1000.0));
+
+	EXPECT_LT(lanesWorst, fifoWorst);
+}
@@ -0,0 +1,195 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/StreamBuffer.h"
+#include "arch/Arch.h"
+#include "base/Log.h"
+#include "common/stdlist.h"
+#include "common/stdvector.h"
+
+#include "test/global/gtest.h"
+
+#include <cstring>
+
+// the list of 4 KB chunks that StreamBuffer used to be, kept here to
+// compare against.
+class ChunkListBuffer {
+public:
+	ChunkListBuffer() : m_size(0), m_headUsed(0) { }
+
+	const void*			peek(UInt32 n);
+	void				pop(UInt32 n);
+	void				write(const void* data, UInt32 n);
+
+private:
+	typedef std::vector<UInt8> Chunk;
+	typedef std::list<Chunk> ChunkList;
+
+	ChunkList			m_chunks;
+	UInt32				m_size;
+	UInt32				m_headUsed;
+};
+
+const void*
+ChunkListBuffer::peek(UInt32 n)
+{
+	ChunkList::iterator head = m_chunks.begin();
+	head->reserve(n + m_headUsed);
+	ChunkList::iterator scan = head;
+	++scan;
+	while (head->size() - m_headUsed < n && scan != m_chunks.end()) {
+		head->insert(head->end(), scan->begin(), scan->end());
+		scan = m_chunks.erase(scan);
+	}
+	return &(head->begin()[m_headUsed]);
+}
+
+void
+ChunkListBuffer::pop(UInt32 n)
+{
+	if (n >= m_size) {
+		m_size     = 0;
+		m_headUsed = 0;
+		m_chunks.clear();
+		return;
+	}
+	m_size -= n;
+	ChunkList::iterator scan = m_chunks.begin();
+	while (scan->size() - m_headUsed <= n) {
+		n         -= (UInt32)scan->size() - m_headUsed;
+		m_headUsed = 0;
+		scan       = m_chunks.erase(scan);
+	}
+	m_headUsed += n;
+}
+
+void
+ChunkListBuffer::write(const void* vdata, UInt32 n)
+{
+	m_size += n;
+	const UInt8* data = reinterpret_cast<const UInt8*>(vdata);
+	ChunkList::iterator scan = m_chunks.end();
+	if (scan != m_chunks.begin()) {
+		--scan;
+		if (scan->size() >= 4096) {
+			++scan;
+		}
+	}
+	if (scan == m_chunks.end()) {
+		scan = m_chunks.insert(scan, Chunk());
+	}
+	while (n > 0) {
+		UInt32 count = 4096 - (UInt32)scan->size();
+		if (count > n)
+			count = n;
+		scan->insert(scan->end(), data, data + count);
+		n    -= count;
+		data += count;
+		if (n > 0) {
+			++scan;
+			scan = m_chunks.insert(scan, Chunk());
+		}
+	}
+}
+
+// writes short packets and reads each one back the way
+// PacketStreamFilter does:  peek at the length then at the message.
+template <class Buffer>
+static
+double
+timeSmallMessages(UInt32 messages)
+{
+	static const UInt8 packet[] = {
+		0, 0, 0, 8, 'D', 'M', 'M', 'V', 0, 100, 0, 200
+	};
+	const UInt32 size = sizeof(packet);
+
+	Buffer buffer;
+	UInt32 sum   = 0;
+	double start = ARCH->time();
+	for (UInt32 i = 0; i < messages; ++i) {
+		buffer.write(packet, size);
+
+		// let a few messages queue up, like a busy socket would
+		if ((i & 3) == 3) {
+			for (UInt32 j = 0; j < 4; ++j) {
+				const UInt8* length =
+					static_cast<const UInt8*>(buffer.peek(4));
+				UInt32 n = length[3];
+				const UInt8* message =
+					static_cast<const UInt8*>(buffer.peek(4 + n));
+				sum += message[4];
+				buffer.pop(4 + n);
+			}
+		}
+	}
+	double elapsed = ARCH->time() - start;
+
+	EXPECT_EQ(messages * 'D', sum);
+	return elapsed / messages;
+}
+
+// writes a large message in 4 KB reads then peeks at all of it, like a
+// clipboard or file chunk arriving on a socket.
+template <class Buffer>
+static
+double
+timeBulk(UInt32 size, UInt32 rounds)
+{
+	std::vector<UInt8> data(4096, 'x');
+
+	double start = ARCH->time();
+	for (UInt32 i = 0; i < rounds; ++i) {
+		Buffer buffer;
+		for (UInt32 n = 0; n < size; n += 4096) {
+			buffer.write(&data[0], 4096);
+		}
+		const UInt8* message = static_cast<const UInt8*>(buffer.peek(size));
+		EXPECT_EQ('x', message[size - 1]);
+		buffer.pop(size);
+	}
+	return (ARCH->time() - start) / rounds;
+}
+
+TEST(StreamBufferBenchmarks, smallMessages)
+{
+	const UInt32 messages = 1000000;
+
+	double list = timeSmallMessages<ChunkListBuffer>(messages);
+	double ring = timeSmallMessages<StreamBuffer>(messages);
+
+	LOG((CLOG_INFO "small messages: chunk list %.1f ns, ring %.1f ns",
+		1.0e+9 * list, 1.0e+9 * ring));
+}
+
+TEST(StreamBufferBenchmarks, bulk_64KB)
+{
+	double list = timeBulk<ChunkListBuffer>(64 * 1024, 1000);
+	double ring = timeBulk<StreamBuffer>(64 * 1024, 1000);
+
+	LOG((CLOG_INFO "64 KB message: chunk list %.1f us, ring %.1f us",
+		1.0e+6 * list, 1.0e+6 * ring));
+}
+
+TEST(StreamBufferBenchmarks, bulk_512KB)
+{
+	double list = timeBulk<ChunkListBuffer>(512 * 1024, 100);
+	double ring = timeBulk<StreamBuffer>(512 * 1024, 100);
+
+	LOG((CLOG_INFO "512 KB message: chunk list %.1f us, ring %.1f us",
+		1.0e+6 * list, 1.0e+6 * ring));
+}
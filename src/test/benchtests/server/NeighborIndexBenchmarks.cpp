@@ -0,0 +1,138 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2013 Synergy Si Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_ENV
+
+#include "server/NeighborIndex.h"
+#include "server/Config.h"
+#include "arch/Arch.h"
+#include "base/Log.h"
+#include "base/String.h"
+
+#include "test/mock/server/MockClientProxy.h"
+
+#include "test/global/gtest.h"
+
+#define TEST_COLUMNS 8
+#define TEST_ROWS 5
+#define TEST_LOOKUPS 1000000
+
+// a wall of screens where every other column isn't connected and each
+// side is split into several fractional links.
+class VideoWall {
+public:
+	VideoWall();
+
+	String				name(int column, int row) const;
+	BaseClientProxy*	configNeighbor(const String& src,
+							EDirection dir, float t, float& tOut) const;
+
+public:
+	Config				m_config;
+	NeighborIndex::ClientList	m_clients;
+	MockClientProxy		m_proxies[TEST_COLUMNS * TEST_ROWS];
+};
+
+VideoWall::VideoWall()
+{
+	for (int row = 0; row < TEST_ROWS; ++row) {
+		for (int column = 0; column < TEST_COLUMNS; ++column) {
+			m_config.addScreen(name(column, row));
+		}
+	}
+	for (int row = 0; row < TEST_ROWS; ++row) {
+		for (int column = 0; column + 1 < TEST_COLUMNS; ++column) {
+			String src = name(column, row);
+			String dst = name(column + 1, row);
+			for (int i = 0; i < 4; ++i) {
+				float start = 0.25f * i;
+				m_config.connect(src, kRight, start, start + 0.25f,
+								dst, start, start + 0.25f);
+			}
+		}
+		for (int column = 0; column < TEST_COLUMNS; column += 2) {
+			m_clients[name(column, row)] =
+				&m_proxies[row * TEST_COLUMNS + column];
+		}
+	}
+}
+
+String
+VideoWall::name(int column, int row) const
+{
+	return synergy::string::sprintf("screen-%d-%d", column, row);
+}
+
+BaseClientProxy*
+VideoWall::configNeighbor(const String& src,
+				EDirection dir, float t, float& tOut) const
+{
+	// what Server::getNeighbor() did before the index
+	String srcName(src);
+	for (;;) {
+		String dstName(m_config.getNeighbor(srcName, dir, t, &tOut));
+		if (dstName.empty()) {
+			return NULL;
+		}
+		NeighborIndex::ClientList::const_iterator index =
+			m_clients.find(dstName);
+		if (index != m_clients.end()) {
+			return index->second;
+		}
+		srcName = dstName;
+		t       = tOut;
+	}
+}
+
+TEST(NeighborIndexBenchmarks, getNeighbor_40Screens)
+{
+	VideoWall wall;
+	NeighborIndex index;
+
+	double start = ARCH->time();
+	index.build(wall.m_config, wall.m_clients);
+	double build = ARCH->time() - start;
+
+	String srcName = wall.name(0, 2);
+	BaseClientProxy* src = wall.m_clients[srcName];
+	float t;
+
+	UInt32 found = 0;
+	start = ARCH->time();
+	for (int i = 0; i < TEST_LOOKUPS; ++i) {
+		float position = static_cast<float>(i % 1000) / 1000.0f;
+		if (wall.configNeighbor(srcName, kRight, position, t) != NULL) {
+			++found;
+		}
+	}
+	double config = ARCH->time() - start;
+
+	start = ARCH->time();
+	for (int i = 0; i < TEST_LOOKUPS; ++i) {
+		float position = static_cast<float>(i % 1000) / 1000.0f;
+		if (index.getNeighbor(src, kRight, position, t) != NULL) {
+			++found;
+		}
+	}
+	double indexed = ARCH->time() - start;
+
+	LOG((CLOG_INFO "%d screens: config walk %.1f ns, index %.1f ns, build %.1f us",
+		TEST_COLUMNS * TEST_ROWS,
+		1.0e+9 * config / TEST_LOOKUPS, 1.0e+9 * indexed / TEST_LOOKUPS,
+		1.0e+6 * build));
+	EXPECT_EQ(2u * TEST_LOOKUPS, found);
+}
@@ -0,0 +1,172 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy/ChunkCompressor.h"
+#include "arch/Arch.h"
+#include "base/Log.h"
+#include "common/stdvector.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdlib>
+
+#define CHUNK_SIZE (512 * 1024)
+
+// bytes per second of a 100 Mbit network, for estimating paste latency
+#define LINK_SPEED (100.0e+6 / 8)
+
+static String
+makeText()
+{
+	String data;
+	srand(3);
+	while (data.size() < 4 * 1024 * 1024) {
+		static const char* s_words[] = {
+			"keyboard ", "mouse ", "screen ", "clipboard ", "share ",
+			"the ", "a ", "and ", "of ", "to ", "server ", "client\r\n"
+		};
+		data += s_words[rand() % 12];
+	}
+	return data;
+}
+
+static String
+makeHTML()
+{
+	String data = "Version:0.9\r\nStartHTML:0000000105\r\n<html><body><table>";
+	for (int i = 0; data.size() < 4 * 1024 * 1024; ++i) {
+		data += synergy::string::sprintf(
+			"<tr><td class=\"cell\">%d</td><td style=\"color:#%06x\">row %d</td></tr>\r\n",
+			i, i * 2654435761U & 0xffffff, i);
+	}
+	data += "</table></body></html>";
+	return data;
+}
+
+static String
+makeBitmap()
+{
+	// a 1920x1080 screenshot:  flat window backgrounds, a gradient
+	// title bar and a little noise
+	const int w = 1920, h = 1080;
+	String data(54 + w * h * 3, '\0');
+	data[0] = 'B';
+	data[1] = 'M';
+	srand(4);
+	char* p = &data[54];
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			UInt8 r = 0xf0, g = 0xf0, b = 0xf0;
+			if (y < 30) {
+				r = static_cast<UInt8>(x * 255 / w);
+				g = 0x40;
+				b = 0x80;
+			}
+			else if ((x / 240 + y / 135) % 3 == 0 && rand() % 16 == 0) {
+				r = g = b = static_cast<UInt8>(rand());
+			}
+			*p++ = b;
+			*p++ = g;
+			*p++ = r;
+		}
+	}
+	return data;
+}
+
+static String
+makeRandom()
+{
+	String data(4 * 1024 * 1024, '\0');
+	srand(5);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<char>(rand());
+	}
+	return data;
+}
+
+static void
+measure(const char* name, const String& data)
+{
+	ChunkCompressor compressor;
+	std::vector<String> chunks;
+	std::vector<bool> packed;
+
+	double start = ARCH->time();
+	for (size_t offset = 0; offset < data.size(); offset += CHUNK_SIZE) {
+		size_t size = data.size() - offset;
+		if (size > CHUNK_SIZE) {
+			size = CHUNK_SIZE;
+		}
+		String chunk;
+		bool compressed = compressor.compress(data.data() + offset, size, chunk);
+		if (!compressed) {
+			chunk = data.substr(offset, size);
+		}
+		chunks.push_back(chunk);
+		packed.push_back(compressed);
+	}
+	double compressTime = ARCH->time() - start;
+
+	String result;
+	start = ARCH->time();
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		if (packed[i]) {
+			String chunk;
+			ASSERT_TRUE(ChunkCompressor::decompress(chunks[i], chunk));
+			result += chunk;
+		}
+		else {
+			result += chunks[i];
+		}
+	}
+	double decompressTime = ARCH->time() - start;
+	EXPECT_EQ(data, result);
+
+	double ratio   = static_cast<double>(compressor.getBytesIn()) /
+					 compressor.getBytesOut();
+	double raw     = data.size() / LINK_SPEED;
+	double latency = compressTime + decompressTime +
+					 compressor.getBytesOut() / LINK_SPEED;
+
+	LOG((CLOG_INFO "%s: %u bytes, ratio %.2f, compress %.1f MB/s, decompress %.1f MB/s",
+		name, data.size(), ratio,
+		data.size() / compressTime / 1.0e+6,
+		data.size() / decompressTime / 1.0e+6));
+	LOG((CLOG_INFO "%s: paste latency at 100 Mbit/s %.1f ms raw, %.1f ms compressed",
+		name, 1000 * raw, 1000 * latency));
+}
+
+TEST(ChunkCompressorBenchmarks, text)
+{
+	measure("text", makeText());
+}
+
+TEST(ChunkCompressorBenchmarks, html)
+{
+	measure("html", makeHTML());
+}
+
+TEST(ChunkCompressorBenchmarks, bitmap)
+{
+	measure("bitmap", makeBitmap());
+}
+
+TEST(ChunkCompressorBenchmarks, random)
+{
+	measure("random", makeRandom());
+}
@@ -0,0 +1,111 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/protocol_messages.h"
+#include "synergy/protocol_types.h"
+#include "synergy/ProtocolUtil.h"
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include "test/global/gtest.h"
+
+#define TEST_MESSAGES 1000000
+
+// a stream that reads back the same message forever and discards
+// whatever is written to it
+class LoopStream : public synergy::IStream {
+public:
+	LoopStream() : m_size(0), m_offset(0), m_sum(0) { }
+
+	virtual void		close() { }
+	virtual UInt32		read(void* buffer, UInt32 n)
+	{
+		UInt8* dst = static_cast<UInt8*>(buffer);
+		for (UInt32 i = 0; i < n; ++i) {
+			dst[i]   = m_data[m_offset];
+			m_offset = (m_offset + 1) % m_size;
+		}
+		return n;
+	}
+	virtual void		write(const void* buffer, UInt32 n)
+	{
+		m_sum += static_cast<const UInt8*>(buffer)[n - 1];
+	}
+	virtual void		flush() { }
+	virtual void		shutdownInput() { }
+	virtual void		shutdownOutput() { }
+	virtual void*		getEventTarget() const { return NULL; }
+	virtual bool		isReady() const { return true; }
+	virtual UInt32		getSize() const { return m_size; }
+
+public:
+	UInt8				m_data[4];
+	UInt32				m_size;
+	UInt32				m_offset;
+	UInt32				m_sum;
+};
+
+TEST(ProtocolMessageBenchmarks, writeMouseMove)
+{
+	LoopStream stream;
+
+	double start = ARCH->time();
+	for (SInt32 i = 0; i < TEST_MESSAGES; ++i) {
+		ProtocolUtil::writef(&stream, kMsgDMouseMove, i & 0x7fff, 100);
+	}
+	double writef = ARCH->time() - start;
+
+	start = ARCH->time();
+	for (SInt32 i = 0; i < TEST_MESSAGES; ++i) {
+		MsgDMouseMove::write(&stream, i & 0x7fff, 100);
+	}
+	double write = ARCH->time() - start;
+
+	LOG((CLOG_INFO "write mouse move: writef %.1f ns, template %.1f ns",
+		1.0e+9 * writef / TEST_MESSAGES, 1.0e+9 * write / TEST_MESSAGES));
+	EXPECT_EQ(2u * TEST_MESSAGES * 100, stream.m_sum);
+}
+
+TEST(ProtocolMessageBenchmarks, readMouseMove)
+{
+	LoopStream stream;
+	stream.m_data[0] = 0x01;
+	stream.m_data[1] = 0x02;
+	stream.m_data[2] = 0x03;
+	stream.m_data[3] = 0x04;
+	stream.m_size    = 4;
+	SInt16 x = 0, y = 0;
+	SInt32 sum = 0;
+
+	double start = ARCH->time();
+	for (UInt32 i = 0; i < TEST_MESSAGES; ++i) {
+		ProtocolUtil::readf(&stream, kMsgDMouseMove + 4, &x, &y);
+		sum += x + y;
+	}
+	double readf = ARCH->time() - start;
+
+	start = ARCH->time();
+	for (UInt32 i = 0; i < TEST_MESSAGES; ++i) {
+		MsgDMouseMove::read(&stream, &x, &y);
+		sum += x + y;
+	}
+	double read = ARCH->time() - start;
+
+	LOG((CLOG_INFO "read mouse move: readf %.1f ns, template %.1f ns",
+		1.0e+9 * readf / TEST_MESSAGES, 1.0e+9 * read / TEST_MESSAGES));
+	EXPECT_EQ(2 * TEST_MESSAGES * (0x0102 + 0x0304), sum);
+}
@@ -0,0 +1,223 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/StreamChunker.h"
+#include "synergy/FileChunk.h"
+#include "synergy/FileSendWindow.h"
+#include "synergy/protocol_types.h"
+#include "net/TCPSocket.h"
+#include "net/NetworkAddress.h"
+#include "net/SocketMultiplexer.h"
+#include "mt/Thread.h"
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/TMethodJob.h"
+#include "base/Log.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+#define TEST_PORT 24811
+#define TEST_FILE "StreamChunkerBenchmarks.dat"
+
+// sends a file over loopback the way the server and client do:  a
+// thread chunks the file, the event thread writes the chunks to a
+// socket and a reader on the other end throws the data away.  reports
+// throughput and the cpu time used by the whole process.
+class SendFileBenchmark {
+public:
+	SendFileBenchmark(size_t fileSize);
+	~SendFileBenchmark();
+
+	void				run();
+
+	void				sender(void*);
+	void				reader(void*);
+	void				handleConnected(const Event&, void*);
+	void				handleChunk(const Event&, void*);
+	void				handleOutputFlushed(const Event&, void*);
+
+public:
+	size_t				m_fileSize;
+	EventQueue			m_events;
+	SocketMultiplexer	m_multiplexer;
+	FileSendWindow		m_window;
+	TCPSocket*			m_socket;
+	ArchSocket			m_listen;
+	Thread*				m_sender;
+	Thread*				m_reader;
+	volatile bool		m_stopReader;
+	size_t				m_received;
+	size_t				m_maxInFlight;
+	bool				m_sentEnd;
+};
+
+SendFileBenchmark::SendFileBenchmark(size_t fileSize) :
+	m_fileSize(fileSize),
+	m_socket(NULL),
+	m_sender(NULL),
+	m_reader(NULL),
+	m_stopReader(false),
+	m_received(0),
+	m_maxInFlight(0),
+	m_sentEnd(false)
+{
+	// a sparse file takes no disk space and reads back as zeros
+	std::ofstream file(TEST_FILE, std::ios::out | std::ios::binary);
+	file.seekp(m_fileSize - 1);
+	file.put('\0');
+	file.close();
+
+	ArchNetAddress addr = ARCH->nameToAddr("127.0.0.1");
+	ARCH->setAddrPort(addr, TEST_PORT);
+	m_listen = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+	ARCH->setReuseAddrOnSocket(m_listen, true);
+	ARCH->bindSocket(m_listen, addr);
+	ARCH->listenOnSocket(m_listen);
+	ARCH->closeAddr(addr);
+}
+
+SendFileBenchmark::~SendFileBenchmark()
+{
+	ARCH->closeSocket(m_listen);
+	remove(TEST_FILE);
+}
+
+void
+SendFileBenchmark::run()
+{
+	m_reader = new Thread(new TMethodJob<SendFileBenchmark>(
+							this, &SendFileBenchmark::reader));
+
+	m_socket = new TCPSocket(&m_events, &m_multiplexer);
+	m_events.adoptHandler(m_events.forIDataSocket().connected(),
+		m_socket->getEventTarget(),
+		new TMethodEventJob<SendFileBenchmark>(
+			this, &SendFileBenchmark::handleConnected));
+	m_events.adoptHandler(m_events.forIStream().outputFlushed(),
+		m_socket->getEventTarget(),
+		new TMethodEventJob<SendFileBenchmark>(
+			this, &SendFileBenchmark::handleOutputFlushed));
+	m_events.adoptHandler(m_events.forFile().fileChunkSending(), this,
+		new TMethodEventJob<SendFileBenchmark>(
+			this, &SendFileBenchmark::handleChunk));
+
+	NetworkAddress addr("127.0.0.1", TEST_PORT);
+	addr.resolve();
+	m_socket->connect(addr);
+
+	double start    = ARCH->time();
+	std::clock_t cpu = std::clock();
+	m_events.loop();
+	double wall     = ARCH->time() - start;
+	double cpuTime  = static_cast<double>(std::clock() - cpu) / CLOCKS_PER_SEC;
+
+	m_sender->wait();
+	delete m_sender;
+	m_stopReader = true;
+	m_reader->wait();
+	delete m_reader;
+
+	m_events.removeHandlers(m_socket->getEventTarget());
+	m_events.removeHandlers(this);
+	delete m_socket;
+
+	// the file plus message headers went over
+	EXPECT_LT(m_fileSize, m_received);
+
+	double mb = m_fileSize / (1024.0 * 1024.0);
+	LOG((CLOG_INFO "sent %.0f MB in %.2f s: %.0f MB/s, cpu %.0f%% of one core, max %u KB in flight",
+		mb, wall, mb / wall, 100.0 * cpuTime / wall,
+		static_cast<unsigned int>(m_maxInFlight / 1024)));
+}
+
+void
+SendFileBenchmark::sender(void*)
+{
+	StreamChunker::sendFile(const_cast<char*>(TEST_FILE),
+		&m_events, this, &m_window, false);
+}
+
+void
+SendFileBenchmark::reader(void*)
+{
+	IArchNetwork::PollEntry pe;
+	pe.m_socket = m_listen;
+	pe.m_events = IArchNetwork::kPOLLIN;
+	ArchSocket socket = NULL;
+	while (socket == NULL) {
+		ARCH->pollSocket(&pe, 1, -1.0);
+		socket = ARCH->acceptSocket(m_listen, NULL);
+	}
+
+	static char buffer[65536];
+	pe.m_socket = socket;
+	// once told to stop, read until the socket goes quiet so that
+	// nothing still in the kernel's buffers is missed
+	while (true) {
+		if (ARCH->pollSocket(&pe, 1, 0.1) > 0) {
+			m_received += static_cast<size_t>(
+							ARCH->readSocket(socket, buffer, sizeof(buffer)));
+		}
+		else if (m_stopReader) {
+			break;
+		}
+	}
+	ARCH->closeSocket(socket);
+}
+
+void
+SendFileBenchmark::handleConnected(const Event&, void*)
+{
+	m_sender = new Thread(new TMethodJob<SendFileBenchmark>(
+							this, &SendFileBenchmark::sender));
+}
+
+void
+SendFileBenchmark::handleChunk(const Event& event, void*)
+{
+	FileChunk* chunk = static_cast<FileChunk*>(event.getDataObject());
+	FileChunk::send(m_socket, chunk->m_chunk[0],
+		&chunk->m_chunk[1], chunk->m_dataSize);
+	if (chunk->m_chunk[0] == kDataEnd) {
+		m_sentEnd = true;
+	}
+
+	size_t inFlight = m_window.getInFlight();
+	if (inFlight > m_maxInFlight) {
+		m_maxInFlight = inFlight;
+	}
+}
+
+void
+SendFileBenchmark::handleOutputFlushed(const Event&, void*)
+{
+	m_window.outputFlushed();
+	if (m_sentEnd) {
+		m_events.addEvent(Event(Event::kQuit));
+	}
+}
+
+TEST(StreamChunkerBenchmarks, sendFile_2GB)
+{
+	SendFileBenchmark benchmark(static_cast<size_t>(2048) * 1024 * 1024);
+	benchmark.run();
+}
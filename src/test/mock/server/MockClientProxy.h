@@ -0,0 +1,53 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2013 Synergy Si Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "server/BaseClientProxy.h"
+#include "base/String.h"
+
+#include "test/global/gmock.h"
+
+class MockClientProxy : public BaseClientProxy
+{
+public:
+	MockClientProxy() : BaseClientProxy("mock") { }
+
+	MOCK_CONST_METHOD0(getEventTarget, void*());
+	MOCK_CONST_METHOD2(getClipboard, bool(ClipboardID, IClipboard*));
+	MOCK_CONST_METHOD4(getShape, void(SInt32&, SInt32&, SInt32&, SInt32&));
+	MOCK_CONST_METHOD2(getCursorPos, void(SInt32&, SInt32&));
+	MOCK_METHOD5(enter, void(SInt32, SInt32, UInt32, KeyModifierMask, bool));
+	MOCK_METHOD0(leave, bool());
+	MOCK_METHOD2(setClipboard, void(ClipboardID, const IClipboard*));
+	MOCK_METHOD1(grabClipboard, void(ClipboardID));
+	MOCK_METHOD2(setClipboardDirty, void(ClipboardID, bool));
+	MOCK_METHOD3(keyDown, void(KeyID, KeyModifierMask, KeyButton));
+	MOCK_METHOD4(keyRepeat, void(KeyID, KeyModifierMask, SInt32, KeyButton));
+	MOCK_METHOD3(keyUp, void(KeyID, KeyModifierMask, KeyButton));
+	MOCK_METHOD1(mouseDown, void(ButtonID));
+	MOCK_METHOD1(mouseUp, void(ButtonID));
+	MOCK_METHOD2(mouseMove, void(SInt32, SInt32));
+	MOCK_METHOD2(mouseRelativeMove, void(SInt32, SInt32));
+	MOCK_METHOD2(mouseWheel, void(SInt32, SInt32));
+	MOCK_METHOD1(screensaver, void(bool));
+	MOCK_METHOD0(resetOptions, void());
+	MOCK_METHOD1(setOptions, void(const OptionsList&));
+	MOCK_METHOD3(sendDragInfo, void(UInt32, const char*, size_t));
+	MOCK_METHOD3(fileChunkSending, void(UInt8, char*, size_t));
+	MOCK_CONST_METHOD0(getStream, synergy::IStream*());
+};
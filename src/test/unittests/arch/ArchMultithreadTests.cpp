@@ -0,0 +1,122 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mt/Thread.h"
+#include "arch/Arch.h"
+#include "base/FunctionJob.h"
+
+#include "test/global/gtest.h"
+
+#if HAVE_SYS_GETTID
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if HAVE_PTHREAD_SETAFFINITY_NP
+#include <sched.h>
+#endif
+
+static
+void
+spinUntilCancelled(void* vcount)
+{
+	volatile UInt32* count = static_cast<volatile UInt32*>(vcount);
+	for (;;) {
+		Thread::testCancel();
+		++*count;
+	}
+}
+
+TEST(ArchMultithreadTests, testCancelThread_notCancelled_returns)
+{
+	for (int i = 0; i < 1000; ++i) {
+		ARCH->testCancelThread();
+	}
+}
+
+TEST(ArchMultithreadTests, cancelThread_spinningThread_exits)
+{
+	volatile UInt32 count = 0;
+	Thread thread(new FunctionJob(&spinUntilCancelled,
+								const_cast<UInt32*>(&count)));
+	while (count == 0) {
+		ARCH->sleep(0.001);
+	}
+
+	thread.cancel();
+
+	EXPECT_TRUE(thread.wait(5.0));
+}
+
+TEST(ArchMultithreadTests, newCurrentThread_twice_sameThread)
+{
+	ArchThread a = ARCH->newCurrentThread();
+	ArchThread b = ARCH->newCurrentThread();
+
+	EXPECT_TRUE(ARCH->isSameThread(a, b));
+
+	ARCH->closeThread(a);
+	ARCH->closeThread(b);
+}
+
+#if HAVE_SYS_GETTID
+
+static
+void
+lowerPriority(void* vnice)
+{
+	Thread::getCurrentThread().setPriority(1);
+	*static_cast<int*>(vnice) = getpriority(PRIO_PROCESS,
+							static_cast<id_t>(syscall(SYS_gettid)));
+}
+
+TEST(ArchMultithreadTests, setPriorityOfThread_lower_niceGoesUp)
+{
+	int base = getpriority(PRIO_PROCESS, 0);
+	if (base >= 19) {
+		return;
+	}
+	int nice = base;
+	Thread thread(new FunctionJob(&lowerPriority, &nice));
+	thread.wait();
+
+	EXPECT_EQ(base + 1, nice);
+	EXPECT_EQ(base, getpriority(PRIO_PROCESS, 0));
+}
+
+#endif
+
+#if HAVE_PTHREAD_SETAFFINITY_NP
+
+static
+void
+pinToFirstCpu(void* vcpu)
+{
+	Thread::getCurrentThread().setAffinity(1);
+	*static_cast<int*>(vcpu) = sched_getcpu();
+}
+
+TEST(ArchMultithreadTests, setAffinityOfThread_firstCpu_runsThere)
+{
+	int cpu = -1;
+	Thread thread(new FunctionJob(&pinToFirstCpu, &cpu));
+	thread.wait();
+
+	EXPECT_EQ(0, cpu);
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/ArchPollSetEmulation.h"
+#include "arch/Arch.h"
+#include "mt/Thread.h"
+#include "base/FunctionJob.h"
+
+#include "test/global/gtest.h"
+
+static
+void
+waitForever(void* vpollSet)
+{
+	IArchNetwork::PollSetEvent events[1];
+	static_cast<ArchPollSetEmulation*>(vpollSet)->wait(events, 1, -1.0);
+}
+
+TEST(ArchPollSetEmulationTests, wait_empty_timesOut)
+{
+	ArchPollSetEmulation pollSet(ARCH);
+	IArchNetwork::PollSetEvent events[1];
+
+	int n = pollSet.wait(events, 1, 0.01);
+
+	EXPECT_EQ(0, n);
+}
+
+TEST(ArchPollSetEmulationTests, wait_writableSocket_reportsData)
+{
+	ArchSocket s = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kDGRAM);
+	ArchPollSetEmulation pollSet(ARCH);
+	int data;
+	pollSet.set(s, IArchNetwork::kPOLLOUT, &data);
+	IArchNetwork::PollSetEvent events[1];
+
+	int n = pollSet.wait(events, 1, 1.0);
+
+	EXPECT_EQ(1, n);
+	EXPECT_EQ(&data, events[0].m_data);
+	EXPECT_NE(0, events[0].m_revents & IArchNetwork::kPOLLOUT);
+	pollSet.remove(s);
+	ARCH->closeSocket(s);
+}
+
+TEST(ArchPollSetEmulationTests, wait_removed_notReported)
+{
+	ArchSocket s = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kDGRAM);
+	ArchPollSetEmulation pollSet(ARCH);
+	pollSet.set(s, IArchNetwork::kPOLLOUT, NULL);
+	pollSet.remove(s);
+	IArchNetwork::PollSetEvent events[1];
+
+	int n = pollSet.wait(events, 1, 0.01);
+
+	EXPECT_EQ(0, n);
+	ARCH->closeSocket(s);
+}
+
+TEST(ArchPollSetEmulationTests, remove_whileWaiting_unblocksWaiter)
+{
+	ArchSocket s = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kDGRAM);
+	ArchPollSetEmulation pollSet(ARCH);
+	pollSet.set(s, IArchNetwork::kPOLLIN, NULL);
+	Thread waiter(new FunctionJob(&waitForever, &pollSet));
+	ARCH->sleep(0.05);
+
+	pollSet.remove(s);
+
+	EXPECT_TRUE(waiter.wait(5.0));
+	ARCH->closeSocket(s);
+}
@@ -0,0 +1,51 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/Arch.h"
+
+#include "test/global/gtest.h"
+
+TEST(ArchTimeTests, nanoseconds_manyCalls_neverDecreases)
+{
+	UInt64 last = ARCH->nanoseconds();
+	for (int i = 0; i < 100000; ++i) {
+		UInt64 now = ARCH->nanoseconds();
+		ASSERT_LE(last, now);
+		last = now;
+	}
+}
+
+TEST(ArchTimeTests, nanoseconds_sleep_advancesBySleep)
+{
+	UInt64 start = ARCH->nanoseconds();
+
+	ARCH->sleep(0.02);
+
+	UInt64 elapsed = ARCH->nanoseconds() - start;
+	EXPECT_LE(20000000u, elapsed);
+	EXPECT_GT(1000000000u, elapsed);
+}
+
+TEST(ArchTimeTests, time_sameClockAsNanoseconds)
+{
+	double before = 1.0e-9 * static_cast<double>(ARCH->nanoseconds());
+	double now    = ARCH->time();
+	double after  = 1.0e-9 * static_cast<double>(ARCH->nanoseconds());
+
+	EXPECT_LE(before, now);
+	EXPECT_GE(after, now);
+}
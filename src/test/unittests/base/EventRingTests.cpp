@@ -0,0 +1,110 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/EventRing.h"
+
+#include "test/global/gtest.h"
+
+TEST(EventRingTests, ctor_capacityNotPowerOfTwo_roundedUp)
+{
+	EventRing ring(5);
+
+	EXPECT_EQ(8, ring.getCapacity());
+}
+
+TEST(EventRingTests, store_thenRemove_sameEvent)
+{
+	EventRing ring(4);
+	int target;
+	UInt32 id;
+
+	bool stored = ring.store(Event(Event::kLast + 1, &target), id);
+
+	Event event;
+	EXPECT_TRUE(stored);
+	EXPECT_TRUE(ring.remove(id, event));
+	EXPECT_EQ(Event::kLast + 1, event.getType());
+	EXPECT_EQ(&target, event.getTarget());
+}
+
+TEST(EventRingTests, remove_twice_secondFails)
+{
+	EventRing ring(4);
+	UInt32 id;
+	Event event;
+	ring.store(Event(Event::kLast), id);
+	ring.remove(id, event);
+
+	bool removed = ring.remove(id, event);
+
+	EXPECT_FALSE(removed);
+}
+
+TEST(EventRingTests, remove_idPastCapacity_fails)
+{
+	EventRing ring(4);
+	Event event;
+
+	bool removed = ring.remove(4, event);
+
+	EXPECT_FALSE(removed);
+}
+
+TEST(EventRingTests, store_full_fails)
+{
+	EventRing ring(2);
+	UInt32 id;
+	ring.store(Event(Event::kLast), id);
+	ring.store(Event(Event::kLast), id);
+
+	bool stored = ring.store(Event(Event::kLast), id);
+
+	EXPECT_FALSE(stored);
+}
+
+TEST(EventRingTests, store_afterRemoveOutOfOrder_reusesSlot)
+{
+	EventRing ring(2);
+	UInt32 first, second, third;
+	Event event;
+	ring.store(Event(Event::kLast), first);
+	ring.store(Event(Event::kLast + 1), second);
+	ring.remove(first, event);
+
+	bool stored = ring.store(Event(Event::kLast + 2), third);
+
+	EXPECT_TRUE(stored);
+	EXPECT_EQ(first, third);
+	EXPECT_TRUE(ring.remove(second, event));
+	EXPECT_EQ(Event::kLast + 1, event.getType());
+	EXPECT_TRUE(ring.remove(third, event));
+	EXPECT_EQ(Event::kLast + 2, event.getType());
+}
+
+TEST(EventRingTests, removeAll_someStored_returnsStored)
+{
+	EventRing ring(4);
+	UInt32 id;
+	ring.store(Event(Event::kLast), id);
+	ring.store(Event(Event::kLast), id);
+
+	std::vector<Event> events;
+	ring.removeAll(events);
+
+	EXPECT_EQ(2, events.size());
+	EXPECT_TRUE(ring.store(Event(Event::kLast), id));
+}
@@ -0,0 +1,120 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/HandlerTable.h"
+#include "base/IEventJob.h"
+
+#include "test/global/gtest.h"
+
+class NullEventJob : public IEventJob {
+public:
+	virtual void		run(const Event&) { }
+};
+
+TEST(HandlerTableTests, find_empty_returnsNull)
+{
+	HandlerTable table;
+	int target;
+
+	EXPECT_EQ(NULL, table.find(Event::kQuit, &target));
+	EXPECT_EQ(0, table.size());
+}
+
+TEST(HandlerTableTests, adopt_newHandler_findReturnsIt)
+{
+	HandlerTable table;
+	NullEventJob job;
+	int target;
+
+	EXPECT_EQ(NULL, table.adopt(Event::kQuit, &target, &job));
+
+	EXPECT_EQ(&job, table.find(Event::kQuit, &target));
+	EXPECT_EQ(NULL, table.find(Event::kTimer, &target));
+	EXPECT_EQ(1, table.size());
+}
+
+TEST(HandlerTableTests, adopt_existingHandler_returnsReplaced)
+{
+	HandlerTable table;
+	NullEventJob job1, job2;
+	int target;
+	table.adopt(Event::kQuit, &target, &job1);
+
+	EXPECT_EQ(&job1, table.adopt(Event::kQuit, &target, &job2));
+
+	EXPECT_EQ(&job2, table.find(Event::kQuit, &target));
+	EXPECT_EQ(1, table.size());
+}
+
+TEST(HandlerTableTests, remove_existingHandler_returnsIt)
+{
+	HandlerTable table;
+	NullEventJob job;
+	int target;
+	table.adopt(Event::kQuit, &target, &job);
+
+	EXPECT_EQ(&job, table.remove(Event::kQuit, &target));
+
+	EXPECT_EQ(NULL, table.find(Event::kQuit, &target));
+	EXPECT_EQ(NULL, table.remove(Event::kQuit, &target));
+	EXPECT_EQ(0, table.size());
+}
+
+TEST(HandlerTableTests, removeAll_severalTargets_removesOnlyTarget)
+{
+	HandlerTable table;
+	NullEventJob job1, job2, job3;
+	int target1, target2;
+	table.adopt(Event::kQuit, &target1, &job1);
+	table.adopt(Event::kTimer, &target1, &job2);
+	table.adopt(Event::kQuit, &target2, &job3);
+
+	std::vector<IEventJob*> removed;
+	table.removeAll(&target1, removed);
+
+	EXPECT_EQ(2, removed.size());
+	EXPECT_EQ(NULL, table.find(Event::kQuit, &target1));
+	EXPECT_EQ(NULL, table.find(Event::kTimer, &target1));
+	EXPECT_EQ(&job3, table.find(Event::kQuit, &target2));
+}
+
+TEST(HandlerTableTests, adopt_manyHandlers_allFound)
+{
+	static const int kTargets = 1000;
+	HandlerTable table;
+	NullEventJob job1, job2;
+	std::vector<int> targets(kTargets);
+	for (int i = 0; i < kTargets; ++i) {
+		table.adopt(Event::kQuit, &targets[i], &job1);
+		table.adopt(Event::kTimer, &targets[i], &job2);
+	}
+
+	EXPECT_EQ(2 * kTargets, table.size());
+	for (int i = 0; i < kTargets; ++i) {
+		EXPECT_EQ(&job1, table.find(Event::kQuit, &targets[i]));
+		EXPECT_EQ(&job2, table.find(Event::kTimer, &targets[i]));
+	}
+
+	// shrinks back down without losing anything
+	for (int i = 0; i < kTargets - 1; ++i) {
+		table.remove(Event::kQuit, &targets[i]);
+		table.remove(Event::kTimer, &targets[i]);
+	}
+	EXPECT_EQ(2, table.size());
+	EXPECT_EQ(&job1, table.find(Event::kQuit, &targets[kTargets - 1]));
+	EXPECT_EQ(&job2, table.find(Event::kTimer, &targets[kTargets - 1]));
+}
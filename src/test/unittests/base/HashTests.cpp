@@ -0,0 +1,52 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/Hash.h"
+
+#include "test/global/gtest.h"
+
+#include <cstring>
+
+using namespace synergy::hash;
+
+// expected values are from the reference implementation
+
+TEST(HashTests, xxHash32_empty_referenceValue)
+{
+	EXPECT_EQ(0x02cc5d05U, xxHash32("", 0));
+}
+
+TEST(HashTests, xxHash32_short_referenceValue)
+{
+	EXPECT_EQ(0x550d7456U, xxHash32("a", 1));
+	EXPECT_EQ(0x32d153ffU, xxHash32("abc", 3));
+}
+
+TEST(HashTests, xxHash32_long_referenceValue)
+{
+	const char* data = "Nobody inspects the spammish repetition";
+
+	UInt32 hash = xxHash32(data, strlen(data));
+
+	EXPECT_EQ(0xe2293b2fU, hash);
+}
+
+TEST(HashTests, xxHash32_differentSeed_differentHash)
+{
+	EXPECT_NE(xxHash32("abc", 3, 0), xxHash32("abc", 3, 1));
+}
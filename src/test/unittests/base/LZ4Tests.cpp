@@ -0,0 +1,120 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/LZ4.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdlib>
+#include <string>
+
+using namespace synergy::lz4;
+
+static std::string
+roundTrip(const std::string& data, size_t& compressedSize)
+{
+	std::string block(compressBound(data.size()), '\0');
+	compressedSize = compress(data.data(), data.size(), &block[0], block.size());
+	if (compressedSize == 0) {
+		return "<compress failed>";
+	}
+
+	std::string out(data.size(), '\0');
+	if (!decompress(block.data(), compressedSize, &out[0], out.size())) {
+		return "<decompress failed>";
+	}
+	return out;
+}
+
+TEST(LZ4Tests, compress_repetitiveText_roundTripsSmaller)
+{
+	std::string data;
+	for (int i = 0; i < 1000; ++i) {
+		data += "the quick brown fox jumps over the lazy dog ";
+	}
+	size_t compressedSize;
+
+	std::string out = roundTrip(data, compressedSize);
+
+	EXPECT_EQ(data, out);
+	EXPECT_LT(compressedSize, data.size() / 10);
+}
+
+TEST(LZ4Tests, compress_randomData_roundTrips)
+{
+	std::string data(100000, '\0');
+	srand(1);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<char>(rand());
+	}
+	size_t compressedSize;
+
+	std::string out = roundTrip(data, compressedSize);
+
+	EXPECT_EQ(data, out);
+	EXPECT_LE(compressedSize, compressBound(data.size()));
+}
+
+TEST(LZ4Tests, compress_shortInput_roundTrips)
+{
+	size_t compressedSize;
+
+	EXPECT_EQ("", roundTrip("", compressedSize));
+	EXPECT_EQ("abc", roundTrip("abc", compressedSize));
+	EXPECT_EQ("aaaaaaaaaaaaaaaaaaaaa", roundTrip("aaaaaaaaaaaaaaaaaaaaa", compressedSize));
+}
+
+TEST(LZ4Tests, compress_noRoom_returnsZero)
+{
+	std::string data(1000, 'x');
+	char block[4];
+
+	EXPECT_EQ(0u, compress(data.data(), data.size(), block, sizeof(block)));
+}
+
+TEST(LZ4Tests, decompress_wrongSize_returnsFalse)
+{
+	std::string data(1000, 'x');
+	std::string block(compressBound(data.size()), '\0');
+	size_t n = compress(data.data(), data.size(), &block[0], block.size());
+	std::string out(data.size() + 1, '\0');
+
+	EXPECT_FALSE(decompress(block.data(), n, &out[0], out.size()));
+}
+
+TEST(LZ4Tests, decompress_badOffset_returnsFalse)
+{
+	// one literal then a match reaching back past the start
+	const char block[] = { 0x10, 'a', 0x05, 0x00 };
+	char out[64];
+
+	EXPECT_FALSE(decompress(block, sizeof(block), out, 5));
+}
+
+TEST(LZ4Tests, decompress_truncated_returnsFalse)
+{
+	std::string data;
+	for (int i = 0; i < 100; ++i) {
+		data += "truncated block ";
+	}
+	std::string block(compressBound(data.size()), '\0');
+	size_t n = compress(data.data(), data.size(), &block[0], block.size());
+	std::string out(data.size(), '\0');
+
+	EXPECT_FALSE(decompress(block.data(), n - 3, &out[0], out.size()));
+}
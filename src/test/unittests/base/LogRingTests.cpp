@@ -0,0 +1,90 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/LogRing.h"
+
+#include "test/global/gtest.h"
+
+TEST(LogRingTests, ctor_capacityNotPowerOfTwo_roundedUp)
+{
+	LogRing ring(5, 16);
+
+	EXPECT_EQ(8, ring.getCapacity());
+}
+
+TEST(LogRingTests, store_thenPeek_sameMessage)
+{
+	LogRing ring(4, 16);
+
+	bool stored = ring.store(kDEBUG1, "hello");
+
+	ELevel level;
+	const char* message = ring.peek(level);
+	EXPECT_TRUE(stored);
+	ASSERT_TRUE(message != NULL);
+	EXPECT_STREQ("hello", message);
+	EXPECT_EQ(kDEBUG1, level);
+}
+
+TEST(LogRingTests, peek_empty_returnsNull)
+{
+	LogRing ring(4, 16);
+	ELevel level;
+
+	const char* message = ring.peek(level);
+
+	EXPECT_TRUE(message == NULL);
+}
+
+TEST(LogRingTests, store_longMessage_truncated)
+{
+	LogRing ring(4, 4);
+
+	ring.store(kINFO, "abcdef");
+
+	ELevel level;
+	EXPECT_STREQ("abc", ring.peek(level));
+}
+
+TEST(LogRingTests, store_full_failsAndCountsDrop)
+{
+	LogRing ring(2, 16);
+	ring.store(kINFO, "1");
+	ring.store(kINFO, "2");
+
+	bool stored = ring.store(kINFO, "3");
+
+	EXPECT_FALSE(stored);
+	EXPECT_EQ(1, ring.getDropped());
+}
+
+TEST(LogRingTests, pop_afterWrapAround_keepsOrder)
+{
+	LogRing ring(2, 16);
+	ELevel level;
+	ring.store(kINFO, "1");
+	ring.store(kINFO, "2");
+	ring.pop();
+	ring.store(kINFO, "3");
+
+	EXPECT_STREQ("2", ring.peek(level));
+	ring.pop();
+	EXPECT_STREQ("3", ring.peek(level));
+	ring.pop();
+	EXPECT_TRUE(ring.peek(level) == NULL);
+	EXPECT_EQ(0, ring.getDropped());
+}
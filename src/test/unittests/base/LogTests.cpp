@@ -0,0 +1,119 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Log.h"
+#include "base/ILogOutputter.h"
+
+#include "test/global/gtest.h"
+
+#include <vector>
+#include <string>
+
+class TestLogOutputter : public ILogOutputter {
+public:
+	TestLogOutputter() : m_flushes(0) { }
+
+	virtual void		open(const char*) { }
+	virtual void		close() { }
+	virtual void		show(bool) { }
+	virtual bool		write(ELevel, const char* message)
+	{
+		m_messages.push_back(message);
+
+		// keep test messages off the console
+		return false;
+	}
+	virtual void		flush() { ++m_flushes; }
+
+	std::vector<std::string>	m_messages;
+	int					m_flushes;
+};
+
+static
+int
+indexOf(const std::vector<std::string>& messages, const char* text)
+{
+	for (size_t i = 0; i < messages.size(); ++i) {
+		if (messages[i].find(text) != std::string::npos) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+TEST(LogTests, print_sync_writtenAndFlushed)
+{
+	TestLogOutputter outputter;
+	CLOG->insert(&outputter);
+
+	CLOG->print(NULL, 0, "%z\064test %d", 1);
+
+	CLOG->remove(&outputter);
+	ASSERT_EQ(1, outputter.m_messages.size());
+	EXPECT_NE(std::string::npos, outputter.m_messages[0].find("INFO: test 1"));
+	EXPECT_EQ(1, outputter.m_flushes);
+}
+
+TEST(LogTests, print_async_writtenBySetAsyncFalse)
+{
+	TestLogOutputter outputter;
+	CLOG->insert(&outputter);
+	CLOG->setAsync(true);
+
+	CLOG->print(NULL, 0, "%z\064first");
+	CLOG->print(NULL, 0, "%z\064second");
+	CLOG->setAsync(false);
+
+	CLOG->remove(&outputter);
+	int first  = indexOf(outputter.m_messages, "INFO: first");
+	int second = indexOf(outputter.m_messages, "INFO: second");
+	EXPECT_FALSE(CLOG->isAsync());
+	EXPECT_LE(0, first);
+	EXPECT_LT(first, second);
+}
+
+TEST(LogTests, print_asyncError_writtenImmediatelyInOrder)
+{
+	TestLogOutputter outputter;
+	CLOG->insert(&outputter);
+	CLOG->setAsync(true);
+
+	CLOG->print(NULL, 0, "%z\064queued");
+	CLOG->print(NULL, 0, "%z\061failed");
+
+	std::vector<std::string> messages = outputter.m_messages;
+	CLOG->setAsync(false);
+	CLOG->remove(&outputter);
+	int queued = indexOf(messages, "INFO: queued");
+	int failed = indexOf(messages, "ERROR: failed");
+	EXPECT_LE(0, queued);
+	EXPECT_LT(queued, failed);
+}
+
+TEST(LogTests, print_belowFilter_notWritten)
+{
+	TestLogOutputter outputter;
+	int filter = CLOG->getFilter();
+	CLOG->insert(&outputter);
+	CLOG->setFilter(kINFO);
+
+	CLOG->print(NULL, 0, "%z\065hidden");
+
+	CLOG->setFilter(filter);
+	CLOG->remove(&outputter);
+	EXPECT_EQ(0, outputter.m_messages.size());
+}
@@ -0,0 +1,121 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "base/TimerHeap.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdlib>
+
+TEST(TimerHeapTests, top_empty_returnsNull)
+{
+	TimerHeap heap;
+
+	EXPECT_TRUE(heap.empty());
+	EXPECT_EQ(NULL, heap.top());
+}
+
+TEST(TimerHeapTests, schedule_severalEntries_topIsEarliest)
+{
+	TimerHeap heap;
+	TimerHeap::Entry a, b, c;
+
+	heap.schedule(&a, 3.0);
+	heap.schedule(&b, 1.0);
+	heap.schedule(&c, 2.0);
+
+	EXPECT_EQ(&b, heap.top());
+	EXPECT_EQ(3, heap.size());
+}
+
+TEST(TimerHeapTests, schedule_queuedEntryLater_movesDown)
+{
+	TimerHeap heap;
+	TimerHeap::Entry a, b;
+	heap.schedule(&a, 1.0);
+	heap.schedule(&b, 2.0);
+
+	heap.schedule(&a, 5.0);
+
+	EXPECT_EQ(&b, heap.top());
+	EXPECT_EQ(5.0, a.getDeadline());
+	EXPECT_EQ(2, heap.size());
+}
+
+TEST(TimerHeapTests, schedule_queuedEntryEarlier_movesUp)
+{
+	TimerHeap heap;
+	TimerHeap::Entry a, b;
+	heap.schedule(&a, 1.0);
+	heap.schedule(&b, 2.0);
+
+	heap.schedule(&b, 0.5);
+
+	EXPECT_EQ(&b, heap.top());
+}
+
+TEST(TimerHeapTests, remove_top_nextEarliestIsTop)
+{
+	TimerHeap heap;
+	TimerHeap::Entry a, b, c;
+	heap.schedule(&a, 1.0);
+	heap.schedule(&b, 2.0);
+	heap.schedule(&c, 3.0);
+
+	heap.remove(&a);
+
+	EXPECT_EQ(&b, heap.top());
+	EXPECT_FALSE(a.isQueued());
+	EXPECT_TRUE(b.isQueued());
+}
+
+TEST(TimerHeapTests, remove_notQueued_doesNothing)
+{
+	TimerHeap heap;
+	TimerHeap::Entry a, b;
+	heap.schedule(&a, 1.0);
+
+	heap.remove(&b);
+
+	EXPECT_EQ(1, heap.size());
+	EXPECT_EQ(&a, heap.top());
+}
+
+TEST(TimerHeapTests, remove_randomOrder_keepsHeapOrder)
+{
+	TimerHeap heap;
+	TimerHeap::Entry entries[200];
+	srand(1);
+	for (int i = 0; i < 200; ++i) {
+		heap.schedule(&entries[i], rand() % 1000);
+	}
+	for (int i = 0; i < 200; i += 3) {
+		heap.remove(&entries[i]);
+	}
+	for (int i = 1; i < 200; i += 3) {
+		heap.schedule(&entries[i], rand() % 1000);
+	}
+
+	double last = -1.0;
+	while (!heap.empty()) {
+		TimerHeap::Entry* top = heap.top();
+		EXPECT_LE(last, top->getDeadline());
+		last = top->getDeadline();
+		heap.remove(top);
+	}
+}
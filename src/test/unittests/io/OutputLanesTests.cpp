@@ -0,0 +1,134 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "io/OutputLanes.h"
+#include "base/String.h"
+
+#include "test/global/gtest.h"
+
+#include <cstring>
+
+static
+String
+drain(OutputLanes& lanes, UInt32 n)
+{
+	StreamBuffer& output = lanes.next();
+	if (n > output.getSize()) {
+		n = output.getSize();
+	}
+	String data(static_cast<const char*>(output.peek(n)), n);
+	output.pop(n);
+	return data;
+}
+
+TEST(OutputLanesTests, next_empty_returnsEmptyBuffer)
+{
+	OutputLanes lanes;
+
+	EXPECT_EQ(0, lanes.next().getSize());
+}
+
+TEST(OutputLanesTests, next_bulkThenNormal_sendsNormalFirst)
+{
+	OutputLanes lanes;
+	lanes.writeBulk("bulk", 4);
+	lanes.write("key", 3);
+
+	EXPECT_EQ("key", drain(lanes, 100));
+	EXPECT_EQ("bulk", drain(lanes, 100));
+}
+
+TEST(OutputLanesTests, next_sliceStarted_normalWaitsForSlice)
+{
+	OutputLanes lanes(4);
+	lanes.writeBulk("abcd", 4);
+	lanes.writeBulk("efgh", 4);
+
+	EXPECT_EQ("ab", drain(lanes, 2));
+	lanes.write("key", 3);
+
+	EXPECT_EQ("cdkey", drain(lanes, 100));
+	EXPECT_EQ("efgh", drain(lanes, 100));
+}
+
+TEST(OutputLanesTests, next_smallUnits_fillsSlice)
+{
+	OutputLanes lanes(5);
+	lanes.writeBulk("ab", 2);
+	lanes.writeBulk("cd", 2);
+	lanes.writeBulk("ef", 2);
+	lanes.writeBulk("gh", 2);
+
+	EXPECT_EQ(6, lanes.next().getSize());
+	EXPECT_EQ(2, lanes.getBulkSize());
+}
+
+TEST(OutputLanesTests, next_largeUnit_isNotSplit)
+{
+	OutputLanes lanes(2);
+	lanes.writeBulk("abcdef", 6);
+
+	EXPECT_EQ(6, lanes.next().getSize());
+	EXPECT_EQ(0, lanes.getBulkSize());
+}
+
+TEST(OutputLanesTests, next_unitsWrapAround_keepsOrder)
+{
+	OutputLanes lanes(1);
+	char data[3000];
+	for (UInt32 i = 0; i < sizeof(data); ++i) {
+		data[i] = static_cast<char>(i);
+	}
+
+	// leave the bulk ring's head part way through so later units wrap
+	for (UInt32 i = 0; i < 5; ++i) {
+		lanes.writeBulk(data, sizeof(data));
+		lanes.writeBulk(data, sizeof(data));
+		String first = drain(lanes, sizeof(data));
+
+		EXPECT_EQ(0, memcmp(data, first.data(), sizeof(data)));
+		lanes.writeBulk(data, sizeof(data));
+		String second = drain(lanes, sizeof(data));
+		String third = drain(lanes, sizeof(data));
+
+		EXPECT_EQ(0, memcmp(data, second.data(), sizeof(data)));
+		EXPECT_EQ(0, memcmp(data, third.data(), sizeof(data)));
+	}
+}
+
+TEST(OutputLanesTests, getSize_bothLanes_countsAll)
+{
+	OutputLanes lanes;
+	lanes.write("key", 3);
+	lanes.writeBulk("bulk", 4);
+
+	EXPECT_EQ(7, lanes.getSize());
+	EXPECT_EQ(4, lanes.getBulkSize());
+}
+
+TEST(OutputLanesTests, clear_bothLanes_discardsAll)
+{
+	OutputLanes lanes;
+	lanes.write("key", 3);
+	lanes.writeBulk("bulk", 4);
+
+	lanes.clear();
+
+	EXPECT_EQ(0, lanes.getSize());
+	EXPECT_EQ(0, lanes.next().getSize());
+}
@@ -0,0 +1,159 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/StreamBuffer.h"
+
+#include "test/global/gtest.h"
+
+#include <cstring>
+
+TEST(StreamBufferTests, peekChunks_empty_returnsZero)
+{
+	StreamBuffer buffer;
+	IArchNetwork::WriteBuffer bufs[4];
+
+	UInt32 num = buffer.peekChunks(bufs, 4);
+
+	EXPECT_EQ(0, num);
+}
+
+TEST(StreamBufferTests, peekChunks_afterPop_startsAtNextByte)
+{
+	StreamBuffer buffer;
+	buffer.write("hello", 5);
+	buffer.pop(2);
+	IArchNetwork::WriteBuffer bufs[4];
+
+	UInt32 num = buffer.peekChunks(bufs, 4);
+
+	EXPECT_EQ(1, num);
+	EXPECT_EQ(3, bufs[0].m_size);
+	EXPECT_EQ(0, memcmp("llo", bufs[0].m_data, 3));
+}
+
+TEST(StreamBufferTests, peekChunks_manyChunks_coversAllData)
+{
+	StreamBuffer buffer;
+	UInt8 data[10000];
+	for (UInt32 i = 0; i < sizeof(data); ++i) {
+		data[i] = static_cast<UInt8>(i);
+	}
+	buffer.write(data, sizeof(data));
+	IArchNetwork::WriteBuffer bufs[8];
+
+	UInt32 num = buffer.peekChunks(bufs, 8);
+
+	size_t offset = 0;
+	for (UInt32 i = 0; i < num; ++i) {
+		EXPECT_EQ(0, memcmp(data + offset, bufs[i].m_data, bufs[i].m_size));
+		offset += bufs[i].m_size;
+	}
+	EXPECT_EQ(sizeof(data), offset);
+}
+
+TEST(StreamBufferTests, peekChunks_wrapped_returnsTwoEntries)
+{
+	StreamBuffer buffer;
+	UInt8 data[3000] = { 0 };
+	buffer.write(data, sizeof(data));
+	buffer.pop(sizeof(data) - 1);
+	buffer.write(data, sizeof(data));
+	IArchNetwork::WriteBuffer bufs[2];
+
+	UInt32 num = buffer.peekChunks(bufs, 2);
+
+	EXPECT_EQ(2, num);
+	EXPECT_EQ(sizeof(data) + 1, bufs[0].m_size + bufs[1].m_size);
+}
+
+TEST(StreamBufferTests, peekChunks_wrappedOneEntry_fillsFirstPart)
+{
+	StreamBuffer buffer;
+	UInt8 data[3000] = { 0 };
+	buffer.write(data, sizeof(data));
+	buffer.pop(sizeof(data) - 1);
+	buffer.write(data, sizeof(data));
+	IArchNetwork::WriteBuffer bufs[1];
+
+	UInt32 num = buffer.peekChunks(bufs, 1);
+
+	EXPECT_EQ(1, num);
+	EXPECT_GT(buffer.getSize(), bufs[0].m_size);
+}
+
+TEST(StreamBufferTests, peek_wrapped_returnsContiguousData)
+{
+	StreamBuffer buffer;
+	UInt8 data[3000];
+	memset(data, 'x', sizeof(data));
+	buffer.write(data, sizeof(data));
+	buffer.pop(2500);
+	buffer.write("hello", 5);
+	buffer.write(data, 1100);
+	buffer.pop(500);
+
+	const void* peeked = buffer.peek(1105);
+
+	EXPECT_EQ(0, memcmp("hello", peeked, 5));
+	EXPECT_EQ(0, memcmp(data, static_cast<const UInt8*>(peeked) + 5, 1100));
+}
+
+TEST(StreamBufferTests, write_pastCapacity_keepsData)
+{
+	StreamBuffer buffer;
+	UInt8 data[100000];
+	for (UInt32 i = 0; i < sizeof(data); ++i) {
+		data[i] = static_cast<UInt8>(i * 7);
+	}
+	buffer.write(data, 10);
+	buffer.pop(5);
+	buffer.write(data + 10, sizeof(data) - 10);
+
+	const void* peeked = buffer.peek(sizeof(data) - 5);
+
+	EXPECT_EQ(sizeof(data) - 5, buffer.getSize());
+	EXPECT_EQ(0, memcmp(data + 5, peeked, sizeof(data) - 5));
+}
+
+TEST(StreamBufferTests, pop_all_emptiesBuffer)
+{
+	StreamBuffer buffer;
+	buffer.write("hello", 5);
+
+	buffer.pop(10);
+
+	EXPECT_EQ(0, buffer.getSize());
+}
+
+TEST(StreamBufferTests, write_over2GB_throws)
+{
+	StreamBuffer buffer;
+	UInt8 byte = 0;
+
+	EXPECT_THROW(buffer.write(&byte, 0x80000001u), std::bad_alloc);
+	EXPECT_EQ(0, buffer.getSize());
+}
+
+TEST(StreamBufferTests, write_sizeWrapsAround_throws)
+{
+	StreamBuffer buffer;
+	UInt8 byte = 0;
+	buffer.write(&byte, 1);
+
+	EXPECT_THROW(buffer.write(&byte, 0xffffffffu), std::bad_alloc);
+	EXPECT_EQ(1, buffer.getSize());
+}
@@ -0,0 +1,204 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2013 Synergy Si Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/MouseMoveCoalescer.h"
+
+#include "test/mock/server/MockClientProxy.h"
+#include "test/mock/synergy/MockEventQueue.h"
+
+#include "test/global/gtest.h"
+#include "test/global/gmock.h"
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+TEST(MouseMoveCoalescerTests, mouseMove_noWindow_sendsEveryMove)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setClient(&client);
+
+	EXPECT_CALL(client, mouseMove(_, _)).Times(3);
+
+	coalescer.mouseMove(1, 1);
+	coalescer.mouseMove(2, 2);
+	coalescer.mouseMove(3, 3);
+
+	EXPECT_EQ(3, client.getMouseMovesSent());
+	EXPECT_EQ(0, client.getMouseMovesMerged());
+}
+
+TEST(MouseMoveCoalescerTests, mouseMove_idle_sendsAtOnce)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+
+	EXPECT_CALL(client, mouseMove(1, 2)).Times(1);
+
+	coalescer.mouseMove(1, 2);
+
+	EXPECT_FALSE(coalescer.isPending());
+}
+
+TEST(MouseMoveCoalescerTests, mouseMove_busy_mergedUntilFlushed)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+
+	{
+		InSequence seq;
+		EXPECT_CALL(client, mouseMove(1, 1));
+		EXPECT_CALL(client, mouseMove(4, 4));
+	}
+
+	coalescer.mouseMove(1, 1);
+	coalescer.mouseMove(2, 2);
+	coalescer.mouseMove(3, 3);
+	coalescer.mouseMove(4, 4);
+	EXPECT_TRUE(coalescer.isPending());
+	coalescer.outputFlushed();
+
+	EXPECT_FALSE(coalescer.isPending());
+	EXPECT_EQ(2, client.getMouseMovesSent());
+	EXPECT_EQ(2, client.getMouseMovesMerged());
+}
+
+TEST(MouseMoveCoalescerTests, mouseMove_busy_startsTimerOnce)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+	int timerStorage;
+	EventQueueTimer* timer = reinterpret_cast<EventQueueTimer*>(&timerStorage);
+
+	EXPECT_CALL(eventQueue, newOneShotTimer(0.01, &coalescer))
+		.WillOnce(Return(timer));
+	EXPECT_CALL(eventQueue, deleteTimer(timer)).Times(1);
+
+	coalescer.mouseMove(1, 1);
+	coalescer.mouseMove(2, 2);
+	coalescer.mouseMove(3, 3);
+	coalescer.flush();
+}
+
+TEST(MouseMoveCoalescerTests, mouseRelativeMove_busy_deltasAdded)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+
+	{
+		InSequence seq;
+		EXPECT_CALL(client, mouseRelativeMove(1, 1));
+		EXPECT_CALL(client, mouseRelativeMove(5, -3));
+	}
+
+	coalescer.mouseRelativeMove(1, 1);
+	coalescer.mouseRelativeMove(2, -1);
+	coalescer.mouseRelativeMove(3, -2);
+	coalescer.outputFlushed();
+}
+
+TEST(MouseMoveCoalescerTests, mouseMove_afterHeldRelative_relativeSentFirst)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+
+	{
+		InSequence seq;
+		EXPECT_CALL(client, mouseRelativeMove(1, 1));
+		EXPECT_CALL(client, mouseRelativeMove(2, 2));
+		EXPECT_CALL(client, mouseMove(10, 10));
+	}
+
+	coalescer.mouseRelativeMove(1, 1);
+	coalescer.mouseRelativeMove(2, 2);
+	coalescer.mouseMove(10, 10);
+	coalescer.flush();
+}
+
+TEST(MouseMoveCoalescerTests, flush_beforeButton_moveArrivesFirst)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+	coalescer.mouseMove(1, 1);
+	coalescer.mouseMove(2, 2);
+
+	{
+		InSequence seq;
+		EXPECT_CALL(client, mouseMove(2, 2));
+		EXPECT_CALL(client, mouseDown(kButtonLeft));
+	}
+
+	// this is what the server does before relaying a button
+	coalescer.flush();
+	client.mouseDown(kButtonLeft);
+}
+
+TEST(MouseMoveCoalescerTests, setClient_held_sentToOldClient)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> oldClient;
+	NiceMock<MockClientProxy> newClient;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&oldClient);
+	coalescer.mouseMove(1, 1);
+	coalescer.mouseMove(2, 2);
+
+	EXPECT_CALL(oldClient, mouseMove(2, 2)).Times(1);
+	EXPECT_CALL(newClient, mouseMove(_, _)).Times(0);
+
+	coalescer.setClient(&newClient);
+}
+
+TEST(MouseMoveCoalescerTests, discard_held_neverSent)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	NiceMock<MockClientProxy> client;
+	MouseMoveCoalescer coalescer(&eventQueue);
+	coalescer.setWindow(0.01);
+	coalescer.setClient(&client);
+	coalescer.mouseMove(1, 1);
+
+	EXPECT_CALL(client, mouseMove(_, _)).Times(0);
+
+	coalescer.mouseMove(2, 2);
+	coalescer.discard();
+	coalescer.flush();
+
+	EXPECT_FALSE(coalescer.isPending());
+}
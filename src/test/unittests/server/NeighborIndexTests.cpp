@@ -0,0 +1,197 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2013 Synergy Si Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_ENV
+
+#include "server/NeighborIndex.h"
+#include "server/Config.h"
+
+#include "test/mock/server/MockClientProxy.h"
+
+#include "test/global/gtest.h"
+#include "test/global/gmock.h"
+
+using ::testing::NiceMock;
+
+class NeighborIndexTests : public ::testing::Test {
+public:
+	NeighborIndexTests()
+	{
+		m_config.addScreen("a");
+		m_config.addScreen("b");
+		m_config.addScreen("c");
+	}
+
+	void				build()
+	{
+		m_index.build(m_config, m_clients);
+	}
+
+public:
+	Config				m_config;
+	NeighborIndex::ClientList	m_clients;
+	NeighborIndex		m_index;
+	NiceMock<MockClientProxy>	m_a;
+	NiceMock<MockClientProxy>	m_b;
+	NiceMock<MockClientProxy>	m_c;
+};
+
+TEST_F(NeighborIndexTests, getNeighbor_directLink_returnsClient)
+{
+	m_config.connect("a", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	m_clients["b"] = &m_b;
+	build();
+
+	float t = 0.0f;
+	BaseClientProxy* neighbor = m_index.getNeighbor(&m_a, kRight, 0.25f, t);
+
+	EXPECT_EQ(&m_b, neighbor);
+	EXPECT_FLOAT_EQ(0.25f, t);
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_fractionalLink_mapsPosition)
+{
+	m_config.connect("a", kRight, 0.5f, 1.0f, "b", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	m_clients["b"] = &m_b;
+	build();
+
+	float t = 0.0f;
+	BaseClientProxy* inside = m_index.getNeighbor(&m_a, kRight, 0.75f, t);
+	float unused;
+	BaseClientProxy* outside = m_index.getNeighbor(&m_a, kRight, 0.25f, unused);
+
+	EXPECT_EQ(&m_b, inside);
+	EXPECT_FLOAT_EQ(0.5f, t);
+	EXPECT_EQ(NULL, outside);
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_otherSide_returnsNull)
+{
+	m_config.connect("a", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	m_clients["b"] = &m_b;
+	build();
+
+	float t;
+	BaseClientProxy* neighbor = m_index.getNeighbor(&m_a, kLeft, 0.5f, t);
+
+	EXPECT_EQ(NULL, neighbor);
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_unconnectedBetween_skipsOver)
+{
+	m_config.connect("a", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_config.connect("b", kRight, 0.0f, 0.5f, "c", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	m_clients["c"] = &m_c;
+	build();
+
+	float t = 0.0f;
+	BaseClientProxy* inside = m_index.getNeighbor(&m_a, kRight, 0.25f, t);
+	float unused;
+	BaseClientProxy* outside = m_index.getNeighbor(&m_a, kRight, 0.75f, unused);
+
+	EXPECT_EQ(&m_c, inside);
+	EXPECT_FLOAT_EQ(0.5f, t);
+	EXPECT_EQ(NULL, outside);
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_clientConnected_rebuildFindsIt)
+{
+	m_config.connect("a", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_config.connect("b", kRight, 0.0f, 1.0f, "c", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	m_clients["c"] = &m_c;
+	build();
+	m_clients["b"] = &m_b;
+
+	build();
+
+	float t;
+	EXPECT_EQ(&m_b, m_index.getNeighbor(&m_a, kRight, 0.5f, t));
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_loopOfUnconnected_returnsNull)
+{
+	m_config.connect("a", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_config.connect("b", kRight, 0.0f, 1.0f, "c", 0.0f, 1.0f);
+	m_config.connect("c", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	build();
+
+	float t;
+	BaseClientProxy* neighbor = m_index.getNeighbor(&m_a, kRight, 0.5f, t);
+
+	EXPECT_EQ(NULL, neighbor);
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_unknownClient_returnsNull)
+{
+	m_config.connect("a", kRight, 0.0f, 1.0f, "b", 0.0f, 1.0f);
+	m_clients["b"] = &m_b;
+	build();
+
+	float t;
+	BaseClientProxy* neighbor = m_index.getNeighbor(&m_a, kRight, 0.5f, t);
+
+	EXPECT_EQ(NULL, neighbor);
+}
+
+TEST_F(NeighborIndexTests, getNeighbor_skippedLayout_matchesConfig)
+{
+	m_config.connect("a", kBottom, 0.0f, 0.6f, "b", 0.2f, 1.0f);
+	m_config.connect("a", kBottom, 0.6f, 1.0f, "c", 0.0f, 0.5f);
+	m_config.connect("b", kBottom, 0.1f, 0.7f, "c", 0.3f, 0.9f);
+	m_clients["a"] = &m_a;
+	m_clients["c"] = &m_c;
+	build();
+
+	for (int i = 0; i < 100; ++i) {
+		float position = (i + 0.5f) / 100.0f;
+
+		// walk the config the way the server used to
+		String name("a");
+		float expected = position;
+		do {
+			name = m_config.getNeighbor(name, kBottom, expected, &expected);
+		} while (name == "b");
+
+		float t = 0.0f;
+		BaseClientProxy* neighbor =
+			m_index.getNeighbor(&m_a, kBottom, position, t);
+
+		if (name.empty()) {
+			EXPECT_EQ(NULL, neighbor) << "at " << position;
+		}
+		else {
+			EXPECT_EQ(&m_c, neighbor) << "at " << position;
+			EXPECT_NEAR(expected, t, 1.0e-5f) << "at " << position;
+		}
+	}
+}
+
+TEST_F(NeighborIndexTests, hasLink_unconnectedNeighbor_true)
+{
+	m_config.connect("a", kTop, 0.0f, 0.5f, "b", 0.0f, 1.0f);
+	m_clients["a"] = &m_a;
+	build();
+
+	EXPECT_TRUE(m_index.hasLink(&m_a, kTop, 0.25f));
+	EXPECT_FALSE(m_index.hasLink(&m_a, kTop, 0.75f));
+}
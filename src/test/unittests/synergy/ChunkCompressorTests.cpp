@@ -0,0 +1,107 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy/ChunkCompressor.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdlib>
+
+static String
+makeText(size_t size)
+{
+	String text;
+	while (text.size() < size) {
+		text += "<p>clipboard text compresses well</p>\r\n";
+	}
+	text.resize(size);
+	return text;
+}
+
+static String
+makeRandom(size_t size)
+{
+	String data(size, '\0');
+	srand(2);
+	for (size_t i = 0; i < size; ++i) {
+		data[i] = static_cast<char>(rand());
+	}
+	return data;
+}
+
+TEST(ChunkCompressorTests, compress_text_decompressesToOriginal)
+{
+	ChunkCompressor compressor;
+	String text = makeText(10000);
+	String packed, unpacked;
+
+	ASSERT_TRUE(compressor.compress(text.data(), text.size(), packed));
+
+	EXPECT_LT(packed.size(), text.size());
+	EXPECT_TRUE(ChunkCompressor::decompress(packed, unpacked));
+	EXPECT_EQ(text, unpacked);
+}
+
+TEST(ChunkCompressorTests, compress_smallChunk_returnsFalse)
+{
+	ChunkCompressor compressor;
+	String text = makeText(20);
+	String packed;
+
+	EXPECT_FALSE(compressor.compress(text.data(), text.size(), packed));
+	EXPECT_TRUE(packed.empty());
+}
+
+TEST(ChunkCompressorTests, compress_png_skipsPayload)
+{
+	ChunkCompressor compressor;
+	String png = "\x89PNG\r\n\x1a\n" + makeText(10000);
+	String text = makeText(10000);
+	String packed;
+
+	EXPECT_FALSE(compressor.compress(png.data(), png.size(), packed));
+	EXPECT_FALSE(compressor.compress(text.data(), text.size(), packed));
+	EXPECT_EQ(20000u + 8, compressor.getBytesOut());
+}
+
+TEST(ChunkCompressorTests, compress_incompressible_givesUp)
+{
+	ChunkCompressor compressor;
+	String noise = makeRandom(10000);
+	String text = makeText(10000);
+	String packed;
+
+	EXPECT_FALSE(compressor.compress(noise.data(), noise.size(), packed));
+	EXPECT_FALSE(compressor.compress(noise.data(), noise.size(), packed));
+
+	EXPECT_FALSE(compressor.compress(text.data(), text.size(), packed));
+}
+
+TEST(ChunkCompressorTests, decompress_corrupt_returnsFalse)
+{
+	ChunkCompressor compressor;
+	String text = makeText(10000);
+	String packed, unpacked;
+	ASSERT_TRUE(compressor.compress(text.data(), text.size(), packed));
+
+	// claim a different size
+	packed[3] = static_cast<char>(packed[3] + 1);
+
+	EXPECT_FALSE(ChunkCompressor::decompress(packed, unpacked));
+	EXPECT_FALSE(ChunkCompressor::decompress(String("\0\0", 2), unpacked));
+}
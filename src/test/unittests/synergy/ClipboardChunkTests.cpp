@@ -74,3 +74,23 @@ TEST(ClipboardChunkTests, end_formatDataChunk)
 
 	delete chunk;
 }
+
+TEST(ClipboardChunkTests, cached_formatDataChunk)
+{
+	ClipboardID id = 1;
+	UInt32 sequence = 0;
+	ClipboardChunk* chunk = ClipboardChunk::cached(id, sequence, 0x01020304, 0x05060708);
+
+	EXPECT_EQ(id, chunk->m_chunk[0]);
+	EXPECT_EQ(sequence, (UInt32)chunk->m_chunk[1]);
+	EXPECT_EQ(kDataCached, chunk->m_chunk[5]);
+	EXPECT_EQ(8, chunk->m_dataSize);
+	EXPECT_EQ('\0', chunk->m_chunk[14]);
+
+	UInt32 hash[2];
+	memcpy(hash, &chunk->m_chunk[6], sizeof(hash));
+	EXPECT_EQ(0x01020304u, hash[0]);
+	EXPECT_EQ(0x05060708u, hash[1]);
+
+	delete chunk;
+}
@@ -402,3 +402,73 @@ TEST(ClipboardTests, copy_withSingleText_clipboardsAreEqual)
 	String actual = clipboard2.get(Clipboard::kText);
 	EXPECT_EQ("synergy rocks!", actual);
 }
+
+TEST(ClipboardTests, getHash_sameData_sameHash)
+{
+	Clipboard clipboard1;
+	clipboard1.open(0);
+	clipboard1.add(Clipboard::kText, "synergy rocks!");
+	clipboard1.close();
+	Clipboard clipboard2;
+	clipboard2.open(1);
+	clipboard2.add(Clipboard::kText, "synergy rocks!");
+	clipboard2.close();
+
+	EXPECT_TRUE(clipboard1.getHash() == clipboard2.getHash());
+}
+
+TEST(ClipboardTests, getHash_differentData_differentHash)
+{
+	Clipboard clipboard1;
+	clipboard1.open(0);
+	clipboard1.add(Clipboard::kText, "synergy rocks!");
+	clipboard1.close();
+	Clipboard clipboard2;
+	clipboard2.open(0);
+	clipboard2.add(Clipboard::kText, "synergy rolls!");
+	clipboard2.close();
+
+	EXPECT_TRUE(clipboard1.getHash() != clipboard2.getHash());
+}
+
+TEST(ClipboardTests, getHash_differentFormat_differentHash)
+{
+	Clipboard clipboard1;
+	clipboard1.open(0);
+	clipboard1.add(Clipboard::kText, "synergy rocks!");
+	clipboard1.close();
+	Clipboard clipboard2;
+	clipboard2.open(0);
+	clipboard2.add(Clipboard::kHTML, "synergy rocks!");
+	clipboard2.close();
+
+	EXPECT_TRUE(clipboard1.getHash() != clipboard2.getHash());
+	EXPECT_TRUE(clipboard1.getHash(Clipboard::kText) ==
+				clipboard2.getHash(Clipboard::kHTML));
+}
+
+TEST(ClipboardTests, getHash_replaceValue_hashChanges)
+{
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(Clipboard::kText, "synergy rocks!");
+	Clipboard::Hash before = clipboard.getHash(Clipboard::kText);
+
+	clipboard.add(Clipboard::kText, "maxivista sucks");
+
+	EXPECT_TRUE(before != clipboard.getHash(Clipboard::kText));
+}
+
+TEST(ClipboardTests, getHash_unmarshalled_sameHash)
+{
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(Clipboard::kText, "synergy rocks!");
+	clipboard.add(Clipboard::kBitmap, "\x10\x20\x30");
+	clipboard.close();
+	Clipboard copy;
+
+	copy.unmarshall(clipboard.marshall(), 0);
+
+	EXPECT_TRUE(clipboard.getHash() == copy.getHash());
+}
@@ -0,0 +1,134 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synergy/FileReceiver.h"
+
+#include "test/global/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+
+static const char* kTestDir = ".";
+static const char* kTestTarget = "FileReceiverTests.out";
+
+static
+bool
+fileExists(const String& path)
+{
+	std::ifstream file(path.c_str());
+	return file.is_open();
+}
+
+static
+String
+readFile(const String& path)
+{
+	std::ifstream file(path.c_str(), std::ios::binary);
+	return String((std::istreambuf_iterator<char>(file)),
+					std::istreambuf_iterator<char>());
+}
+
+TEST(FileReceiverTests, finish_allData_complete)
+{
+	FileReceiver receiver;
+	receiver.setDirectory(kTestDir);
+	receiver.start(6);
+
+	receiver.write("abc", 3);
+	receiver.write("def", 3);
+	bool finished = receiver.finish();
+
+	EXPECT_TRUE(finished);
+	EXPECT_TRUE(receiver.isComplete());
+	EXPECT_EQ(6, receiver.getReceivedSize());
+	EXPECT_EQ("abcdef", readFile(receiver.getPath()));
+}
+
+TEST(FileReceiverTests, finish_shortData_discarded)
+{
+	FileReceiver receiver;
+	receiver.setDirectory(kTestDir);
+	receiver.start(6);
+	String path = receiver.getPath();
+
+	receiver.write("abc", 3);
+	bool finished = receiver.finish();
+
+	EXPECT_FALSE(finished);
+	EXPECT_FALSE(receiver.isComplete());
+	EXPECT_FALSE(fileExists(path));
+}
+
+TEST(FileReceiverTests, write_pastExpectedSize_discarded)
+{
+	FileReceiver receiver;
+	receiver.setDirectory(kTestDir);
+	receiver.start(2);
+	String path = receiver.getPath();
+
+	bool written = receiver.write("abc", 3);
+
+	EXPECT_FALSE(written);
+	EXPECT_FALSE(receiver.isReceiving());
+	EXPECT_FALSE(fileExists(path));
+}
+
+TEST(FileReceiverTests, moveTo_complete_renamed)
+{
+	std::remove(kTestTarget);
+	FileReceiver receiver;
+	receiver.setDirectory(kTestDir);
+	receiver.start(3);
+	receiver.write("abc", 3);
+	receiver.finish();
+	String path = receiver.getPath();
+
+	bool moved = receiver.moveTo(kTestTarget);
+
+	EXPECT_TRUE(moved);
+	EXPECT_FALSE(receiver.isComplete());
+	EXPECT_FALSE(fileExists(path));
+	EXPECT_EQ("abc", readFile(kTestTarget));
+	std::remove(kTestTarget);
+}
+
+TEST(FileReceiverTests, moveTo_receiving_false)
+{
+	FileReceiver receiver;
+	receiver.setDirectory(kTestDir);
+	receiver.start(3);
+	receiver.write("abc", 3);
+
+	bool moved = receiver.moveTo(kTestTarget);
+
+	EXPECT_FALSE(moved);
+	EXPECT_FALSE(fileExists(kTestTarget));
+}
+
+TEST(FileReceiverTests, discard_receiving_removed)
+{
+	FileReceiver receiver;
+	receiver.setDirectory(kTestDir);
+	receiver.start(3);
+	String path = receiver.getPath();
+
+	receiver.discard();
+
+	EXPECT_FALSE(receiver.isReceiving());
+	EXPECT_FALSE(fileExists(path));
+}
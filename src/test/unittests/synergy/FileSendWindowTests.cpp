@@ -0,0 +1,62 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileSendWindow.h"
+
+#include "test/global/gtest.h"
+
+TEST(FileSendWindowTests, waitForRoom_empty_true)
+{
+	FileSendWindow window(100);
+
+	bool room = window.waitForRoom(0.0);
+
+	EXPECT_TRUE(room);
+}
+
+TEST(FileSendWindowTests, waitForRoom_belowSize_true)
+{
+	FileSendWindow window(100);
+	window.add(99);
+
+	bool room = window.waitForRoom(0.0);
+
+	EXPECT_TRUE(room);
+}
+
+TEST(FileSendWindowTests, waitForRoom_full_timesOut)
+{
+	FileSendWindow window(100);
+	window.add(60);
+	window.add(60);
+
+	bool room = window.waitForRoom(0.01);
+
+	EXPECT_FALSE(room);
+	EXPECT_EQ(120, window.getInFlight());
+}
+
+TEST(FileSendWindowTests, outputFlushed_full_makesRoom)
+{
+	FileSendWindow window(100);
+	window.add(100);
+
+	window.outputFlushed();
+
+	EXPECT_EQ(0, window.getInFlight());
+	EXPECT_TRUE(window.waitForRoom(0.0));
+}
@@ -77,6 +77,54 @@ TEST(GenericArgsParsingTests, parseGenericArgs_logFileCmd_saveLogFilename)
 	EXPECT_EQ(2, i);
 }
 
+TEST(GenericArgsParsingTests, parseGenericArgs_asyncLogCmd_asyncLogTrue)
+{
+	int i = 1;
+	const int argc = 2;
+	const char* kAsyncLogCmd[argc] = { "stub", "--async-log" };
+
+	ArgParser argParser(NULL);
+	ArgsBase argsBase;
+	argParser.setArgsBase(argsBase);
+
+	argParser.parseGenericArgs(argc, kAsyncLogCmd, i);
+
+	EXPECT_EQ(true, argsBase.m_asyncLog);
+	EXPECT_EQ(1, i);
+}
+
+TEST(GenericArgsParsingTests, parseGenericArgs_threadPriorityCmd_saveThreadPriority)
+{
+	int i = 1;
+	const int argc = 3;
+	const char* kThreadPriorityCmd[argc] = { "stub", "--thread-priority", "-2" };
+
+	ArgParser argParser(NULL);
+	ArgsBase argsBase;
+	argParser.setArgsBase(argsBase);
+
+	argParser.parseGenericArgs(argc, kThreadPriorityCmd, i);
+
+	EXPECT_EQ(-2, argsBase.m_threadPriority);
+	EXPECT_EQ(2, i);
+}
+
+TEST(GenericArgsParsingTests, parseGenericArgs_threadAffinityCmdHex_saveThreadAffinity)
+{
+	int i = 1;
+	const int argc = 3;
+	const char* kThreadAffinityCmd[argc] = { "stub", "--thread-affinity", "0xc" };
+
+	ArgParser argParser(NULL);
+	ArgsBase argsBase;
+	argParser.setArgsBase(argsBase);
+
+	argParser.parseGenericArgs(argc, kThreadAffinityCmd, i);
+
+	EXPECT_EQ(0xcu, argsBase.m_threadAffinity);
+	EXPECT_EQ(2, i);
+}
+
 TEST(GenericArgsParsingTests, parseGenericArgs_logFileCmdWithSpace_saveLogFilename)
 {
 	int i = 1;
@@ -0,0 +1,103 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyHistogram.h"
+
+#include "test/global/gtest.h"
+
+TEST(LatencyHistogramTests, add_smallTimes_microsecondBuckets)
+{
+	LatencyHistogram histogram;
+
+	histogram.add(0);
+	histogram.add(2500);
+	histogram.add(3999);
+
+	EXPECT_EQ(1, histogram.getBucketCount(0));
+	EXPECT_EQ(1, histogram.getBucketCount(2));
+	EXPECT_EQ(1, histogram.getBucketCount(3));
+}
+
+TEST(LatencyHistogramTests, getBucketStart_eachBucket_containsItsStart)
+{
+	for (UInt32 i = 0; i < LatencyHistogram::getNumBuckets(); ++i) {
+		LatencyHistogram histogram;
+		histogram.add(LatencyHistogram::getBucketStart(i));
+
+		EXPECT_EQ(1, histogram.getBucketCount(i));
+		if (i > 0) {
+			EXPECT_LT(LatencyHistogram::getBucketStart(i - 1),
+						LatencyHistogram::getBucketStart(i));
+		}
+	}
+}
+
+TEST(LatencyHistogramTests, add_hugeTime_lastBucket)
+{
+	LatencyHistogram histogram;
+
+	histogram.add(static_cast<UInt64>(1) << 62);
+
+	EXPECT_EQ(1, histogram.getBucketCount(LatencyHistogram::getNumBuckets() - 1));
+}
+
+TEST(LatencyHistogramTests, getMean_threeSamples_average)
+{
+	LatencyHistogram histogram;
+	histogram.add(1000);
+	histogram.add(2000);
+	histogram.add(6000);
+
+	EXPECT_EQ(3000, histogram.getMean());
+	EXPECT_EQ(6000, histogram.getMax());
+	EXPECT_EQ(3, histogram.getCount());
+}
+
+TEST(LatencyHistogramTests, getPercentile_empty_zero)
+{
+	LatencyHistogram histogram;
+
+	EXPECT_EQ(0, histogram.getPercentile(50.0));
+}
+
+TEST(LatencyHistogramTests, getPercentile_spread_withinBucketOfSample)
+{
+	LatencyHistogram histogram;
+	for (UInt64 us = 1; us <= 100; ++us) {
+		histogram.add(us * 1000);
+	}
+
+	// quarter octave buckets are within 25% of the sample
+	UInt64 p50 = histogram.getPercentile(50.0);
+	UInt64 p99 = histogram.getPercentile(99.0);
+	EXPECT_GE(p50, 50000);
+	EXPECT_LE(p50, 62500);
+	EXPECT_GE(p99, 99000);
+	EXPECT_LE(p99, 100000);
+}
+
+TEST(LatencyHistogramTests, clear_afterAdd_empty)
+{
+	LatencyHistogram histogram;
+	histogram.add(5000);
+
+	histogram.clear();
+
+	EXPECT_EQ(0, histogram.getCount());
+	EXPECT_EQ(0, histogram.getMax());
+	EXPECT_EQ(0, histogram.getBucketCount(5));
+}
@@ -0,0 +1,127 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyTrace.h"
+
+#include "test/global/gtest.h"
+
+// a millisecond in nanoseconds
+static const UInt64 kMs = 1000000;
+
+TEST(LatencyTraceTests, begin_first_true)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+
+	bool started = trace.begin(1 * kMs, 2 * kMs, id);
+
+	EXPECT_TRUE(started);
+	EXPECT_NE(0, id);
+}
+
+TEST(LatencyTraceTests, begin_withinInterval_false)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+	trace.begin(1 * kMs, 2 * kMs, id);
+	trace.sent(id, 3 * kMs);
+	trace.echoed(id, 1 * kMs, 10 * kMs);
+
+	bool started = trace.begin(20 * kMs, 21 * kMs, id);
+
+	EXPECT_FALSE(started);
+}
+
+TEST(LatencyTraceTests, begin_sampleInFlight_false)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+	trace.begin(1 * kMs, 2 * kMs, id);
+
+	bool started = trace.begin(100 * kMs, 100 * kMs, id);
+
+	EXPECT_FALSE(started);
+}
+
+TEST(LatencyTraceTests, begin_sampleTimedOut_true)
+{
+	LatencyTrace trace(0.05);
+	UInt32 first = 0;
+	UInt32 second = 0;
+	trace.begin(1 * kMs, 2 * kMs, first);
+
+	bool started = trace.begin(1100 * kMs, 1100 * kMs, second);
+
+	EXPECT_TRUE(started);
+	EXPECT_NE(first, second);
+}
+
+TEST(LatencyTraceTests, echoed_afterSent_addsHops)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+	trace.begin(1 * kMs, 2 * kMs, id);
+	trace.sent(id, 4 * kMs);
+
+	// 10ms round trip of which the client took 2ms
+	trace.echoed(id, 2 * kMs, 14 * kMs);
+
+	EXPECT_EQ(1 * kMs, trace.getHistogram(LatencyTrace::kServerQueue).getMax());
+	EXPECT_EQ(2 * kMs, trace.getHistogram(LatencyTrace::kServerSend).getMax());
+	EXPECT_EQ(4 * kMs, trace.getHistogram(LatencyTrace::kNetwork).getMax());
+	EXPECT_EQ(2 * kMs, trace.getHistogram(LatencyTrace::kClient).getMax());
+	EXPECT_EQ(9 * kMs, trace.getHistogram(LatencyTrace::kTotal).getMax());
+}
+
+TEST(LatencyTraceTests, echoed_wrongID_ignored)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+	trace.begin(1 * kMs, 2 * kMs, id);
+	trace.sent(id, 4 * kMs);
+
+	trace.echoed(id + 1, 2 * kMs, 14 * kMs);
+
+	EXPECT_EQ(0, trace.getHistogram(LatencyTrace::kTotal).getCount());
+}
+
+TEST(LatencyTraceTests, echoed_notSent_ignored)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+	trace.begin(1 * kMs, 2 * kMs, id);
+
+	trace.echoed(id, 2 * kMs, 14 * kMs);
+
+	EXPECT_EQ(0, trace.getHistogram(LatencyTrace::kTotal).getCount());
+}
+
+TEST(LatencyTraceTests, getReport_oneSample_listsHops)
+{
+	LatencyTrace trace(0.05);
+	UInt32 id = 0;
+	trace.begin(1 * kMs, 2 * kMs, id);
+	trace.sent(id, 4 * kMs);
+	trace.echoed(id, 2 * kMs, 14 * kMs);
+
+	String report = trace.getReport();
+
+	for (int i = 0; i < LatencyTrace::kNumHops; ++i) {
+		const char* name = LatencyTrace::getHopName(static_cast<LatencyTrace::EHop>(i));
+		EXPECT_NE(String::npos, report.find(name));
+	}
+}
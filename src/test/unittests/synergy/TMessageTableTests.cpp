@@ -0,0 +1,77 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/TMessageTable.h"
+#include "synergy/protocol_types.h"
+
+#include "test/global/gtest.h"
+
+class MessageTableTarget {
+public:
+	int					first() { return 1; }
+	int					second() { return 2; }
+};
+
+typedef TMessageTable<MessageTableTarget, int> TestMessageTable;
+
+TEST(TMessageTableTests, find_set_returnsHandler)
+{
+	TestMessageTable table;
+	table.set(kMsgDMouseMove, &MessageTableTarget::first);
+	table.set(kMsgDKeyDown, &MessageTableTarget::second);
+	MessageTableTarget target;
+
+	TestMessageTable::Handler handler =
+		table.find(reinterpret_cast<const UInt8*>(kMsgDKeyDown));
+
+	ASSERT_TRUE(handler != NULL);
+	EXPECT_EQ(2, (target.*handler)());
+}
+
+TEST(TMessageTableTests, find_notSet_returnsNull)
+{
+	TestMessageTable table;
+	table.set(kMsgDMouseMove, &MessageTableTarget::first);
+
+	TestMessageTable::Handler handler =
+		table.find(reinterpret_cast<const UInt8*>(kMsgDKeyUp));
+
+	EXPECT_TRUE(handler == NULL);
+}
+
+TEST(TMessageTableTests, find_codeWithArguments_matchesFirstFourBytes)
+{
+	TestMessageTable table;
+	table.set(kMsgDMouseMove, &MessageTableTarget::first);
+
+	TestMessageTable::Handler handler =
+		table.find(reinterpret_cast<const UInt8*>("DMMV\x01\x02"));
+
+	EXPECT_TRUE(handler == &MessageTableTarget::first);
+}
+
+TEST(TMessageTableTests, set_twice_replacesHandler)
+{
+	TestMessageTable table;
+	table.set(kMsgCKeepAlive, &MessageTableTarget::first);
+
+	table.set(kMsgCKeepAlive, &MessageTableTarget::second);
+
+	TestMessageTable::Handler handler =
+		table.find(reinterpret_cast<const UInt8*>(kMsgCKeepAlive));
+	EXPECT_TRUE(handler == &MessageTableTarget::second);
+}
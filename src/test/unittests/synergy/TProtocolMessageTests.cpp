@@ -0,0 +1,159 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2015 Synergy Seamless Inc.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/protocol_messages.h"
+#include "synergy/protocol_types.h"
+#include "synergy/ProtocolUtil.h"
+#include "base/String.h"
+
+#include "test/global/gtest.h"
+
+// a stream that keeps what's written to it for reading back
+class BufferStream : public synergy::IStream {
+public:
+	BufferStream() : m_writes(0) { }
+
+	virtual void		close() { }
+	virtual UInt32		read(void* buffer, UInt32 n)
+	{
+		if (n > m_data.size()) {
+			n = (UInt32)m_data.size();
+		}
+		memcpy(buffer, m_data.data(), n);
+		m_data.erase(0, n);
+		return n;
+	}
+	virtual void		write(const void* buffer, UInt32 n)
+	{
+		m_data.append(static_cast<const char*>(buffer), n);
+		++m_writes;
+	}
+	virtual void		flush() { }
+	virtual void		shutdownInput() { }
+	virtual void		shutdownOutput() { }
+	virtual void*		getEventTarget() const { return NULL; }
+	virtual bool		isReady() const { return !m_data.empty(); }
+	virtual UInt32		getSize() const { return (UInt32)m_data.size(); }
+
+public:
+	String				m_data;
+	int					m_writes;
+};
+
+TEST(TProtocolMessageTests, write_noFields_sameAsWritef)
+{
+	BufferStream expected, actual;
+	ProtocolUtil::writef(&expected, kMsgCKeepAlive);
+
+	MsgCKeepAlive::write(&actual);
+
+	EXPECT_EQ(String("CALV"), actual.m_data);
+	EXPECT_EQ(expected.m_data, actual.m_data);
+}
+
+TEST(TProtocolMessageTests, write_mouseMove_sameAsWritef)
+{
+	BufferStream expected, actual;
+	ProtocolUtil::writef(&expected, kMsgDMouseMove, 1234, -5);
+
+	MsgDMouseMove::write(&actual, 1234, -5);
+
+	EXPECT_EQ(String("DMMV\x04\xd2\xff\xfb", 8), actual.m_data);
+	EXPECT_EQ(expected.m_data, actual.m_data);
+}
+
+TEST(TProtocolMessageTests, write_mixedWidths_sameAsWritef)
+{
+	BufferStream expected, actual;
+	ProtocolUtil::writef(&expected, kMsgCEnter, 10, 20, 0x01020304, 0x4002);
+
+	MsgCEnter::write(&actual, 10, 20, 0x01020304, 0x4002);
+
+	EXPECT_EQ(String("CINN\x00\x0a\x00\x14\x01\x02\x03\x04\x40\x02", 14),
+		actual.m_data);
+	EXPECT_EQ(expected.m_data, actual.m_data);
+}
+
+TEST(TProtocolMessageTests, write_oneByteField_sameAsWritef)
+{
+	BufferStream expected, actual;
+	ProtocolUtil::writef(&expected, kMsgCClipboard, 1, 0xdeadbeef);
+
+	MsgCClipboard::write(&actual, 1, 0xdeadbeef);
+
+	EXPECT_EQ(String("CCLP\x01\xde\xad\xbe\xef", 9), actual.m_data);
+	EXPECT_EQ(expected.m_data, actual.m_data);
+}
+
+TEST(TProtocolMessageTests, write_sevenFields_sameAsWritef)
+{
+	BufferStream expected, actual;
+	ProtocolUtil::writef(&expected, kMsgDInfo, 0, 0, 1920, 1080, 0, 960, 540);
+
+	MsgDInfo::write(&actual, 0, 0, 1920, 1080, 0, 960, 540);
+
+	EXPECT_EQ(expected.m_data, actual.m_data);
+	EXPECT_EQ(MsgDInfo::kSize, actual.m_data.size());
+}
+
+TEST(TProtocolMessageTests, write_anyMessage_oneStreamWrite)
+{
+	BufferStream stream;
+
+	MsgDKeyRepeat::write(&stream, 1, 2, 3, 4);
+
+	EXPECT_EQ(1, stream.m_writes);
+}
+
+TEST(TProtocolMessageTests, read_writtenByWritef_sameValues)
+{
+	BufferStream stream;
+	ProtocolUtil::writef(&stream, kMsgDKeyRepeat + 4, 0xefbe, 0x2000, 7, 42);
+
+	UInt16 id, mask, count, button;
+	bool result = MsgDKeyRepeat::read(&stream, &id, &mask, &count, &button);
+
+	EXPECT_TRUE(result);
+	EXPECT_EQ(0xefbe, id);
+	EXPECT_EQ(0x2000, mask);
+	EXPECT_EQ(7, count);
+	EXPECT_EQ(42, button);
+}
+
+TEST(TProtocolMessageTests, read_negative_signExtended)
+{
+	BufferStream stream;
+	ProtocolUtil::writef(&stream, kMsgDMouseRelMove + 4, -3, 300);
+
+	SInt16 dx, dy;
+	MsgDMouseRelMove::read(&stream, &dx, &dy);
+
+	EXPECT_EQ(-3, dx);
+	EXPECT_EQ(300, dy);
+}
+
+TEST(TProtocolMessageTests, read_streamEnds_returnsFalse)
+{
+	BufferStream stream;
+	stream.m_data = String("\x01\x02", 2);
+
+	UInt8 id;
+	UInt32 seqNum;
+	bool result = MsgCClipboard::read(&stream, &id, &seqNum);
+
+	EXPECT_FALSE(result);
+}